@@ -148,7 +148,11 @@ namespace CppRefl.Compiler
 			AddFileCodeGenerator<ClassSuperGenerator>();
 			AddFileCodeGenerator<ClassMemberTypeGetters>();
 			AddFileCodeGenerator<ClassStaticTypeGetters>();
+			AddFileCodeGenerator<ClassSerializerGenerator>();
 			AddFileCodeGenerator<VectorDynamicArrayGenerator>();
+			AddFileCodeGenerator<ArrayViewGenerator>();
+			AddFileCodeGenerator<MapAssociativeArrayGenerator>();
+			AddFileCodeGenerator<OptionalGenerator>();
 		}
 
 		public List<IFileCodeGenerator> FileGenerators { get; } = new();
@@ -1,5 +1,7 @@
-﻿using CppRefl.Compiler.CodeWriters;
+﻿using CppRefl.Compiler.CodeGenerators.STL;
+using CppRefl.Compiler.CodeWriters;
 using CppRefl.Compiler.Reflection;
+using System.Globalization;
 using System.Text;
 
 namespace CppRefl.Compiler.CodeGenerators
@@ -60,9 +62,15 @@ namespace CppRefl.Compiler.CodeGenerators
 				var value = pair.Value.Value;
 
 				// If this attribute doesn't have quotes, then see if it's convertable to a number. If not, add quotes.
-				if (value[0] != '"')
+				if (value[0] != '"' && !int.TryParse(value, out var _))
 				{
-					if (!int.TryParse(value, out var _) && !float.TryParse(value, out var _))
+					// Float literals need a suffix, otherwise they're doubles, which convert to both int and float.
+					var floatValue = value.EndsWith('f') || value.EndsWith('F') ? value[..^1] : value;
+					if (floatValue.Any(char.IsDigit) && float.TryParse(floatValue, NumberStyles.Float, CultureInfo.InvariantCulture, out var _))
+					{
+						value = $"{floatValue}f";
+					}
+					else
 					{
 						value = $"\"{value}\"";
 					}
@@ -113,14 +121,43 @@ namespace CppRefl.Compiler.CodeGenerators
 			return $"CppReflPrivate::MaybeCreateReflectedType<{typeInfo.QualifiedName()}>(cpprefl::EnsureName(\"{typeInfo.QualifiedName()}\"))";
 		}
 
+		/// <summary>
+		/// Registers a container accessor table (e.g. "DynamicArray" calls Registry::AddDynamicArrayFunctions()).
+		/// </summary>
+		/// <returns></returns>
+		public static string RegisterContainerFunctions(ClassInfo classInfo, FieldInfo fieldInfo, string containerKind, string containerFunctions)
+		{
+			string varName = $"{classInfo.Type.FlattenedName()}{fieldInfo.Name}_{containerKind}";
+			return $"const auto& {varName} = cpprefl::Registry::GetSystemRegistry().Add{containerKind}Functions(cpprefl::EnsureName(\"{fieldInfo.Type.QualifiedName()}\"), {containerFunctions});";
+		}
+
+		/// <summary>
+		/// Create an expression that points to the container accessor table of a field (or nullptr if the field isn't a container).
+		/// The table is registered on first use, so the returned pointer never requires a lookup at runtime.
+		/// </summary>
+		/// <param name="fieldInfo"></param>
+		/// <returns></returns>
+		public static string GetContainerFunctions(FieldInfo fieldInfo)
+		{
+			foreach (var generator in ContainerFunctionsGenerator.StlGenerators)
+			{
+				string? containerFunctions = generator.CreateContainerFunctions(fieldInfo.Type);
+				if (containerFunctions != null)
+				{
+					return $"&cpprefl::Registry::GetSystemRegistry().Add{generator.ContainerKind}Functions(cpprefl::EnsureName(\"{fieldInfo.Type.QualifiedName()}\"), {containerFunctions})";
+				}
+			}
+
+			return "nullptr";
+		}
+
 		/// <summary>
 		/// Registers a dynamic array generator.
 		/// </summary>
 		/// <returns></returns>
 		public static string RegisterDynamicArrayFunctions(ClassInfo classInfo, FieldInfo fieldInfo, string dynamicArrayFunctions)
 		{
-			string varName = $"{classInfo.Type.FlattenedName()}{fieldInfo.Name}_DynamicArray";
-			return $"const auto& {varName} = cpprefl::Registry::GetSystemRegistry().AddDynamicArrayFunctions(cpprefl::EnsureName(\"{fieldInfo.Type.QualifiedName()}\"), {dynamicArrayFunctions});";
+			return RegisterContainerFunctions(classInfo, fieldInfo, "DynamicArray", dynamicArrayFunctions);
 		}
 	}
 }
@@ -0,0 +1,147 @@
+﻿using CppRefl.Compiler.CodeWriters;
+using CppRefl.Compiler.Reflection;
+
+namespace CppRefl.Compiler.CodeGenerators.Optional
+{
+	/// <summary>
+	/// Generates straight-line serialization code for each class (CppReflPrivate::GeneratedSerializer), which the runtime Serializer
+	/// and Deserializer use instead of walking the reflected fields. Fields are found with a switch over the precomputed hashes of their names.
+	/// </summary>
+	internal class ClassSerializerGenerator : IFileCodeGenerator
+	{
+		private const string SerializationNamespace = $"{CppDefines.Namespaces.Public}::serialization";
+
+		public void Execute(FileCodeGeneratorContext context)
+		{
+			var classes = context.Objects.Classes
+				.Where(classInfo => !classInfo.Type.IsTemplated && (classInfo.Fields.Any() || GetBaseClass(classInfo) != null))
+				.ToList();
+			if (!classes.Any())
+			{
+				return;
+			}
+
+			foreach (var classInfo in classes)
+			{
+				var collision = Hash.FindHashCollision(classInfo.Fields, field => field.Name, Hash.Crc32);
+				if (collision != null)
+				{
+					context.AddDiagnostic(DiagnosticLevel.Error, $"Fields '{collision.Item1.Name}' and '{collision.Item2.Name}' of '{classInfo.Type.QualifiedName()}' have the same name hash.");
+				}
+
+				// The generated code accesses fields directly, so it needs access to private fields.
+				context.WriteClassDeclaration(classInfo, writer =>
+				{
+					writer.WriteLine($"friend struct {CppDefines.Namespaces.Private}::GeneratedSerializer<{classInfo.Type.Name}>;");
+				});
+			}
+
+			context.WriteSource(writer =>
+			{
+				writer.IncludeHeader("Serialization/GeneratedSerializer.h");
+
+				using (writer.WithNamespace(CppDefines.Namespaces.Private))
+				{
+					foreach (var classInfo in classes)
+					{
+						WriteClassSerializer(writer, classInfo);
+					}
+				}
+			});
+		}
+
+		/// <summary>
+		/// Returns the base class whose fields are part of the reflected class (see ClassReflectionGenerator), or null.
+		/// </summary>
+		/// <param name="classInfo"></param>
+		/// <returns></returns>
+		private static ClassInfo? GetBaseClass(ClassInfo classInfo)
+		{
+			var baseClass = classInfo.BaseClasses.FirstOrDefault();
+			while (baseClass != null && baseClass.Metadata.IsReflected && baseClass.Type.IsTemplated)
+			{
+				baseClass = baseClass.BaseClasses.FirstOrDefault();
+			}
+
+			return baseClass != null && baseClass.Metadata.IsReflected && !baseClass.Type.IsTemplated ? baseClass : null;
+		}
+
+		private static string FieldName(FieldInfo field) => $"cpprefl::Name::FromHash(0x{Hash.Crc32(field.Name):x8}u)";
+
+		private void WriteClassSerializer(CppWriter writer, ClassInfo classInfo)
+		{
+			string className = classInfo.Type.GloballyQualifiedName();
+			var baseClass = GetBaseClass(classInfo);
+
+			writer.WriteLine("template <>");
+			using (writer.WithCodeBlock($"struct GeneratedSerializer<{className}> : {SerializationNamespace}::GeneratedSerializerBase", "{", "};"))
+			{
+				// Fields are written in the same order as the reflected path: base class fields first, then our own fields.
+				using (writer.WithFunction($"static void SerializeFields({SerializationNamespace}::Serializer& serializer, {SerializationNamespace}::IWriter& writer, const void* classObject)"))
+				{
+					writer.WriteLine($"const auto& object = *static_cast<const {className}*>(classObject);");
+					if (classInfo.Fields.Any())
+					{
+						writer.WriteLine($"const auto& classInfo = cpprefl::GetReflectedClass<{className}>();");
+					}
+
+					if (baseClass != null)
+					{
+						string baseClassName = baseClass.Type.GloballyQualifiedName();
+						writer.WriteLine($"SerializeBaseFields(serializer, writer, cpprefl::GetReflectedClass<{baseClassName}>(), static_cast<const {baseClassName}*>(&object));");
+					}
+
+					foreach (var field in classInfo.Fields)
+					{
+						writer.WriteLine();
+						writer.WriteLine($"writer.Key(\"{field.Name}\");");
+						writer.WriteLine($"SerializeMember(serializer, writer, classInfo, classObject, object.{field.Name}, {FieldName(field)});");
+					}
+				}
+
+				writer.WriteLine();
+
+				using (writer.WithFunction($"static bool DeserializeField({SerializationNamespace}::Deserializer& deserializer, {SerializationNamespace}::IReader& reader, void* classObject, const cpprefl::Name& key, bool& changed)"))
+				{
+					writer.WriteLine($"auto& object = *static_cast<{className}*>(classObject);");
+					if (classInfo.Fields.Any())
+					{
+						writer.WriteLine($"const auto& classInfo = cpprefl::GetReflectedClass<{className}>();");
+					}
+
+					writer.WriteLine();
+
+					using (writer.WithCodeBlock("switch (key.GetHash())", "{", "}"))
+					{
+						foreach (var field in classInfo.Fields)
+						{
+							writer.WriteLine($"case 0x{Hash.Crc32(field.Name):x8}u: // {field.Name}");
+							using (writer.WithIndent())
+							{
+								writer.WriteLine($"return DeserializeMember(deserializer, reader, classInfo, classObject, object.{field.Name}, key, changed);");
+							}
+						}
+
+						writer.WriteLine("default:");
+						using (writer.WithIndent())
+						{
+							if (baseClass != null)
+							{
+								string baseClassName = baseClass.Type.GloballyQualifiedName();
+								writer.WriteLine($"return DeserializeBaseField(deserializer, reader, cpprefl::GetReflectedClass<{baseClassName}>(), static_cast<{baseClassName}*>(&object), key, changed);");
+							}
+							else
+							{
+								writer.WriteLine("return reader.SkipValue();");
+							}
+						}
+					}
+				}
+			}
+
+			writer.WriteLine();
+			writer.WriteLine($"const auto& {classInfo.Type.FlattenedName()}_GeneratedSerializer = {SerializationNamespace}::RegisterGeneratedSerializer<{className}>();");
+			writer.WriteLine();
+		}
+	}
+}
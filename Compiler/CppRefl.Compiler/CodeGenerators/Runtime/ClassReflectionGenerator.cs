@@ -108,7 +108,7 @@ namespace CppRefl.Compiler.CodeGenerators.Runtime
 				using (writer.WithFunction($"const TypeInfo& GetReflectedType<{classInfo.Type.GloballyQualifiedName()}>()"))
 				{
 					writer.WriteLine(
-						$"static auto& type = cpprefl::Registry::GetSystemRegistry().EmplaceType(cpprefl::EnsureName(\"{classInfo.Type.QualifiedName()}\"), cpprefl::TypeKind::Class, sizeof({classInfo.Type.GloballyQualifiedName()}));");
+						$"static auto& type = cpprefl::Registry::GetSystemRegistry().EmplaceType(cpprefl::EnsureName(\"{classInfo.Type.QualifiedName()}\"), cpprefl::TypeKind::Class, sizeof({classInfo.Type.GloballyQualifiedName()}), \"{classInfo.Type.QualifiedName()}\");");
 					writer.WriteLine("return type;");
 				}
 
@@ -147,37 +147,53 @@ namespace CppRefl.Compiler.CodeGenerators.Runtime
 									                  	cpprefl::MakeTypeInstance<decltype({classInfo.Type.GloballyQualifiedName()}::{field.Name})>({CodeGeneratorUtil.MaybeCreateReflectedType(field.Type)}),
 									                  	offsetof({classInfo.Type.GloballyQualifiedName()}, {field.Name}),
 									                  	cpprefl::EnsureName("{field.Name}"),
+									                  	"{field.Name}",
 									                  	{fieldTags[field]},
-									                  	{fieldAttributes[field]}
+									                  	{fieldAttributes[field]},
+									                  	{CodeGeneratorUtil.GetContainerFunctions(field)}
 									                  ),
 									                  """);
 							}
 						}
 					}
 
+					// Find the first reflected base class that isn't templated.
+					var baseClass = classInfo.BaseClasses.FirstOrDefault();
+					while (baseClass != null && baseClass.Metadata.IsReflected && baseClass.Type.IsTemplated)
+					{
+						baseClass = baseClass.BaseClasses.FirstOrDefault();
+					}
+
+					if (baseClass != null && (!baseClass.Metadata.IsReflected || baseClass.Type.IsTemplated))
+					{
+						baseClass = null;
+					}
+
+					// Write the flattened field list (base class fields + our own fields, sorted by offset).
+					string fields = classInfo.Fields.Count > 0 ? "Fields" : "cpprefl::FieldView()";
+					string flattenedFields = fields;
+					if (baseClass != null)
+					{
+						writer.WriteLine($"static const auto FlattenedFields = cpprefl::FlattenFields({fields}, &GetReflectedClass<{baseClass.Type.GloballyQualifiedName()}>(), CppReflPrivate::GetBaseClassOffset<{classInfo.Type.GloballyQualifiedName()}, {baseClass.Type.GloballyQualifiedName()}>());");
+						flattenedFields = "FlattenedFields";
+					}
+
 					using (writer.WithCodeBlock(
 							   "static const auto& classInfo = cpprefl::Registry::GetSystemRegistry().EmplaceClass",
 							   "(", ");"))
 					{
 						using (writer.WithPostfix(","))
 						{
-							var baseClass = classInfo.BaseClasses.FirstOrDefault();
-							while (baseClass != null && baseClass.Metadata.IsReflected && baseClass.Type.IsTemplated)
-							{
-								baseClass = baseClass.BaseClasses.FirstOrDefault();
-							}
-
 							var ctor = classInfo.IsAbstract ? "nullptr" : $"[](void * obj) {{ new(obj) {classInfo.Type.GloballyQualifiedName()}(); }}";
 							var dtor = classInfo.IsAbstract ? "nullptr" : $"[](void * obj) {{ (({classInfo.Type.GloballyQualifiedName()}*)obj)->~{classInfo.Type.Name}(); }}";
 
 							writer.WriteLine($"&GetReflectedType<{classInfo.Type.GloballyQualifiedName()}>()");
-							writer.WriteLine(
-								baseClass != null && baseClass.Metadata.IsReflected && !baseClass.Type.IsTemplated
-									? $"&GetReflectedClass<{baseClass.Type.GloballyQualifiedName()}>()"
-									: "nullptr");
+							writer.WriteLine(baseClass != null ? $"&GetReflectedClass<{baseClass.Type.GloballyQualifiedName()}>()" : "nullptr");
 							writer.WriteLine(ctor);
 							writer.WriteLine(dtor);
-							writer.WriteLine(classInfo.Fields.Count > 0 ? "Fields" : "cpprefl::FieldView()");
+							writer.WriteLine($"CppReflPrivate::GetDynamicClassGetter<{classInfo.Type.GloballyQualifiedName()}>()");
+							writer.WriteLine(fields);
+							writer.WriteLine(flattenedFields);
 							writer.WriteLine(classTags);
 						}
 
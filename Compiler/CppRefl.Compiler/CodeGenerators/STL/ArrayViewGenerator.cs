@@ -0,0 +1,25 @@
+﻿using CppRefl.Compiler.Reflection;
+
+namespace CppRefl.Compiler.CodeGenerators.STL
+{
+	/// <summary>
+	/// Registers accessors for std::array and std::span fields.
+	/// </summary>
+	internal class ArrayViewGenerator : ContainerFunctionsGenerator
+	{
+		private static readonly string[] ContainerPrefixes = { "std::array<", "std::span<" };
+
+		public override string ContainerKind => "ArrayView";
+
+		public override string? CreateContainerFunctions(TypeInfo type)
+		{
+			if (!ContainerPrefixes.Any(prefix => type.QualifiedName().StartsWith(prefix)))
+			{
+				return null;
+			}
+
+			string elementType = type.Template!.Arguments.First().ToString();
+			return $"{CppDefines.Namespaces.Public}::StdArrayViewFunctionsFactory::Create<{type.QualifiedName()}>(cpprefl::EnsureName(\"{elementType}\"))";
+		}
+	}
+}
@@ -0,0 +1,56 @@
+﻿using CppRefl.Compiler.Reflection;
+
+namespace CppRefl.Compiler.CodeGenerators.STL
+{
+	/// <summary>
+	/// Base class for generators that register container accessor tables (e.g. cpprefl::DynamicArrayFunctions) for reflected fields.
+	/// </summary>
+	internal abstract class ContainerFunctionsGenerator : IFileCodeGenerator
+	{
+		/// <summary>
+		/// All built-in STL container generators.
+		/// </summary>
+		public static IReadOnlyList<ContainerFunctionsGenerator> StlGenerators { get; } = new ContainerFunctionsGenerator[]
+		{
+			new VectorDynamicArrayGenerator(),
+			new ArrayViewGenerator(),
+			new MapAssociativeArrayGenerator(),
+			new OptionalGenerator(),
+		};
+
+		/// <summary>
+		/// Kind of accessor table this generator creates (e.g. "DynamicArray"). Selects the Registry::AddXXXFunctions() to call.
+		/// </summary>
+		public abstract string ContainerKind { get; }
+
+		/// <summary>
+		/// Returns an expression that creates the accessor table for a type, or null if this generator doesn't handle the type.
+		/// </summary>
+		/// <param name="type"></param>
+		/// <returns></returns>
+		public abstract string? CreateContainerFunctions(TypeInfo type);
+
+		public void Execute(FileCodeGeneratorContext context)
+		{
+			context.WriteSource(writer =>
+			{
+				foreach (var classInfo in context.Objects.Classes)
+				{
+					var containerFields = classInfo.Fields
+						.Select(x => (Field: x, Functions: CreateContainerFunctions(x.Type)))
+						.Where(x => x.Functions != null);
+					if (containerFields.Any())
+					{
+						using (writer.WithNamespace(CppDefines.Namespaces.Private))
+						{
+							foreach (var (fieldInfo, containerFunctions) in containerFields)
+							{
+								writer.WriteLine(CodeGeneratorUtil.RegisterContainerFunctions(classInfo, fieldInfo, ContainerKind, containerFunctions!));
+							}
+						}
+					}
+				}
+			});
+		}
+	}
+}
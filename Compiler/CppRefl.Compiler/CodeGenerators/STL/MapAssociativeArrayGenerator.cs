@@ -0,0 +1,26 @@
+﻿using CppRefl.Compiler.Reflection;
+
+namespace CppRefl.Compiler.CodeGenerators.STL
+{
+	/// <summary>
+	/// Registers accessors for std::map and std::unordered_map fields.
+	/// </summary>
+	internal class MapAssociativeArrayGenerator : ContainerFunctionsGenerator
+	{
+		private static readonly string[] ContainerPrefixes = { "std::map<", "std::unordered_map<" };
+
+		public override string ContainerKind => "AssociativeArray";
+
+		public override string? CreateContainerFunctions(TypeInfo type)
+		{
+			if (!ContainerPrefixes.Any(prefix => type.QualifiedName().StartsWith(prefix)))
+			{
+				return null;
+			}
+
+			string keyType = type.Template!.Arguments[0].ToString();
+			string valueType = type.Template!.Arguments[1].ToString();
+			return $"{CppDefines.Namespaces.Public}::StdAssociativeArrayFunctionsFactory::Create<{type.QualifiedName()}>(cpprefl::EnsureName(\"{keyType}\"), cpprefl::EnsureName(\"{valueType}\"))";
+		}
+	}
+}
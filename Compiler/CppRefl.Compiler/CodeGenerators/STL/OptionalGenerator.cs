@@ -0,0 +1,30 @@
+﻿using CppRefl.Compiler.Reflection;
+
+namespace CppRefl.Compiler.CodeGenerators.STL
+{
+	/// <summary>
+	/// Registers accessors for std::optional and std::unique_ptr fields.
+	/// </summary>
+	internal class OptionalGenerator : ContainerFunctionsGenerator
+	{
+		public override string ContainerKind => "Optional";
+
+		public override string? CreateContainerFunctions(TypeInfo type)
+		{
+			string? factory = type.QualifiedName() switch
+			{
+				var name when name.StartsWith("std::optional<") => "StdOptionalFunctionsFactory",
+				var name when name.StartsWith("std::unique_ptr<") => "StdUniquePtrFunctionsFactory",
+				_ => null
+			};
+
+			if (factory == null)
+			{
+				return null;
+			}
+
+			string valueType = type.Template!.Arguments.First().ToString();
+			return $"{CppDefines.Namespaces.Public}::{factory}::Create<{valueType}>(cpprefl::EnsureName(\"{valueType}\"))";
+		}
+	}
+}
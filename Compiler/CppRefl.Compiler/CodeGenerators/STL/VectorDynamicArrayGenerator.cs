@@ -2,29 +2,19 @@
 
 namespace CppRefl.Compiler.CodeGenerators.STL
 {
-	internal class VectorDynamicArrayGenerator : IFileCodeGenerator
+	internal class VectorDynamicArrayGenerator : ContainerFunctionsGenerator
 	{
-		public void Execute(FileCodeGeneratorContext context)
+		public override string ContainerKind => "DynamicArray";
+
+		public override string? CreateContainerFunctions(TypeInfo type)
 		{
-			context.WriteSource(writer =>
+			if (!type.QualifiedName().StartsWith("std::vector<"))
 			{
-				foreach (var classInfo in context.Objects.Classes)
-				{
-					var dynamicArrayFields = classInfo.Fields.Where(x => x.Type.QualifiedName().StartsWith("std::vector<"));
-					if (dynamicArrayFields.Any())
-					{
-						using (writer.WithNamespace(CppDefines.Namespaces.Private))
-						{
-							foreach (var fieldInfo in dynamicArrayFields)
-							{
-								string elementType = fieldInfo.Type.Template!.Arguments.First().ToString();
-								string dynamicArrayFunctions = $"{CppDefines.Namespaces.Public}::StdVectorFunctionsFactory::Create<{elementType}>(cpprefl::EnsureName(\"{elementType}\"))";
-								writer.WriteLine(CodeGeneratorUtil.RegisterDynamicArrayFunctions(classInfo, fieldInfo, dynamicArrayFunctions));
-							}
-						}
-					}
-				}
-			});
+				return null;
+			}
+
+			string elementType = type.Template!.Arguments.First().ToString();
+			return $"{CppDefines.Namespaces.Public}::StdVectorFunctionsFactory::Create<{elementType}>(cpprefl::EnsureName(\"{elementType}\"))";
 		}
 	}
 }
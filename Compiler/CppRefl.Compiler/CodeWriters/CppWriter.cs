@@ -64,7 +64,7 @@ namespace CppRefl.Compiler.CodeWriters
 		public void ForwardDeclare(EnumInfo enumInfo)
 		{
 			var namespaceDec = enumInfo.Type.IsInGlobalNamespace() ? null : WithNamespace(enumInfo.Type.Namespace);
-			WriteLine($"enum class {enumInfo.Type.Name};");
+			WriteLine($"enum class {enumInfo.Type.Name} : {enumInfo.UnderlyingType};");
 			namespaceDec?.Dispose();
 		}
 
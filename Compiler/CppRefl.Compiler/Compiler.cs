@@ -770,6 +770,7 @@ public class Compiler
 			enumInfo = new()
 			{
 				Type = ReflectType(cursor.Type),
+				UnderlyingType = cursor.EnumDecl_IntegerType.CanonicalType.Spelling.ToString(),
 				Metadata = metadata,
 				GeneratedBodyLine = MaybeGetGeneratedReflectionBodyLine(cursor)
 			};
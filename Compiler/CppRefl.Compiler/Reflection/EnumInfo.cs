@@ -23,6 +23,11 @@
 		/// </summary>
 		public required TypeInfo Type { get; init; }
 
+		/// <summary>
+		/// Underlying integer type (e.g. "unsigned char"), needed to forward declare the enum.
+		/// </summary>
+		public string UnderlyingType { get; init; } = "int";
+
 		/// <summary>
 		/// Enum values.
 		/// </summary>
@@ -0,0 +1,144 @@
+#include "Benchmark.h"
+
+#include <atomic>
+#include <cstdio>
+
+#include "Serialization/JsonScanner.h"
+#include "Serialization/NumberConversion.h"
+
+namespace cpprefl::benchmarks
+{
+	namespace
+	{
+		std::atomic<uint64_t> AllocationCount = 0;
+
+		const char* GetScannerKernelName(json::ScannerKernel kernel)
+		{
+			switch (kernel)
+			{
+			case json::ScannerKernel::Scalar: return "scalar";
+			case json::ScannerKernel::Sse42: return "sse42";
+			case json::ScannerKernel::Avx2: return "avx2";
+			default: return "unknown";
+			}
+		}
+
+		const char* GetConversionKernelName(serialization::ConversionKernel kernel)
+		{
+			switch (kernel)
+			{
+			case serialization::ConversionKernel::Scalar: return "scalar";
+			case serialization::ConversionKernel::Avx2: return "avx2";
+			default: return "unknown";
+			}
+		}
+
+		// Writes a string that only needs the basic escapes (benchmark names are plain ASCII).
+		void WriteJsonString(FILE* file, const std::string& string)
+		{
+			std::fputc('"', file);
+			for (const char c : string)
+			{
+				if (c == '"' || c == '\\')
+				{
+					std::fputc('\\', file);
+				}
+				std::fputc(c, file);
+			}
+			std::fputc('"', file);
+		}
+
+		void WriteResults(FILE* file, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results)
+		{
+			// One benchmark per line, so that results of two runs can be diffed line by line.
+			std::fprintf(file, "{\n");
+			std::fprintf(file, "\t\"context\": { \"scanner_kernel\": \"%s\", \"conversion_kernel\": \"%s\", \"min_seconds\": %g },\n",
+				GetScannerKernelName(json::GetScannerKernel()), GetConversionKernelName(serialization::GetConversionKernel()), options.mMinSeconds);
+			std::fprintf(file, "\t\"benchmarks\":\n\t[\n");
+			for (size_t i = 0; i < results.size(); ++i)
+			{
+				const BenchmarkResult& result = results[i];
+				std::fprintf(file, "\t\t{ \"name\": ");
+				WriteJsonString(file, result.mName);
+				std::fprintf(file, ", \"iterations\": %llu, \"ns_per_iteration\": %.1f, \"bytes_per_second\": %.0f, \"objects_per_second\": %.0f, \"allocations_per_iteration\": %.2f }%s\n",
+					(unsigned long long)result.mIterations, result.mNanosecondsPerIteration, result.mBytesPerSecond, result.mObjectsPerSecond,
+					result.mAllocationsPerIteration, i + 1 < results.size() ? "," : "");
+			}
+			std::fprintf(file, "\t]\n}\n");
+		}
+	}
+
+	void CountAllocation()
+	{
+		AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	uint64_t GetAllocationCount()
+	{
+		return AllocationCount.load(std::memory_order_relaxed);
+	}
+
+	bool BenchmarkContext::GetResult(BenchmarkResult& result)const
+	{
+		if (mIterations == 0)
+		{
+			return false;
+		}
+
+		const double iterations = (double)mIterations;
+		result.mIterations = mIterations;
+		result.mNanosecondsPerIteration = mSeconds * 1e9 / iterations;
+		result.mBytesPerSecond = mSeconds > 0.0 ? (double)mBytesPerIteration * iterations / mSeconds : 0.0;
+		result.mObjectsPerSecond = mSeconds > 0.0 ? (double)mObjectsPerIteration * iterations / mSeconds : 0.0;
+		result.mAllocationsPerIteration = (double)mAllocations / iterations;
+		return true;
+	}
+
+	void BenchmarkRunner::Add(std::string name, BenchmarkFunction function)
+	{
+		mBenchmarks.push_back({ std::move(name), std::move(function) });
+	}
+
+	bool BenchmarkRunner::Run(const BenchmarkOptions& options)const
+	{
+		std::vector<BenchmarkResult> results;
+		for (const Benchmark& benchmark : mBenchmarks)
+		{
+			if (benchmark.mName.find(options.mFilter) == std::string::npos)
+			{
+				continue;
+			}
+
+			BenchmarkContext context(options.mMinSeconds);
+			benchmark.mFunction(context);
+
+			BenchmarkResult result;
+			if (!context.GetResult(result))
+			{
+				std::fprintf(stderr, "%-48s skipped\n", benchmark.mName.c_str());
+				continue;
+			}
+
+			result.mName = benchmark.mName;
+			std::fprintf(stderr, "%-48s %14.1f ns %10.1f MB/s %14.0f objects/s %10.2f allocations\n", result.mName.c_str(),
+				result.mNanosecondsPerIteration, result.mBytesPerSecond / (1024.0 * 1024.0), result.mObjectsPerSecond, result.mAllocationsPerIteration);
+			results.push_back(std::move(result));
+		}
+
+		if (options.mOutputPath.empty())
+		{
+			WriteResults(stdout, options, results);
+			return true;
+		}
+
+		FILE* file = std::fopen(options.mOutputPath.c_str(), "w");
+		if (file == nullptr)
+		{
+			std::fprintf(stderr, "Couldn't open '%s' for writing.\n", options.mOutputPath.c_str());
+			return false;
+		}
+
+		WriteResults(file, options, results);
+		return std::fclose(file) == 0;
+	}
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cpprefl::benchmarks
+{
+	// Counts an allocation. Called by the global operator new and the benchmark IConfig (see Main.cpp).
+	void CountAllocation();
+	uint64_t GetAllocationCount();
+
+	// Keeps the compiler from optimizing away a value that is otherwise unused.
+	template <typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		static_cast<void>(*reinterpret_cast<const volatile char*>(&value));
+#else
+		asm volatile("" : : "g"(&value) : "memory");
+#endif
+	}
+
+	// The measurement of a single benchmark.
+	struct BenchmarkResult
+	{
+		std::string mName;
+		uint64_t mIterations = 0;
+		double mNanosecondsPerIteration = 0.0;
+
+		// Zero if the benchmark doesn't process bytes or objects.
+		double mBytesPerSecond = 0.0;
+		double mObjectsPerSecond = 0.0;
+
+		double mAllocationsPerIteration = 0.0;
+	};
+
+	// Passed to a benchmark to measure the code it is interested in.
+	class BenchmarkContext
+	{
+	public:
+		explicit BenchmarkContext(double minSeconds) : mMinSeconds(minSeconds) {}
+
+		// What a single iteration processes, to report throughput. Can be set before or after Measure().
+		void SetBytesPerIteration(size_t bytes) { mBytesPerIteration = bytes; }
+		void SetObjectsPerIteration(size_t objects) { mObjectsPerIteration = objects; }
+
+		// Calls the function repeatedly until enough time has passed, and records the average time and number of allocations.
+		// Anything done outside of the function (e.g. building the input) isn't measured.
+		template <typename Function>
+		void Measure(Function&& function);
+
+		// Fills in the measurement. Returns false if Measure() was never called.
+		bool GetResult(BenchmarkResult& result)const;
+
+	private:
+		double mMinSeconds;
+
+		size_t mBytesPerIteration = 0;
+		size_t mObjectsPerIteration = 0;
+
+		uint64_t mIterations = 0;
+		double mSeconds = 0.0;
+		uint64_t mAllocations = 0;
+	};
+
+	using BenchmarkFunction = std::function<void(BenchmarkContext& context)>;
+
+	struct BenchmarkOptions
+	{
+		// Only benchmarks whose name contains this string are run.
+		std::string mFilter;
+
+		// Minimum time spent measuring each benchmark.
+		double mMinSeconds = 0.25;
+
+		// Results are written here as JSON, or to stdout if empty.
+		std::string mOutputPath;
+	};
+
+	// Runs benchmarks and reports their results.
+	//
+	// The results are written as a JSON document with one entry per benchmark, in the order they were added, so that runs can be
+	// diffed or compared by a script. A readable summary is printed to stderr while running.
+	class BenchmarkRunner
+	{
+	public:
+		// Names are paths like "wide/json/read", so related benchmarks can be selected with a filter.
+		void Add(std::string name, BenchmarkFunction function);
+
+		// Returns false if the results couldn't be written.
+		bool Run(const BenchmarkOptions& options)const;
+
+	private:
+		struct Benchmark
+		{
+			std::string mName;
+			BenchmarkFunction mFunction;
+		};
+
+		std::vector<Benchmark> mBenchmarks;
+	};
+
+	void RegisterKernelBenchmarks(BenchmarkRunner& runner);
+	void RegisterRegistryBenchmarks(BenchmarkRunner& runner);
+	void RegisterSerializerBenchmarks(BenchmarkRunner& runner);
+
+	template <typename Function>
+	void BenchmarkContext::Measure(Function&& function)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		// Warm up caches and lazily built state (plans, scratch buffers), then grow the batch until it takes long enough.
+		function();
+
+		uint64_t iterations = 1;
+		while (true)
+		{
+			const uint64_t firstAllocation = GetAllocationCount();
+			const Clock::time_point start = Clock::now();
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				function();
+			}
+			const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+			if (seconds >= mMinSeconds || iterations >= (1ull << 40))
+			{
+				mIterations = iterations;
+				mSeconds = seconds;
+				mAllocations = GetAllocationCount() - firstAllocation;
+				return;
+			}
+
+			// Aim a bit past the minimum time, but don't grow too fast based on a noisy short batch.
+			const double scale = seconds > 0.0 ? mMinSeconds * 1.2 / seconds : 10.0;
+			iterations = (uint64_t)((double)iterations * std::min(std::max(scale, 2.0), 10.0));
+		}
+	}
+}
@@ -0,0 +1,168 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "Serialization/JsonScanner.h"
+#include "Serialization/NumberConversion.h"
+
+namespace cpprefl::benchmarks
+{
+	namespace
+	{
+		constexpr size_t ElementCount = 65536;
+
+		struct ScannerKernelEntry
+		{
+			json::ScannerKernel mKernel;
+			const char* mName;
+		};
+
+		constexpr ScannerKernelEntry ScannerKernels[] =
+		{
+			{ json::ScannerKernel::Scalar, "scalar" },
+			{ json::ScannerKernel::Sse42, "sse42" },
+			{ json::ScannerKernel::Avx2, "avx2" },
+		};
+
+		struct ConversionKernelEntry
+		{
+			serialization::ConversionKernel mKernel;
+			const char* mName;
+		};
+
+		constexpr ConversionKernelEntry ConversionKernels[] =
+		{
+			{ serialization::ConversionKernel::Scalar, "scalar" },
+			{ serialization::ConversionKernel::Avx2, "avx2" },
+		};
+
+		struct Conversion
+		{
+			TypeKind mSourceKind;
+			TypeKind mDestinationKind;
+			size_t mSourceSize;
+			size_t mDestinationSize;
+			const char* mName;
+		};
+
+		constexpr Conversion Conversions[] =
+		{
+			{ TypeKind::Int64, TypeKind::Int32, sizeof(int64_t), sizeof(int32_t), "int64-int32" },
+			{ TypeKind::Int32, TypeKind::Int64, sizeof(int32_t), sizeof(int64_t), "int32-int64" },
+			{ TypeKind::Double, TypeKind::Float, sizeof(double), sizeof(float), "double-float" },
+			{ TypeKind::Double, TypeKind::Int32, sizeof(double), sizeof(int32_t), "double-int32" },
+			{ TypeKind::Int32, TypeKind::Double, sizeof(int32_t), sizeof(double), "int32-double" },
+		};
+
+		bool IsSupported(json::ScannerKernel kernel)
+		{
+			const json::ScannerKernel previous = json::GetScannerKernel();
+			const bool supported = json::SetScannerKernel(kernel);
+			json::SetScannerKernel(previous);
+			return supported;
+		}
+
+		bool IsSupported(serialization::ConversionKernel kernel)
+		{
+			const serialization::ConversionKernel previous = serialization::GetConversionKernel();
+			const bool supported = serialization::SetConversionKernel(kernel);
+			serialization::SetConversionKernel(previous);
+			return supported;
+		}
+
+		// A document with long runs of each kind of text the scanner skips over.
+		std::string MakeJsonText()
+		{
+			std::string text = "[\n";
+			for (int i = 0; i < 2000; ++i)
+			{
+				text += "    { \"name\": \"A fairly long string value without any escapes, number " + std::to_string(i) + "\", ";
+				text += "\"values\": [ 1.5, -20, 300000, 4e10 ] },\n";
+			}
+			text += "    {}\n]\n";
+			return text;
+		}
+
+		// Calls the scan function repeatedly until it reaches the end of the text, the way the JSON reader does.
+		template <typename Function>
+		void AddScannerBenchmark(BenchmarkRunner& runner, const char* function, const ScannerKernelEntry& kernel, Function&& scan)
+		{
+			runner.Add(std::string("kernel/json/") + function + "/" + kernel.mName, [kernel, scan](BenchmarkContext& context)
+			{
+				const std::string text = MakeJsonText();
+
+				const json::ScannerKernel previous = json::GetScannerKernel();
+				json::SetScannerKernel(kernel.mKernel);
+
+				context.Measure([&]
+				{
+					const char* end = text.data() + text.size();
+					size_t stops = 0;
+					for (const char* it = scan(text.data(), end); it != end; it = scan(it + 1, end))
+					{
+						++stops;
+					}
+					DoNotOptimize(stops);
+				});
+
+				json::SetScannerKernel(previous);
+				context.SetBytesPerIteration(text.size());
+			});
+		}
+	}
+
+	void RegisterKernelBenchmarks(BenchmarkRunner& runner)
+	{
+		for (const ScannerKernelEntry& kernel : ScannerKernels)
+		{
+			if (!IsSupported(kernel.mKernel))
+			{
+				continue;
+			}
+
+			AddScannerBenchmark(runner, "FindStructural", kernel, &json::FindStructural);
+			AddScannerBenchmark(runner, "FindStringSpecial", kernel, &json::FindStringSpecial);
+
+			// Stops at every character that isn't whitespace, so it mostly measures the cost of a call over short runs.
+			AddScannerBenchmark(runner, "FindNonWhitespace", kernel, &json::FindNonWhitespace);
+		}
+
+		for (const ConversionKernelEntry& kernel : ConversionKernels)
+		{
+			if (!IsSupported(kernel.mKernel))
+			{
+				continue;
+			}
+
+			for (const Conversion& conversion : Conversions)
+			{
+				runner.Add(std::string("kernel/convert/") + conversion.mName + "/" + kernel.mName, [kernel, conversion](BenchmarkContext& context)
+				{
+					// Values that all fit the destination, so that only the common path is measured.
+					std::vector<std::byte> source(ElementCount * conversion.mSourceSize);
+					std::vector<std::byte> destination(ElementCount * conversion.mDestinationSize);
+					std::vector<int32_t> values(ElementCount);
+					for (size_t i = 0; i < ElementCount; ++i)
+					{
+						values[i] = (int32_t)(i * 2654435761u) >> 8;
+					}
+					serialization::ConvertNumbers(TypeKind::Int32, values.data(), conversion.mSourceKind, source.data(), ElementCount);
+
+					const serialization::ConversionKernel previous = serialization::GetConversionKernel();
+					serialization::SetConversionKernel(kernel.mKernel);
+
+					context.Measure([&]
+					{
+						const size_t overflows = serialization::ConvertNumbers(conversion.mSourceKind, source.data(), conversion.mDestinationKind, destination.data(), ElementCount);
+						DoNotOptimize(overflows);
+						DoNotOptimize(destination);
+					});
+
+					serialization::SetConversionKernel(previous);
+					context.SetBytesPerIteration(source.size());
+					context.SetObjectsPerIteration(ElementCount);
+				});
+			}
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "BenchmarkCode.h"
+#include "Reflection/ClassInfo.h"
+#include "Reflection/Registry.h"
+
+namespace cpprefl::benchmarks
+{
+	namespace
+	{
+		// Lookups done per iteration, so that the time of a single lookup is long enough to measure.
+		constexpr int LookupCount = 1000;
+
+		// Names of every reflected class in BenchmarkCode.h, plus one that isn't registered.
+		const char* const ClassNames[] =
+		{
+			"BenchmarkWide", "BenchmarkWideList", "BenchmarkDeep0", "BenchmarkDeep1", "BenchmarkDeep2", "BenchmarkDeep3",
+			"BenchmarkDeep4", "BenchmarkDeep5", "BenchmarkDeepList", "BenchmarkVectors", "BenchmarkShape", "BenchmarkCircle",
+			"BenchmarkRectangle", "BenchmarkScene", "BenchmarkRecord", "BenchmarkRecordList",
+		};
+		constexpr const char* MissingClassName = "BenchmarkMissing";
+
+		std::vector<Name> GetClassNames()
+		{
+			std::vector<Name> names;
+			for (const char* className : ClassNames)
+			{
+				names.push_back(Name(className));
+			}
+			return names;
+		}
+
+		std::vector<Name> GetFieldNames(const ClassInfo& classInfo)
+		{
+			std::vector<Name> names;
+			for (const FieldInfo& field : classInfo.mFlattenedFields)
+			{
+				names.push_back(field.mName);
+			}
+			return names;
+		}
+
+		// Runs the function LookupCount times, cycling through the inputs.
+		template <typename Input, typename Function>
+		void MeasureLookups(BenchmarkContext& context, const std::vector<Input>& inputs, Function&& function)
+		{
+			context.Measure([&]
+			{
+				for (int i = 0; i < LookupCount; ++i)
+				{
+					DoNotOptimize(function(inputs[i % inputs.size()]));
+				}
+			});
+			context.SetObjectsPerIteration(LookupCount);
+		}
+	}
+
+	void RegisterRegistryBenchmarks(BenchmarkRunner& runner)
+	{
+		runner.Add("registry/GetClass", [](BenchmarkContext& context)
+		{
+			Registry& registry = Registry::GetSystemRegistry();
+			MeasureLookups(context, GetClassNames(), [&](const Name& name) { return &registry.GetClass(name); });
+		});
+
+		runner.Add("registry/TryGetClass/missing", [](BenchmarkContext& context)
+		{
+			Registry& registry = Registry::GetSystemRegistry();
+			MeasureLookups(context, std::vector<Name>{ Name(MissingClassName) }, [&](const Name& name) { return registry.TryGetClass(name); });
+		});
+
+		runner.Add("registry/GetType", [](BenchmarkContext& context)
+		{
+			Registry& registry = Registry::GetSystemRegistry();
+			MeasureLookups(context, GetClassNames(), [&](const Name& name) { return &registry.GetType(name); });
+		});
+
+		// Names are usually hashed at compile time, but loaders hash the strings they read.
+		runner.Add("registry/Name/runtime", [](BenchmarkContext& context)
+		{
+			const std::vector<std::string> strings(std::begin(ClassNames), std::end(ClassNames));
+			MeasureLookups(context, strings, [](const std::string& string) { return Name(string.data(), string.size()); });
+		});
+
+		runner.Add("class/GetField", [](BenchmarkContext& context)
+		{
+			const ClassInfo& classInfo = GetReflectedClass<BenchmarkWide>();
+			MeasureLookups(context, GetFieldNames(classInfo), [&](const Name& name) { return classInfo.GetField(name); });
+		});
+
+		runner.Add("class/GetField/missing", [](BenchmarkContext& context)
+		{
+			const ClassInfo& classInfo = GetReflectedClass<BenchmarkWide>();
+			MeasureLookups(context, std::vector<Name>{ Name("mMissing") }, [&](const Name& name) { return classInfo.GetField(name); });
+		});
+
+		runner.Add("class/GetFieldValueSafe", [](BenchmarkContext& context)
+		{
+			const ClassInfo& classInfo = GetReflectedClass<BenchmarkWide>();
+			BenchmarkWide object;
+			const std::vector<Name> names = { Name("mInt0"), Name("mInt3"), Name("mInt7") };
+			MeasureLookups(context, names, [&](const Name& name) { return classInfo.GetFieldValueSafe<int32_t>(&object, name); });
+		});
+
+		runner.Add("class/GetDerivedClass", [](BenchmarkContext& context)
+		{
+			const ClassInfo& classInfo = GetReflectedClass<BenchmarkShape>();
+			const std::vector<Name> names = { Name("BenchmarkShape"), Name("BenchmarkCircle"), Name("BenchmarkRectangle") };
+			MeasureLookups(context, names, [&](const Name& name) { return classInfo.GetDerivedClass(name); });
+		});
+
+		runner.Add("class/IsA", [](BenchmarkContext& context)
+		{
+			const ClassInfo& baseClass = GetReflectedClass<BenchmarkShape>();
+			const std::vector<const ClassInfo*> classes = { &baseClass, &GetReflectedClass<BenchmarkCircle>(), &GetReflectedClass<BenchmarkWide>() };
+			MeasureLookups(context, classes, [&](const ClassInfo* classInfo) { return classInfo->IsA(baseClass); });
+		});
+
+		runner.Add("class/GetDynamicClass", [](BenchmarkContext& context)
+		{
+			const ClassInfo& classInfo = GetReflectedClass<BenchmarkShape>();
+			BenchmarkShape shape;
+			BenchmarkCircle circle;
+			BenchmarkRectangle rectangle;
+			const std::vector<const BenchmarkShape*> objects = { &shape, &circle, &rectangle };
+			MeasureLookups(context, objects, [&](const BenchmarkShape* object) { return &classInfo.GetDynamicClass(object); });
+		});
+	}
+}
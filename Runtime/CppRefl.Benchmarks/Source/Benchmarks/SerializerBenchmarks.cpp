@@ -0,0 +1,743 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "BenchmarkCode.h"
+#include "Serialization/BinaryDeserializer.h"
+#include "Serialization/BinarySerializer.h"
+#include "Serialization/BitPackDeserializer.h"
+#include "Serialization/BitPackSerializer.h"
+#include "Serialization/CborDeserializer.h"
+#include "Serialization/CborSerializer.h"
+#include "Serialization/ColumnarReader.h"
+#include "Serialization/ColumnarWriter.h"
+#include "Serialization/CsvLoader.h"
+#include "Serialization/Format.h"
+#include "Serialization/FrozenBlob.h"
+#include "Serialization/JsonDeserializer.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonStreamDeserializer.h"
+#include "Serialization/MemoryFootprint.h"
+#include "Serialization/MsgPackDeserializer.h"
+#include "Serialization/MsgPackSerializer.h"
+#include "Serialization/Serializer.h"
+#include "Serialization/ThreadPool.h"
+
+namespace cpprefl::benchmarks
+{
+	namespace
+	{
+		// Number of objects in each list, and number of elements in each array of BenchmarkVectors.
+		constexpr int ObjectCount = 1000;
+		constexpr int VectorSize = 16384;
+
+		// Number of shapes read by the parallel benchmarks, enough for every thread to get many chunks.
+		constexpr int ParallelShapeCount = 100000;
+
+		// Size of the JSON written by the large benchmarks.
+		constexpr size_t LargeOutputSize = 100 * 1024 * 1024;
+
+		// Size of the chunks fed to the streaming JSON deserializer, like reads from a pipe or a decompressor.
+		constexpr size_t StreamChunkSize = 64 * 1024;
+
+		// The inputs are deterministic, so that the encoded sizes (and results) are the same between runs.
+		BenchmarkWideList MakeWideList()
+		{
+			BenchmarkWideList list;
+			list.mItems.resize(ObjectCount);
+			for (int i = 0; i < ObjectCount; ++i)
+			{
+				BenchmarkWide& item = list.mItems[i];
+				item.mInt0 = i;
+				item.mInt1 = -i * 7;
+				item.mInt2 = i * 1000;
+				item.mInt3 = i % 10;
+				item.mInt4 = 1 << (i % 31);
+				item.mInt5 = -1;
+				item.mInt6 = i * i;
+				item.mInt7 = 42;
+				item.mLong0 = (int64_t)i << 32;
+				item.mLong1 = -(int64_t)i * 123456789;
+				item.mLong2 = i;
+				item.mLong3 = 0;
+				item.mByte0 = (uint8_t)i;
+				item.mByte1 = 255;
+				item.mByte2 = (uint8_t)(i * 3);
+				item.mByte3 = 1;
+				item.mShort0 = (int16_t)i;
+				item.mShort1 = (int16_t)-i;
+				item.mShort2 = 1000;
+				item.mShort3 = (int16_t)(i * 31);
+				item.mFloat0 = (float)i * 0.5f;
+				item.mFloat1 = 3.14159f;
+				item.mFloat2 = -(float)i / 3.0f;
+				item.mFloat3 = 1e-3f * (float)i;
+				item.mFloat4 = 100.25f;
+				item.mFloat5 = (float)(i % 17);
+				item.mFloat6 = -0.125f;
+				item.mFloat7 = 1e6f + (float)i;
+				item.mDouble0 = (double)i / 7.0;
+				item.mDouble1 = 2.718281828459045;
+				item.mDouble2 = -1e10 * (double)i;
+				item.mDouble3 = 0.0;
+				item.mFlag0 = i % 2 == 0;
+				item.mFlag1 = i % 3 == 0;
+				item.mColor0 = (BenchmarkColor)(i % 4);
+				item.mColor1 = BenchmarkColor::Blue;
+			}
+			return list;
+		}
+
+		BenchmarkDeepList MakeDeepList()
+		{
+			BenchmarkDeepList list;
+			list.mItems.resize(ObjectCount);
+			for (int i = 0; i < ObjectCount; ++i)
+			{
+				BenchmarkDeep0& item = list.mItems[i];
+				item.mValue = i;
+				item.mScale = 1.0f;
+				item.mChild.mValue = i + 1;
+				item.mChild.mScale = 0.5f;
+				item.mChild.mChild.mValue = i + 2;
+				item.mChild.mChild.mScale = 0.25f;
+				item.mChild.mChild.mChild.mValue = i + 3;
+				item.mChild.mChild.mChild.mScale = 0.125f;
+				item.mChild.mChild.mChild.mChild.mValue = i + 4;
+				item.mChild.mChild.mChild.mChild.mScale = 0.0625f;
+				item.mChild.mChild.mChild.mChild.mChild.mValue = i + 5;
+				item.mChild.mChild.mChild.mChild.mChild.mScale = (float)i;
+				item.mChild.mChild.mChild.mChild.mChild.mEnabled = i % 2 == 0;
+			}
+			return list;
+		}
+
+		BenchmarkVectors MakeVectors()
+		{
+			BenchmarkVectors vectors;
+			for (int i = 0; i < VectorSize; ++i)
+			{
+				vectors.mFloats.push_back((float)i * 0.25f - 100.0f);
+				vectors.mDoubles.push_back((double)i / 3.0);
+				vectors.mInts.push_back(i * 37 - VectorSize);
+				vectors.mBytes.push_back((uint8_t)(i * 13));
+			}
+			return vectors;
+		}
+
+		BenchmarkSmallVectorsList MakeSmallVectorsList()
+		{
+			BenchmarkSmallVectorsList list;
+			list.mItems.resize(ObjectCount);
+			for (int i = 0; i < ObjectCount; ++i)
+			{
+				BenchmarkSmallVectors& item = list.mItems[i];
+				item.mId = i;
+
+				// Zero to four elements each, so that empty arrays are covered too.
+				for (int element = 0; element < i % 5; ++element)
+				{
+					item.mIndices.push_back(i + element);
+					item.mWeights.push_back(1.0f / (float)(element + 1));
+					item.mFlags.push_back((uint8_t)(i * element));
+					item.mTimes.push_back((double)i * 0.001 + element);
+					item.mOffsets.push_back((int16_t)(element - i % 100));
+					item.mMasks.push_back(1u << element);
+				}
+			}
+			return list;
+		}
+
+		template <typename T>
+		T* NewShape()
+		{
+			return new (IConfig::Get().AllocateMemory(sizeof(T))) T();
+		}
+
+		BenchmarkScene MakeScene(int shapeCount)
+		{
+			BenchmarkScene scene;
+			for (int i = 0; i < shapeCount; ++i)
+			{
+				BenchmarkShape* shape;
+				switch (i % 3)
+				{
+				case 0:
+				{
+					BenchmarkCircle* circle = NewShape<BenchmarkCircle>();
+					circle->mRadius = (float)i;
+					shape = circle;
+					break;
+				}
+
+				case 1:
+				{
+					BenchmarkRectangle* rectangle = NewShape<BenchmarkRectangle>();
+					rectangle->mWidth = (float)i;
+					rectangle->mHeight = 2.0f;
+					rectangle->mColor = BenchmarkColor::Green;
+					shape = rectangle;
+					break;
+				}
+
+				default:
+					shape = NewShape<BenchmarkShape>();
+					break;
+				}
+
+				shape->mId = i;
+				shape->mX = (float)i * 0.5f;
+				shape->mY = -(float)i;
+				scene.mShapes.push_back(shape);
+			}
+			return scene;
+		}
+
+		BenchmarkScene MakeScene()
+		{
+			return MakeScene(ObjectCount);
+		}
+
+		BenchmarkRecordList MakeRecordList()
+		{
+			static const char* const Categories[] = { "weapon", "armor", "consumable", "quest item", "crafting material" };
+
+			BenchmarkRecordList list;
+			list.mItems.resize(ObjectCount);
+			for (int i = 0; i < ObjectCount; ++i)
+			{
+				BenchmarkRecord& item = list.mItems[i];
+				item.mId = i;
+				item.mName = "Item name number " + std::to_string(i);
+				item.mCategory = Categories[i % 5];
+
+				// Mix short strings with ones that need escaping and ones well past the small string buffer.
+				item.mDescription = "A \"quoted\" description of item " + std::to_string(i) + ", " + std::string(16 + i % 200, 'x');
+				for (int tag = 0; tag < 1 + i % 4; ++tag)
+				{
+					item.mTags.push_back("tag" + std::to_string(tag));
+				}
+			}
+			return list;
+		}
+
+		std::string_view GetOutput(const json::JsonSerializer& writer)
+		{
+			return writer.GetString();
+		}
+
+		template <typename Writer>
+		std::string_view GetOutput(const Writer& writer)
+		{
+			return std::string_view((const char*)writer.GetBuffer().data(), writer.GetBuffer().size());
+		}
+
+		// Benchmarks the Serializer and Deserializer with one of the writer/reader pairs.
+		template <typename T, typename Writer, typename Reader>
+		void AddStreamBenchmarks(BenchmarkRunner& runner, const std::string& prefix, T(*make)(), int objectCount, bool useGeneratedCode, bool addUpdate)
+		{
+			runner.Add(prefix + "/write", [=](BenchmarkContext& context)
+			{
+				const T object = make();
+
+				Writer writer;
+				serialization::Serializer serializer;
+				serializer.SetUseGeneratedCode(useGeneratedCode);
+
+				context.Measure([&]
+				{
+					writer.Clear();
+					serializer.Serialize(writer, object);
+				});
+
+				context.SetBytesPerIteration(GetOutput(writer).size());
+				context.SetObjectsPerIteration(objectCount);
+			});
+
+			runner.Add(prefix + "/read", [=](BenchmarkContext& context)
+			{
+				Writer writer;
+				serialization::Serializer().Serialize(writer, make());
+				const std::string data(GetOutput(writer));
+
+				serialization::Deserializer deserializer;
+				deserializer.SetUseGeneratedCode(useGeneratedCode);
+
+				context.Measure([&]
+				{
+					Reader reader(data.data(), data.size());
+					const std::optional<T> object = deserializer.Deserialize<T>(reader);
+					DoNotOptimize(object);
+				});
+
+				context.SetBytesPerIteration(data.size());
+				context.SetObjectsPerIteration(objectCount);
+			});
+
+			if (!addUpdate)
+			{
+				return;
+			}
+
+			// Loading the same document into an existing object reuses all of its memory.
+			runner.Add(prefix + "/update", [=](BenchmarkContext& context)
+			{
+				Writer writer;
+				serialization::Serializer().Serialize(writer, make());
+				const std::string data(GetOutput(writer));
+
+				serialization::Deserializer deserializer;
+				deserializer.SetUseGeneratedCode(useGeneratedCode);
+
+				T object = make();
+				context.Measure([&]
+				{
+					Reader reader(data.data(), data.size());
+					const bool success = deserializer.Update(reader, object);
+					DoNotOptimize(success);
+				});
+
+				context.SetBytesPerIteration(data.size());
+				context.SetObjectsPerIteration(objectCount);
+			});
+		}
+
+		template <typename T>
+		void AddBinaryBenchmarks(BenchmarkRunner& runner, const std::string& prefix, T(*make)(), int objectCount)
+		{
+			runner.Add(prefix + "/write", [=](BenchmarkContext& context)
+			{
+				const T object = make();
+
+				binary::BinarySerializer serializer;
+				context.Measure([&]
+				{
+					serializer.Clear();
+					serializer.Serialize(object);
+				});
+
+				context.SetBytesPerIteration(serializer.GetBuffer().size());
+				context.SetObjectsPerIteration(objectCount);
+			});
+
+			runner.Add(prefix + "/read", [=](BenchmarkContext& context)
+			{
+				binary::BinarySerializer serializer;
+				serializer.Serialize(make());
+				const std::vector<std::byte> data = serializer.GetBuffer();
+
+				context.Measure([&]
+				{
+					binary::BinaryDeserializer deserializer(data.data(), data.size());
+					const std::optional<T> object = deserializer.Deserialize<T>();
+					DoNotOptimize(object);
+				});
+
+				context.SetBytesPerIteration(data.size());
+				context.SetObjectsPerIteration(objectCount);
+			});
+		}
+
+		// Reads JSON that arrives in chunks, to compare with reading the whole document at once.
+		template <typename T>
+		void AddJsonStreamBenchmarks(BenchmarkRunner& runner, const std::string& prefix, T(*make)(), int objectCount)
+		{
+			runner.Add(prefix + "/read", [=](BenchmarkContext& context)
+			{
+				json::JsonSerializer writer;
+				serialization::Serializer().Serialize(writer, make());
+				const std::string data(GetOutput(writer));
+
+				serialization::Deserializer deserializer;
+				context.Measure([&]
+				{
+					T object;
+					json::JsonStreamDeserializer stream(deserializer, object);
+					for (size_t offset = 0; offset < data.size(); offset += StreamChunkSize)
+					{
+						stream.Feed(data.data() + offset, std::min(StreamChunkSize, data.size() - offset));
+					}
+
+					const json::JsonStreamStatus status = stream.Finish();
+					DoNotOptimize(status);
+					DoNotOptimize(object);
+				});
+
+				context.SetBytesPerIteration(data.size());
+				context.SetObjectsPerIteration(objectCount);
+			});
+		}
+
+		// Frozen blobs are used in place, so reading one opens it and reads a field of every object in one of its arrays.
+		template <typename T>
+		void AddFrozenBenchmarks(BenchmarkRunner& runner, const std::string& prefix, T(*make)(), int objectCount, const char* arrayField, const char* idField)
+		{
+			runner.Add(prefix + "/write", [=](BenchmarkContext& context)
+			{
+				const T object = make();
+
+				frozen::FrozenWriter writer;
+				context.Measure([&]
+				{
+					writer.Freeze(object);
+				});
+
+				context.SetBytesPerIteration(writer.GetBuffer().size());
+				context.SetObjectsPerIteration(objectCount);
+			});
+
+			runner.Add(prefix + "/read", [=](BenchmarkContext& context)
+			{
+				frozen::FrozenWriter writer;
+				writer.Freeze(make());
+				const std::vector<std::byte> data = writer.GetBuffer();
+
+				const Name arrayName(arrayField);
+				const Name idName(idField);
+
+				context.Measure([&]
+				{
+					const frozen::FrozenView root = frozen::OpenFrozenBlob<T>(data.data(), data.size());
+					const frozen::FrozenArrayView objects = root.GetArray(arrayName);
+
+					int64_t sum = 0;
+					for (size_t i = 0; i < objects.size(); ++i)
+					{
+						const int32_t* id = objects.GetObject(i).GetValue<int32_t>(idName);
+						sum += id != nullptr ? *id : 0;
+					}
+
+					DoNotOptimize(sum);
+				});
+
+				context.SetBytesPerIteration(data.size());
+				context.SetObjectsPerIteration(objectCount);
+			});
+		}
+
+		// Bit-packing works on single objects without containers, so the items of a list are packed one after another.
+		template <typename List>
+		void AddBitPackBenchmarks(BenchmarkRunner& runner, const std::string& prefix, List(*make)())
+		{
+			using Item = typename decltype(List::mItems)::value_type;
+
+			runner.Add(prefix + "/write", [=](BenchmarkContext& context)
+			{
+				const List list = make();
+
+				bitpack::BitPackSerializer serializer;
+				context.Measure([&]
+				{
+					serializer.Clear();
+					for (const Item& item : list.mItems)
+					{
+						serializer.Serialize(item);
+					}
+				});
+
+				context.SetBytesPerIteration(serializer.GetBuffer().size());
+				context.SetObjectsPerIteration(list.mItems.size());
+			});
+
+			runner.Add(prefix + "/read", [=](BenchmarkContext& context)
+			{
+				List list = make();
+
+				bitpack::BitPackSerializer serializer;
+				for (const Item& item : list.mItems)
+				{
+					serializer.Serialize(item);
+				}
+				const std::vector<std::byte> data = serializer.GetBuffer();
+
+				const ClassInfo& classInfo = GetReflectedClass<Item>();
+				context.Measure([&]
+				{
+					bitpack::BitPackDeserializer deserializer(data.data(), data.size());
+					for (Item& item : list.mItems)
+					{
+						deserializer.Deserialize(classInfo, &item);
+					}
+					DoNotOptimize(list);
+				});
+
+				context.SetBytesPerIteration(data.size());
+				context.SetObjectsPerIteration(list.mItems.size());
+			});
+		}
+
+		// Columnar tables hold the items of a list, one column per value.
+		template <typename List>
+		void AddColumnarBenchmarks(BenchmarkRunner& runner, const std::string& prefix, List(*make)())
+		{
+			runner.Add(prefix + "/write", [=](BenchmarkContext& context)
+			{
+				const List list = make();
+
+				columnar::ColumnarWriter writer;
+				context.Measure([&]
+				{
+					writer.Write(list.mItems);
+				});
+
+				context.SetBytesPerIteration(writer.GetBuffer().size());
+				context.SetObjectsPerIteration(list.mItems.size());
+			});
+
+			runner.Add(prefix + "/read", [=](BenchmarkContext& context)
+			{
+				List list = make();
+
+				columnar::ColumnarWriter writer;
+				writer.Write(list.mItems);
+				const std::vector<std::byte> data = writer.GetBuffer();
+
+				context.Measure([&]
+				{
+					columnar::ColumnarReader reader(data.data(), data.size());
+					const bool success = reader.Read(list.mItems);
+					DoNotOptimize(success);
+				});
+
+				context.SetBytesPerIteration(data.size());
+				context.SetObjectsPerIteration(list.mItems.size());
+			});
+		}
+
+		// A CSV table with the scalar fields of the records, repeated so that there is enough text to split between threads.
+		std::string MakeRecordCsv()
+		{
+			constexpr int Repeats = 100;
+
+			const BenchmarkRecordList list = MakeRecordList();
+			std::string csv = "mId,mName,mCategory,mDescription\n";
+			for (int repeat = 0; repeat < Repeats; ++repeat)
+			{
+				for (const BenchmarkRecord& item : list.mItems)
+				{
+					csv += std::to_string(repeat * ObjectCount + item.mId) + "," + item.mName + "," + item.mCategory + ",\"";
+					for (const char c : item.mDescription)
+					{
+						csv += c == '"' ? "\"\"" : std::string(1, c);
+					}
+					csv += "\"\n";
+				}
+			}
+			return csv;
+		}
+
+		void AddCsvBenchmarks(BenchmarkRunner& runner, const std::string& prefix, bool parallel)
+		{
+			runner.Add(prefix, [=](BenchmarkContext& context)
+			{
+				const std::string csv = MakeRecordCsv();
+
+				serialization::ThreadPool threadPool(std::max(1u, std::thread::hardware_concurrency()));
+				csv::CsvLoader loader;
+				if (parallel)
+				{
+					loader.SetThreadPool(&threadPool);
+				}
+
+				std::vector<BenchmarkRecord> records;
+				context.Measure([&]
+				{
+					const bool success = loader.Load(csv.data(), csv.size(), records);
+					DoNotOptimize(success);
+				});
+
+				context.SetBytesPerIteration(csv.size());
+				context.SetObjectsPerIteration(records.size());
+			});
+		}
+
+		// Reads a large array of polymorphic pointers with the Deserializer splitting it between threads.
+		void AddParallelReadBenchmarks(BenchmarkRunner& runner, const std::string& prefix)
+		{
+			for (const size_t threadCount : { 1, 4, 8, 16 })
+			{
+				runner.Add(prefix + "/" + std::to_string(threadCount), [=](BenchmarkContext& context)
+				{
+					json::JsonSerializer writer;
+					serialization::Serializer().Serialize(writer, MakeScene(ParallelShapeCount));
+					const std::string data(writer.GetString());
+
+					serialization::ThreadPool threadPool(threadCount);
+					serialization::Deserializer deserializer;
+					deserializer.SetThreadPool(&threadPool);
+
+					context.Measure([&]
+					{
+						json::JsonDeserializer reader(data.data(), data.size());
+						const std::optional<BenchmarkScene> scene = deserializer.Deserialize<BenchmarkScene>(reader);
+						DoNotOptimize(scene);
+					});
+
+					context.SetBytesPerIteration(data.size());
+					context.SetObjectsPerIteration(ParallelShapeCount);
+				});
+			}
+		}
+
+		// A wide list repeated until it is LargeOutputSize bytes as JSON, for output throughput on large object graphs.
+		BenchmarkWideList MakeLargeWideList()
+		{
+			const BenchmarkWideList list = MakeWideList();
+
+			json::JsonSerializer writer;
+			serialization::Serializer().Serialize(writer, list);
+			const size_t repeats = (LargeOutputSize + writer.GetString().size() - 1) / writer.GetString().size();
+
+			BenchmarkWideList largeList;
+			largeList.mItems.reserve(list.mItems.size() * repeats);
+			for (size_t repeat = 0; repeat < repeats; ++repeat)
+			{
+				largeList.mItems.insert(largeList.mItems.end(), list.mItems.begin(), list.mItems.end());
+			}
+			return largeList;
+		}
+
+		// Writes the large list into a buffer that is reused between iterations, or in pieces through a sink.
+		void AddLargeJsonBenchmarks(BenchmarkRunner& runner, const std::string& prefix)
+		{
+			runner.Add(prefix + "/write", [=](BenchmarkContext& context)
+			{
+				const BenchmarkWideList list = MakeLargeWideList();
+
+				json::JsonSerializer writer;
+				serialization::Serializer serializer;
+				context.Measure([&]
+				{
+					writer.Clear();
+					serializer.Serialize(writer, list);
+				});
+
+				context.SetBytesPerIteration(writer.GetString().size());
+				context.SetObjectsPerIteration(list.mItems.size());
+			});
+
+			runner.Add(prefix + "/write-sink", [=](BenchmarkContext& context)
+			{
+				const BenchmarkWideList list = MakeLargeWideList();
+
+				size_t bytes = 0;
+				serialization::Serializer serializer;
+				context.Measure([&]
+				{
+					bytes = 0;
+					json::JsonSerializer writer([](void* sinkContext, const char* data, size_t size)
+					{
+						DoNotOptimize(data);
+						*static_cast<size_t*>(sinkContext) += size;
+					}, &bytes);
+					serializer.Serialize(writer, list);
+				});
+
+				context.SetBytesPerIteration(bytes);
+				context.SetObjectsPerIteration(list.mItems.size());
+			});
+		}
+
+		// Items of a list formatted one at a time, the way they would be logged.
+		template <typename List>
+		void AddFormatBenchmarks(BenchmarkRunner& runner, const std::string& prefix, List(*make)())
+		{
+			runner.Add(prefix, [=](BenchmarkContext& context)
+			{
+				const List list = make();
+
+				char buffer[2048];
+				size_t length = 0;
+				context.Measure([&]
+				{
+					length = 0;
+					for (const auto& item : list.mItems)
+					{
+						length += Format(item, buffer, sizeof(buffer));
+					}
+					DoNotOptimize(buffer);
+				});
+
+				context.SetBytesPerIteration(length);
+				context.SetObjectsPerIteration(list.mItems.size());
+			});
+		}
+
+		// Items of a list measured the way a memory tracker would sample them, repeated so that there are enough objects to split
+		// between threads.
+		template <typename List>
+		void AddMemoryBenchmarks(BenchmarkRunner& runner, const std::string& prefix, List(*make)(), bool parallel)
+		{
+			runner.Add(prefix, [=](BenchmarkContext& context)
+			{
+				constexpr int Repeats = 100;
+
+				const List list = make();
+				std::vector<typename decltype(list.mItems)::value_type> items;
+				items.reserve(list.mItems.size() * Repeats);
+				for (int repeat = 0; repeat < Repeats; ++repeat)
+				{
+					items.insert(items.end(), list.mItems.begin(), list.mItems.end());
+				}
+
+				serialization::ThreadPool threadPool(std::max(1u, std::thread::hardware_concurrency()));
+				size_t bytes = 0;
+				context.Measure([&]
+				{
+					bytes = MeasureDeep(items, parallel ? &threadPool : nullptr).GetTotalBytes();
+					DoNotOptimize(bytes);
+				});
+
+				context.SetObjectsPerIteration(items.size());
+			});
+		}
+
+		template <typename T>
+		void AddSchemaBenchmarks(BenchmarkRunner& runner, const std::string& schema, T(*make)(), int objectCount)
+		{
+			AddStreamBenchmarks<T, json::JsonSerializer, json::JsonDeserializer>(runner, schema + "/json", make, objectCount, true, true);
+			AddStreamBenchmarks<T, json::JsonSerializer, json::JsonDeserializer>(runner, schema + "/json-reflected", make, objectCount, false, true);
+			AddStreamBenchmarks<T, msgpack::MsgPackSerializer, msgpack::MsgPackDeserializer>(runner, schema + "/msgpack", make, objectCount, true, false);
+			AddStreamBenchmarks<T, cbor::CborSerializer, cbor::CborDeserializer>(runner, schema + "/cbor", make, objectCount, true, false);
+			AddBinaryBenchmarks<T>(runner, schema + "/binary", make, objectCount);
+			AddJsonStreamBenchmarks<T>(runner, schema + "/json-stream", make, objectCount);
+		}
+	}
+
+	void RegisterSerializerBenchmarks(BenchmarkRunner& runner)
+	{
+		AddSchemaBenchmarks<BenchmarkWideList>(runner, "wide", MakeWideList, ObjectCount);
+		AddSchemaBenchmarks<BenchmarkDeepList>(runner, "deep", MakeDeepList, ObjectCount);
+		AddSchemaBenchmarks<BenchmarkVectors>(runner, "vectors", MakeVectors, 1);
+		AddSchemaBenchmarks<BenchmarkSmallVectorsList>(runner, "small-vectors", MakeSmallVectorsList, ObjectCount);
+		AddSchemaBenchmarks<BenchmarkScene>(runner, "polymorphic", MakeScene, ObjectCount);
+		AddSchemaBenchmarks<BenchmarkRecordList>(runner, "strings", MakeRecordList, ObjectCount);
+
+		AddParallelReadBenchmarks(runner, "polymorphic/json-parallel");
+
+		AddLargeJsonBenchmarks(runner, "large/json");
+
+		AddFrozenBenchmarks<BenchmarkWideList>(runner, "wide/frozen", MakeWideList, ObjectCount, "mItems", "mInt0");
+		AddFrozenBenchmarks<BenchmarkScene>(runner, "polymorphic/frozen", MakeScene, ObjectCount, "mShapes", "mId");
+		AddFrozenBenchmarks<BenchmarkRecordList>(runner, "strings/frozen", MakeRecordList, ObjectCount, "mItems", "mId");
+
+		AddBitPackBenchmarks<BenchmarkWideList>(runner, "wide/bitpack", MakeWideList);
+		AddBitPackBenchmarks<BenchmarkDeepList>(runner, "deep/bitpack", MakeDeepList);
+
+		AddColumnarBenchmarks<BenchmarkWideList>(runner, "wide/columnar", MakeWideList);
+		AddColumnarBenchmarks<BenchmarkDeepList>(runner, "deep/columnar", MakeDeepList);
+
+		AddFormatBenchmarks<BenchmarkWideList>(runner, "wide/format", MakeWideList);
+		AddFormatBenchmarks<BenchmarkDeepList>(runner, "deep/format", MakeDeepList);
+
+		AddCsvBenchmarks(runner, "strings/csv", false);
+		AddCsvBenchmarks(runner, "strings/csv-parallel", true);
+
+		AddMemoryBenchmarks<BenchmarkRecordList>(runner, "strings/memory", MakeRecordList, false);
+		AddMemoryBenchmarks<BenchmarkRecordList>(runner, "strings/memory-parallel", MakeRecordList, true);
+		AddMemoryBenchmarks<BenchmarkDeepList>(runner, "deep/memory", MakeDeepList, false);
+	}
+}
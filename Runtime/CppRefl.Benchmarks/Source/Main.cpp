@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Benchmark.h"
+#include "CppReflConfig.h"
+
+#include "CppReflBenchmarks.reflgen.h"
+
+// Every heap allocation is counted, so that benchmarks can report allocations per iteration. The array forms of operator new
+// forward to these.
+void* operator new(std::size_t size)
+{
+	cpprefl::benchmarks::CountAllocation();
+	if (void* memory = std::malloc(size != 0 ? size : 1))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	cpprefl::benchmarks::CountAllocation();
+	return std::malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+class BenchmarkConfig : public cpprefl::IConfig
+{
+public:
+	void* AllocateMemory(size_t numBytes) override
+	{
+		cpprefl::benchmarks::CountAllocation();
+		return IConfig::AllocateMemory(numBytes);
+	}
+};
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"Usage: CppRefl.Benchmarks [--filter=<substring>] [--min-time=<seconds>] [--out=<file>]\n"
+			"  --filter    Only runs benchmarks whose name contains the substring (e.g. \"json\" or \"wide/\").\n"
+			"  --min-time  Minimum time spent measuring each benchmark (default 0.25).\n"
+			"  --out       Writes the JSON results to a file instead of stdout.\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkConfig config;
+	config.Set();
+
+	RegisterCppReflBenchmarksReflection();
+
+	cpprefl::benchmarks::BenchmarkOptions options;
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* argument = argv[i];
+		if (std::strncmp(argument, "--filter=", 9) == 0)
+		{
+			options.mFilter = argument + 9;
+		}
+		else if (std::strncmp(argument, "--min-time=", 11) == 0)
+		{
+			options.mMinSeconds = std::atof(argument + 11);
+		}
+		else if (std::strncmp(argument, "--out=", 6) == 0)
+		{
+			options.mOutputPath = argument + 6;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	cpprefl::benchmarks::BenchmarkRunner runner;
+	cpprefl::benchmarks::RegisterSerializerBenchmarks(runner);
+	cpprefl::benchmarks::RegisterRegistryBenchmarks(runner);
+	cpprefl::benchmarks::RegisterKernelBenchmarks(runner);
+
+	return runner.Run(options) ? 0 : 1;
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CppReflConfig.h"
+#include "CppReflMarkup.h"
+
+#include "BenchmarkCode.reflgen.h"
+
+// Synthetic schemas that stress different parts of the serializers. Each list class holds many objects, so that a single
+// iteration of a benchmark is long enough to measure.
+
+enum class REFLECTED BenchmarkColor
+{
+	Red,
+	Green,
+	Blue,
+	Alpha,
+};
+
+// Many flat scalar fields, like a config or a network snapshot.
+class REFLECTED BenchmarkWide
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mInt0 REFLECTED = 0;
+	int32_t mInt1 REFLECTED = 0;
+	int32_t mInt2 REFLECTED = 0;
+	int32_t mInt3 REFLECTED = 0;
+	int32_t mInt4 REFLECTED = 0;
+	int32_t mInt5 REFLECTED = 0;
+	int32_t mInt6 REFLECTED = 0;
+	int32_t mInt7 REFLECTED = 0;
+	int64_t mLong0 REFLECTED = 0;
+	int64_t mLong1 REFLECTED = 0;
+	int64_t mLong2 REFLECTED = 0;
+	int64_t mLong3 REFLECTED = 0;
+	uint8_t mByte0 REFLECTED = 0;
+	uint8_t mByte1 REFLECTED = 0;
+	uint8_t mByte2 REFLECTED = 0;
+	uint8_t mByte3 REFLECTED = 0;
+	int16_t mShort0 REFLECTED = 0;
+	int16_t mShort1 REFLECTED = 0;
+	int16_t mShort2 REFLECTED = 0;
+	int16_t mShort3 REFLECTED = 0;
+	float mFloat0 REFLECTED = 0.0f;
+	float mFloat1 REFLECTED = 0.0f;
+	float mFloat2 REFLECTED = 0.0f;
+	float mFloat3 REFLECTED = 0.0f;
+	float mFloat4 REFLECTED = 0.0f;
+	float mFloat5 REFLECTED = 0.0f;
+	float mFloat6 REFLECTED = 0.0f;
+	float mFloat7 REFLECTED = 0.0f;
+	double mDouble0 REFLECTED = 0.0;
+	double mDouble1 REFLECTED = 0.0;
+	double mDouble2 REFLECTED = 0.0;
+	double mDouble3 REFLECTED = 0.0;
+	bool mFlag0 REFLECTED = false;
+	bool mFlag1 REFLECTED = false;
+	BenchmarkColor mColor0 REFLECTED = BenchmarkColor::Red;
+	BenchmarkColor mColor1 REFLECTED = BenchmarkColor::Red;
+};
+
+class REFLECTED BenchmarkWideList
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	std::vector<BenchmarkWide> mItems REFLECTED;
+};
+
+// Classes nested several levels deep, with a few fields at each level.
+class REFLECTED BenchmarkDeep5
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mValue REFLECTED = 0;
+	float mScale REFLECTED = 0.0f;
+	bool mEnabled REFLECTED = false;
+};
+
+class REFLECTED BenchmarkDeep4
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mValue REFLECTED = 0;
+	float mScale REFLECTED = 0.0f;
+	BenchmarkDeep5 mChild REFLECTED;
+};
+
+class REFLECTED BenchmarkDeep3
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mValue REFLECTED = 0;
+	float mScale REFLECTED = 0.0f;
+	BenchmarkDeep4 mChild REFLECTED;
+};
+
+class REFLECTED BenchmarkDeep2
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mValue REFLECTED = 0;
+	float mScale REFLECTED = 0.0f;
+	BenchmarkDeep3 mChild REFLECTED;
+};
+
+class REFLECTED BenchmarkDeep1
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mValue REFLECTED = 0;
+	float mScale REFLECTED = 0.0f;
+	BenchmarkDeep2 mChild REFLECTED;
+};
+
+class REFLECTED BenchmarkDeep0
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mValue REFLECTED = 0;
+	float mScale REFLECTED = 0.0f;
+	BenchmarkDeep1 mChild REFLECTED;
+};
+
+class REFLECTED BenchmarkDeepList
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	std::vector<BenchmarkDeep0> mItems REFLECTED;
+};
+
+// A few large arrays of numbers, like a mesh or a sampled curve.
+class REFLECTED BenchmarkVectors
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	std::vector<float> mFloats REFLECTED;
+	std::vector<double> mDoubles REFLECTED;
+	std::vector<int32_t> mInts REFLECTED;
+	std::vector<uint8_t> mBytes REFLECTED;
+};
+
+// Many short arrays, like per-object tag or bone lists, so that the cost of each array outweighs the cost of its elements.
+class REFLECTED BenchmarkSmallVectors
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mId REFLECTED = 0;
+	std::vector<int32_t> mIndices REFLECTED;
+	std::vector<float> mWeights REFLECTED;
+	std::vector<uint8_t> mFlags REFLECTED;
+	std::vector<double> mTimes REFLECTED;
+	std::vector<int16_t> mOffsets REFLECTED;
+	std::vector<uint32_t> mMasks REFLECTED;
+};
+
+class REFLECTED BenchmarkSmallVectorsList
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	std::vector<BenchmarkSmallVectors> mItems REFLECTED;
+};
+
+// Objects behind pointers to a polymorphic base class.
+class REFLECTED BenchmarkShape
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	virtual ~BenchmarkShape() = default;
+
+	int32_t mId REFLECTED = 0;
+	float mX REFLECTED = 0.0f;
+	float mY REFLECTED = 0.0f;
+};
+
+class REFLECTED BenchmarkCircle : public BenchmarkShape
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	float mRadius REFLECTED = 0.0f;
+};
+
+class REFLECTED BenchmarkRectangle : public BenchmarkShape
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	float mWidth REFLECTED = 0.0f;
+	float mHeight REFLECTED = 0.0f;
+	BenchmarkColor mColor REFLECTED = BenchmarkColor::Red;
+};
+
+// Owns its shapes, which are allocated through cpprefl::IConfig like the ones the deserializers create.
+class REFLECTED BenchmarkScene
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	BenchmarkScene() = default;
+	BenchmarkScene(BenchmarkScene&& other) noexcept : mShapes(std::move(other.mShapes)) { other.mShapes.clear(); }
+	BenchmarkScene(const BenchmarkScene&) = delete;
+	BenchmarkScene& operator=(const BenchmarkScene&) = delete;
+	~BenchmarkScene() { Clear(); }
+
+	void Clear()
+	{
+		for (BenchmarkShape* shape : mShapes)
+		{
+			if (shape != nullptr)
+			{
+				shape->~BenchmarkShape();
+				cpprefl::IConfig::Get().FreeMemory(shape);
+			}
+		}
+		mShapes.clear();
+	}
+
+	std::vector<BenchmarkShape*> mShapes REFLECTED;
+};
+
+// Records made mostly of strings, like a localization table or an asset database.
+class REFLECTED BenchmarkRecord
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mId REFLECTED = 0;
+	std::string mName REFLECTED;
+	std::string mCategory REFLECTED;
+	std::string mDescription REFLECTED;
+	std::vector<std::string> mTags REFLECTED;
+};
+
+class REFLECTED BenchmarkRecordList
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	std::vector<BenchmarkRecord> mItems REFLECTED;
+};
@@ -89,4 +89,319 @@ class REFLECTED ChildClass2 : public ChildClass
 	GENERATED_REFLECTION_CODE()
 };
 
+// More fields than fit an 8-bit index, half of them inherited.
+class REFLECTED ManyFieldsBase
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	uint8_t mBaseField000 REFLECTED = 0;
+	uint8_t mBaseField001 REFLECTED = 0;
+	uint8_t mBaseField002 REFLECTED = 0;
+	uint8_t mBaseField003 REFLECTED = 0;
+	uint8_t mBaseField004 REFLECTED = 0;
+	uint8_t mBaseField005 REFLECTED = 0;
+	uint8_t mBaseField006 REFLECTED = 0;
+	uint8_t mBaseField007 REFLECTED = 0;
+	uint8_t mBaseField008 REFLECTED = 0;
+	uint8_t mBaseField009 REFLECTED = 0;
+	uint8_t mBaseField010 REFLECTED = 0;
+	uint8_t mBaseField011 REFLECTED = 0;
+	uint8_t mBaseField012 REFLECTED = 0;
+	uint8_t mBaseField013 REFLECTED = 0;
+	uint8_t mBaseField014 REFLECTED = 0;
+	uint8_t mBaseField015 REFLECTED = 0;
+	uint8_t mBaseField016 REFLECTED = 0;
+	uint8_t mBaseField017 REFLECTED = 0;
+	uint8_t mBaseField018 REFLECTED = 0;
+	uint8_t mBaseField019 REFLECTED = 0;
+	uint8_t mBaseField020 REFLECTED = 0;
+	uint8_t mBaseField021 REFLECTED = 0;
+	uint8_t mBaseField022 REFLECTED = 0;
+	uint8_t mBaseField023 REFLECTED = 0;
+	uint8_t mBaseField024 REFLECTED = 0;
+	uint8_t mBaseField025 REFLECTED = 0;
+	uint8_t mBaseField026 REFLECTED = 0;
+	uint8_t mBaseField027 REFLECTED = 0;
+	uint8_t mBaseField028 REFLECTED = 0;
+	uint8_t mBaseField029 REFLECTED = 0;
+	uint8_t mBaseField030 REFLECTED = 0;
+	uint8_t mBaseField031 REFLECTED = 0;
+	uint8_t mBaseField032 REFLECTED = 0;
+	uint8_t mBaseField033 REFLECTED = 0;
+	uint8_t mBaseField034 REFLECTED = 0;
+	uint8_t mBaseField035 REFLECTED = 0;
+	uint8_t mBaseField036 REFLECTED = 0;
+	uint8_t mBaseField037 REFLECTED = 0;
+	uint8_t mBaseField038 REFLECTED = 0;
+	uint8_t mBaseField039 REFLECTED = 0;
+	uint8_t mBaseField040 REFLECTED = 0;
+	uint8_t mBaseField041 REFLECTED = 0;
+	uint8_t mBaseField042 REFLECTED = 0;
+	uint8_t mBaseField043 REFLECTED = 0;
+	uint8_t mBaseField044 REFLECTED = 0;
+	uint8_t mBaseField045 REFLECTED = 0;
+	uint8_t mBaseField046 REFLECTED = 0;
+	uint8_t mBaseField047 REFLECTED = 0;
+	uint8_t mBaseField048 REFLECTED = 0;
+	uint8_t mBaseField049 REFLECTED = 0;
+	uint8_t mBaseField050 REFLECTED = 0;
+	uint8_t mBaseField051 REFLECTED = 0;
+	uint8_t mBaseField052 REFLECTED = 0;
+	uint8_t mBaseField053 REFLECTED = 0;
+	uint8_t mBaseField054 REFLECTED = 0;
+	uint8_t mBaseField055 REFLECTED = 0;
+	uint8_t mBaseField056 REFLECTED = 0;
+	uint8_t mBaseField057 REFLECTED = 0;
+	uint8_t mBaseField058 REFLECTED = 0;
+	uint8_t mBaseField059 REFLECTED = 0;
+	uint8_t mBaseField060 REFLECTED = 0;
+	uint8_t mBaseField061 REFLECTED = 0;
+	uint8_t mBaseField062 REFLECTED = 0;
+	uint8_t mBaseField063 REFLECTED = 0;
+	uint8_t mBaseField064 REFLECTED = 0;
+	uint8_t mBaseField065 REFLECTED = 0;
+	uint8_t mBaseField066 REFLECTED = 0;
+	uint8_t mBaseField067 REFLECTED = 0;
+	uint8_t mBaseField068 REFLECTED = 0;
+	uint8_t mBaseField069 REFLECTED = 0;
+	uint8_t mBaseField070 REFLECTED = 0;
+	uint8_t mBaseField071 REFLECTED = 0;
+	uint8_t mBaseField072 REFLECTED = 0;
+	uint8_t mBaseField073 REFLECTED = 0;
+	uint8_t mBaseField074 REFLECTED = 0;
+	uint8_t mBaseField075 REFLECTED = 0;
+	uint8_t mBaseField076 REFLECTED = 0;
+	uint8_t mBaseField077 REFLECTED = 0;
+	uint8_t mBaseField078 REFLECTED = 0;
+	uint8_t mBaseField079 REFLECTED = 0;
+	uint8_t mBaseField080 REFLECTED = 0;
+	uint8_t mBaseField081 REFLECTED = 0;
+	uint8_t mBaseField082 REFLECTED = 0;
+	uint8_t mBaseField083 REFLECTED = 0;
+	uint8_t mBaseField084 REFLECTED = 0;
+	uint8_t mBaseField085 REFLECTED = 0;
+	uint8_t mBaseField086 REFLECTED = 0;
+	uint8_t mBaseField087 REFLECTED = 0;
+	uint8_t mBaseField088 REFLECTED = 0;
+	uint8_t mBaseField089 REFLECTED = 0;
+	uint8_t mBaseField090 REFLECTED = 0;
+	uint8_t mBaseField091 REFLECTED = 0;
+	uint8_t mBaseField092 REFLECTED = 0;
+	uint8_t mBaseField093 REFLECTED = 0;
+	uint8_t mBaseField094 REFLECTED = 0;
+	uint8_t mBaseField095 REFLECTED = 0;
+	uint8_t mBaseField096 REFLECTED = 0;
+	uint8_t mBaseField097 REFLECTED = 0;
+	uint8_t mBaseField098 REFLECTED = 0;
+	uint8_t mBaseField099 REFLECTED = 0;
+	uint8_t mBaseField100 REFLECTED = 0;
+	uint8_t mBaseField101 REFLECTED = 0;
+	uint8_t mBaseField102 REFLECTED = 0;
+	uint8_t mBaseField103 REFLECTED = 0;
+	uint8_t mBaseField104 REFLECTED = 0;
+	uint8_t mBaseField105 REFLECTED = 0;
+	uint8_t mBaseField106 REFLECTED = 0;
+	uint8_t mBaseField107 REFLECTED = 0;
+	uint8_t mBaseField108 REFLECTED = 0;
+	uint8_t mBaseField109 REFLECTED = 0;
+	uint8_t mBaseField110 REFLECTED = 0;
+	uint8_t mBaseField111 REFLECTED = 0;
+	uint8_t mBaseField112 REFLECTED = 0;
+	uint8_t mBaseField113 REFLECTED = 0;
+	uint8_t mBaseField114 REFLECTED = 0;
+	uint8_t mBaseField115 REFLECTED = 0;
+	uint8_t mBaseField116 REFLECTED = 0;
+	uint8_t mBaseField117 REFLECTED = 0;
+	uint8_t mBaseField118 REFLECTED = 0;
+	uint8_t mBaseField119 REFLECTED = 0;
+	uint8_t mBaseField120 REFLECTED = 0;
+	uint8_t mBaseField121 REFLECTED = 0;
+	uint8_t mBaseField122 REFLECTED = 0;
+	uint8_t mBaseField123 REFLECTED = 0;
+	uint8_t mBaseField124 REFLECTED = 0;
+	uint8_t mBaseField125 REFLECTED = 0;
+	uint8_t mBaseField126 REFLECTED = 0;
+	uint8_t mBaseField127 REFLECTED = 0;
+	uint8_t mBaseField128 REFLECTED = 0;
+	uint8_t mBaseField129 REFLECTED = 0;
+	uint8_t mBaseField130 REFLECTED = 0;
+	uint8_t mBaseField131 REFLECTED = 0;
+	uint8_t mBaseField132 REFLECTED = 0;
+	uint8_t mBaseField133 REFLECTED = 0;
+	uint8_t mBaseField134 REFLECTED = 0;
+	uint8_t mBaseField135 REFLECTED = 0;
+	uint8_t mBaseField136 REFLECTED = 0;
+	uint8_t mBaseField137 REFLECTED = 0;
+	uint8_t mBaseField138 REFLECTED = 0;
+	uint8_t mBaseField139 REFLECTED = 0;
+	uint8_t mBaseField140 REFLECTED = 0;
+	uint8_t mBaseField141 REFLECTED = 0;
+	uint8_t mBaseField142 REFLECTED = 0;
+	uint8_t mBaseField143 REFLECTED = 0;
+	uint8_t mBaseField144 REFLECTED = 0;
+	uint8_t mBaseField145 REFLECTED = 0;
+	uint8_t mBaseField146 REFLECTED = 0;
+	uint8_t mBaseField147 REFLECTED = 0;
+	uint8_t mBaseField148 REFLECTED = 0;
+	uint8_t mBaseField149 REFLECTED = 0;
+};
+
+class REFLECTED ManyFieldsClass : public ManyFieldsBase
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	uint8_t mField000 REFLECTED = 0;
+	uint8_t mField001 REFLECTED = 0;
+	uint8_t mField002 REFLECTED = 0;
+	uint8_t mField003 REFLECTED = 0;
+	uint8_t mField004 REFLECTED = 0;
+	uint8_t mField005 REFLECTED = 0;
+	uint8_t mField006 REFLECTED = 0;
+	uint8_t mField007 REFLECTED = 0;
+	uint8_t mField008 REFLECTED = 0;
+	uint8_t mField009 REFLECTED = 0;
+	uint8_t mField010 REFLECTED = 0;
+	uint8_t mField011 REFLECTED = 0;
+	uint8_t mField012 REFLECTED = 0;
+	uint8_t mField013 REFLECTED = 0;
+	uint8_t mField014 REFLECTED = 0;
+	uint8_t mField015 REFLECTED = 0;
+	uint8_t mField016 REFLECTED = 0;
+	uint8_t mField017 REFLECTED = 0;
+	uint8_t mField018 REFLECTED = 0;
+	uint8_t mField019 REFLECTED = 0;
+	uint8_t mField020 REFLECTED = 0;
+	uint8_t mField021 REFLECTED = 0;
+	uint8_t mField022 REFLECTED = 0;
+	uint8_t mField023 REFLECTED = 0;
+	uint8_t mField024 REFLECTED = 0;
+	uint8_t mField025 REFLECTED = 0;
+	uint8_t mField026 REFLECTED = 0;
+	uint8_t mField027 REFLECTED = 0;
+	uint8_t mField028 REFLECTED = 0;
+	uint8_t mField029 REFLECTED = 0;
+	uint8_t mField030 REFLECTED = 0;
+	uint8_t mField031 REFLECTED = 0;
+	uint8_t mField032 REFLECTED = 0;
+	uint8_t mField033 REFLECTED = 0;
+	uint8_t mField034 REFLECTED = 0;
+	uint8_t mField035 REFLECTED = 0;
+	uint8_t mField036 REFLECTED = 0;
+	uint8_t mField037 REFLECTED = 0;
+	uint8_t mField038 REFLECTED = 0;
+	uint8_t mField039 REFLECTED = 0;
+	uint8_t mField040 REFLECTED = 0;
+	uint8_t mField041 REFLECTED = 0;
+	uint8_t mField042 REFLECTED = 0;
+	uint8_t mField043 REFLECTED = 0;
+	uint8_t mField044 REFLECTED = 0;
+	uint8_t mField045 REFLECTED = 0;
+	uint8_t mField046 REFLECTED = 0;
+	uint8_t mField047 REFLECTED = 0;
+	uint8_t mField048 REFLECTED = 0;
+	uint8_t mField049 REFLECTED = 0;
+	uint8_t mField050 REFLECTED = 0;
+	uint8_t mField051 REFLECTED = 0;
+	uint8_t mField052 REFLECTED = 0;
+	uint8_t mField053 REFLECTED = 0;
+	uint8_t mField054 REFLECTED = 0;
+	uint8_t mField055 REFLECTED = 0;
+	uint8_t mField056 REFLECTED = 0;
+	uint8_t mField057 REFLECTED = 0;
+	uint8_t mField058 REFLECTED = 0;
+	uint8_t mField059 REFLECTED = 0;
+	uint8_t mField060 REFLECTED = 0;
+	uint8_t mField061 REFLECTED = 0;
+	uint8_t mField062 REFLECTED = 0;
+	uint8_t mField063 REFLECTED = 0;
+	uint8_t mField064 REFLECTED = 0;
+	uint8_t mField065 REFLECTED = 0;
+	uint8_t mField066 REFLECTED = 0;
+	uint8_t mField067 REFLECTED = 0;
+	uint8_t mField068 REFLECTED = 0;
+	uint8_t mField069 REFLECTED = 0;
+	uint8_t mField070 REFLECTED = 0;
+	uint8_t mField071 REFLECTED = 0;
+	uint8_t mField072 REFLECTED = 0;
+	uint8_t mField073 REFLECTED = 0;
+	uint8_t mField074 REFLECTED = 0;
+	uint8_t mField075 REFLECTED = 0;
+	uint8_t mField076 REFLECTED = 0;
+	uint8_t mField077 REFLECTED = 0;
+	uint8_t mField078 REFLECTED = 0;
+	uint8_t mField079 REFLECTED = 0;
+	uint8_t mField080 REFLECTED = 0;
+	uint8_t mField081 REFLECTED = 0;
+	uint8_t mField082 REFLECTED = 0;
+	uint8_t mField083 REFLECTED = 0;
+	uint8_t mField084 REFLECTED = 0;
+	uint8_t mField085 REFLECTED = 0;
+	uint8_t mField086 REFLECTED = 0;
+	uint8_t mField087 REFLECTED = 0;
+	uint8_t mField088 REFLECTED = 0;
+	uint8_t mField089 REFLECTED = 0;
+	uint8_t mField090 REFLECTED = 0;
+	uint8_t mField091 REFLECTED = 0;
+	uint8_t mField092 REFLECTED = 0;
+	uint8_t mField093 REFLECTED = 0;
+	uint8_t mField094 REFLECTED = 0;
+	uint8_t mField095 REFLECTED = 0;
+	uint8_t mField096 REFLECTED = 0;
+	uint8_t mField097 REFLECTED = 0;
+	uint8_t mField098 REFLECTED = 0;
+	uint8_t mField099 REFLECTED = 0;
+	uint8_t mField100 REFLECTED = 0;
+	uint8_t mField101 REFLECTED = 0;
+	uint8_t mField102 REFLECTED = 0;
+	uint8_t mField103 REFLECTED = 0;
+	uint8_t mField104 REFLECTED = 0;
+	uint8_t mField105 REFLECTED = 0;
+	uint8_t mField106 REFLECTED = 0;
+	uint8_t mField107 REFLECTED = 0;
+	uint8_t mField108 REFLECTED = 0;
+	uint8_t mField109 REFLECTED = 0;
+	uint8_t mField110 REFLECTED = 0;
+	uint8_t mField111 REFLECTED = 0;
+	uint8_t mField112 REFLECTED = 0;
+	uint8_t mField113 REFLECTED = 0;
+	uint8_t mField114 REFLECTED = 0;
+	uint8_t mField115 REFLECTED = 0;
+	uint8_t mField116 REFLECTED = 0;
+	uint8_t mField117 REFLECTED = 0;
+	uint8_t mField118 REFLECTED = 0;
+	uint8_t mField119 REFLECTED = 0;
+	uint8_t mField120 REFLECTED = 0;
+	uint8_t mField121 REFLECTED = 0;
+	uint8_t mField122 REFLECTED = 0;
+	uint8_t mField123 REFLECTED = 0;
+	uint8_t mField124 REFLECTED = 0;
+	uint8_t mField125 REFLECTED = 0;
+	uint8_t mField126 REFLECTED = 0;
+	uint8_t mField127 REFLECTED = 0;
+	uint8_t mField128 REFLECTED = 0;
+	uint8_t mField129 REFLECTED = 0;
+	uint8_t mField130 REFLECTED = 0;
+	uint8_t mField131 REFLECTED = 0;
+	uint8_t mField132 REFLECTED = 0;
+	uint8_t mField133 REFLECTED = 0;
+	uint8_t mField134 REFLECTED = 0;
+	uint8_t mField135 REFLECTED = 0;
+	uint8_t mField136 REFLECTED = 0;
+	uint8_t mField137 REFLECTED = 0;
+	uint8_t mField138 REFLECTED = 0;
+	uint8_t mField139 REFLECTED = 0;
+	uint8_t mField140 REFLECTED = 0;
+	uint8_t mField141 REFLECTED = 0;
+	uint8_t mField142 REFLECTED = 0;
+	uint8_t mField143 REFLECTED = 0;
+	uint8_t mField144 REFLECTED = 0;
+	uint8_t mField145 REFLECTED = 0;
+	uint8_t mField146 REFLECTED = 0;
+	uint8_t mField147 REFLECTED = 0;
+	uint8_t mField148 REFLECTED = 0;
+	uint8_t mField149 REFLECTED = 0;
+};
+
 #endif
\ No newline at end of file
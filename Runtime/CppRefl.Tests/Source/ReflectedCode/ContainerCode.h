@@ -0,0 +1,34 @@
+#pragma once
+
+#define TEST_CONTAINER_CODE() 1
+
+#if TEST_CONTAINER_CODE()
+
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CppReflMarkup.h"
+
+#include "ContainerCode.reflgen.h"
+
+// A class with a field for every supported STL container.
+class REFLECTED ContainerClass
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int mInt REFLECTED;
+	std::vector<int> mVector REFLECTED;
+	std::array<float, 3> mArray REFLECTED;
+	std::map<std::string, int> mMap REFLECTED;
+	std::unordered_map<int, float> mUnorderedMap REFLECTED;
+	std::optional<int> mOptional REFLECTED;
+	std::unique_ptr<int> mUniquePtr REFLECTED;
+};
+
+#endif
@@ -17,6 +17,17 @@ enum class REFLECTED ReflectedEnum
 	GENERATED_REFLECTION_CODE()
 };
 
+// Values too far apart for a dense lookup table, including one that aliases another.
+enum class REFLECTED SparseEnum
+{
+	Negative = -5,
+	None = 0,
+	Low = 1,
+	Middle = 1 << 8,
+	High = 1 << 20,
+	MiddleAlias = Middle,
+};
+
 enum class NonReflectedEnum
 {
 	V1,
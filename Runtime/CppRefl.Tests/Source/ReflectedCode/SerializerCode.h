@@ -5,6 +5,8 @@
 #if TEST_SERIALIZER_CODE()
 
 #include <cstdint>
+#include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -71,6 +73,18 @@ public:
 	int mPadding = 1;
 };
 
+// A class with arrays of numbers, which are converted all at once.
+class REFLECTED DeserializeNumberArrays
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	uint8_t mBytes[4] REFLECTED = {};
+	double mDoubles[2] REFLECTED = {};
+	std::vector<float> mFloats REFLECTED;
+	std::vector<int16_t> mShorts REFLECTED;
+};
+
 // A class with metadata to be deserialized.
 class REFLECTED DeserializeMetadata
 {
@@ -119,4 +133,176 @@ public:
 	std::vector<DeserializationBase*> mInstances REFLECTED;
 };
 
-#endif
\ No newline at end of file
+// Two builds of the same class, to load binary data written before fields were added, removed, moved or changed type.
+// The names have the same length, so that tests can rename the class in the data.
+class REFLECTED BinaryVersion1
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int mKept REFLECTED = 0;
+	short mWidened REFLECTED = 0;
+	float mToDouble REFLECTED = 0.0f;
+	std::string mRemoved REFLECTED;
+	int mRemovedInt REFLECTED = 0;
+	int mMoved REFLECTED = 0;
+	int mArray[3] REFLECTED;
+	std::vector<int> mVector REFLECTED;
+	DeserializationBase* mPointer REFLECTED = nullptr;
+};
+
+class REFLECTED BinaryVersion2
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int mMoved REFLECTED = 0;
+	int mKept REFLECTED = 0;
+	long long mWidened REFLECTED = 0;
+	double mToDouble REFLECTED = 0.0;
+	int mAdded REFLECTED = 42;
+	int mArray[2] REFLECTED;
+	std::vector<float> mVector REFLECTED;
+	DeserializationBase* mPointer REFLECTED = nullptr;
+};
+
+// A class that is deserialized into repeatedly.
+class REFLECTED DeserializeUpdate
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int mInt REFLECTED = 0;
+	std::string mString REFLECTED;
+	std::vector<DeserializeDynamicArrayElement> mElements REFLECTED;
+	std::map<std::string, std::string> mMap REFLECTED;
+	std::optional<DeserializeDynamicArrayElement> mOptional REFLECTED;
+	DeserializeDynamicArrayElement* mPointer REFLECTED = nullptr;
+};
+
+// Classes that are bit-packed according to the metadata of their fields.
+enum class REFLECTED BitPackState
+{
+	Idle,
+	Walking,
+	Running,
+	Dead,
+};
+
+class REFLECTED BitPackVector
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	float x REFL_META_RUNTIME("bits", 16) REFL_META_RUNTIME("min", -100.0) REFL_META_RUNTIME("max", 100.0) = 0.0f;
+	float y REFL_META_RUNTIME("bits", 16) REFL_META_RUNTIME("min", -100.0) REFL_META_RUNTIME("max", 100.0) = 0.0f;
+	float z REFL_META_RUNTIME("bits", 12) REFL_META_RUNTIME("min", 0) REFL_META_RUNTIME("max", 50) = 0.0f;
+};
+
+class REFLECTED BitPackSnapshot
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	BitPackVector mPosition REFLECTED;
+	float mYaw REFL_META_RUNTIME("bits", 8) REFL_META_RUNTIME("min", 0) REFL_META_RUNTIME("max", 360) = 0.0f;
+	int mHealth REFL_META_RUNTIME("min", 0) REFL_META_RUNTIME("max", 100) = 0;
+	int mDelta REFL_META_RUNTIME("bits", 6) = 0;
+	uint16_t mAmmo[2] REFL_META_RUNTIME("bits", 10);
+	BitPackState mState REFLECTED = BitPackState::Idle;
+	bool mCrouching REFLECTED = false;
+	double mTime REFLECTED = 0.0;
+	const int mConstant REFLECTED = 7;
+	std::string mName REFLECTED;
+};
+
+// An enum with an unsigned underlying type, and a value with the top bit set.
+enum class REFLECTED BitPackFlags : uint8_t
+{
+	None = 0,
+	Low = 1,
+	High = 200,
+};
+
+class REFLECTED BitPackFlagsHolder
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	BitPackFlags mFlags[3] REFLECTED = { BitPackFlags::None, BitPackFlags::None, BitPackFlags::None };
+	bool mEnabled REFLECTED = false;
+};
+
+// Classes exported as columnar tables.
+enum class REFLECTED ColumnarCategory
+{
+	Movement,
+	Combat,
+	Economy,
+};
+
+class REFLECTED ColumnarPoint
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	float mX REFLECTED = 0.0f;
+	float mY REFLECTED = 0.0f;
+};
+
+class REFLECTED ColumnarRecord
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mId REFLECTED = 0;
+	uint64_t mTimestamp REFLECTED = 0;
+	ColumnarCategory mCategory REFLECTED = ColumnarCategory::Movement;
+	ColumnarPoint mPosition REFLECTED;
+	double mValue REFLECTED = 0.0;
+	uint16_t mSamples[2] REFLECTED = {};
+	bool mActive REFLECTED = false;
+	const int mConstant REFLECTED = 7;
+	std::string mName REFLECTED;
+};
+
+// ColumnarRecord after its fields changed: mId is wider, mValue is a float, mActive is gone and mLevel is new.
+class REFLECTED ColumnarRecordChanged
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int64_t mId REFLECTED = 0;
+	ColumnarPoint mPosition REFLECTED;
+	float mValue REFLECTED = 0.0f;
+	int32_t mLevel REFLECTED = -1;
+};
+
+// Class loaded from CSV text.
+class REFLECTED CsvRecord
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mId REFLECTED = 0;
+	ColumnarCategory mCategory REFLECTED = ColumnarCategory::Movement;
+	ColumnarPoint mPosition REFLECTED;
+	double mValue REFLECTED = 0.0;
+	uint8_t mSmall REFLECTED = 0;
+	uint16_t mSamples[2] REFLECTED = {};
+	bool mActive REFLECTED = false;
+	std::string mName REFLECTED;
+	int32_t mDefault REFLECTED = 42;
+};
+
+// Class formatted as text, that can point to itself.
+class REFLECTED FormatNode
+{
+	GENERATED_REFLECTION_CODE()
+
+public:
+	int32_t mValue REFLECTED = 0;
+	FormatNode* mNext REFLECTED = nullptr;
+};
+
+#endif
@@ -40,6 +40,19 @@ TEST(ClassTests, DerivedClasses)
 	EXPECT_TRUE(ChildClass2::StaticReflectedClass().IsA<ChildClass2>());
 }
 
+TEST(ClassTests, GetDerivedClass)
+{
+	const auto& baseClass = BaseClass::StaticReflectedClass();
+	EXPECT_EQ(baseClass.GetDerivedClass(Name("BaseClass")), &baseClass);
+	EXPECT_EQ(baseClass.GetDerivedClass(Name("ChildClass")), &ChildClass::StaticReflectedClass());
+	EXPECT_EQ(baseClass.GetDerivedClass(Name("ChildClass2")), &ChildClass2::StaticReflectedClass());
+	EXPECT_EQ(baseClass.GetDerivedClass(Name("ReflectedClass")), nullptr);
+
+	const auto& childClass = ChildClass::StaticReflectedClass();
+	EXPECT_EQ(childClass.GetDerivedClass(Name("ChildClass2")), &ChildClass2::StaticReflectedClass());
+	EXPECT_EQ(childClass.GetDerivedClass(Name("BaseClass")), nullptr);
+}
+
 TEST(ClassTests, GetField)
 {
 	const auto& classInfo = ReflectedClass::StaticReflectedClass();
@@ -52,6 +65,70 @@ TEST(ClassTests, GetField)
 	EXPECT_EQ(classInfo.GetField(Name("blargh")), nullptr);
 }
 
+TEST(ClassTests, FlattenedFields)
+{
+	const auto& baseClassInfo = BaseClass::StaticReflectedClass();
+	EXPECT_EQ(baseClassInfo.mFlattenedFields.size(), 1);
+
+	const auto& classInfo = ChildClass2::StaticReflectedClass();
+	EXPECT_EQ(classInfo.mFields.size(), 0);
+	ASSERT_EQ(classInfo.mFlattenedFields.size(), 2);
+	EXPECT_EQ(classInfo.mFlattenedFields[0].mName, Name("mBaseClassField"));
+	EXPECT_EQ(classInfo.mFlattenedFields[1].mName, Name("mChildClassField"));
+	EXPECT_LT(classInfo.mFlattenedFields[0].mOffset, classInfo.mFlattenedFields[1].mOffset);
+}
+
+TEST(ClassTests, FieldRecords)
+{
+	const auto& classInfo = ChildClass2::StaticReflectedClass();
+
+	const auto records = classInfo.GetFieldRecords();
+	ASSERT_EQ(records.size(), classInfo.mFlattenedFields.size());
+
+	for (const auto& record : records)
+	{
+		const auto& fieldInfo = classInfo.GetFieldInfo(record);
+		EXPECT_EQ(record.mName, fieldInfo.mName);
+		EXPECT_EQ(record.mOffset, fieldInfo.mOffset);
+		EXPECT_EQ(record.mKind, TypeKind::Int32);
+		EXPECT_FALSE(record.HasFlag(FieldFlags::Array));
+		EXPECT_FALSE(record.HasFlag(FieldFlags::Container));
+	}
+}
+
+TEST(ClassTests, GetInheritedField)
+{
+	ChildClass2 obj;
+
+	const auto& classInfo = ChildClass2::StaticReflectedClass();
+	EXPECT_EQ(classInfo.GetFieldValueUnsafe<int>(&obj, Name("mChildClassField")), &obj.mChildClassField);
+	EXPECT_EQ(classInfo.GetFieldValueUnsafe<int>(&obj, Name("mBaseClassField")), BaseClass::StaticReflectedClass().GetFieldValueUnsafe<int>(static_cast<BaseClass*>(&obj), Name("mBaseClassField")));
+	EXPECT_EQ(classInfo.GetField(Name("blargh")), nullptr);
+}
+
+TEST(ClassTests, GetFieldManyFields)
+{
+	ManyFieldsClass obj;
+
+	const auto& classInfo = ManyFieldsClass::StaticReflectedClass();
+	ASSERT_EQ(classInfo.GetFieldRecords().size(), 300);
+
+	// Every field is found, including those whose index doesn't fit in 8 bits.
+	for (const auto& record : classInfo.GetFieldRecords())
+	{
+		const FieldInfo* fieldInfo = classInfo.GetField(record.mName);
+		ASSERT_NE(fieldInfo, nullptr);
+		EXPECT_EQ(fieldInfo, &classInfo.GetFieldInfo(record));
+		EXPECT_EQ(fieldInfo->mName, record.mName);
+	}
+
+	EXPECT_EQ(classInfo.GetFieldValueUnsafe<uint8_t>(&obj, Name("mBaseField000")), &obj.mBaseField000);
+	EXPECT_EQ(classInfo.GetFieldValueUnsafe<uint8_t>(&obj, Name("mField104")), &obj.mField104);
+	EXPECT_EQ(classInfo.GetFieldValueUnsafe<uint8_t>(&obj, Name("mField105")), &obj.mField105);
+	EXPECT_EQ(classInfo.GetFieldValueUnsafe<uint8_t>(&obj, Name("mField149")), &obj.mField149);
+	EXPECT_EQ(classInfo.GetField(Name("blargh")), nullptr);
+}
+
 TEST(ClassTests, GetFieldValueUnsafe)
 {
 	const auto& classInfo = ReflectedClass::StaticReflectedClass();
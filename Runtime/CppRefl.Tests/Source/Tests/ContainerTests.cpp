@@ -0,0 +1,231 @@
+#include "gtest/gtest.h"
+
+#include "ContainerCode.h"
+#include "Reflection/ArrayView.h"
+#include "Reflection/AssociativeArray.h"
+#include "Reflection/DynamicArray.h"
+#include "Reflection/Optional.h"
+
+#if CPPREFL_WITH_STL()
+
+TEST(ContainerTests, DynamicArrayElementType)
+{
+	const auto functions = cpprefl::StdVectorFunctionsFactory::Create<int>(cpprefl::Name("int"));
+
+	EXPECT_EQ(&functions.mElementType.mType, &cpprefl::GetReflectedType<int>());
+	EXPECT_EQ(functions.mElementStride, sizeof(int));
+}
+
+TEST(ContainerTests, DynamicArrayResizePreservesElements)
+{
+	const auto functions = cpprefl::StdVectorFunctionsFactory::Create<int>(cpprefl::Name("int"));
+
+	std::vector<int> arr = { 1, 2, 3 };
+	functions.mResize(&arr, 5);
+	EXPECT_EQ(functions.mGetSize(&arr), 5);
+	EXPECT_EQ(arr[0], 1);
+	EXPECT_EQ(arr[1], 2);
+	EXPECT_EQ(arr[2], 3);
+	EXPECT_EQ(arr[3], 0);
+	EXPECT_EQ(arr[4], 0);
+
+	functions.mResize(&arr, 2);
+	EXPECT_EQ(functions.mGetSize(&arr), 2);
+	EXPECT_EQ(arr[1], 2);
+}
+
+TEST(ContainerTests, DynamicArrayReserve)
+{
+	const auto functions = cpprefl::StdVectorFunctionsFactory::Create<int>(cpprefl::Name("int"));
+
+	std::vector<int> arr;
+	functions.mReserve(&arr, 64);
+	EXPECT_EQ(functions.mGetSize(&arr), 0);
+	EXPECT_GE(arr.capacity(), 64);
+}
+
+TEST(ContainerTests, DynamicArrayEmplaceBack)
+{
+	const auto functions = cpprefl::StdVectorFunctionsFactory::Create<int>(cpprefl::Name("int"));
+
+	std::vector<int> arr;
+	functions.mReserve(&arr, 3);
+	for (int i = 0; i < 3; ++i)
+	{
+		*static_cast<int*>(functions.mEmplaceBack(&arr)) = i * 10;
+	}
+
+	EXPECT_EQ(functions.mGetSize(&arr), 3);
+	EXPECT_EQ(*static_cast<int*>(functions.GetElement(&arr, 0)), 0);
+	EXPECT_EQ(*static_cast<int*>(functions.GetElement(&arr, 1)), 10);
+	EXPECT_EQ(*static_cast<int*>(functions.GetElement(&arr, 2)), 20);
+
+	functions.mClear(&arr);
+	EXPECT_EQ(functions.mGetSize(&arr), 0);
+	EXPECT_GE(arr.capacity(), 3);
+}
+
+TEST(ContainerTests, ArrayView)
+{
+	const auto functions = cpprefl::StdArrayViewFunctionsFactory::Create<std::array<int, 4>>(cpprefl::Name("int"));
+	EXPECT_EQ(functions.mKind, cpprefl::ContainerKind::ArrayView);
+	EXPECT_EQ(functions.mElementStride, sizeof(int));
+
+	std::array<int, 4> arr = { 4, 8, 15, 16 };
+	EXPECT_EQ(functions.mGetSize(&arr), 4);
+	EXPECT_EQ(functions.mGetData(&arr), arr.data());
+	EXPECT_EQ(*static_cast<int*>(functions.GetElement(&arr, 3)), 16);
+
+#if CPPREFL_WITH_STD_SPAN()
+	const auto spanFunctions = cpprefl::StdArrayViewFunctionsFactory::Create<std::span<int>>(cpprefl::Name("int"));
+
+	std::span<int> span(arr.data() + 1, 2);
+	EXPECT_EQ(spanFunctions.mGetSize(&span), 2);
+	EXPECT_EQ(*static_cast<int*>(spanFunctions.GetElement(&span, 0)), 8);
+#endif
+}
+
+namespace
+{
+	template <typename Container>
+	void TestAssociativeArray()
+	{
+		const auto functions = cpprefl::StdAssociativeArrayFunctionsFactory::Create<Container>(cpprefl::Name("std::string"), cpprefl::Name("int"));
+		EXPECT_EQ(functions.mKind, cpprefl::ContainerKind::AssociativeArray);
+		EXPECT_EQ(&functions.mValueType.mType, &cpprefl::GetReflectedType<int>());
+
+		Container map;
+		functions.mReserve(&map, 16);
+
+		std::string key = "first";
+		*static_cast<int*>(functions.mEmplace(&map, &key)) = 1;
+		key = "second";
+		*static_cast<int*>(functions.mEmplace(&map, &key)) = 2;
+
+		// Emplacing an existing key returns the existing value.
+		key = "first";
+		EXPECT_EQ(*static_cast<int*>(functions.mEmplace(&map, &key)), 1);
+
+		EXPECT_EQ(functions.mGetSize(&map), 2);
+
+		const std::string missing = "missing";
+		EXPECT_EQ(functions.mFind(&map, &missing), nullptr);
+
+		const std::string second = "second";
+		EXPECT_EQ(functions.mFind(&map, &second), &map.at("second"));
+
+		int sum = 0;
+		functions.mForEach(&map, [](void* context, const void* key, void* value)
+		{
+			*static_cast<int*>(context) += *static_cast<int*>(value);
+			return true;
+		}, &sum);
+		EXPECT_EQ(sum, 3);
+
+		functions.mClear(&map);
+		EXPECT_EQ(functions.mGetSize(&map), 0);
+	}
+}
+
+TEST(ContainerTests, AssociativeArray)
+{
+	TestAssociativeArray<std::map<std::string, int>>();
+	TestAssociativeArray<std::unordered_map<std::string, int>>();
+}
+
+TEST(ContainerTests, AssociativeArrayKeyConstruction)
+{
+	using Container = std::map<std::string, int>;
+	const auto functions = cpprefl::StdAssociativeArrayFunctionsFactory::Create<Container>(cpprefl::Name("std::string"), cpprefl::Name("int"));
+
+	EXPECT_EQ(functions.mKeySize, sizeof(std::string));
+
+	alignas(std::string) std::byte keyMemory[sizeof(std::string)];
+	functions.mConstructKey(keyMemory);
+	*reinterpret_cast<std::string*>(keyMemory) = "key";
+
+	Container map;
+	*static_cast<int*>(functions.mEmplace(&map, keyMemory)) = 7;
+	functions.mDestructKey(keyMemory);
+
+	EXPECT_EQ(map.at("key"), 7);
+}
+
+TEST(ContainerTests, Optional)
+{
+	const auto functions = cpprefl::StdOptionalFunctionsFactory::Create<int>(cpprefl::Name("int"));
+	EXPECT_EQ(functions.mKind, cpprefl::ContainerKind::Optional);
+
+	std::optional<int> opt;
+	EXPECT_FALSE(functions.HasValue(&opt));
+
+	*static_cast<int*>(functions.mEmplace(&opt)) = 42;
+	EXPECT_TRUE(functions.HasValue(&opt));
+	EXPECT_EQ(*opt, 42);
+	EXPECT_EQ(functions.mGetValue(&opt), &*opt);
+
+	functions.mReset(&opt);
+	EXPECT_FALSE(opt.has_value());
+}
+
+TEST(ContainerTests, UniquePtr)
+{
+	const auto functions = cpprefl::StdUniquePtrFunctionsFactory::Create<int>(cpprefl::Name("int"));
+
+	std::unique_ptr<int> ptr;
+	EXPECT_FALSE(functions.HasValue(&ptr));
+
+	*static_cast<int*>(functions.mEmplace(&ptr)) = 42;
+	EXPECT_EQ(*ptr, 42);
+	EXPECT_EQ(functions.mGetValue(&ptr), ptr.get());
+
+	functions.mReset(&ptr);
+	EXPECT_EQ(ptr, nullptr);
+}
+
+#endif
+
+#if TEST_CONTAINER_CODE()
+
+#include "Reflection/ClassInfo.h"
+#include "Reflection/Registry.h"
+
+TEST(ContainerTests, FieldContainerFunctions)
+{
+	const auto& classInfo = ContainerClass::StaticReflectedClass();
+
+	const auto* intField = classInfo.GetField(cpprefl::Name("mInt"));
+	EXPECT_EQ(intField->mContainerFunctions, nullptr);
+	EXPECT_EQ(intField->GetContainerFunctions<cpprefl::DynamicArrayFunctions>(), nullptr);
+
+	const auto* vectorField = classInfo.GetField(cpprefl::Name("mVector"));
+	EXPECT_NE(vectorField->GetContainerFunctions<cpprefl::DynamicArrayFunctions>(), nullptr);
+	EXPECT_EQ(vectorField->GetContainerFunctions<cpprefl::AssociativeArrayFunctions>(), nullptr);
+
+	// The field points directly at the table stored in the registry.
+	EXPECT_EQ(vectorField->GetContainerFunctions<cpprefl::DynamicArrayFunctions>(), cpprefl::Registry::GetSystemRegistry().GetDynamicArrayFunctions(vectorField->GetType().mName));
+
+	EXPECT_NE(classInfo.GetField(cpprefl::Name("mArray"))->GetContainerFunctions<cpprefl::ArrayViewFunctions>(), nullptr);
+	EXPECT_NE(classInfo.GetField(cpprefl::Name("mMap"))->GetContainerFunctions<cpprefl::AssociativeArrayFunctions>(), nullptr);
+	EXPECT_NE(classInfo.GetField(cpprefl::Name("mUnorderedMap"))->GetContainerFunctions<cpprefl::AssociativeArrayFunctions>(), nullptr);
+	EXPECT_NE(classInfo.GetField(cpprefl::Name("mOptional"))->GetContainerFunctions<cpprefl::OptionalFunctions>(), nullptr);
+	EXPECT_NE(classInfo.GetField(cpprefl::Name("mUniquePtr"))->GetContainerFunctions<cpprefl::OptionalFunctions>(), nullptr);
+}
+
+TEST(ContainerTests, FieldDynamicArray)
+{
+	ContainerClass obj;
+
+	const auto* vectorField = ContainerClass::StaticReflectedClass().GetField(cpprefl::Name("mVector"));
+	const auto* functions = vectorField->GetContainerFunctions<cpprefl::DynamicArrayFunctions>();
+
+	void* arr = vectorField->GetMemoryInClass(&obj);
+	*static_cast<int*>(functions->mEmplaceBack(arr)) = 5;
+	*static_cast<int*>(functions->mEmplaceBack(arr)) = 6;
+
+	EXPECT_EQ(obj.mVector.size(), 2);
+	EXPECT_EQ(obj.mVector[0], 5);
+	EXPECT_EQ(obj.mVector[1], 6);
+}
+
+#endif
@@ -28,6 +28,28 @@ TEST(EnumTests, EnumValues)
 	EXPECT_EQ(enumInfo.mValues[2].mValue, (int)ReflectedEnum::Foo);
 }
 
+TEST(EnumTests, EnumValuesByNumber)
+{
+	const auto& enumInfo = cpprefl::GetReflectedEnum<ReflectedEnum>();
+	EXPECT_EQ(enumInfo.GetValue((int)ReflectedEnum::EnumValue1), &enumInfo.mValues[0]);
+	EXPECT_EQ(enumInfo.GetValue((int)ReflectedEnum::Bar), &enumInfo.mValues[1]);
+	EXPECT_EQ(enumInfo.GetValue((int)ReflectedEnum::Foo), &enumInfo.mValues[2]);
+	EXPECT_EQ(enumInfo.GetValue(5), nullptr);
+	EXPECT_EQ(enumInfo.GetValue(-1), nullptr);
+	EXPECT_EQ(enumInfo.GetValue(12), nullptr);
+
+	// The first declared value wins if several share a number.
+	const auto& sparseInfo = cpprefl::GetReflectedEnum<SparseEnum>();
+	EXPECT_EQ(sparseInfo.GetValue((int)SparseEnum::Negative)->mName, cpprefl::Name("Negative"));
+	EXPECT_EQ(sparseInfo.GetValue((int)SparseEnum::None)->mName, cpprefl::Name("None"));
+	EXPECT_EQ(sparseInfo.GetValue((int)SparseEnum::Low)->mName, cpprefl::Name("Low"));
+	EXPECT_EQ(sparseInfo.GetValue((int)SparseEnum::Middle)->mName, cpprefl::Name("Middle"));
+	EXPECT_EQ(sparseInfo.GetValue((int)SparseEnum::High)->mName, cpprefl::Name("High"));
+	EXPECT_EQ(sparseInfo.GetValue(2), nullptr);
+	EXPECT_EQ(sparseInfo.GetValue(-4), nullptr);
+	EXPECT_EQ(sparseInfo.GetValue(1 << 21), nullptr);
+}
+
 TEST(EnumTests, Concepts)
 {
 #if CPPREFL_CONCEPTS()
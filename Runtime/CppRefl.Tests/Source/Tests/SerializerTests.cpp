@@ -4,8 +4,110 @@
 
 #if TEST_SERIALIZER_CODE()
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "CppReflConfig.h"
+#include "Serialization/BinaryDeserializer.h"
+#include "Serialization/BinarySerializer.h"
+#include "Serialization/BitPackDeserializer.h"
+#include "Serialization/BitPackSerializer.h"
+#include "Serialization/CborDeserializer.h"
+#include "Serialization/CborSerializer.h"
+#include "Serialization/ColumnarReader.h"
+#include "Serialization/ColumnarWriter.h"
+#include "Serialization/CsvLoader.h"
+#include "Serialization/DeserializationArena.h"
+#include "Serialization/Format.h"
+#include "Serialization/FrozenBlob.h"
 #include "Serialization/Serializer.h"
 #include "Serialization/JsonDeserializer.h"
+#include "Serialization/JsonScanner.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonStreamDeserializer.h"
+#include "Serialization/MappedFile.h"
+#include "Serialization/MemoryFootprint.h"
+#include "Serialization/MsgPackDeserializer.h"
+#include "Serialization/MsgPackSerializer.h"
+#include "Serialization/NumberConversion.h"
+#include "Serialization/ThreadPool.h"
+
+namespace
+{
+	// Heap allocations made by the current thread, while counted by CountAllocations().
+	thread_local size_t* AllocationCounter = nullptr;
+
+	void CountAllocation()
+	{
+		if (AllocationCounter != nullptr)
+		{
+			++*AllocationCounter;
+		}
+	}
+
+	class CountingConfig : public cpprefl::IConfig
+	{
+	public:
+		void* AllocateMemory(size_t numBytes) override
+		{
+			CountAllocation();
+			return IConfig::AllocateMemory(numBytes);
+		}
+	};
+
+	// Returns the number of heap allocations, through operator new or IConfig, made by a function.
+	template <typename Function>
+	size_t CountAllocations(Function&& function)
+	{
+		cpprefl::IConfig& previousConfig = cpprefl::IConfig::Get();
+		CountingConfig config;
+		config.Set();
+
+		size_t allocations = 0;
+		AllocationCounter = &allocations;
+		function();
+		AllocationCounter = nullptr;
+
+		previousConfig.Set();
+		return allocations;
+	}
+}
+
+// Replaced so that tests can count allocations. The array forms of operator new forward to these.
+void* operator new(std::size_t size)
+{
+	CountAllocation();
+	if (void* memory = std::malloc(size != 0 ? size : 1))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	CountAllocation();
+	return std::malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
 
 namespace
 {
@@ -188,6 +290,39 @@ TEST(SerializerTests, JsonDeserializeNestedClass)
 	EXPECT_EQ(object.arrayOfClasses[2].mBool, false);
 }
 
+TEST(SerializerTests, JsonArena)
+{
+	cpprefl::serialization::DeserializationArena arena(true);
+
+	cpprefl::serialization::Deserializer deserializer;
+	deserializer.SetArena(&arena);
+
+	// Interned strings are shared between objects.
+	cpprefl::json::JsonDeserializer jsonDeserializer1(SimpleClassJson);
+	const auto object1 = deserializer.Deserialize<DeserializeSimple>(jsonDeserializer1);
+	ASSERT_TRUE(object1.has_value());
+
+	cpprefl::json::JsonDeserializer jsonDeserializer2(SimpleClassJson);
+	const auto object2 = deserializer.Deserialize<DeserializeSimple>(jsonDeserializer2);
+	ASSERT_TRUE(object2.has_value());
+
+	EXPECT_STREQ(object1->dynamicString, "some dynamic string");
+	EXPECT_EQ(object1->dynamicString, object2->dynamicString);
+	EXPECT_EQ(arena.GetInternedStringCount(), 1);
+	EXPECT_EQ(arena.GetAllocatedBytes(), std::strlen("some dynamic string") + 1);
+
+	// Allocations are aligned, and large allocations get their own block.
+	for (size_t size : { 1, 3, 100000, 7 })
+	{
+		void* memory = arena.Allocate(size, 16);
+		EXPECT_EQ((uintptr_t)memory % 16, 0);
+		std::memset(memory, 0xFF, size);
+	}
+
+	arena.Release();
+	EXPECT_EQ(arena.GetAllocatedBytes(), 0);
+}
+
 TEST(SerializerTests, JsonInvalid)
 {
 	cpprefl::json::JsonDeserializer jsonDeserializer(InvalidJson);
@@ -200,20 +335,226 @@ TEST(SerializerTests, JsonInvalid)
 
 TEST(SerializerTests, JsonOverflow)
 {
-	cpprefl::json::JsonDeserializer jsonDeserializer(OverflowJson);
+	// The generated code has to convert values that don't fit the same way as the reflected path.
+	for (const bool useGeneratedCode : { false, true })
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(OverflowJson);
+
+		cpprefl::serialization::Deserializer deserializer;
+		deserializer.SetUseGeneratedCode(useGeneratedCode);
+		const auto objectResult = deserializer.Deserialize<DeserializeOverflow>(jsonDeserializer);
+		EXPECT_TRUE(objectResult.has_value());
+		const auto& object = *objectResult;
+
+		EXPECT_EQ(object.mU8, (uint8_t)257);
+		EXPECT_EQ(object.mFloat, (float)std::numeric_limits<double>::max());
+		EXPECT_EQ(object.mArray[0], 5);
+		EXPECT_EQ(object.mArray[1], 10);
+		EXPECT_EQ(object.mArray[2], 15);
+		EXPECT_EQ(object.mArray[3], 1);// This array is only 3 long, so we shouldn't have deserialized the 4th value.
+		EXPECT_EQ(object.mPadding, 1);
+	}
+}
+
+TEST(SerializerTests, JsonEscapedStrings)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(R"""({ "string": "a\"b\\c\n\u00e9\ud83d\ude00", "unknown": { "nested": [ 1, "\"]" ] }, "stdstring": "plain" })""");
 
 	cpprefl::serialization::Deserializer deserializer;
-	const auto objectResult = deserializer.Deserialize<DeserializeOverflow>(jsonDeserializer);
-	EXPECT_TRUE(objectResult.has_value());
-	const auto& object = *objectResult;
+	const auto objectResult = deserializer.Deserialize<DeserializeSimple>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	EXPECT_STREQ(objectResult->string, "a\"b\\c\n\xC3\xA9\xF0\x9F\x98\x80");
+	EXPECT_STREQ(objectResult->stdstring.c_str(), "plain");
+}
+
+TEST(SerializerTests, JsonScannerKernels)
+{
+	using namespace cpprefl::json;
+
+	const std::string json = R"""({ "key": "value with \"escapes\"",		"array": [ 1, 2, { "nested": [] } ],
+		"long string to cross a few vector widths .................................." :    true })""";
+
+	const char* begin = json.data();
+	const char* end = json.data() + json.size();
+
+	const ScannerKernel defaultKernel = GetScannerKernel();
+	ASSERT_TRUE(SetScannerKernel(ScannerKernel::Scalar));
+
+	std::vector<const char*> expected;
+	for (const char* it = begin; it != end; ++it)
+	{
+		expected.push_back(FindNonWhitespace(it, end));
+		expected.push_back(FindStringSpecial(it, end));
+		expected.push_back(FindStructural(it, end));
+	}
+
+	// Every kernel the CPU supports must agree with the scalar kernel, from every starting offset.
+	for (const ScannerKernel kernel : { ScannerKernel::Sse42, ScannerKernel::Avx2 })
+	{
+		if (!SetScannerKernel(kernel))
+		{
+			continue;
+		}
+
+		for (const char* it = begin; it != end; ++it)
+		{
+			const size_t index = (it - begin) * 3;
+			EXPECT_EQ(FindNonWhitespace(it, end), expected[index + 0]);
+			EXPECT_EQ(FindStringSpecial(it, end), expected[index + 1]);
+			EXPECT_EQ(FindStructural(it, end), expected[index + 2]);
+		}
+	}
+
+	SetScannerKernel(defaultKernel);
+}
+
+TEST(SerializerTests, NumberConversion)
+{
+	using namespace cpprefl::serialization;
+	using cpprefl::TypeKind;
+
+	int64_t int64s[] = { 300, -129, 5, std::numeric_limits<int64_t>::min(), 70000 };
+	int8_t int8s[5];
+	EXPECT_EQ(ConvertNumbers(TypeKind::Int64, int64s, TypeKind::Int8, int8s, 5), 4);
+	EXPECT_EQ(std::vector<int8_t>(int8s, int8s + 5), std::vector<int8_t>({ 44, 127, 5, 0, 112 }));
+	EXPECT_EQ(ConvertNumbers(TypeKind::Int64, int64s, TypeKind::Int8, int8s, 5, NumberOverflow::Saturate), 4);
+	EXPECT_EQ(std::vector<int8_t>(int8s, int8s + 5), std::vector<int8_t>({ 127, -128, 5, -128, 127 }));
+
+	const double doubles[] = { 2.9, -2.9, 3e9, std::numeric_limits<double>::quiet_NaN(), 1e300 };
+	int32_t int32s[5];
+	EXPECT_EQ(ConvertNumbers(TypeKind::Double, doubles, TypeKind::Int32, int32s, 5), 3);
+	EXPECT_EQ(std::vector<int32_t>(int32s, int32s + 5), std::vector<int32_t>({ 2, -2, (int32_t)3000000000ll, 0, 0 }));
+	EXPECT_EQ(ConvertNumbers(TypeKind::Double, doubles, TypeKind::Int32, int32s, 5, NumberOverflow::Saturate), 3);
+	EXPECT_EQ(std::vector<int32_t>(int32s, int32s + 5), std::vector<int32_t>({ 2, -2, std::numeric_limits<int32_t>::max(), 0, std::numeric_limits<int32_t>::max() }));
+
+	float floats[5];
+	EXPECT_EQ(ConvertNumbers(TypeKind::Double, doubles, TypeKind::Float, floats, 5), 1);
+	EXPECT_TRUE(std::isnan(floats[3]));
+	EXPECT_EQ(floats[4], std::numeric_limits<float>::infinity());
+	EXPECT_EQ(ConvertNumbers(TypeKind::Double, doubles, TypeKind::Float, floats, 5, NumberOverflow::Saturate), 1);
+	EXPECT_TRUE(std::isnan(floats[3]));
+	EXPECT_EQ(floats[4], std::numeric_limits<float>::max());
+
+	uint16_t uint16s[] = { 1, 65535 };
+	uint64_t uint64s[2];
+	EXPECT_EQ(ConvertNumbers(TypeKind::Uint16, uint16s, TypeKind::Uint64, uint64s, 2), 0);
+	EXPECT_EQ(uint64s[1], 65535u);
+	EXPECT_EQ(ConvertNumbers(TypeKind::Int64, int64s, TypeKind::Uint64, uint64s, 2, NumberOverflow::Saturate), 1);
+	EXPECT_EQ(uint64s[0], 300u);
+	EXPECT_EQ(uint64s[1], 0u);
+}
+
+TEST(SerializerTests, NumberConversionKernels)
+{
+	using namespace cpprefl::serialization;
+	using cpprefl::TypeKind;
+
+	const TypeKind kinds[] =
+	{
+		TypeKind::Uint8, TypeKind::Int8, TypeKind::Uint16, TypeKind::Int16, TypeKind::Uint32, TypeKind::Int32,
+		TypeKind::Uint64, TypeKind::Int64, TypeKind::Float, TypeKind::Double, TypeKind::LongDouble,
+	};
+
+	// Edge cases of every kind, repeated to cover both whole vectors and the remainder.
+	const double seeds[] =
+	{
+		0.0, 1.0, -1.0, 2.9, -2.9, 127.0, 128.0, -129.0, 255.0, 256.0, 32767.0, 40000.0, -40000.0, 2147483647.0, 2147483648.0, -3e9,
+		4294967296.0, 1e12, 9.3e18, -9.3e18, 1.8e19, 1e300, -1e300, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN(),
+	};
+
+	std::vector<double> values;
+	for (int i = 0; i < 3; ++i)
+	{
+		values.insert(values.end(), std::begin(seeds), std::end(seeds));
+	}
+
+	const ConversionKernel defaultKernel = GetConversionKernel();
+	ASSERT_TRUE(SetConversionKernel(ConversionKernel::Scalar));
+
+	// Every kernel the CPU supports must agree with the scalar kernel.
+	for (const TypeKind sourceKind : kinds)
+	{
+		std::vector<std::byte> source(values.size() * sizeof(long double));
+		ConvertNumbers(TypeKind::Double, values.data(), sourceKind, source.data(), values.size(), NumberOverflow::Saturate);
+
+		for (const TypeKind destinationKind : kinds)
+		{
+			for (const NumberOverflow overflow : { NumberOverflow::Truncate, NumberOverflow::Saturate })
+			{
+				SetConversionKernel(ConversionKernel::Scalar);
+				std::vector<std::byte> expected(values.size() * sizeof(long double));
+				const size_t expectedOverflowCount = ConvertNumbers(sourceKind, source.data(), destinationKind, expected.data(), values.size(), overflow);
+
+				if (!SetConversionKernel(ConversionKernel::Avx2))
+				{
+					continue;
+				}
+
+				std::vector<std::byte> actual(values.size() * sizeof(long double));
+				EXPECT_EQ(ConvertNumbers(sourceKind, source.data(), destinationKind, actual.data(), values.size(), overflow), expectedOverflowCount);
+				EXPECT_EQ(actual, expected) << (int)sourceKind << " to " << (int)destinationKind;
+			}
+		}
+	}
+
+	SetConversionKernel(defaultKernel);
+}
+
+TEST(SerializerTests, JsonNumbers)
+{
+	using namespace cpprefl::json;
+
+	const char* numbers[] =
+	{
+		"0", "-0", "10", "-66", "3.14", "0.1", "1e22", "1e23", "-2.5E-3", "9007199254740993", "18446744073709551615",
+		"123456789012345678901234567890", "0.000000000000000000000000001234", "2.2250738585072014e-308", "4.9e-324",
+		"1.7976931348623157e308", "1e400", "-1e400", "1e-400",
+	};
+
+	for (const char* text : numbers)
+	{
+		JsonNumber number;
+		const char* end = text + std::strlen(text);
+		ASSERT_EQ(ParseNumber(text, end, number), end) << text;
+		EXPECT_EQ(number.ToDouble(), std::strtod(text, nullptr)) << text;
+	}
 
-	EXPECT_EQ(object.mU8, (uint8_t)257);
-	EXPECT_EQ(object.mFloat, (float)std::numeric_limits<double>::max());
-	EXPECT_EQ(object.mArray[0], 5);
-	EXPECT_EQ(object.mArray[1], 10);
-	EXPECT_EQ(object.mArray[2], 15);
-	EXPECT_EQ(object.mArray[3], 1);// This array is only 3 long, so we shouldn't have deserialized the 4th value.
-	EXPECT_EQ(object.mPadding, 1);
+	for (const char* text : { "-", "1.", ".5", "1e", "1e+", "-x" })
+	{
+		JsonNumber number;
+		EXPECT_EQ(ParseNumber(text, text + std::strlen(text), number), nullptr) << text;
+	}
+
+	// Integers are read exactly, even if they have more digits than a double can hold.
+	for (const uint64_t value : std::initializer_list<uint64_t>{ std::numeric_limits<uint64_t>::max(), 10000000000000000000ull, 12345678901234567891ull, 9007199254740993ull })
+	{
+		const std::string text = std::to_string(value);
+		JsonDeserializer jsonDeserializer(text.c_str());
+
+		uint64_t result = 0;
+		ASSERT_TRUE(jsonDeserializer.ReadUInt(result)) << text;
+		EXPECT_EQ(result, value);
+	}
+
+	for (const int64_t value : std::initializer_list<int64_t>{ std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), -9007199254740993ll })
+	{
+		const std::string text = std::to_string(value);
+		JsonDeserializer jsonDeserializer(text.c_str());
+
+		int64_t result = 0;
+		ASSERT_TRUE(jsonDeserializer.ReadInt(result)) << text;
+		EXPECT_EQ(result, value);
+	}
+
+	// Integers too big for a uint64_t saturate.
+	{
+		JsonDeserializer jsonDeserializer("18446744073709551616");
+
+		uint64_t result = 0;
+		ASSERT_TRUE(jsonDeserializer.ReadUInt(result));
+		EXPECT_EQ(result, std::numeric_limits<uint64_t>::max());
+	}
 }
 
 namespace
@@ -314,4 +655,1863 @@ TEST(SerializerTests, JsonDynamic)
 	EXPECT_EQ(object.mInstances[3]->GetBaseField(), true);
 }
 
-#endif
\ No newline at end of file
+TEST(SerializerTests, JsonSerializeSimpleClass)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(SimpleClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	auto objectResult = deserializer.Deserialize<DeserializeSimple>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+	objectResult->stdstring = "quote \" backslash \\ newline \n control \x01";
+
+	cpprefl::json::JsonSerializer jsonSerializer;
+	cpprefl::serialization::Serializer serializer;
+	serializer.Serialize(jsonSerializer, *objectResult);
+
+	EXPECT_EQ(jsonSerializer.GetString(),
+		R"({"boolValue":true,"intValue":10,"negativeIntValue":-66,"floatValue":3.14,"floatFromIntValue":9,"enumValue":"Bar",)"
+		R"("string":"some string","dynamicString":"some dynamic string","stdstring":"quote \" backslash \\ newline \n control \u0001",)"
+		R"("intArray":[7,14,28,4],"dynamicArray":[1,5,7,12]})");
+
+	// Read the output back in.
+	const std::string json(jsonSerializer.GetString());
+	cpprefl::json::JsonDeserializer roundTripDeserializer(json.c_str());
+	const auto roundTripResult = deserializer.Deserialize<DeserializeSimple>(roundTripDeserializer);
+	ASSERT_TRUE(roundTripResult.has_value());
+	const auto& object = *roundTripResult;
+
+	EXPECT_EQ(object.boolValue, true);
+	EXPECT_EQ(object.intValue, 10);
+	EXPECT_EQ(object.negativeIntValue, -66);
+	EXPECT_EQ(object.floatValue, objectResult->floatValue);
+	EXPECT_EQ(object.enumValue, DeserializeEnum::Bar);
+	EXPECT_STREQ(object.string, "some string");
+	EXPECT_STREQ(object.dynamicString, "some dynamic string");
+	EXPECT_EQ(object.stdstring, objectResult->stdstring);
+	EXPECT_EQ(object.intArray[3], 4);
+	EXPECT_EQ(object.dynamicArray, objectResult->dynamicArray);
+}
+
+TEST(SerializerTests, JsonSerializeNestedClass)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(NestedClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializeNested>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::json::JsonSerializer jsonSerializer;
+	cpprefl::serialization::Serializer serializer;
+	serializer.Serialize(jsonSerializer, *objectResult);
+
+	const std::string json(jsonSerializer.GetString());
+	cpprefl::json::JsonDeserializer roundTripDeserializer(json.c_str());
+	const auto roundTripResult = deserializer.Deserialize<DeserializeNested>(roundTripDeserializer);
+	ASSERT_TRUE(roundTripResult.has_value());
+	const auto& object = *roundTripResult;
+
+	EXPECT_EQ(object.outerBool, false);
+	EXPECT_EQ(object.outerInt, 123456);
+	EXPECT_EQ(object.nested.intValue, 10);
+	EXPECT_EQ(object.nested.enumValue, DeserializeEnum::Bar);
+	EXPECT_STREQ(object.nested.dynamicString, "some dynamic string");
+	EXPECT_EQ(object.nested.dynamicArray, objectResult->nested.dynamicArray);
+
+	EXPECT_EQ(object.arrayOfClasses.size(), 3);
+	EXPECT_EQ(object.arrayOfClasses[0].mBool, true);
+	EXPECT_EQ(object.arrayOfClasses[1].mBool, true);
+	EXPECT_EQ(object.arrayOfClasses[2].mBool, false);
+}
+
+TEST(SerializerTests, JsonSerializeLargeIntegers)
+{
+	for (const uint64_t timestamp : std::initializer_list<uint64_t>{ std::numeric_limits<uint64_t>::max(), 12345678901234567891ull })
+	{
+		for (const bool useGeneratedCode : { false, true })
+		{
+			ColumnarRecord record;
+			record.mTimestamp = timestamp;
+
+			cpprefl::json::JsonSerializer jsonSerializer;
+			cpprefl::serialization::Serializer serializer;
+			serializer.SetUseGeneratedCode(useGeneratedCode);
+			serializer.Serialize(jsonSerializer, record);
+
+			const std::string json(jsonSerializer.GetString());
+			EXPECT_NE(json.find(std::to_string(timestamp)), std::string::npos) << json;
+
+			cpprefl::json::JsonDeserializer jsonDeserializer(json.c_str());
+			cpprefl::serialization::Deserializer deserializer;
+			deserializer.SetUseGeneratedCode(useGeneratedCode);
+			const auto result = deserializer.Deserialize<ColumnarRecord>(jsonDeserializer);
+			ASSERT_TRUE(result.has_value()) << json;
+			EXPECT_EQ(result->mTimestamp, timestamp) << json;
+		}
+	}
+}
+
+TEST(SerializerTests, JsonSerializeDynamic)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(DynamicClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializationDynamic>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::json::JsonSerializer jsonSerializer;
+	cpprefl::serialization::Serializer serializer;
+	serializer.Serialize(jsonSerializer, *objectResult);
+
+	// The runtime class of each instance is written out.
+	EXPECT_EQ(jsonSerializer.GetString(),
+		R"({"mInstances":[{"__type__":"DeserializationClass1","mBaseField":true,"mInt":5},)"
+		R"({"__type__":"DeserializationClass2","mBaseField":true,"mString":"im a string"},)"
+		R"({"__type__":"DeserializationClass1","mBaseField":false,"mInt":15},)"
+		R"({"__type__":"DeserializationClass1","mBaseField":true,"mInt":25}]})");
+
+	const std::string json(jsonSerializer.GetString());
+	cpprefl::json::JsonDeserializer roundTripDeserializer(json.c_str());
+	const auto roundTripResult = deserializer.Deserialize<DeserializationDynamic>(roundTripDeserializer);
+	ASSERT_TRUE(roundTripResult.has_value());
+	const auto& object = *roundTripResult;
+
+	EXPECT_EQ(object.mInstances.size(), 4);
+	EXPECT_EQ(&object.mInstances[1]->GetReflectedClass(), &cpprefl::GetReflectedClass<DeserializationClass2>());
+	EXPECT_STREQ(((DeserializationClass2*)object.mInstances[1])->mString, "im a string");
+	EXPECT_EQ(((DeserializationClass1*)object.mInstances[3])->mInt, 25);
+}
+
+namespace
+{
+	// Reads an object and writes it back out, with or without the generated serialization code.
+	template <typename T>
+	std::string ReadAndWrite(const char* json, bool generatedDeserializer, bool generatedSerializer)
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(json);
+		cpprefl::serialization::Deserializer deserializer;
+		deserializer.SetUseGeneratedCode(generatedDeserializer);
+
+		T object;
+		if (!deserializer.Deserialize(jsonDeserializer, cpprefl::GetReflectedClass<T>(), &object))
+		{
+			return {};
+		}
+
+		cpprefl::json::JsonSerializer jsonSerializer;
+		cpprefl::serialization::Serializer serializer;
+		serializer.SetUseGeneratedCode(generatedSerializer);
+		serializer.Serialize(jsonSerializer, object);
+		return std::string(jsonSerializer.GetString());
+	}
+}
+
+TEST(SerializerTests, JsonGeneratedCode)
+{
+	EXPECT_NE(cpprefl::GetReflectedClass<DeserializeNested>().GetSerializerFunctions(), nullptr);
+	EXPECT_NE(cpprefl::GetReflectedClass<DeserializationClass1>().GetSerializerFunctions(), nullptr);
+
+	// The generated and reflected paths read and write the same data.
+	const std::string nested = ReadAndWrite<DeserializeNested>(NestedClassJson, false, false);
+	EXPECT_FALSE(nested.empty());
+	EXPECT_EQ(ReadAndWrite<DeserializeNested>(NestedClassJson, true, false), nested);
+	EXPECT_EQ(ReadAndWrite<DeserializeNested>(NestedClassJson, false, true), nested);
+	EXPECT_EQ(ReadAndWrite<DeserializeNested>(NestedClassJson, true, true), nested);
+
+	const std::string dynamic = ReadAndWrite<DeserializationDynamic>(DynamicClassJson, false, false);
+	EXPECT_FALSE(dynamic.empty());
+	EXPECT_EQ(ReadAndWrite<DeserializationDynamic>(DynamicClassJson, true, false), dynamic);
+	EXPECT_EQ(ReadAndWrite<DeserializationDynamic>(DynamicClassJson, false, true), dynamic);
+	EXPECT_EQ(ReadAndWrite<DeserializationDynamic>(DynamicClassJson, true, true), dynamic);
+
+	// Unknown keys are skipped by the generated code.
+	cpprefl::json::JsonDeserializer jsonDeserializer(R"({ "unknown": [ 1, { "mBaseField": false } ], "mBaseField": true, "mInt": 7, "mString": "x" })");
+	cpprefl::serialization::Deserializer deserializer;
+	const auto object = deserializer.Deserialize<DeserializationClass1>(jsonDeserializer);
+	ASSERT_TRUE(object.has_value());
+	EXPECT_EQ(object->GetBaseField(), true);
+	EXPECT_EQ(object->mInt, 7);
+}
+
+TEST(SerializerTests, JsonSerializeToSink)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(NestedClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializeNested>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::serialization::Serializer serializer;
+
+	cpprefl::json::JsonSerializer bufferedSerializer;
+	serializer.Serialize(bufferedSerializer, *objectResult);
+
+	// Use a tiny buffer so the output is flushed many times, including strings that are bigger than the buffer.
+	std::string output;
+	int flushes = 0;
+	{
+		struct SinkContext
+		{
+			std::string& mOutput;
+			int& mFlushes;
+		} context{ output, flushes };
+
+		cpprefl::json::JsonSerializer sinkSerializer([](void* contextPtr, const char* data, size_t size)
+		{
+			auto& context = *static_cast<SinkContext*>(contextPtr);
+			context.mOutput.append(data, size);
+			++context.mFlushes;
+		}, &context, 16);
+
+		serializer.Serialize(sinkSerializer, *objectResult);
+	}
+
+	EXPECT_EQ(output, bufferedSerializer.GetString());
+	EXPECT_GT(flushes, 1);
+}
+
+TEST(SerializerTests, JsonParallelArrays)
+{
+	std::string json = R"({"mInstances":[)";
+	for (int i = 0; i < 1000; ++i)
+	{
+		json += i == 0 ? "" : ",";
+		json += i % 3 == 0 ?
+			R"({"__type__":"DeserializationClass2","mString":"string )" + std::to_string(i) + R"("})" :
+			R"({"__type__":"DeserializationClass1","mBaseField":true,"mInt":)" + std::to_string(i) + "}";
+	}
+	json += "]}";
+
+	// The result is the same for any number of threads.
+	for (size_t threadCount : { 1, 4, 8, 16 })
+	{
+		cpprefl::serialization::ThreadPool threadPool(threadCount);
+
+		cpprefl::serialization::Deserializer deserializer;
+		deserializer.SetThreadPool(&threadPool, 16);
+
+		cpprefl::json::JsonDeserializer jsonDeserializer(json.c_str());
+		const auto result = deserializer.Deserialize<DeserializationDynamic>(jsonDeserializer);
+		ASSERT_TRUE(result.has_value());
+		ASSERT_EQ(result->mInstances.size(), 1000);
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			if (i % 3 == 0)
+			{
+				ASSERT_EQ(&result->mInstances[i]->GetReflectedClass(), &cpprefl::GetReflectedClass<DeserializationClass2>());
+				EXPECT_EQ(std::string(((DeserializationClass2*)result->mInstances[i])->mString), "string " + std::to_string(i));
+			}
+			else
+			{
+				ASSERT_EQ(&result->mInstances[i]->GetReflectedClass(), &cpprefl::GetReflectedClass<DeserializationClass1>());
+				EXPECT_EQ(((DeserializationClass1*)result->mInstances[i])->mInt, i);
+			}
+		}
+	}
+
+	// Errors inside a chunk fail the whole object.
+	{
+		json.replace(json.find(R"("mInt":500)"), 10, R"("mInt":"x")");
+
+		cpprefl::serialization::ThreadPool threadPool(4);
+		cpprefl::serialization::Deserializer deserializer;
+		deserializer.SetThreadPool(&threadPool, 16);
+
+		cpprefl::json::JsonDeserializer jsonDeserializer(json.c_str());
+		EXPECT_FALSE(deserializer.Deserialize<DeserializationDynamic>(jsonDeserializer).has_value());
+	}
+}
+
+namespace
+{
+	// Records the fields that changed.
+	class ChangedFieldsDeserializerExtension : public cpprefl::serialization::IObjectDeserializerExtension
+	{
+	public:
+		void OnFieldChanged(void* classObject, const cpprefl::ClassInfo& classInfo, const cpprefl::FieldInfo& fieldInfo) override
+		{
+			mChangedFields.push_back(fieldInfo.mName);
+		}
+
+		std::vector<cpprefl::Name> mChangedFields;
+	};
+}
+
+TEST(SerializerTests, JsonUpdate)
+{
+	const char* json = R"({
+		"mInt": 5,
+		"mString": "a string that doesn't fit into a small string buffer",
+		"mElements": [ { "mBool": true }, { "mBool": false } ],
+		"mMap": { "a": "x", "b": "y" },
+		"mOptional": { "mBool": true },
+		"mPointer": { "mBool": true }
+	})";
+
+	cpprefl::serialization::Deserializer deserializer;
+
+	ChangedFieldsDeserializerExtension extension;
+	deserializer.RegisterExtension(extension);
+
+	DeserializeUpdate object;
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(json);
+		ASSERT_TRUE(deserializer.Update(jsonDeserializer, object));
+		for (const char* field : { "mInt", "mString", "mElements", "mMap", "mOptional", "mPointer" })
+		{
+			EXPECT_NE(std::find(extension.mChangedFields.begin(), extension.mChangedFields.end(), cpprefl::Name(field)), extension.mChangedFields.end()) << field;
+		}
+	}
+
+	const char* string = object.mString.data();
+	const DeserializeDynamicArrayElement* elements = object.mElements.data();
+	const std::string* mapValue = &object.mMap["b"];
+	const DeserializeDynamicArrayElement* optional = &*object.mOptional;
+	const DeserializeDynamicArrayElement* pointer = object.mPointer;
+
+	// Loading the same document again reuses all memory and changes nothing.
+	{
+		extension.mChangedFields.clear();
+
+		cpprefl::json::JsonDeserializer jsonDeserializer(json);
+		bool updated = false;
+		EXPECT_EQ(CountAllocations([&] { updated = deserializer.Update(jsonDeserializer, object); }), 0);
+		ASSERT_TRUE(updated);
+		EXPECT_TRUE(extension.mChangedFields.empty());
+
+		EXPECT_EQ(object.mString.data(), string);
+		EXPECT_EQ(object.mElements.data(), elements);
+		EXPECT_EQ(&object.mMap["b"], mapValue);
+		EXPECT_EQ(&*object.mOptional, optional);
+		EXPECT_EQ(object.mPointer, pointer);
+	}
+
+	// Missing fields are left alone, arrays shrink in place and map entries missing from the input are removed.
+	{
+		extension.mChangedFields.clear();
+
+		cpprefl::json::JsonDeserializer jsonDeserializer(R"({ "mInt": 6, "mElements": [ { "mBool": true } ], "mMap": { "b": "z", "c": "w" }, "mPointer": { "mBool": false } })");
+		ASSERT_TRUE(deserializer.Update(jsonDeserializer, object));
+		EXPECT_EQ(extension.mChangedFields, std::vector<cpprefl::Name>({ cpprefl::Name("mInt"), cpprefl::Name("mElements"), cpprefl::Name("mMap"), cpprefl::Name("mBool"), cpprefl::Name("mPointer") }));
+
+		EXPECT_EQ(object.mInt, 6);
+		EXPECT_EQ(object.mString, "a string that doesn't fit into a small string buffer");
+		ASSERT_EQ(object.mElements.size(), 1);
+		EXPECT_EQ(object.mElements.data(), elements);
+		EXPECT_EQ(object.mMap, (std::map<std::string, std::string>{ { "b", "z" }, { "c", "w" } }));
+		EXPECT_EQ(&object.mMap["b"], mapValue);
+		EXPECT_TRUE(object.mOptional.has_value());
+		EXPECT_EQ(object.mPointer, pointer);
+		EXPECT_FALSE(object.mPointer->mBool);
+	}
+}
+
+TEST(SerializerTests, JsonUpdateDynamic)
+{
+	cpprefl::serialization::Deserializer deserializer;
+
+	DeserializationDynamic object;
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(DynamicClassJson);
+		ASSERT_TRUE(deserializer.Update(jsonDeserializer, object));
+		ASSERT_EQ(object.mInstances.size(), 4);
+	}
+
+	const std::vector<DeserializationBase*> instances = object.mInstances;
+
+	// Objects of the same class are updated in place.
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(DynamicClassJson);
+		bool updated = false;
+		EXPECT_EQ(CountAllocations([&] { updated = deserializer.Update(jsonDeserializer, object); }), 0);
+		ASSERT_TRUE(updated);
+		EXPECT_EQ(object.mInstances, instances);
+	}
+
+	// Objects of another class are replaced, and removed objects are freed.
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(R"({ "mInstances": [ { "__type__": "DeserializationClass2", "mString": "replaced" }, { "__type__": "DeserializationClass2", "mString": "kept" } ] })");
+		ASSERT_TRUE(deserializer.Update(jsonDeserializer, object));
+		ASSERT_EQ(object.mInstances.size(), 2);
+		EXPECT_EQ(&object.mInstances[0]->GetReflectedClass(), &cpprefl::GetReflectedClass<DeserializationClass2>());
+		EXPECT_STREQ(((DeserializationClass2*)object.mInstances[0])->mString, "replaced");
+		EXPECT_EQ(object.mInstances[1], instances[1]);
+		EXPECT_STREQ(((DeserializationClass2*)object.mInstances[1])->mString, "kept");
+	}
+
+	// Replaced strings are freed.
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(R"({ "mInstances": [ null, { "__type__": "DeserializationClass2", "mString": null } ] })");
+		ASSERT_TRUE(deserializer.Update(jsonDeserializer, object));
+		EXPECT_EQ(object.mInstances[0], nullptr);
+		EXPECT_EQ(((DeserializationClass2*)object.mInstances[1])->mString, nullptr);
+	}
+}
+
+TEST(SerializerTests, JsonNumberArrays)
+{
+	const char* json = R"({ "mBytes": [ 1, 255, 257, 3, 4 ], "mDoubles": [ 0.5, -7 ], "mFloats": [ 1.5, 2, -3, 1e300 ], "mShorts": [ -5, 70000 ] })";
+
+	cpprefl::serialization::Deserializer deserializer;
+
+	ChangedFieldsDeserializerExtension extension;
+	deserializer.RegisterExtension(extension);
+
+	DeserializeNumberArrays object;
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(json);
+		ASSERT_TRUE(deserializer.Update(jsonDeserializer, object));
+		EXPECT_EQ(extension.mChangedFields.size(), 4);
+	}
+
+	// Values that don't fit are truncated, like single values.
+	EXPECT_EQ(std::vector<uint8_t>(object.mBytes, object.mBytes + 4), std::vector<uint8_t>({ 1, 255, 1, 3 }));
+	EXPECT_EQ(object.mDoubles[0], 0.5);
+	EXPECT_EQ(object.mDoubles[1], -7.0);
+	EXPECT_EQ(object.mFloats, std::vector<float>({ 1.5f, 2.0f, -3.0f, std::numeric_limits<float>::infinity() }));
+	EXPECT_EQ(object.mShorts, std::vector<int16_t>({ -5, (int16_t)70000 }));
+
+	// Loading the same values again changes nothing, and only changed arrays are reported.
+	{
+		extension.mChangedFields.clear();
+
+		cpprefl::json::JsonDeserializer jsonDeserializer(json);
+		ASSERT_TRUE(deserializer.Update(jsonDeserializer, object));
+		EXPECT_TRUE(extension.mChangedFields.empty());
+	}
+
+	{
+		extension.mChangedFields.clear();
+
+		cpprefl::json::JsonDeserializer jsonDeserializer(R"({ "mBytes": [ 1, 255, 1, 3 ], "mDoubles": [ 0.5, -8 ], "mFloats": [ 1.5, 2 ] })");
+		ASSERT_TRUE(deserializer.Update(jsonDeserializer, object));
+		EXPECT_EQ(extension.mChangedFields, std::vector<cpprefl::Name>({ cpprefl::Name("mDoubles"), cpprefl::Name("mFloats") }));
+		EXPECT_EQ(object.mFloats, std::vector<float>({ 1.5f, 2.0f }));
+	}
+
+	// Arrays of numbers are written back the same way.
+	cpprefl::json::JsonSerializer jsonSerializer;
+	cpprefl::serialization::Serializer serializer;
+	serializer.Serialize(jsonSerializer, object);
+
+	const std::string written(jsonSerializer.GetString());
+	cpprefl::json::JsonDeserializer jsonDeserializer(written.c_str());
+	const auto copy = deserializer.Deserialize<DeserializeNumberArrays>(jsonDeserializer);
+	ASSERT_TRUE(copy.has_value());
+	EXPECT_EQ(std::memcmp(copy->mBytes, object.mBytes, sizeof(object.mBytes)), 0);
+	EXPECT_EQ(copy->mDoubles[1], -8.0);
+	EXPECT_EQ(copy->mFloats, object.mFloats);
+	EXPECT_EQ(copy->mShorts, object.mShorts);
+}
+
+TEST(SerializerTests, JsonStream)
+{
+	// Unknown fields are skipped, including brackets and escaped quotes inside of strings.
+	std::string json = NestedClassJson;
+	json.replace(json.find(R"("outerBool")"), 0, R"("unknown": { "a": [ "}\"]", 1.5e3 ], "b": null }, )");
+	json.replace(json.find("some std::string value"), 4, R"(\"some\")");
+
+	// The result is the same no matter where the input is split.
+	for (size_t chunkSize : { 1, 2, 3, 7, 64, 4096 })
+	{
+		DeserializeNested object;
+
+		cpprefl::serialization::Deserializer deserializer;
+		cpprefl::json::JsonStreamDeserializer stream(deserializer, object);
+		for (size_t i = 0; i < json.size(); i += chunkSize)
+		{
+			// Copy each chunk, the stream must not hold on to its input.
+			const std::string chunk = json.substr(i, chunkSize);
+			ASSERT_NE(stream.Feed(chunk), cpprefl::json::JsonStreamStatus::Error);
+		}
+		ASSERT_EQ(stream.Finish(), cpprefl::json::JsonStreamStatus::Done);
+
+		EXPECT_EQ(object.outerBool, false);
+		EXPECT_EQ(object.outerInt, 123456);
+		EXPECT_EQ(object.nested.intValue, 10);
+		EXPECT_EQ(object.nested.negativeIntValue, -66);
+		EXPECT_FLOAT_EQ(object.nested.floatValue, 3.14f);
+		EXPECT_EQ(object.nested.enumValue, DeserializeEnum::Bar);
+		EXPECT_STREQ(object.nested.string, "some string");
+		EXPECT_STREQ(object.nested.dynamicString, "some dynamic string");
+		EXPECT_STREQ(object.nested.stdstring.c_str(), "\"some\" std::string value");
+		EXPECT_EQ(object.nested.intArray[3], 4);
+		EXPECT_EQ(object.nested.dynamicArray, std::vector<int>({ 1, 5, 7, 12 }));
+
+		ASSERT_EQ(object.arrayOfClasses.size(), 3);
+		EXPECT_EQ(object.arrayOfClasses[0].mBool, true);
+		EXPECT_EQ(object.arrayOfClasses[1].mBool, true);
+		EXPECT_EQ(object.arrayOfClasses[2].mBool, false);
+	}
+
+	// Pointers are decoded polymorphically.
+	{
+		DeserializationDynamic object;
+
+		cpprefl::serialization::Deserializer deserializer;
+		cpprefl::json::JsonStreamDeserializer stream(deserializer, object);
+		for (const char* current = DynamicClassJson; *current != 0; current += std::min<size_t>(std::strlen(current), 5))
+		{
+			stream.Feed(current, std::min<size_t>(std::strlen(current), 5));
+		}
+		ASSERT_EQ(stream.Finish(), cpprefl::json::JsonStreamStatus::Done);
+
+		ASSERT_EQ(object.mInstances.size(), 4);
+		ASSERT_EQ(&object.mInstances[1]->GetReflectedClass(), &cpprefl::GetReflectedClass<DeserializationClass2>());
+		EXPECT_STREQ(((DeserializationClass2*)object.mInstances[1])->mString, "im a string");
+	}
+
+	// Arrays of numbers and pointers are decoded one element at a time, so only a single element is ever buffered.
+	{
+		std::string numbersJson = R"({"mFloats": [)";
+		std::string instancesJson = R"({"mInstances": [)";
+		for (int i = 0; i < 10000; ++i)
+		{
+			numbersJson += (i == 0 ? "" : ", ") + std::to_string(i) + ".5";
+			instancesJson += (i == 0 ? "" : ", ") + std::string(R"({"__type__": "DeserializationClass1", "mInt": )") + std::to_string(i) + "}";
+		}
+		numbersJson += R"(], "mShorts": [1, -2, 3]})";
+		instancesJson += "]}";
+
+		DeserializeNumberArrays numbers;
+		DeserializationDynamic instances;
+
+		cpprefl::serialization::Deserializer deserializer;
+		cpprefl::json::JsonStreamDeserializer numbersStream(deserializer, numbers);
+		cpprefl::json::JsonStreamDeserializer instancesStream(deserializer, instances);
+		for (size_t i = 0; i < instancesJson.size(); i += 16)
+		{
+			if (i < numbersJson.size())
+			{
+				ASSERT_NE(numbersStream.Feed(numbersJson.substr(i, 16)), cpprefl::json::JsonStreamStatus::Error);
+			}
+			ASSERT_NE(instancesStream.Feed(instancesJson.substr(i, 16)), cpprefl::json::JsonStreamStatus::Error);
+		}
+		ASSERT_EQ(numbersStream.Finish(), cpprefl::json::JsonStreamStatus::Done);
+		ASSERT_EQ(instancesStream.Finish(), cpprefl::json::JsonStreamStatus::Done);
+		EXPECT_LT(numbersStream.GetBufferCapacity(), 64);
+		EXPECT_LT(instancesStream.GetBufferCapacity(), 128);
+
+		ASSERT_EQ(numbers.mFloats.size(), 10000);
+		EXPECT_EQ(numbers.mFloats[9999], 9999.5f);
+		EXPECT_EQ(numbers.mShorts, std::vector<int16_t>({ 1, -2, 3 }));
+
+		ASSERT_EQ(instances.mInstances.size(), 10000);
+		ASSERT_EQ(&instances.mInstances[9999]->GetReflectedClass(), &cpprefl::GetReflectedClass<DeserializationClass1>());
+		EXPECT_EQ(((DeserializationClass1*)instances.mInstances[9999])->mInt, 9999);
+	}
+
+	// Incomplete documents, trailing data and malformed values are errors.
+	for (const char* invalid : { R"({"outerInt": 5)", R"({"outerInt": 5} 1)", R"({"outerInt": 5x})", R"({"nested": [1]})", "asdf" })
+	{
+		DeserializeNested object;
+
+		cpprefl::serialization::Deserializer deserializer;
+		cpprefl::json::JsonStreamDeserializer stream(deserializer, object);
+		stream.Feed(invalid, std::strlen(invalid));
+		EXPECT_EQ(stream.Finish(), cpprefl::json::JsonStreamStatus::Error) << invalid;
+	}
+}
+
+TEST(SerializerTests, JsonStreamFieldChanged)
+{
+	// Extensions hear about the same fields, in the same order, as when the whole document is deserialized at once. That includes
+	// the fields holding nested objects and arrays, which are reported once they are complete.
+	cpprefl::serialization::Deserializer deserializer;
+
+	ChangedFieldsDeserializerExtension extension;
+	deserializer.RegisterExtension(extension);
+
+	DeserializeNested expected{};
+	cpprefl::json::JsonDeserializer jsonDeserializer(NestedClassJson);
+	ASSERT_TRUE(deserializer.Deserialize(jsonDeserializer, cpprefl::GetReflectedClass<DeserializeNested>(), &expected));
+	const std::vector<cpprefl::Name> expectedFields = extension.mChangedFields;
+	EXPECT_NE(std::find(expectedFields.begin(), expectedFields.end(), cpprefl::Name("nested")), expectedFields.end());
+	EXPECT_NE(std::find(expectedFields.begin(), expectedFields.end(), cpprefl::Name("arrayOfClasses")), expectedFields.end());
+
+	for (size_t chunkSize : { 1, 7, 4096 })
+	{
+		extension.mChangedFields.clear();
+
+		DeserializeNested object{};
+		cpprefl::json::JsonStreamDeserializer stream(deserializer, object);
+		const std::string_view json = NestedClassJson;
+		for (size_t i = 0; i < json.size(); i += chunkSize)
+		{
+			ASSERT_NE(stream.Feed(json.substr(i, chunkSize)), cpprefl::json::JsonStreamStatus::Error);
+		}
+		ASSERT_EQ(stream.Finish(), cpprefl::json::JsonStreamStatus::Done);
+
+		EXPECT_EQ(extension.mChangedFields, expectedFields) << chunkSize;
+	}
+}
+
+TEST(SerializerTests, BinarySimpleClass)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(SimpleClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializeSimple>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::binary::BinarySerializer binarySerializer;
+	binarySerializer.Serialize(*objectResult);
+
+	const auto& buffer = binarySerializer.GetBuffer();
+	cpprefl::binary::BinaryDeserializer binaryDeserializer(buffer.data(), buffer.size());
+	const auto roundTripResult = binaryDeserializer.Deserialize<DeserializeSimple>();
+	ASSERT_TRUE(roundTripResult.has_value());
+	const auto& object = *roundTripResult;
+
+	EXPECT_EQ(object.boolValue, true);
+	EXPECT_EQ(object.intValue, 10);
+	EXPECT_EQ(object.negativeIntValue, -66);
+	EXPECT_FLOAT_EQ(object.floatValue, 3.14f);
+	EXPECT_FLOAT_EQ(object.floatFromIntValue, 9.0f);
+	EXPECT_EQ(object.enumValue, DeserializeEnum::Bar);
+	EXPECT_STREQ(object.string, "some string");
+	EXPECT_STREQ(object.dynamicString, "some dynamic string");
+	EXPECT_EQ(object.stdstring, "some std::string value");
+	EXPECT_EQ(object.intArray[0], 7);
+	EXPECT_EQ(object.intArray[3], 4);
+	EXPECT_EQ(object.dynamicArray, objectResult->dynamicArray);
+}
+
+TEST(SerializerTests, BinarySchema)
+{
+	cpprefl::binary::BinarySchemaCache schemas;
+	const auto& schema = schemas.GetSchema(cpprefl::GetReflectedClass<DeserializeSimple>());
+
+	// Adjacent trivially copyable fields are merged: [boolValue] [intValue..string] dynamicString stdstring [intArray] dynamicArray
+	ASSERT_EQ(schema.mSteps.size(), 6);
+	EXPECT_EQ(schema.mSteps[0].mField, nullptr);
+	EXPECT_EQ(schema.mSteps[1].mField, nullptr);
+	EXPECT_EQ(schema.mSteps[1].mOffset, offsetof(DeserializeSimple, intValue));
+	EXPECT_EQ(schema.mSteps[1].mSize, offsetof(DeserializeSimple, string) + sizeof(DeserializeSimple::string) - offsetof(DeserializeSimple, intValue));
+	EXPECT_EQ(schema.mSteps[2].mField->mName, cpprefl::Name("dynamicString"));
+	EXPECT_EQ(schema.mSteps[4].mField, nullptr);
+	EXPECT_EQ(schema.mSteps[4].mSize, sizeof(DeserializeSimple::intArray));
+
+	// Different layouts have different fingerprints.
+	EXPECT_FALSE(schema.mFingerprint == schemas.GetSchema(cpprefl::GetReflectedClass<DeserializeNested>()).mFingerprint);
+	EXPECT_FALSE(schemas.GetSchema(cpprefl::GetReflectedClass<DeserializationClass1>()).mFingerprint == schemas.GetSchema(cpprefl::GetReflectedClass<DeserializationClass2>()).mFingerprint);
+}
+
+TEST(SerializerTests, BinaryNestedClass)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(NestedClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializeNested>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::binary::BinarySerializer binarySerializer;
+	binarySerializer.Serialize(*objectResult);
+
+	const auto& buffer = binarySerializer.GetBuffer();
+	cpprefl::binary::BinaryDeserializer binaryDeserializer(buffer.data(), buffer.size());
+	const auto roundTripResult = binaryDeserializer.Deserialize<DeserializeNested>();
+	ASSERT_TRUE(roundTripResult.has_value());
+	const auto& object = *roundTripResult;
+
+	EXPECT_EQ(object.outerBool, false);
+	EXPECT_EQ(object.outerInt, 123456);
+	EXPECT_EQ(object.nested.intValue, 10);
+	EXPECT_EQ(object.nested.enumValue, DeserializeEnum::Bar);
+	EXPECT_STREQ(object.nested.dynamicString, "some dynamic string");
+	EXPECT_EQ(object.nested.stdstring, "some std::string value");
+	EXPECT_EQ(object.nested.dynamicArray, objectResult->nested.dynamicArray);
+
+	EXPECT_EQ(object.arrayOfClasses.size(), 3);
+	EXPECT_EQ(object.arrayOfClasses[0].mBool, true);
+	EXPECT_EQ(object.arrayOfClasses[1].mBool, true);
+	EXPECT_EQ(object.arrayOfClasses[2].mBool, false);
+}
+
+TEST(SerializerTests, BinaryDynamic)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(DynamicClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializationDynamic>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::binary::BinarySerializer binarySerializer;
+	binarySerializer.Serialize(*objectResult);
+
+	const auto& buffer = binarySerializer.GetBuffer();
+	cpprefl::binary::BinaryDeserializer binaryDeserializer(buffer.data(), buffer.size());
+	const auto roundTripResult = binaryDeserializer.Deserialize<DeserializationDynamic>();
+	ASSERT_TRUE(roundTripResult.has_value());
+	const auto& object = *roundTripResult;
+
+	ASSERT_EQ(object.mInstances.size(), 4);
+	EXPECT_EQ(&object.mInstances[0]->GetReflectedClass(), &cpprefl::GetReflectedClass<DeserializationClass1>());
+	EXPECT_EQ(((DeserializationClass1*)object.mInstances[0])->mInt, 5);
+	EXPECT_EQ(&object.mInstances[1]->GetReflectedClass(), &cpprefl::GetReflectedClass<DeserializationClass2>());
+	EXPECT_STREQ(((DeserializationClass2*)object.mInstances[1])->mString, "im a string");
+	EXPECT_EQ(object.mInstances[2]->GetBaseField(), false);
+	EXPECT_EQ(((DeserializationClass1*)object.mInstances[3])->mInt, 25);
+}
+
+TEST(SerializerTests, BinaryInvalid)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(SimpleClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializeSimple>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::binary::BinarySerializer binarySerializer;
+	binarySerializer.Serialize(*objectResult);
+	const auto& buffer = binarySerializer.GetBuffer();
+
+	// Written with a different class.
+	{
+		cpprefl::binary::BinaryDeserializer binaryDeserializer(buffer.data(), buffer.size());
+		EXPECT_FALSE(binaryDeserializer.Deserialize<DeserializeNested>().has_value());
+		EXPECT_TRUE(binaryDeserializer.HasError());
+	}
+
+	// Truncated.
+	{
+		cpprefl::binary::BinaryDeserializer binaryDeserializer(buffer.data(), buffer.size() - 1);
+		EXPECT_FALSE(binaryDeserializer.Deserialize<DeserializeSimple>().has_value());
+		EXPECT_TRUE(binaryDeserializer.HasError());
+	}
+}
+
+TEST(SerializerTests, BinaryFieldChanges)
+{
+	DeserializationClass1 pointed;
+	pointed.mInt = 8;
+
+	BinaryVersion1 oldObject;
+	oldObject.mKept = 1;
+	oldObject.mWidened = -300;
+	oldObject.mToDouble = 2.5f;
+	oldObject.mRemoved = "removed";
+	oldObject.mRemovedInt = 3;
+	oldObject.mMoved = 4;
+	oldObject.mArray[0] = 5;
+	oldObject.mArray[1] = 6;
+	oldObject.mArray[2] = 7;
+	oldObject.mVector = { 1, 2, 3 };
+	oldObject.mPointer = &pointed;
+
+	cpprefl::binary::BinarySerializer binarySerializer;
+	binarySerializer.Serialize(oldObject);
+	binarySerializer.Serialize(oldObject);
+
+	// Pretend the data was written by an older build of BinaryVersion2.
+	std::vector<std::byte> buffer = binarySerializer.GetBuffer();
+	const std::string_view oldName = "BinaryVersion1";
+	const auto name = std::search(buffer.begin(), buffer.end(), (const std::byte*)oldName.data(), (const std::byte*)oldName.data() + oldName.size());
+	ASSERT_NE(name, buffer.end());
+	name[oldName.size() - 1] = (std::byte)'2';
+
+	// The second object is loaded with the plan built for the first one.
+	cpprefl::binary::BinaryDeserializer binaryDeserializer(buffer.data(), buffer.size());
+	for (int i = 0; i < 2; ++i)
+	{
+		const auto result = binaryDeserializer.Deserialize<BinaryVersion2>();
+		ASSERT_TRUE(result.has_value());
+		const auto& object = *result;
+
+		EXPECT_EQ(object.mKept, 1);
+		EXPECT_EQ(object.mWidened, -300);
+		EXPECT_EQ(object.mToDouble, 2.5);
+		EXPECT_EQ(object.mMoved, 4);
+		EXPECT_EQ(object.mAdded, 42);
+		EXPECT_EQ(object.mArray[0], 5);
+		EXPECT_EQ(object.mArray[1], 6);
+		EXPECT_EQ(object.mVector, std::vector<float>({ 1.0f, 2.0f, 3.0f }));
+
+		ASSERT_NE(object.mPointer, nullptr);
+		EXPECT_EQ(((DeserializationClass1*)object.mPointer)->mInt, 8);
+	}
+
+	EXPECT_FALSE(binaryDeserializer.HasError());
+}
+
+TEST(SerializerTests, FrozenBlob)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(NestedClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializeNested>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::frozen::FrozenWriter writer;
+	writer.Freeze(*objectResult);
+
+	// Copy the blob, it must not depend on where it lives in memory.
+	const std::vector<std::byte> blob = writer.GetBuffer();
+	const auto root = cpprefl::frozen::OpenFrozenBlob<DeserializeNested>(blob.data(), blob.size());
+	ASSERT_TRUE(root.IsValid());
+
+	EXPECT_EQ(*root.GetValue<bool>(cpprefl::Name("outerBool")), false);
+	EXPECT_EQ(*root.GetValue<int>(cpprefl::Name("outerInt")), 123456);
+	EXPECT_EQ(root.GetValue<float>(cpprefl::Name("outerInt")), nullptr);
+
+	const auto nested = root.GetObject(cpprefl::Name("nested"));
+	ASSERT_TRUE(nested.IsValid());
+	EXPECT_EQ(*nested.GetValue<DeserializeEnum>(cpprefl::Name("enumValue")), DeserializeEnum::Bar);
+	EXPECT_EQ(nested.GetString(cpprefl::Name("string")), "some string");
+	EXPECT_EQ(nested.GetString(cpprefl::Name("dynamicString")), "some dynamic string");
+	EXPECT_EQ(nested.GetString(cpprefl::Name("stdstring")), "some std::string value");
+
+	const auto intArray = nested.GetArray(cpprefl::Name("intArray"));
+	ASSERT_EQ(intArray.size(), 4);
+	EXPECT_EQ(intArray.GetData<int>()[2], 28);
+
+	const auto dynamicArray = nested.GetArray(cpprefl::Name("dynamicArray"));
+	ASSERT_EQ(dynamicArray.size(), 4);
+	EXPECT_EQ(dynamicArray.GetData<int>()[3], 12);
+
+	const auto arrayOfClasses = root.GetArray(cpprefl::Name("arrayOfClasses"));
+	ASSERT_EQ(arrayOfClasses.size(), 3);
+	EXPECT_EQ(*arrayOfClasses.GetObject(0).GetValue<bool>(cpprefl::Name("mBool")), true);
+	EXPECT_EQ(*arrayOfClasses.GetObject(2).GetValue<bool>(cpprefl::Name("mBool")), false);
+
+	// Opening as the wrong class fails.
+	EXPECT_FALSE(cpprefl::frozen::OpenFrozenBlob<DeserializeSimple>(blob.data(), blob.size()).IsValid());
+	EXPECT_FALSE(cpprefl::frozen::OpenFrozenBlob<DeserializeNested>(blob.data(), blob.size() - 1).IsValid());
+}
+
+TEST(SerializerTests, FrozenBlobMappedFile)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(DynamicClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializationDynamic>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	const std::string path = testing::TempDir() + "FrozenBlobMappedFile.bin";
+
+	cpprefl::frozen::FrozenWriter writer;
+	writer.Freeze(*objectResult);
+	ASSERT_TRUE(writer.WriteToFile(path.c_str()));
+
+	cpprefl::serialization::MappedFile file;
+	ASSERT_TRUE(file.Open(path.c_str()));
+
+	const auto root = cpprefl::frozen::OpenFrozenBlob<DeserializationDynamic>(file.GetData(), file.GetSize());
+	ASSERT_TRUE(root.IsValid());
+
+	// Pointers resolve to objects of their runtime class.
+	const auto instances = root.GetArray(cpprefl::Name("mInstances"));
+	ASSERT_EQ(instances.size(), 4);
+	EXPECT_EQ(&instances.GetObject(0).GetClass(), &cpprefl::GetReflectedClass<DeserializationClass1>());
+	EXPECT_EQ(*instances.GetObject(0).GetValue<int>(cpprefl::Name("mInt")), 5);
+	EXPECT_EQ(*instances.GetObject(0).GetValue<bool>(cpprefl::Name("mBaseField")), true);
+	EXPECT_EQ(&instances.GetObject(1).GetClass(), &cpprefl::GetReflectedClass<DeserializationClass2>());
+	EXPECT_EQ(instances.GetObject(1).GetString(cpprefl::Name("mString")), "im a string");
+	EXPECT_EQ(*instances.GetObject(3).GetValue<int>(cpprefl::Name("mInt")), 25);
+
+	file.Close();
+	std::remove(path.c_str());
+}
+
+namespace
+{
+	// Written by reference MessagePack/CBOR encoders: SimpleClassJson with floats as single precision, in field order.
+	const uint8_t SimpleClassMsgPack[] =
+	{
+		0x8b, 0xa9, 0x62, 0x6f, 0x6f, 0x6c, 0x56, 0x61, 0x6c, 0x75, 0x65, 0xc3, 0xa8, 0x69, 0x6e, 0x74,
+		0x56, 0x61, 0x6c, 0x75, 0x65, 0x0a, 0xb0, 0x6e, 0x65, 0x67, 0x61, 0x74, 0x69, 0x76, 0x65, 0x49,
+		0x6e, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65, 0xd0, 0xbe, 0xaa, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x56,
+		0x61, 0x6c, 0x75, 0x65, 0xca, 0x40, 0x48, 0xf5, 0xc3, 0xb1, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x46,
+		0x72, 0x6f, 0x6d, 0x49, 0x6e, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65, 0xca, 0x41, 0x10, 0x00, 0x00,
+		0xa9, 0x65, 0x6e, 0x75, 0x6d, 0x56, 0x61, 0x6c, 0x75, 0x65, 0xa3, 0x42, 0x61, 0x72, 0xa6, 0x73,
+		0x74, 0x72, 0x69, 0x6e, 0x67, 0xab, 0x73, 0x6f, 0x6d, 0x65, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6e,
+		0x67, 0xad, 0x64, 0x79, 0x6e, 0x61, 0x6d, 0x69, 0x63, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0xb3,
+		0x73, 0x6f, 0x6d, 0x65, 0x20, 0x64, 0x79, 0x6e, 0x61, 0x6d, 0x69, 0x63, 0x20, 0x73, 0x74, 0x72,
+		0x69, 0x6e, 0x67, 0xa9, 0x73, 0x74, 0x64, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0xb6, 0x73, 0x6f,
+		0x6d, 0x65, 0x20, 0x73, 0x74, 0x64, 0x3a, 0x3a, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x20, 0x76,
+		0x61, 0x6c, 0x75, 0x65, 0xa8, 0x69, 0x6e, 0x74, 0x41, 0x72, 0x72, 0x61, 0x79, 0x94, 0x07, 0x0e,
+		0x1c, 0x04, 0xac, 0x64, 0x79, 0x6e, 0x61, 0x6d, 0x69, 0x63, 0x41, 0x72, 0x72, 0x61, 0x79, 0x94,
+		0x01, 0x05, 0x07, 0x0c,
+	};
+
+	const uint8_t SimpleClassCbor[] =
+	{
+		0xab, 0x69, 0x62, 0x6f, 0x6f, 0x6c, 0x56, 0x61, 0x6c, 0x75, 0x65, 0xf5, 0x68, 0x69, 0x6e, 0x74,
+		0x56, 0x61, 0x6c, 0x75, 0x65, 0x0a, 0x70, 0x6e, 0x65, 0x67, 0x61, 0x74, 0x69, 0x76, 0x65, 0x49,
+		0x6e, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x38, 0x41, 0x6a, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x56,
+		0x61, 0x6c, 0x75, 0x65, 0xfa, 0x40, 0x48, 0xf5, 0xc3, 0x71, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x46,
+		0x72, 0x6f, 0x6d, 0x49, 0x6e, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65, 0xfa, 0x41, 0x10, 0x00, 0x00,
+		0x69, 0x65, 0x6e, 0x75, 0x6d, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x63, 0x42, 0x61, 0x72, 0x66, 0x73,
+		0x74, 0x72, 0x69, 0x6e, 0x67, 0x6b, 0x73, 0x6f, 0x6d, 0x65, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6e,
+		0x67, 0x6d, 0x64, 0x79, 0x6e, 0x61, 0x6d, 0x69, 0x63, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x73,
+		0x73, 0x6f, 0x6d, 0x65, 0x20, 0x64, 0x79, 0x6e, 0x61, 0x6d, 0x69, 0x63, 0x20, 0x73, 0x74, 0x72,
+		0x69, 0x6e, 0x67, 0x69, 0x73, 0x74, 0x64, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x76, 0x73, 0x6f,
+		0x6d, 0x65, 0x20, 0x73, 0x74, 0x64, 0x3a, 0x3a, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x20, 0x76,
+		0x61, 0x6c, 0x75, 0x65, 0x68, 0x69, 0x6e, 0x74, 0x41, 0x72, 0x72, 0x61, 0x79, 0x84, 0x07, 0x0e,
+		0x18, 0x1c, 0x04, 0x6c, 0x64, 0x79, 0x6e, 0x61, 0x6d, 0x69, 0x63, 0x41, 0x72, 0x72, 0x61, 0x79,
+		0x84, 0x01, 0x05, 0x07, 0x0c,
+	};
+
+	// Encodings the serializers don't produce: wider integers, doubles, enums by value, binary strings, ext/tagged values in an
+	// unknown field and larger arrays. The CBOR data is in canonical form, with sorted keys and half precision floats.
+	const uint8_t SimpleClassMsgPackVariants[] =
+	{
+		0x87, 0xa8, 0x69, 0x6e, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65, 0xce, 0x00, 0x01, 0x11, 0x70, 0xb0,
+		0x6e, 0x65, 0x67, 0x61, 0x74, 0x69, 0x76, 0x65, 0x49, 0x6e, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65,
+		0xd2, 0xff, 0xff, 0x63, 0xc0, 0xaa, 0x66, 0x6c, 0x6f, 0x61, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65,
+		0xcb, 0x3f, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa9, 0x65, 0x6e, 0x75, 0x6d, 0x56, 0x61,
+		0x6c, 0x75, 0x65, 0x0b, 0xa6, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0xc4, 0x05, 0x62, 0x79, 0x74,
+		0x65, 0x73, 0xa7, 0x75, 0x6e, 0x6b, 0x6e, 0x6f, 0x77, 0x6e, 0x94, 0xc7, 0x03, 0x01, 0x61, 0x62,
+		0x63, 0x81, 0xa1, 0x61, 0x93, 0x01, 0x02, 0x80, 0xc0, 0xcb, 0x3f, 0xf8, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0xac, 0x64, 0x79, 0x6e, 0x61, 0x6d, 0x69, 0x63, 0x41, 0x72, 0x72, 0x61, 0x79, 0xdc,
+		0x00, 0x14, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d,
+		0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13,
+	};
+
+	const uint8_t SimpleClassCborVariants[] =
+	{
+		0xa7, 0x66, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x45, 0x62, 0x79, 0x74, 0x65, 0x73, 0x67, 0x75,
+		0x6e, 0x6b, 0x6e, 0x6f, 0x77, 0x6e, 0x84, 0xc1, 0x1a, 0x5f, 0x5e, 0x10, 0x00, 0xa1, 0x61, 0x61,
+		0x81, 0x01, 0xf6, 0xf7, 0x68, 0x69, 0x6e, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x1a, 0x00, 0x01,
+		0x11, 0x70, 0x69, 0x65, 0x6e, 0x75, 0x6d, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x0b, 0x6a, 0x66, 0x6c,
+		0x6f, 0x61, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65, 0xf9, 0x38, 0x00, 0x6c, 0x64, 0x79, 0x6e, 0x61,
+		0x6d, 0x69, 0x63, 0x41, 0x72, 0x72, 0x61, 0x79, 0x98, 0x1e, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+		0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+		0x16, 0x17, 0x18, 0x18, 0x18, 0x19, 0x18, 0x1a, 0x18, 0x1b, 0x18, 0x1c, 0x18, 0x1d, 0x70, 0x6e,
+		0x65, 0x67, 0x61, 0x74, 0x69, 0x76, 0x65, 0x49, 0x6e, 0x74, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x39,
+		0x9c, 0x3f,
+	};
+
+	// CBOR with indefinite lengths: { "mString": "ab" "c", "mElements": [ { "mBool": true }, { "mBool": false } ], "mMap": { 1: "x" }, "mInt": -5 }
+	const uint8_t UpdateClassCborIndefinite[] =
+	{
+		0xbf,
+		0x67, 'm', 'S', 't', 'r', 'i', 'n', 'g', 0x7f, 0x62, 'a', 'b', 0x61, 'c', 0xff,
+		0x69, 'm', 'E', 'l', 'e', 'm', 'e', 'n', 't', 's', 0x9f,
+			0xa1, 0x65, 'm', 'B', 'o', 'o', 'l', 0xf5,
+			0xa1, 0x65, 'm', 'B', 'o', 'o', 'l', 0xf4,
+			0xff,
+		0x64, 'm', 'M', 'a', 'p', 0xbf, 0x01, 0x61, 'x', 0xff,
+		0x64, 'm', 'I', 'n', 't', 0x24,
+		0xff,
+	};
+
+	template <size_t Size>
+	std::vector<std::byte> ToBytes(const uint8_t (&data)[Size])
+	{
+		return std::vector<std::byte>((const std::byte*)data, (const std::byte*)data + Size);
+	}
+
+	template <typename T, typename Reader>
+	std::optional<T> DeserializeBytes(const std::vector<std::byte>& data, cpprefl::serialization::ThreadPool* threadPool = nullptr)
+	{
+		Reader reader(data.data(), data.size());
+
+		cpprefl::serialization::Deserializer deserializer;
+		if (threadPool != nullptr)
+		{
+			deserializer.SetThreadPool(threadPool, 16);
+		}
+
+		auto result = deserializer.Deserialize<T>(reader);
+		if (!reader.IsAtEnd())
+		{
+			return std::nullopt;
+		}
+
+		return result;
+	}
+
+	// Reads a JSON document, passes it through a binary writer and reader, and writes it back out as JSON.
+	template <typename T, typename Writer, typename Reader>
+	std::string RoundTripJson(const char* json, cpprefl::serialization::ThreadPool* threadPool = nullptr)
+	{
+		cpprefl::json::JsonDeserializer jsonDeserializer(json);
+		cpprefl::serialization::Deserializer deserializer;
+		const auto object = deserializer.Deserialize<T>(jsonDeserializer);
+		if (!object.has_value())
+		{
+			return {};
+		}
+
+		Writer writer;
+		cpprefl::serialization::Serializer serializer;
+		serializer.Serialize(writer, *object);
+
+		const auto roundTripObject = DeserializeBytes<T, Reader>(writer.GetBuffer(), threadPool);
+		if (!roundTripObject.has_value())
+		{
+			return {};
+		}
+
+		cpprefl::json::JsonSerializer jsonSerializer;
+		serializer.Serialize(jsonSerializer, *roundTripObject);
+		return std::string(jsonSerializer.GetString());
+	}
+
+	void ExpectSimpleClass(const DeserializeSimple& object)
+	{
+		EXPECT_EQ(object.boolValue, true);
+		EXPECT_EQ(object.intValue, 10);
+		EXPECT_EQ(object.negativeIntValue, -66);
+		EXPECT_FLOAT_EQ(object.floatValue, 3.14f);
+		EXPECT_FLOAT_EQ(object.floatFromIntValue, 9.0f);
+		EXPECT_EQ(object.enumValue, DeserializeEnum::Bar);
+		EXPECT_STREQ(object.string, "some string");
+		EXPECT_STREQ(object.dynamicString, "some dynamic string");
+		EXPECT_EQ(object.stdstring, "some std::string value");
+		EXPECT_EQ(object.intArray[0], 7);
+		EXPECT_EQ(object.intArray[3], 4);
+		EXPECT_EQ(object.dynamicArray, std::vector<int>({ 1, 5, 7, 12 }));
+	}
+
+	void ExpectSimpleClassVariants(const DeserializeSimple& object)
+	{
+		EXPECT_EQ(object.intValue, 70000);
+		EXPECT_EQ(object.negativeIntValue, -40000);
+		EXPECT_EQ(object.floatValue, 0.5f);
+		EXPECT_EQ(object.enumValue, DeserializeEnum::Foo);
+		EXPECT_STREQ(object.string, "bytes");
+		ASSERT_GE(object.dynamicArray.size(), 20);
+		EXPECT_EQ(object.dynamicArray[19], 19);
+	}
+
+	// Every prefix of a document is incomplete.
+	template <typename Reader, size_t Size>
+	void ExpectTruncatedFails(const uint8_t (&data)[Size])
+	{
+		for (size_t size = 0; size < Size; ++size)
+		{
+			const std::vector<std::byte> truncated((const std::byte*)data, (const std::byte*)data + size);
+			Reader reader(truncated.data(), truncated.size());
+
+			cpprefl::serialization::Deserializer deserializer;
+			EXPECT_FALSE(deserializer.Deserialize<DeserializeSimple>(reader).has_value()) << size;
+			EXPECT_TRUE(reader.HasError()) << size;
+		}
+	}
+}
+
+TEST(SerializerTests, MsgPackSimpleClass)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(SimpleClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializeSimple>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::msgpack::MsgPackSerializer msgPackSerializer;
+	cpprefl::serialization::Serializer serializer;
+	serializer.Serialize(msgPackSerializer, *objectResult);
+	EXPECT_EQ(msgPackSerializer.GetBuffer(), ToBytes(SimpleClassMsgPack));
+
+	const auto object = DeserializeBytes<DeserializeSimple, cpprefl::msgpack::MsgPackDeserializer>(ToBytes(SimpleClassMsgPack));
+	ASSERT_TRUE(object.has_value());
+	ExpectSimpleClass(*object);
+}
+
+TEST(SerializerTests, MsgPackVariants)
+{
+	const auto object = DeserializeBytes<DeserializeSimple, cpprefl::msgpack::MsgPackDeserializer>(ToBytes(SimpleClassMsgPackVariants));
+	ASSERT_TRUE(object.has_value());
+	ExpectSimpleClassVariants(*object);
+	EXPECT_EQ(object->dynamicArray.size(), 20);
+
+	// Strings are read straight out of the input, and integer keys are read as strings.
+	const uint8_t data[] = { 0x82, 0xa3, 'k', 'e', 'y', 0xc4, 0x02, 'a', 'b', 0xd0, 0x85, 0x2a };
+	cpprefl::msgpack::MsgPackDeserializer reader(data, sizeof(data));
+
+	std::string_view key;
+	std::string_view value;
+	ASSERT_TRUE(reader.BeginObject());
+	ASSERT_TRUE(reader.NextKey(key));
+	EXPECT_EQ(key, "key");
+	ASSERT_TRUE(reader.ReadString(value));
+	EXPECT_EQ(value, "ab");
+	EXPECT_EQ(value.data(), (const char*)data + 7);
+	ASSERT_TRUE(reader.NextKey(key));
+	EXPECT_EQ(key, "-123");
+	EXPECT_EQ(reader.PeekValue(), cpprefl::serialization::ValueType::Number);
+
+	double number;
+	ASSERT_TRUE(reader.ReadDouble(number));
+	EXPECT_EQ(number, 42.0);
+	EXPECT_FALSE(reader.NextKey(key));
+	EXPECT_TRUE(reader.IsAtEnd());
+	EXPECT_FALSE(reader.HasError());
+}
+
+TEST(SerializerTests, MsgPackRoundTrip)
+{
+	using Writer = cpprefl::msgpack::MsgPackSerializer;
+	using Reader = cpprefl::msgpack::MsgPackDeserializer;
+
+	EXPECT_EQ((RoundTripJson<DeserializeNested, Writer, Reader>(NestedClassJson)), ReadAndWrite<DeserializeNested>(NestedClassJson, true, true));
+	EXPECT_EQ((RoundTripJson<DeserializationDynamic, Writer, Reader>(DynamicClassJson)), ReadAndWrite<DeserializationDynamic>(DynamicClassJson, true, true));
+
+	const char* updateJson = R"({"mInt":-5,"mString":"abc","mElements":[{"mBool":true}],"mMap":{"a":"b","c":"d"},"mOptional":null,"mPointer":{"mBool":false}})";
+	EXPECT_EQ((RoundTripJson<DeserializeUpdate, Writer, Reader>(updateJson)), ReadAndWrite<DeserializeUpdate>(updateJson, true, true));
+
+	// Long arrays and strings use the wider headers, and arrays of objects can be decoded in parallel.
+	std::string json = R"({"mInstances":[)";
+	for (int i = 0; i < 70000; ++i)
+	{
+		json += i == 0 ? "" : ",";
+		json += i % 3 == 0 ?
+			R"({"__type__":"DeserializationClass2","mString":")" + std::string(i % 300, 'x') + R"("})" :
+			R"({"__type__":"DeserializationClass1","mBaseField":true,"mInt":)" + std::to_string(i * -1000) + "}";
+	}
+	json += "]}";
+
+	cpprefl::serialization::ThreadPool threadPool(4);
+	const std::string expected = ReadAndWrite<DeserializationDynamic>(json.c_str(), true, true);
+	EXPECT_EQ((RoundTripJson<DeserializationDynamic, Writer, Reader>(json.c_str())), expected);
+	EXPECT_EQ((RoundTripJson<DeserializationDynamic, Writer, Reader>(json.c_str(), &threadPool)), expected);
+}
+
+TEST(SerializerTests, MsgPackInvalid)
+{
+	ExpectTruncatedFails<cpprefl::msgpack::MsgPackDeserializer>(SimpleClassMsgPack);
+	ExpectTruncatedFails<cpprefl::msgpack::MsgPackDeserializer>(SimpleClassMsgPackVariants);
+
+	// An unused prefix, a key that isn't a string, and an array bigger than the input.
+	for (const auto& data : { std::vector<uint8_t>{ 0xc1 }, { 0x81, 0xc0, 0xc0 }, { 0x81, 0xac, 'd', 'y', 'n', 'a', 'm', 'i', 'c', 'A', 'r', 'r', 'a', 'y', 0xdd, 0xff, 0xff, 0xff, 0xff, 0x01 } })
+	{
+		cpprefl::msgpack::MsgPackDeserializer reader(data.data(), data.size());
+
+		cpprefl::serialization::Deserializer deserializer;
+		EXPECT_FALSE(deserializer.Deserialize<DeserializeSimple>(reader).has_value());
+		EXPECT_TRUE(reader.HasError());
+	}
+}
+
+TEST(SerializerTests, CborSimpleClass)
+{
+	cpprefl::json::JsonDeserializer jsonDeserializer(SimpleClassJson);
+
+	cpprefl::serialization::Deserializer deserializer;
+	const auto objectResult = deserializer.Deserialize<DeserializeSimple>(jsonDeserializer);
+	ASSERT_TRUE(objectResult.has_value());
+
+	cpprefl::cbor::CborSerializer cborSerializer;
+	cpprefl::serialization::Serializer serializer;
+	serializer.Serialize(cborSerializer, *objectResult);
+	EXPECT_EQ(cborSerializer.GetBuffer(), ToBytes(SimpleClassCbor));
+
+	const auto object = DeserializeBytes<DeserializeSimple, cpprefl::cbor::CborDeserializer>(ToBytes(SimpleClassCbor));
+	ASSERT_TRUE(object.has_value());
+	ExpectSimpleClass(*object);
+}
+
+TEST(SerializerTests, CborVariants)
+{
+	const auto object = DeserializeBytes<DeserializeSimple, cpprefl::cbor::CborDeserializer>(ToBytes(SimpleClassCborVariants));
+	ASSERT_TRUE(object.has_value());
+	ExpectSimpleClassVariants(*object);
+	EXPECT_EQ(object->dynamicArray.size(), 30);
+
+	const auto update = DeserializeBytes<DeserializeUpdate, cpprefl::cbor::CborDeserializer>(ToBytes(UpdateClassCborIndefinite));
+	ASSERT_TRUE(update.has_value());
+	EXPECT_EQ(update->mString, "abc");
+	ASSERT_EQ(update->mElements.size(), 2);
+	EXPECT_EQ(update->mElements[0].mBool, true);
+	EXPECT_EQ(update->mElements[1].mBool, false);
+	EXPECT_EQ(update->mMap, (std::map<std::string, std::string>{ { "1", "x" } }));
+	EXPECT_EQ(update->mInt, -5);
+}
+
+TEST(SerializerTests, CborRoundTrip)
+{
+	using Writer = cpprefl::cbor::CborSerializer;
+	using Reader = cpprefl::cbor::CborDeserializer;
+
+	EXPECT_EQ((RoundTripJson<DeserializeNested, Writer, Reader>(NestedClassJson)), ReadAndWrite<DeserializeNested>(NestedClassJson, true, true));
+	EXPECT_EQ((RoundTripJson<DeserializationDynamic, Writer, Reader>(DynamicClassJson)), ReadAndWrite<DeserializationDynamic>(DynamicClassJson, true, true));
+
+	const char* updateJson = R"({"mInt":-5,"mString":"abc","mElements":[{"mBool":true}],"mMap":{"a":"b","c":"d"},"mOptional":null,"mPointer":{"mBool":false}})";
+	EXPECT_EQ((RoundTripJson<DeserializeUpdate, Writer, Reader>(updateJson)), ReadAndWrite<DeserializeUpdate>(updateJson, true, true));
+
+	// Long arrays and strings use the wider headers, and arrays of objects can be decoded in parallel.
+	std::string json = R"({"mInstances":[)";
+	for (int i = 0; i < 70000; ++i)
+	{
+		json += i == 0 ? "" : ",";
+		json += i % 3 == 0 ?
+			R"({"__type__":"DeserializationClass2","mString":")" + std::string(i % 300, 'x') + R"("})" :
+			R"({"__type__":"DeserializationClass1","mBaseField":true,"mInt":)" + std::to_string(i * -1000) + "}";
+	}
+	json += "]}";
+
+	cpprefl::serialization::ThreadPool threadPool(4);
+	const std::string expected = ReadAndWrite<DeserializationDynamic>(json.c_str(), true, true);
+	EXPECT_EQ((RoundTripJson<DeserializationDynamic, Writer, Reader>(json.c_str())), expected);
+	EXPECT_EQ((RoundTripJson<DeserializationDynamic, Writer, Reader>(json.c_str(), &threadPool)), expected);
+}
+
+TEST(SerializerTests, CborInvalid)
+{
+	ExpectTruncatedFails<cpprefl::cbor::CborDeserializer>(SimpleClassCbor);
+	ExpectTruncatedFails<cpprefl::cbor::CborDeserializer>(SimpleClassCborVariants);
+
+	// A reserved additional information, a stray break, and an array bigger than the input.
+	for (const auto& data : { std::vector<uint8_t>{ 0x1c }, { 0xa1, 0xff }, { 0xa1, 0x6c, 'd', 'y', 'n', 'a', 'm', 'i', 'c', 'A', 'r', 'r', 'a', 'y', 0x9a, 0xff, 0xff, 0xff, 0xff, 0x01 } })
+	{
+		cpprefl::cbor::CborDeserializer reader(data.data(), data.size());
+
+		cpprefl::serialization::Deserializer deserializer;
+		EXPECT_FALSE(deserializer.Deserialize<DeserializeSimple>(reader).has_value());
+		EXPECT_TRUE(reader.HasError());
+	}
+}
+
+namespace
+{
+	BitPackSnapshot MakeBitPackSnapshot()
+	{
+		BitPackSnapshot snapshot;
+		snapshot.mPosition.x = 12.345f;
+		snapshot.mPosition.y = -99.9f;
+		snapshot.mPosition.z = 50.0f;
+		snapshot.mYaw = 90.0f;
+		snapshot.mHealth = 75;
+		snapshot.mDelta = -20;
+		snapshot.mAmmo[0] = 30;
+		snapshot.mAmmo[1] = 1023;
+		snapshot.mState = BitPackState::Running;
+		snapshot.mCrouching = true;
+		snapshot.mTime = 1234.5678;
+		snapshot.mName = "player";
+		return snapshot;
+	}
+
+	void ExpectBitPackSnapshot(const BitPackSnapshot& actual, const BitPackSnapshot& expected)
+	{
+		// Quantized values are within half a step of the original.
+		EXPECT_NEAR(actual.mPosition.x, expected.mPosition.x, 100.0 / 65535);
+		EXPECT_NEAR(actual.mPosition.y, expected.mPosition.y, 100.0 / 65535);
+		EXPECT_NEAR(actual.mPosition.z, expected.mPosition.z, 25.0 / 4095);
+		EXPECT_NEAR(actual.mYaw, expected.mYaw, 180.0 / 255);
+		EXPECT_EQ(actual.mHealth, expected.mHealth);
+		EXPECT_EQ(actual.mDelta, expected.mDelta);
+		EXPECT_EQ(actual.mAmmo[0], expected.mAmmo[0]);
+		EXPECT_EQ(actual.mAmmo[1], expected.mAmmo[1]);
+		EXPECT_EQ(actual.mState, expected.mState);
+		EXPECT_EQ(actual.mCrouching, expected.mCrouching);
+		EXPECT_EQ(actual.mTime, expected.mTime);
+	}
+}
+
+TEST(SerializerTests, BitPackPlan)
+{
+	cpprefl::bitpack::BitPackSerializer serializer;
+	const cpprefl::bitpack::BitPackPlan& plan = serializer.GetPlan(cpprefl::GetReflectedClass<BitPackSnapshot>());
+	EXPECT_EQ(&plan, &serializer.GetPlan(cpprefl::GetReflectedClass<BitPackSnapshot>()));
+
+	// The nested vector and the array are flattened, the const field and the string are left out.
+	ASSERT_EQ(plan.mSteps.size(), 11);
+
+	std::vector<int> bits;
+	for (const auto& step : plan.mSteps)
+	{
+		bits.push_back(step.mBits);
+	}
+
+	// x, y, z, yaw, health (0 to 100), delta (6 bits), ammo (2 * 10 bits), state (4 values), crouching, time.
+	EXPECT_EQ(bits, std::vector<int>({ 16, 16, 12, 8, 7, 6, 10, 10, 2, 1, 64 }));
+	EXPECT_EQ(plan.mBitCount, 152);
+
+	EXPECT_EQ(plan.mSteps[0].mEncoding, cpprefl::bitpack::BitPackEncoding::Quantized);
+	EXPECT_EQ(plan.mSteps[0].mMinValue, -100.0);
+	EXPECT_EQ(plan.mSteps[0].mMaxValue, 100.0);
+	EXPECT_EQ(plan.mSteps[5].mEncoding, cpprefl::bitpack::BitPackEncoding::Range);
+	EXPECT_EQ(plan.mSteps[5].mMin, -32);
+	EXPECT_EQ(plan.mSteps[5].mMax, 31);
+	EXPECT_EQ(plan.mSteps[10].mEncoding, cpprefl::bitpack::BitPackEncoding::Raw);
+}
+
+TEST(SerializerTests, BitPackQuantized)
+{
+	const BitPackSnapshot snapshot = MakeBitPackSnapshot();
+
+	cpprefl::bitpack::BitPackSerializer serializer;
+	serializer.Serialize(snapshot);
+	EXPECT_EQ(serializer.GetBuffer().size(), 19);
+
+	cpprefl::bitpack::BitPackDeserializer deserializer(serializer.GetBuffer().data(), serializer.GetBuffer().size());
+	const auto object = deserializer.Deserialize<BitPackSnapshot>();
+	ASSERT_TRUE(object.has_value());
+	ExpectBitPackSnapshot(*object, snapshot);
+	EXPECT_EQ(object->mPosition.z, 50.0f);
+	EXPECT_TRUE(object->mName.empty());
+	EXPECT_TRUE(deserializer.IsAtEnd());
+
+	// Values out of range are clamped, NaN goes to the minimum.
+	BitPackSnapshot outOfRange;
+	outOfRange.mPosition.x = 1000.0f;
+	outOfRange.mPosition.y = std::nanf("");
+	outOfRange.mPosition.z = -1.0f;
+	outOfRange.mHealth = 150;
+	outOfRange.mDelta = -40;
+	outOfRange.mAmmo[0] = 2000;
+	outOfRange.mAmmo[1] = 0;
+
+	serializer.Clear();
+	serializer.Serialize(outOfRange);
+
+	cpprefl::bitpack::BitPackDeserializer clampedDeserializer(serializer.GetBuffer().data(), serializer.GetBuffer().size());
+	const auto clamped = clampedDeserializer.Deserialize<BitPackSnapshot>();
+	ASSERT_TRUE(clamped.has_value());
+	EXPECT_EQ(clamped->mPosition.x, 100.0f);
+	EXPECT_EQ(clamped->mPosition.y, -100.0f);
+	EXPECT_EQ(clamped->mPosition.z, 0.0f);
+	EXPECT_EQ(clamped->mHealth, 100);
+	EXPECT_EQ(clamped->mDelta, -32);
+	EXPECT_EQ(clamped->mAmmo[0], 1023);
+}
+
+TEST(SerializerTests, BitPackUnsignedEnum)
+{
+	BitPackFlagsHolder holder;
+	holder.mFlags[0] = BitPackFlags::High;
+	holder.mFlags[1] = BitPackFlags::Low;
+	holder.mFlags[2] = BitPackFlags::None;
+	holder.mEnabled = true;
+
+	cpprefl::bitpack::BitPackSerializer serializer;
+	const cpprefl::bitpack::BitPackPlan& plan = serializer.GetPlan(cpprefl::GetReflectedClass<BitPackFlagsHolder>());
+	ASSERT_EQ(plan.mSteps.size(), 4);
+	EXPECT_EQ(plan.mSteps[0].mMin, 0);
+	EXPECT_EQ(plan.mSteps[0].mMax, 200);
+	EXPECT_EQ(plan.mSteps[0].mBits, 8);
+
+	// Values with the top bit set aren't sign extended.
+	serializer.Serialize(holder);
+
+	cpprefl::bitpack::BitPackDeserializer deserializer(serializer.GetBuffer().data(), serializer.GetBuffer().size());
+	const auto object = deserializer.Deserialize<BitPackFlagsHolder>();
+	ASSERT_TRUE(object.has_value());
+	EXPECT_EQ(object->mFlags[0], BitPackFlags::High);
+	EXPECT_EQ(object->mFlags[1], BitPackFlags::Low);
+	EXPECT_EQ(object->mFlags[2], BitPackFlags::None);
+	EXPECT_TRUE(object->mEnabled);
+}
+
+TEST(SerializerTests, BitPackDelta)
+{
+	const BitPackSnapshot baseline = MakeBitPackSnapshot();
+
+	BitPackSnapshot snapshot = MakeBitPackSnapshot();
+	snapshot.mHealth = 50;
+	snapshot.mCrouching = false;
+
+	// Changes smaller than the precision of a field aren't written.
+	snapshot.mPosition.x += 0.0001f;
+
+	// One bit per value, plus the health and crouching values.
+	cpprefl::bitpack::BitPackSerializer serializer;
+	serializer.Serialize(snapshot, &baseline);
+	EXPECT_EQ(serializer.GetBuffer().size(), 3);
+
+	// Unchanged values are written as a single bit each.
+	serializer.Serialize(snapshot, &snapshot);
+	EXPECT_EQ(serializer.GetBuffer().size(), 5);
+
+	cpprefl::bitpack::BitPackDeserializer deserializer(serializer.GetBuffer().data(), serializer.GetBuffer().size());
+	const auto object = deserializer.Deserialize(&baseline);
+	ASSERT_TRUE(object.has_value());
+	ExpectBitPackSnapshot(*object, snapshot);
+	EXPECT_EQ(object->mName, "player");
+
+	// The baseline can be the object being updated.
+	BitPackSnapshot updated = *object;
+	ASSERT_TRUE(deserializer.Deserialize(cpprefl::GetReflectedClass<BitPackSnapshot>(), &updated, &updated));
+	ExpectBitPackSnapshot(updated, snapshot);
+	EXPECT_TRUE(deserializer.IsAtEnd());
+}
+
+TEST(SerializerTests, BitPackInvalid)
+{
+	const BitPackSnapshot snapshot = MakeBitPackSnapshot();
+
+	cpprefl::bitpack::BitPackSerializer serializer;
+	serializer.Serialize(snapshot);
+
+	cpprefl::bitpack::BitPackDeserializer deserializer(serializer.GetBuffer().data(), serializer.GetBuffer().size() - 1);
+	EXPECT_FALSE(deserializer.Deserialize<BitPackSnapshot>().has_value());
+	EXPECT_TRUE(deserializer.HasError());
+
+	// Deltas need the bits of every value.
+	cpprefl::bitpack::BitPackDeserializer deltaDeserializer(serializer.GetBuffer().data(), 1);
+	EXPECT_FALSE(deltaDeserializer.Deserialize(&snapshot).has_value());
+	EXPECT_TRUE(deltaDeserializer.HasError());
+}
+
+namespace
+{
+	std::vector<ColumnarRecord> MakeColumnarRecords()
+	{
+		std::vector<ColumnarRecord> records(1000);
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			ColumnarRecord& record = records[i];
+			record.mId = (int32_t)i;
+			record.mTimestamp = 5000 + i / 250;
+			record.mCategory = (ColumnarCategory)(i % 3);
+			record.mPosition.mX = (float)i * 0.5f;
+			record.mPosition.mY = i == 0 ? -0.0f : (i == 1 ? std::nanf("") : 1.0f);
+			record.mValue = (double)i / 7.0;
+			record.mSamples[0] = (uint16_t)(i % 2);
+			record.mActive = i < 500;
+			record.mName = "record";
+		}
+		return records;
+	}
+
+	void ExpectColumnarRecords(const std::vector<ColumnarRecord>& actual, const std::vector<ColumnarRecord>& expected)
+	{
+		ASSERT_EQ(actual.size(), expected.size());
+		for (size_t i = 0; i < actual.size(); ++i)
+		{
+			EXPECT_EQ(actual[i].mId, expected[i].mId);
+			EXPECT_EQ(actual[i].mTimestamp, expected[i].mTimestamp);
+			EXPECT_EQ(actual[i].mCategory, expected[i].mCategory);
+			EXPECT_EQ(actual[i].mPosition.mX, expected[i].mPosition.mX);
+			EXPECT_EQ(std::memcmp(&actual[i].mPosition.mY, &expected[i].mPosition.mY, sizeof(float)), 0);
+			EXPECT_EQ(actual[i].mValue, expected[i].mValue);
+			EXPECT_EQ(actual[i].mSamples[0], expected[i].mSamples[0]);
+			EXPECT_EQ(actual[i].mSamples[1], expected[i].mSamples[1]);
+			EXPECT_EQ(actual[i].mActive, expected[i].mActive);
+		}
+	}
+}
+
+TEST(SerializerTests, Columnar)
+{
+	using namespace cpprefl::columnar;
+
+	const std::vector<ColumnarRecord> records = MakeColumnarRecords();
+
+	ColumnarWriter writer;
+	writer.Write(records);
+
+	ColumnarReader reader(writer.GetBuffer().data(), writer.GetBuffer().size());
+	ASSERT_FALSE(reader.HasError());
+	EXPECT_EQ(reader.GetRowCount(), records.size());
+	EXPECT_EQ(reader.GetClassName(), cpprefl::GetReflectedClass<ColumnarRecord>().mType->mName);
+
+	// The nested class and the array are flattened, the const field and the string are left out.
+	const std::vector<ColumnarColumnView>& columns = reader.GetColumns();
+	std::vector<std::string_view> names;
+	std::vector<ColumnEncoding> encodings;
+	for (const ColumnarColumnView& column : columns)
+	{
+		names.push_back(column.mName);
+		encodings.push_back(column.mEncoding);
+	}
+
+	EXPECT_EQ(names, std::vector<std::string_view>({ "mId", "mTimestamp", "mCategory", "mPosition.mX", "mPosition.mY", "mValue", "mSamples[0]", "mSamples[1]", "mActive" }));
+	EXPECT_EQ(encodings, std::vector<ColumnEncoding>({ ColumnEncoding::Plain, ColumnEncoding::RunLength, ColumnEncoding::Dictionary, ColumnEncoding::Plain,
+		ColumnEncoding::RunLength, ColumnEncoding::Plain, ColumnEncoding::Dictionary, ColumnEncoding::RunLength, ColumnEncoding::RunLength }));
+	EXPECT_EQ(columns[1].mEntryCount, 4);
+	EXPECT_EQ(columns[2].mKind, cpprefl::TypeKind::Int32);
+	EXPECT_EQ(columns[2].mEntryCount, 3);
+	EXPECT_EQ(columns[8].mEntryCount, 2);
+
+	// -0.0 and NaN are kept bit for bit.
+	std::vector<ColumnarRecord> objects;
+	ASSERT_TRUE(reader.Read(objects));
+	ExpectColumnarRecords(objects, records);
+	EXPECT_TRUE(std::signbit(objects[0].mPosition.mY));
+	EXPECT_TRUE(std::isnan(objects[1].mPosition.mY));
+	EXPECT_TRUE(objects[0].mName.empty());
+
+	// Empty tables have every column, without any values.
+	writer.Write(std::vector<ColumnarRecord>());
+	ColumnarReader emptyReader(writer.GetBuffer().data(), writer.GetBuffer().size());
+	EXPECT_EQ(emptyReader.GetRowCount(), 0);
+	EXPECT_EQ(emptyReader.GetColumns().size(), columns.size());
+	ASSERT_TRUE(emptyReader.Read(objects));
+	EXPECT_TRUE(objects.empty());
+}
+
+TEST(SerializerTests, ColumnarThreadPool)
+{
+	using namespace cpprefl::columnar;
+
+	const std::vector<ColumnarRecord> records = MakeColumnarRecords();
+	cpprefl::serialization::ThreadPool threadPool(4);
+
+	ColumnarWriter writer;
+	writer.Write(records);
+
+	// Columns are encoded independently, so the output doesn't depend on the number of threads.
+	ColumnarWriter parallelWriter;
+	parallelWriter.SetThreadPool(&threadPool);
+	parallelWriter.Write(records);
+	EXPECT_EQ(parallelWriter.GetBuffer(), writer.GetBuffer());
+
+	ColumnarReader reader(parallelWriter.GetBuffer().data(), parallelWriter.GetBuffer().size());
+	reader.SetThreadPool(&threadPool);
+
+	std::vector<ColumnarRecord> objects;
+	ASSERT_TRUE(reader.Read(objects));
+	ExpectColumnarRecords(objects, records);
+}
+
+TEST(SerializerTests, ColumnarChangedClass)
+{
+	using namespace cpprefl::columnar;
+
+	const std::vector<ColumnarRecord> records = MakeColumnarRecords();
+
+	ColumnarWriter writer;
+	writer.Write(records);
+
+	// Columns are matched by name: numbers are converted, and new fields keep their value.
+	ColumnarReader reader(writer.GetBuffer().data(), writer.GetBuffer().size());
+	std::vector<ColumnarRecordChanged> objects;
+	ASSERT_TRUE(reader.Read(objects));
+	ASSERT_EQ(objects.size(), records.size());
+	for (size_t i = 0; i < objects.size(); ++i)
+	{
+		EXPECT_EQ(objects[i].mId, records[i].mId);
+		EXPECT_EQ(objects[i].mPosition.mX, records[i].mPosition.mX);
+		EXPECT_EQ(objects[i].mValue, (float)records[i].mValue);
+		EXPECT_EQ(objects[i].mLevel, -1);
+	}
+}
+
+TEST(SerializerTests, ColumnarInvalid)
+{
+	using namespace cpprefl::columnar;
+
+	const std::vector<ColumnarRecord> records = MakeColumnarRecords();
+
+	ColumnarWriter writer;
+	writer.Write(records);
+	const std::vector<std::byte>& buffer = writer.GetBuffer();
+
+	ColumnarReader truncatedReader(buffer.data(), buffer.size() / 2);
+	EXPECT_TRUE(truncatedReader.HasError());
+
+	std::vector<std::byte> corrupted = buffer;
+	corrupted[0] = std::byte(0);
+	ColumnarReader magicReader(corrupted.data(), corrupted.size());
+	EXPECT_TRUE(magicReader.HasError());
+
+	// The number of objects has to match the number of rows.
+	ColumnarReader reader(buffer.data(), buffer.size());
+	std::vector<ColumnarRecord> objects(records.size() - 1);
+	EXPECT_FALSE(reader.Read(cpprefl::GetReflectedClass<ColumnarRecord>(), objects.data(), objects.size(), sizeof(ColumnarRecord)));
+	EXPECT_FALSE(reader.HasError());
+
+	// Dictionary indices are checked when they are read.
+	corrupted = buffer;
+	const ColumnarColumnView& category = reader.GetColumns()[2];
+	ASSERT_EQ(category.mEncoding, ColumnEncoding::Dictionary);
+	corrupted[(category.mData - buffer.data()) + category.mEntryCount * sizeof(int32_t)] = std::byte(200);
+
+	ColumnarReader indexReader(corrupted.data(), corrupted.size());
+	ASSERT_FALSE(indexReader.HasError());
+	EXPECT_FALSE(indexReader.Read(objects));
+	EXPECT_TRUE(indexReader.HasError());
+}
+
+TEST(SerializerTests, Csv)
+{
+	using namespace cpprefl::csv;
+
+	// Columns can be in any order, unknown columns are skipped and empty values keep the field's value.
+	const std::string csv =
+		"\xEF\xBB\xBF" "mName,mId,mCategory,mPosition.mX,mUnknown,mValue,mSmall,mSamples[1],mActive\r\n"
+		"\"Hello, \"\"world\"\"\",1,Combat,1.5,x,-2.5e3,300,7,true\r\n"
+		"\r\n"
+		"\"two\nlines\",2,2, -0.25 ,x,,-1,,0\r\n"
+		"plain,3,,,,1e400,,,FALSE,extra\r\n";
+
+	CsvLoader loader;
+	std::vector<CsvRecord> records;
+	ASSERT_TRUE(loader.Load(csv.data(), csv.size(), records));
+	ASSERT_EQ(records.size(), 3);
+
+	EXPECT_EQ(records[0].mName, "Hello, \"world\"");
+	EXPECT_EQ(records[0].mId, 1);
+	EXPECT_EQ(records[0].mCategory, ColumnarCategory::Combat);
+	EXPECT_EQ(records[0].mPosition.mX, 1.5f);
+	EXPECT_EQ(records[0].mValue, -2500.0);
+	EXPECT_EQ(records[0].mSmall, 255);
+	EXPECT_EQ(records[0].mSamples[0], 0);
+	EXPECT_EQ(records[0].mSamples[1], 7);
+	EXPECT_TRUE(records[0].mActive);
+	EXPECT_EQ(records[0].mDefault, 42);
+
+	EXPECT_EQ(records[1].mName, "two\nlines");
+	EXPECT_EQ(records[1].mCategory, ColumnarCategory::Economy);
+	EXPECT_EQ(records[1].mPosition.mX, -0.25f);
+	EXPECT_EQ(records[1].mValue, 0.0);
+	EXPECT_EQ(records[1].mSmall, 0);
+	EXPECT_FALSE(records[1].mActive);
+
+	EXPECT_EQ(records[2].mName, "plain");
+	EXPECT_EQ(records[2].mCategory, ColumnarCategory::Movement);
+	EXPECT_TRUE(std::isinf(records[2].mValue));
+
+	// TSV, without a newline after the last record.
+	const std::string tsv = "mId\tmName\n4\ta,b\n5\t\"c\td\"";
+	CsvLoader tsvLoader('\t');
+	ASSERT_TRUE(tsvLoader.Load(tsv.data(), tsv.size(), records));
+	ASSERT_EQ(records.size(), 2);
+	EXPECT_EQ(records[0].mName, "a,b");
+	EXPECT_EQ(records[1].mId, 5);
+	EXPECT_EQ(records[1].mName, "c\td");
+
+	// A header without records.
+	const std::string header = "mId,mName\n";
+	ASSERT_TRUE(loader.Load(header.data(), header.size(), records));
+	EXPECT_TRUE(records.empty());
+}
+
+TEST(SerializerTests, CsvThreadPool)
+{
+	using namespace cpprefl::csv;
+
+	std::string csv = "mId,mName,mCategory,mValue\n";
+	for (int i = 0; i < 2000; ++i)
+	{
+		csv += std::to_string(i) + ",";
+		csv += i % 5 == 0 ? "\"quoted,\n\"\"name\"\"\"" : "name" + std::to_string(i);
+		csv += i % 2 == 0 ? ",Movement," : ",1,";
+		csv += std::to_string(i) + ".5\n";
+		if (i % 7 == 0)
+		{
+			csv += "\n";
+		}
+	}
+
+	CsvLoader loader;
+	std::vector<CsvRecord> expected;
+	ASSERT_TRUE(loader.Load(csv.data(), csv.size(), expected));
+	ASSERT_EQ(expected.size(), 2000);
+
+	// Small chunks, so that chunks start inside of quoted fields and in the middle of records.
+	cpprefl::serialization::ThreadPool threadPool(4);
+	for (const size_t chunkSize : { 1, 7, 64, 4096 })
+	{
+		CsvLoader parallelLoader;
+		parallelLoader.SetThreadPool(&threadPool, chunkSize);
+
+		std::vector<CsvRecord> records;
+		ASSERT_TRUE(parallelLoader.Load(csv.data(), csv.size(), records));
+		ASSERT_EQ(records.size(), expected.size());
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			EXPECT_EQ(records[i].mId, (int32_t)i);
+			EXPECT_EQ(records[i].mName, expected[i].mName);
+			EXPECT_EQ(records[i].mCategory, expected[i].mCategory);
+			EXPECT_EQ(records[i].mValue, expected[i].mValue);
+		}
+	}
+
+	EXPECT_EQ(expected[5].mName, "quoted,\n\"name\"");
+	EXPECT_EQ(expected[1].mCategory, ColumnarCategory::Combat);
+	EXPECT_EQ(expected[1999].mValue, 1999.5);
+}
+
+TEST(SerializerTests, CsvInvalid)
+{
+	using namespace cpprefl::csv;
+
+	cpprefl::serialization::ThreadPool threadPool(4);
+	CsvLoader loader;
+	loader.SetThreadPool(&threadPool, 16);
+
+	std::vector<CsvRecord> records;
+	for (const char* csv : { "mId\n1\n2x\n", "mActive\nyes\n", "mCategory\nRunning\n", "mName\n\"open\n" })
+	{
+		EXPECT_FALSE(loader.Load(csv, std::strlen(csv), records));
+		EXPECT_TRUE(loader.HasError());
+	}
+
+	// The error is cleared by the next load.
+	const char* valid = "mId\n1\n";
+	EXPECT_TRUE(loader.Load(valid, std::strlen(valid), records));
+	EXPECT_FALSE(loader.HasError());
+}
+
+TEST(SerializerTests, Format)
+{
+	ColumnarRecord record;
+	record.mId = 7;
+	record.mTimestamp = 123;
+	record.mCategory = ColumnarCategory::Economy;
+	record.mPosition.mX = 1.5f;
+	record.mPosition.mY = -2.0f;
+	record.mValue = 0.1;
+	record.mSamples[0] = 3;
+	record.mSamples[1] = 4;
+	record.mActive = true;
+	record.mName = "a \"b\"\n";
+
+	// Nested classes are inlined into the plan, strings are quoted and escaped.
+	const std::string_view expected = "ColumnarRecord{mId: 7, mTimestamp: 123, mCategory: Economy, mPosition: {mX: 1.5, mY: -2}, mValue: 0.1, "
+		"mSamples: [3, 4], mActive: true, mConstant: 7, mName: \"a \\\"b\\\"\\n\"}";
+
+	char buffer[256];
+	EXPECT_EQ(cpprefl::Format(record, buffer), expected);
+	EXPECT_EQ(&cpprefl::FormatPlan::Get(cpprefl::GetReflectedClass<ColumnarRecord>()), &cpprefl::FormatPlan::Get(cpprefl::GetReflectedClass<ColumnarRecord>()));
+
+	// Text that doesn't fit is cut off, but still counted.
+	char smallBuffer[16];
+	EXPECT_EQ(cpprefl::Format(record, smallBuffer), expected.substr(0, sizeof(smallBuffer)));
+	EXPECT_EQ(cpprefl::Format(record, smallBuffer, sizeof(smallBuffer)), expected.size());
+
+	// With a flush function, the text goes through the buffer in pieces.
+	std::string flushed;
+	char tinyBuffer[5];
+	cpprefl::FormatOutput output(tinyBuffer, sizeof(tinyBuffer), [](void* context, const char* text, size_t size)
+	{
+		static_cast<std::string*>(context)->append(text, size);
+	}, &flushed);
+	output.Write("ColumnarRecord");
+	cpprefl::FormatPlan::Get(cpprefl::GetReflectedClass<ColumnarRecord>()).Format(&record, output);
+	output.Flush();
+	EXPECT_EQ(flushed, expected);
+	EXPECT_EQ(output.GetLength(), expected.size());
+
+#if CPPREFL_WITH_STD_FORMAT()
+	EXPECT_EQ(std::format("{}", record), expected);
+#endif
+}
+
+TEST(SerializerTests, FormatContainers)
+{
+	DeserializeUpdate update;
+	update.mInt = 1;
+	update.mString = "s";
+	update.mElements.resize(2);
+	update.mElements[0].mBool = true;
+	update.mElements[1].mBool = false;
+	update.mMap["key"] = "value";
+
+	char buffer[256];
+	EXPECT_EQ(cpprefl::Format(update, buffer),
+		"DeserializeUpdate{mInt: 1, mString: \"s\", mElements: [{mBool: true}, {mBool: false}], mMap: {\"key\": \"value\"}, mOptional: null, mPointer: null}");
+
+	DeserializeDynamicArrayElement element;
+	element.mBool = true;
+	update.mElements.clear();
+	update.mMap.clear();
+	update.mOptional.emplace().mBool = false;
+	update.mPointer = &element;
+	EXPECT_EQ(cpprefl::Format(update, buffer),
+		"DeserializeUpdate{mInt: 1, mString: \"s\", mElements: [], mMap: {}, mOptional: {mBool: false}, mPointer: {mBool: true}}");
+
+	// Pointers are formatted as their most derived class, which is named if it differs from the pointer type.
+	DeserializationClass1 instance{};
+	instance.mInt = 3;
+	DeserializationDynamic dynamic;
+	dynamic.mInstances = { &instance, nullptr };
+	EXPECT_EQ(cpprefl::Format(dynamic, buffer), "DeserializationDynamic{mInstances: [DeserializationClass1{mBaseField: false, mInt: 3}, null]}");
+
+	// Cycles end once objects are nested too deep.
+	FormatNode node;
+	node.mValue = 5;
+	node.mNext = &node;
+	std::string_view text = cpprefl::Format(node, buffer);
+	EXPECT_EQ(text.substr(0, 31), "FormatNode{mValue: 5, mNext: {m");
+	EXPECT_NE(text.find("{...}"), std::string_view::npos);
+	EXPECT_EQ(std::count(text.begin(), text.end(), '{'), cpprefl::FormatPlan::MaxDepth + 2);
+}
+
+TEST(SerializerTests, MemoryFootprint)
+{
+	// Short strings are stored inside of the string object.
+	ColumnarRecord record;
+	record.mName = "a";
+	cpprefl::MemoryFootprint footprint = cpprefl::MeasureDeep(record);
+	EXPECT_EQ(footprint.mInlineBytes, sizeof(ColumnarRecord));
+	EXPECT_EQ(footprint.mHeapBytes, 0);
+	EXPECT_EQ(footprint.mFields.size(), cpprefl::GetReflectedClass<ColumnarRecord>().mFlattenedFields.size());
+	EXPECT_EQ(footprint.mFields[3].mInlineBytes, sizeof(ColumnarPoint));
+	EXPECT_EQ(footprint.mFields[5].mInlineBytes, sizeof(record.mSamples));
+
+	record.mName.assign(100, 'x');
+	footprint = cpprefl::MeasureDeep(record);
+	EXPECT_EQ(footprint.mHeapBytes, record.mName.capacity() + 1);
+	EXPECT_EQ(footprint.mFields.back().mHeapBytes, footprint.mHeapBytes);
+	EXPECT_EQ(footprint.GetTotalBytes(), sizeof(ColumnarRecord) + record.mName.capacity() + 1);
+
+	// Classes without any fields owning memory aren't measured at all.
+	EXPECT_FALSE(cpprefl::MemoryPlan::Get(cpprefl::GetReflectedClass<ColumnarPoint>()).HasHeap());
+	std::vector<ColumnarPoint> points(10);
+	footprint = cpprefl::MeasureDeep(points);
+	EXPECT_EQ(footprint.mInlineBytes, 10 * sizeof(ColumnarPoint));
+	EXPECT_EQ(footprint.mHeapBytes, 0);
+
+	// Dynamic arrays count their capacity, optionals only count values stored outside of them, pointers count what they point to.
+	DeserializeDynamicArrayElement element;
+	DeserializeUpdate update;
+	update.mString = "s";
+	update.mElements.reserve(8);
+	update.mElements.resize(2);
+	update.mMap["key"] = std::string(50, 'v');
+	update.mOptional.emplace();
+	update.mPointer = &element;
+
+	const size_t mapBytes = sizeof(std::string) * 2 + update.mMap["key"].capacity() + 1;
+	footprint = cpprefl::MeasureDeep(update);
+	EXPECT_EQ(footprint.mFields[1].mHeapBytes, 0);
+	EXPECT_EQ(footprint.mFields[2].mHeapBytes, 8 * sizeof(DeserializeDynamicArrayElement));
+	EXPECT_EQ(footprint.mFields[3].mHeapBytes, mapBytes);
+	EXPECT_EQ(footprint.mFields[4].mHeapBytes, 0);
+	EXPECT_EQ(footprint.mFields[5].mHeapBytes, sizeof(DeserializeDynamicArrayElement));
+	EXPECT_EQ(footprint.mHeapBytes, 8 * sizeof(DeserializeDynamicArrayElement) + mapBytes + sizeof(DeserializeDynamicArrayElement));
+}
+
+TEST(SerializerTests, MemoryFootprintPointers)
+{
+	// Pointers count the most derived class of their object, and objects they share are counted once.
+	DeserializationClass1 instance1;
+	DeserializationClass2 instance2;
+	DeserializationDynamic dynamic;
+	dynamic.mInstances = { &instance1, &instance2, &instance1, nullptr };
+
+	cpprefl::MemoryFootprint footprint = cpprefl::MeasureDeep(dynamic);
+	EXPECT_EQ(footprint.mHeapBytes, dynamic.mInstances.capacity() * sizeof(DeserializationBase*) + sizeof(DeserializationClass1) + sizeof(DeserializationClass2));
+
+	// Cycles end at objects that were already counted.
+	FormatNode node1;
+	FormatNode node2;
+	node1.mNext = &node2;
+	node2.mNext = &node1;
+	footprint = cpprefl::MeasureDeep(node1);
+	EXPECT_EQ(footprint.mHeapBytes, 2 * sizeof(FormatNode));
+}
+
+TEST(SerializerTests, MemoryFootprintThreadPool)
+{
+	std::vector<DeserializeUpdate> updates(5000);
+	for (size_t i = 0; i < updates.size(); ++i)
+	{
+		updates[i].mString.assign(i % 64, 'x');
+		updates[i].mElements.resize(i % 5);
+	}
+
+	const cpprefl::MemoryFootprint serial = cpprefl::MeasureDeep(updates);
+
+	cpprefl::serialization::ThreadPool threadPool(4);
+	const cpprefl::MemoryFootprint parallel = cpprefl::MeasureDeep(updates, &threadPool);
+	EXPECT_EQ(parallel.mInlineBytes, updates.size() * sizeof(DeserializeUpdate));
+	EXPECT_EQ(parallel.mHeapBytes, serial.mHeapBytes);
+	EXPECT_GT(parallel.mHeapBytes, 0);
+
+	size_t fieldHeapBytes = 0;
+	for (size_t i = 0; i < parallel.mFields.size(); ++i)
+	{
+		EXPECT_EQ(parallel.mFields[i].mHeapBytes, serial.mFields[i].mHeapBytes);
+		fieldHeapBytes += parallel.mFields[i].mHeapBytes;
+	}
+	EXPECT_EQ(fieldHeapBytes, parallel.mHeapBytes);
+}
+
+#endif
@@ -36,6 +36,23 @@
 #define CPPREFL_WITH_STL() 1
 #endif
 
+#ifndef CPPREFL_WITH_STD_SPAN
+#if CPPREFL_WITH_STL() && (__cplusplus >= 202002L || _MSVC_LANG >= 202002L)
+#define CPPREFL_WITH_STD_SPAN() 1
+#else
+#define CPPREFL_WITH_STD_SPAN() 0
+#endif
+#endif
+
+// Vectorized parsing kernels (x86 only). The best kernel supported by the CPU is picked at runtime.
+#ifndef CPPREFL_WITH_SIMD
+#if defined(_M_X64) || defined(__x86_64__)
+#define CPPREFL_WITH_SIMD() 1
+#else
+#define CPPREFL_WITH_SIMD() 0
+#endif
+#endif
+
 namespace cpprefl
 {
 	enum class LogLevel
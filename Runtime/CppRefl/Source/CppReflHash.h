@@ -86,9 +86,9 @@ namespace cpprefl
 	// A hash of a string.
 	class Name
 	{
+	public:
 		using HashType = uint32_t;
 
-	public:
 		constexpr Name() = default;
 
 		constexpr explicit Name(const char* str, size_t length) : mHash(Crc32(str, length))
@@ -114,11 +114,22 @@ namespace cpprefl
 			return mHash == rhs.mHash;
 		}
 
+		// Returns the raw hash value (e.g. for building lookup tables).
+		constexpr HashType GetHash()const { return mHash; }
+
 	private:
 		HashType mHash = 0;
 
 	public:
 		static constexpr Name Invalid() { return Name(); }
+
+		// Recreates a name from its raw hash (e.g. one stored in serialized data).
+		static constexpr Name FromHash(HashType hash)
+		{
+			Name name;
+			name.mHash = hash;
+			return name;
+		}
 		static inline constexpr const char* InvalidString = "None";
 
 		friend class DebugStringHashMap;
@@ -17,6 +17,10 @@ namespace CppReflPrivate
 	// Creates a static type if it doesn't already exist.
 	template <typename T>
 	const cpprefl::TypeInfo& MaybeCreateReflectedType(const cpprefl::Name& typeName);
+
+	// Generated serialization code of a class (see Serialization/GeneratedSerializer.h). Reflected classes befriend it, so it can access private fields.
+	template <typename T>
+	struct GeneratedSerializer;
 }
 
 namespace cpprefl
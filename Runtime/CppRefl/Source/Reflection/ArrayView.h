@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CppReflConfig.h"
+
+#if CPPREFL_WITH_STL()
+#include <array>
+#endif
+
+#if CPPREFL_WITH_STD_SPAN()
+#include <span>
+#endif
+
+#include "ContainerFunctions.h"
+#include "TypeInstanceInfo.h"
+#include "../CppReflStatics.h"
+
+namespace cpprefl
+{
+	// Functions that allow access to contiguous arrays that cannot be resized (e.g. std::array, std::span).
+	class ArrayViewFunctions : public ContainerFunctions
+	{
+	public:
+		static constexpr ContainerKind Kind = ContainerKind::ArrayView;
+
+		using GetDataFunction = void*(*)(void* arr);
+		using GetSizeFunction = ArraySizeType(*)(const void* arr);
+
+		ArrayViewFunctions(const TypeInstanceInfo& elementType, size_t elementStride, GetDataFunction getDataFunction, GetSizeFunction getSizeFunction) :
+			ContainerFunctions(Kind),
+			mElementType(elementType),
+			mElementStride(elementStride),
+			mGetData(getDataFunction),
+			mGetSize(getSizeFunction)
+		{}
+
+		// Element type.
+		TypeInstanceInfo mElementType;
+
+		// Distance in bytes between two consecutive elements.
+		size_t mElementStride;
+
+		// Returns a pointer to the start of the array data.
+		GetDataFunction mGetData;
+
+		// Returns the number of elements in the array.
+		GetSizeFunction mGetSize;
+
+	public:
+		// Returns a pointer to an element in the array. Does not do any bounds checking.
+		void* GetElement(void* arr, ArraySizeType index)const { return (std::byte*)mGetData(arr) + index * mElementStride; }
+	};
+
+#if CPPREFL_WITH_STL()
+	// Creates accessors for any container with contiguous storage and a fixed size (std::array, std::span).
+	class StdArrayViewFunctionsFactory
+	{
+	private:
+		template <typename Container>
+		static void* GetData(void* obj)
+		{
+			const auto& arr = static_cast<Container*>(obj);
+			return (void*)arr->data();
+		}
+
+		template <typename Container>
+		static ArraySizeType GetSize(const void* obj)
+		{
+			const auto& arr = static_cast<const Container*>(obj);
+			return (ArraySizeType)arr->size();
+		}
+
+	public:
+		template <typename Container>
+		static ArrayViewFunctions Create(const Name& elementTypeName)
+		{
+			using ElementType = typename Container::value_type;
+
+			return ArrayViewFunctions(
+				MakeTypeInstance<ElementType>(elementTypeName),
+				sizeof(ElementType),
+				GetData<Container>,
+				GetSize<Container>);
+		}
+	};
+#endif
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "CppReflConfig.h"
+
+#if CPPREFL_WITH_STL()
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#endif
+
+#include "ContainerFunctions.h"
+#include "TypeInstanceInfo.h"
+#include "../CppReflStatics.h"
+
+#if CPPREFL_WITH_STL()
+namespace CppReflPrivate
+{
+	// Detects containers that support reserve() (e.g. std::unordered_map but not std::map).
+	template <typename Container, typename = void>
+	struct HasReserve : std::false_type {};
+
+	template <typename Container>
+	struct HasReserve<Container, std::void_t<decltype(std::declval<Container&>().reserve(0))>> : std::true_type {};
+}
+#endif
+
+namespace cpprefl
+{
+	// Functions that allow access to templated key/value containers.
+	class AssociativeArrayFunctions : public ContainerFunctions
+	{
+	public:
+		static constexpr ContainerKind Kind = ContainerKind::AssociativeArray;
+
+		// Invoked for each entry when iterating. Return false to stop iterating.
+		using VisitFunction = bool(*)(void* context, const void* key, void* value);
+
+		using ConstructKeyFunction = void(*)(void* key);
+		using DestructKeyFunction = void(*)(void* key);
+		using GetSizeFunction = ArraySizeType(*)(const void* arr);
+		using ReserveFunction = void(*)(void* arr, ArraySizeType capacity);
+		using ClearFunction = void(*)(void* arr);
+		using EmplaceFunction = void*(*)(void* arr, void* key);
+		using FindFunction = void*(*)(void* arr, const void* key);
+		using EraseFunction = void(*)(void* arr, const void* key);
+		using ForEachFunction = void(*)(void* arr, VisitFunction visitor, void* context);
+
+		AssociativeArrayFunctions(
+			const TypeInstanceInfo& keyType,
+			const TypeInstanceInfo& valueType,
+			size_t keySize,
+			size_t keyAlignment,
+			ConstructKeyFunction constructKeyFunction,
+			DestructKeyFunction destructKeyFunction,
+			GetSizeFunction getSizeFunction,
+			ReserveFunction reserveFunction,
+			ClearFunction clearFunction,
+			EmplaceFunction emplaceFunction,
+			FindFunction findFunction,
+			EraseFunction eraseFunction,
+			ForEachFunction forEachFunction) :
+			ContainerFunctions(Kind),
+			mKeyType(keyType),
+			mValueType(valueType),
+			mKeySize(keySize),
+			mKeyAlignment(keyAlignment),
+			mConstructKey(constructKeyFunction),
+			mDestructKey(destructKeyFunction),
+			mGetSize(getSizeFunction),
+			mReserve(reserveFunction),
+			mClear(clearFunction),
+			mEmplace(emplaceFunction),
+			mFind(findFunction),
+			mErase(eraseFunction),
+			mForEach(forEachFunction)
+		{}
+
+		// Key type.
+		TypeInstanceInfo mKeyType;
+
+		// Value type.
+		TypeInstanceInfo mValueType;
+
+		// Size and alignment of a key, for callers that need to build a key before emplacing it.
+		size_t mKeySize;
+		size_t mKeyAlignment;
+
+		// Default constructs/destructs a key in caller provided memory.
+		ConstructKeyFunction mConstructKey;
+		DestructKeyFunction mDestructKey;
+
+		// Returns the number of entries in the container.
+		GetSizeFunction mGetSize;
+
+		// Ensures the container can hold at least the given number of entries without rehashing. No-op for ordered containers.
+		ReserveFunction mReserve;
+
+		// Removes all entries from the container.
+		ClearFunction mClear;
+
+		// Moves the key into the container (if not already present) and returns a pointer to its value.
+		// New values are default constructed in place. Returns nullptr if the value type is not default constructible.
+		EmplaceFunction mEmplace;
+
+		// Returns a pointer to the value for a key, or nullptr if it doesn't exist.
+		FindFunction mFind;
+
+		// Removes the entry for a key, if any. The key may point into the entry being removed.
+		EraseFunction mErase;
+
+		// Visits every entry in the container without copying.
+		ForEachFunction mForEach;
+	};
+
+#if CPPREFL_WITH_STL()
+	// Creates accessors for std::map and std::unordered_map (or anything with the same interface).
+	class StdAssociativeArrayFunctionsFactory
+	{
+	private:
+		template <typename Container>
+		static void ConstructKey(void* key)
+		{
+			new(key) typename Container::key_type();
+		}
+
+		template <typename Container>
+		static void DestructKey(void* key)
+		{
+			using KeyType = typename Container::key_type;
+			static_cast<KeyType*>(key)->~KeyType();
+		}
+
+		template <typename Container>
+		static ArraySizeType GetSize(const void* obj)
+		{
+			const auto& arr = static_cast<const Container*>(obj);
+			return (ArraySizeType)arr->size();
+		}
+
+		template <typename Container>
+		static void Reserve(void* obj, ArraySizeType capacity)
+		{
+			if constexpr (CppReflPrivate::HasReserve<Container>::value)
+			{
+				const auto& arr = static_cast<Container*>(obj);
+				arr->reserve(capacity);
+			}
+		}
+
+		template <typename Container>
+		static void Clear(void* obj)
+		{
+			const auto& arr = static_cast<Container*>(obj);
+			arr->clear();
+		}
+
+		template <typename Container>
+		static void* Emplace(void* obj, void* key)
+		{
+			if constexpr (std::is_default_constructible_v<typename Container::mapped_type>)
+			{
+				const auto& arr = static_cast<Container*>(obj);
+				return &arr->try_emplace(std::move(*static_cast<typename Container::key_type*>(key))).first->second;
+			}
+			else
+			{
+				return nullptr;
+			}
+		}
+
+		template <typename Container>
+		static void* Find(void* obj, const void* key)
+		{
+			const auto& arr = static_cast<Container*>(obj);
+			const auto it = arr->find(*static_cast<const typename Container::key_type*>(key));
+			return it != arr->end() ? &it->second : nullptr;
+		}
+
+		template <typename Container>
+		static void Erase(void* obj, const void* key)
+		{
+			const auto& arr = static_cast<Container*>(obj);
+			const auto it = arr->find(*static_cast<const typename Container::key_type*>(key));
+			if (it != arr->end())
+			{
+				arr->erase(it);
+			}
+		}
+
+		template <typename Container>
+		static void ForEach(void* obj, AssociativeArrayFunctions::VisitFunction visitor, void* context)
+		{
+			const auto& arr = static_cast<Container*>(obj);
+			for (auto& [key, value] : *arr)
+			{
+				if (!visitor(context, &key, &value))
+				{
+					return;
+				}
+			}
+		}
+
+	public:
+		template <typename Container>
+		static AssociativeArrayFunctions Create(const Name& keyTypeName, const Name& valueTypeName)
+		{
+			using KeyType = typename Container::key_type;
+			using ValueType = typename Container::mapped_type;
+
+			return AssociativeArrayFunctions(
+				MakeTypeInstance<KeyType>(keyTypeName),
+				MakeTypeInstance<ValueType>(valueTypeName),
+				sizeof(KeyType),
+				alignof(KeyType),
+				ConstructKey<Container>,
+				DestructKey<Container>,
+				GetSize<Container>,
+				Reserve<Container>,
+				Clear<Container>,
+				Emplace<Container>,
+				Find<Container>,
+				Erase<Container>,
+				ForEach<Container>);
+		}
+	};
+#endif
+}
@@ -1,9 +1,76 @@
 #include "ClassInfo.h"
 
+#include <algorithm>
+
+#include "../CppReflConfig.h"
 #include "FieldInfo.h"
+#include "TypeInfo.h"
 
 namespace cpprefl
 {
+	ClassInfo::ClassInfo(
+		const TypeInfo* type,
+		const ClassInfo* baseClass,
+		ClassConstructor ctor,
+		ClassDestructor dtor,
+		DynamicClassGetter dynamicClassGetter,
+		const FieldView& fields,
+		const FieldView& flattenedFields,
+		const MetadataTagView& tags,
+		const MetadataAttributeView& attributes) :
+		ObjectInfo(tags, attributes),
+		mType(type),
+		mBaseClass(baseClass),
+		mConstructor(ctor),
+		mDestructor(dtor),
+		mGetDynamicClass(dynamicClassGetter),
+		mFields(fields),
+		mFlattenedFields(flattenedFields)
+	{
+		BuildFieldTables();
+	}
+
+	void ClassInfo::BuildFieldTables()
+	{
+		if (mFlattenedFields.size() == 0)
+		{
+			return;
+		}
+
+		if (mFlattenedFields.size() > MaxFields)
+		{
+			CPPREFL_INTERNAL_FATAL_ERROR("Class has %zu fields, at most %zu are supported.", (size_t)mFlattenedFields.size(), MaxFields);
+		}
+
+		mFieldRecords.reserve(mFlattenedFields.size());
+		for (size_t i = 0; i < mFlattenedFields.size(); ++i)
+		{
+			mFieldRecords.emplace_back(mFlattenedFields[i], (uint16_t)i);
+		}
+
+		// Keep the table at most half full so probe sequences stay short.
+		size_t capacity = 1;
+		while (capacity < mFieldRecords.size() * 2)
+		{
+			capacity <<= 1;
+		}
+
+		mFieldIndex.assign(capacity, InvalidFieldIndex);
+
+		const size_t mask = capacity - 1;
+		for (size_t i = 0; i < mFieldRecords.size(); ++i)
+		{
+			size_t slot = mFieldRecords[i].mName.GetHash() & mask;
+			while (mFieldIndex[slot] != InvalidFieldIndex && !(mFieldRecords[mFieldIndex[slot]].mName == mFieldRecords[i].mName))
+			{
+				slot = (slot + 1) & mask;
+			}
+
+			// Fields are sorted by offset, so if a derived class hides a base class field then the derived field wins.
+			mFieldIndex[slot] = (uint16_t)i;
+		}
+	}
+
 	void ClassInfo::Construct(void* obj)const
 	{
 		mConstructor(obj);
@@ -30,16 +97,117 @@ namespace cpprefl
 		return false;
 	}
 
+	const ClassInfo* ClassInfo::GetDerivedClass(const Name& className) const
+	{
+		if (mDerivedClassIndex.empty())
+		{
+			return nullptr;
+		}
+
+		const size_t mask = mDerivedClassIndex.size() - 1;
+		for (size_t slot = className.GetHash() & mask; mDerivedClassIndex[slot].mClass != nullptr; slot = (slot + 1) & mask)
+		{
+			if (mDerivedClassIndex[slot].mName == className.GetHash())
+			{
+				return mDerivedClassIndex[slot].mClass;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void ClassInfo::AddDerivedClass(const ClassInfo& derivedClass)
+	{
+		if (GetDerivedClass(derivedClass.mType->mName) != nullptr)
+		{
+			return;
+		}
+
+		// Classes are only registered at startup, so simply rebuild the table every time.
+		std::vector<const ClassInfo*> classes = { &derivedClass };
+		for (const DerivedClassEntry& entry : mDerivedClassIndex)
+		{
+			if (entry.mClass != nullptr)
+			{
+				classes.push_back(entry.mClass);
+			}
+		}
+
+		// Keep the table at most half full so probe sequences stay short.
+		size_t capacity = 2;
+		while (capacity < classes.size() * 2)
+		{
+			capacity <<= 1;
+		}
+
+		mDerivedClassIndex.assign(capacity, { 0, nullptr });
+
+		const size_t mask = capacity - 1;
+		for (const ClassInfo* cls : classes)
+		{
+			size_t slot = cls->mType->mName.GetHash() & mask;
+			while (mDerivedClassIndex[slot].mClass != nullptr)
+			{
+				slot = (slot + 1) & mask;
+			}
+
+			mDerivedClassIndex[slot] = { cls->mType->mName.GetHash(), cls };
+		}
+	}
+
 	const FieldInfo* ClassInfo::GetField(const Name& fieldName) const
 	{
-		for (const auto& fieldInfo : mFields)
+		if (mFieldIndex.empty())
 		{
-			if (fieldInfo.mName == fieldName)
+			return nullptr;
+		}
+
+		const size_t mask = mFieldIndex.size() - 1;
+		for (size_t slot = fieldName.GetHash() & mask; mFieldIndex[slot] != InvalidFieldIndex; slot = (slot + 1) & mask)
+		{
+			const FieldRecord& record = mFieldRecords[mFieldIndex[slot]];
+			if (record.mName == fieldName)
 			{
-				return &fieldInfo;
+				return &GetFieldInfo(record);
 			}
 		}
 
 		return nullptr;
 	}
+
+	std::vector<FieldInfo> FlattenFields(const FieldView& fields, const ClassInfo* baseClass, size_t baseClassOffset)
+	{
+		// FieldInfo isn't assignable, so sort (absolute offset, field) pairs and copy the fields afterwards.
+		std::vector<std::pair<size_t, const FieldInfo*>> sortedFields;
+		if (baseClass != nullptr)
+		{
+			for (const auto& fieldInfo : baseClass->mFlattenedFields)
+			{
+				sortedFields.emplace_back(fieldInfo.mOffset + baseClassOffset, &fieldInfo);
+			}
+		}
+
+		for (const auto& fieldInfo : fields)
+		{
+			sortedFields.emplace_back(fieldInfo.mOffset, &fieldInfo);
+		}
+
+		std::stable_sort(sortedFields.begin(), sortedFields.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+		// The fields are viewed through a FieldView, which can't hold more.
+		if (sortedFields.size() > ClassInfo::MaxFields)
+		{
+			CPPREFL_INTERNAL_FATAL_ERROR("Class has %zu fields, at most %zu are supported.", sortedFields.size(), ClassInfo::MaxFields);
+		}
+
+		std::vector<FieldInfo> flattenedFields;
+		flattenedFields.reserve(sortedFields.size());
+		for (const auto& [offset, fieldInfo] : sortedFields)
+		{
+			flattenedFields.push_back(*fieldInfo);
+			flattenedFields.back().mOffset = offset;
+		}
+
+		return flattenedFields;
+	}
 }
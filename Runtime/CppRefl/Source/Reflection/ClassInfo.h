@@ -1,17 +1,68 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
 #include "FieldInfo.h"
 #include "ObjectInfo.h"
 
+namespace cpprefl
+{
+	class ClassInfo;
+	class FormatPlan;
+	class MemoryPlan;
+
+	namespace serialization
+	{
+		struct ClassSerializerFunctions;
+	}
+}
+
+namespace CppReflPrivate
+{
+	// Returns the offset of a base class within a derived class.
+	template <typename Derived, typename Base>
+	size_t GetBaseClassOffset()
+	{
+		// Use a non-null address, since casting nullptr always results in nullptr.
+		constexpr uintptr_t Address = 0x1000;
+		return (uintptr_t)static_cast<Base*>((Derived*)Address) - Address;
+	}
+
+	template <typename T, typename = void>
+	struct HasReflectedClassGetter : std::false_type {};
+
+	template <typename T>
+	struct HasReflectedClassGetter<T, std::void_t<decltype(std::declval<const T&>().GetReflectedClass())>> : std::true_type {};
+
+	// Returns a function that looks up the runtime class of an object through its virtual GetReflectedClass(), or nullptr if the class has none.
+	template <typename T>
+	constexpr auto GetDynamicClassGetter()
+	{
+		if constexpr (std::is_polymorphic_v<T> && HasReflectedClassGetter<T>::value)
+		{
+			return +[](const void* obj) -> const cpprefl::ClassInfo& { return static_cast<const T*>(obj)->GetReflectedClass(); };
+		}
+		else
+		{
+			return (const cpprefl::ClassInfo&(*)(const void*))nullptr;
+		}
+	}
+}
+
 namespace cpprefl
 {
 	class FieldInfo;
+	class Registry;
 	class TypeInfo;
 
-	using FieldView = Span<FieldInfo>;
+	using FieldView = Span<FieldInfo, uint16_t>;
 
 	using ClassConstructor = void(*)(void*);
 	using ClassDestructor = void(*)(void*);
+	using DynamicClassGetter = const ClassInfo&(*)(const void*);
 
 	// Information about a reflected class.
 	class ClassInfo : public ObjectInfo
@@ -22,11 +73,11 @@ namespace cpprefl
 			const ClassInfo* baseClass,
 			ClassConstructor ctor,
 			ClassDestructor dtor,
-			const FieldView& fields, 
+			DynamicClassGetter dynamicClassGetter,
+			const FieldView& fields,
+			const FieldView& flattenedFields,
 			const MetadataTagView& tags, 
-			const MetadataAttributeView& attributes) : ObjectInfo(tags, attributes), mType(type), mBaseClass(baseClass), mConstructor(ctor), mDestructor(dtor), mFields(fields)
-		{
-		}
+			const MetadataAttributeView& attributes);
 
 		// The type of this class.
 		const TypeInfo* mType;
@@ -38,16 +89,75 @@ namespace cpprefl
 		ClassConstructor mConstructor;
 		ClassDestructor mDestructor;
 
-		// All fields in this class.
+		// Returns the runtime class of an object (nullptr if this class isn't polymorphic).
+		DynamicClassGetter mGetDynamicClass;
+
+		// All fields declared in this class.
 		FieldView mFields;
 
+		// All fields in this class, including those of reflected base classes, sorted by offset.
+		FieldView mFlattenedFields;
+
+		// Most fields a class can have, including those of its reflected base classes.
+		static constexpr size_t MaxFields = 0xFFFE;
+
+	private:
+		// Hot field data, parallel to mFlattenedFields.
+		std::vector<FieldRecord> mFieldRecords;
+
+		// Open addressing hash table of indices into mFieldRecords, keyed by field name.
+		std::vector<uint16_t> mFieldIndex;
+
+		static constexpr uint16_t InvalidFieldIndex = 0xFFFF;
+		static_assert(std::is_same_v<decltype(FieldRecord::mFieldIndex), uint16_t>, "Field indices should match FieldRecord::mFieldIndex.");
+		static_assert(std::is_same_v<decltype(std::declval<FieldView>().size()), uint16_t>, "Field indices should cover every field in a FieldView.");
+		static_assert(MaxFields < InvalidFieldIndex, "Field indices should leave room for InvalidFieldIndex.");
+
+		void BuildFieldTables();
+
+		struct DerivedClassEntry
+		{
+			Name::HashType mName;
+			const ClassInfo* mClass;
+		};
+
+		// Open addressing hash table of this class and all of its reflected derived classes, keyed by class name.
+		// Filled in by the registry as classes are registered.
+		std::vector<DerivedClassEntry> mDerivedClassIndex;
+
+		// Generated serialization code for this class, if any. Set by the registry.
+		const serialization::ClassSerializerFunctions* mSerializerFunctions = nullptr;
+
+		// Built the first time an object of this class is formatted, see FormatPlan.
+		mutable std::once_flag mFormatPlanFlag;
+		mutable std::shared_ptr<const FormatPlan> mFormatPlan;
+
+		// Built the first time an object of this class is measured, see MemoryPlan.
+		mutable std::once_flag mMemoryPlanFlag;
+		mutable std::shared_ptr<const MemoryPlan> mMemoryPlan;
+
+		friend class FormatPlan;
+		friend class MemoryPlan;
+		friend class Registry;
+		void AddDerivedClass(const ClassInfo& derivedClass);
+
 	public:
 		void Construct(void* obj)const;
 		void Destruct(void* obj)const;
 
+		// Returns the most derived class of an object of this class.
+		const ClassInfo& GetDynamicClass(const void* obj)const { return mGetDynamicClass != nullptr ? mGetDynamicClass(obj) : *this; }
+
 		// Returns if this class is a child of the given class.
 		bool IsA(const ClassInfo& baseClass)const;
 
+		// Returns this class or the derived class with the given name, or nullptr if there is no such class.
+		// A single hash table probe, meant for creating objects by name (e.g. deserializing polymorphic pointers).
+		const ClassInfo* GetDerivedClass(const Name& className)const;
+
+		// Returns the generated serialization code of this class, or nullptr if the class only has its reflection data.
+		const serialization::ClassSerializerFunctions* GetSerializerFunctions()const { return mSerializerFunctions; }
+
 		// Returns if this class is a child of the given class.
 		template <typename T>
 		bool IsA()const
@@ -55,8 +165,16 @@ namespace cpprefl
 			return IsA(GetReflectedClass<T>());
 		}
 
+		// Returns a field in this class or any of its reflected base classes.
 		const FieldInfo* GetField(const Name& fieldName)const;
 
+		// Returns the compact records of all fields in this class (including base class fields), sorted by offset.
+		// Prefer these over mFlattenedFields when iterating, and only look up the full FieldInfo when needed.
+		Span<FieldRecord, uint16_t> GetFieldRecords()const { return mFieldRecords; }
+
+		// Returns the full field info of a record.
+		const FieldInfo& GetFieldInfo(const FieldRecord& record)const { return mFlattenedFields[record.mFieldIndex]; }
+
 		// Returns the value of a field in memory, but does not do any validation on if the given template type matches the actual field type.
 		template <typename T>
 		T* GetFieldValueUnsafe(void* classObject, const Name& fieldName)const;
@@ -67,6 +185,9 @@ namespace cpprefl
 		T* GetFieldValueSafe(void* classObject, const Name& fieldName)const;
 	};
 
+	// Builds the flattened field list of a class: all fields of the reflected base classes (relocated to their absolute offsets) and the class' own fields, sorted by offset.
+	std::vector<FieldInfo> FlattenFields(const FieldView& fields, const ClassInfo* baseClass, size_t baseClassOffset);
+
 	template <typename T>
 	T* ClassInfo::GetFieldValueUnsafe(void* classObject, const Name& fieldName) const
 	{
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace cpprefl
+{
+	// The kind of accessor table a container exposes.
+	enum class ContainerKind : uint8_t
+	{
+		DynamicArray,		// std::vector
+		ArrayView,			// std::array, std::span
+		AssociativeArray,	// std::map, std::unordered_map
+		Optional,			// std::optional, std::unique_ptr
+	};
+
+	// Base class for all container accessor tables.
+	class ContainerFunctions
+	{
+	public:
+		constexpr explicit ContainerFunctions(ContainerKind kind) : mKind(kind)
+		{
+		}
+
+		// The kind of container, which determines the concrete accessor table type.
+		ContainerKind mKind;
+	};
+}
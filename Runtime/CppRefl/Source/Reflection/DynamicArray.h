@@ -6,31 +6,84 @@
 #include <vector>
 #endif
 
+#include "ContainerFunctions.h"
+#include "TypeInstanceInfo.h"
 #include "../CppReflStatics.h"
 
 namespace cpprefl
 {
 	// Functions that allow access to templated dynamic arrays.
-	class DynamicArrayFunctions
+	class DynamicArrayFunctions : public ContainerFunctions
 	{
 	public:
+		static constexpr ContainerKind Kind = ContainerKind::DynamicArray;
+
 		using SetSizeFunction = void(*)(void* arr, ArraySizeType size);
 		using GetDataFunction = void*(*)(void* arr);
+		using GetSizeFunction = ArraySizeType(*)(const void* arr);
+		using GetCapacityFunction = ArraySizeType(*)(const void* arr);
+		using ReserveFunction = void(*)(void* arr, ArraySizeType capacity);
+		using ResizeFunction = void(*)(void* arr, ArraySizeType size);
+		using EmplaceBackFunction = void*(*)(void* arr);
+		using ClearFunction = void(*)(void* arr);
 
-		DynamicArrayFunctions(const TypeInstanceInfo& elementType, SetSizeFunction setSizeFunction, GetDataFunction getDataFunction) :
+		DynamicArrayFunctions(
+			const TypeInstanceInfo& elementType,
+			size_t elementStride,
+			SetSizeFunction setSizeFunction,
+			GetDataFunction getDataFunction,
+			GetSizeFunction getSizeFunction,
+			GetCapacityFunction getCapacityFunction,
+			ReserveFunction reserveFunction,
+			ResizeFunction resizeFunction,
+			EmplaceBackFunction emplaceBackFunction,
+			ClearFunction clearFunction) :
+			ContainerFunctions(Kind),
 			mElementType(elementType),
+			mElementStride(elementStride),
 			mSetSize(setSizeFunction),
-			mGetData(getDataFunction)
+			mGetData(getDataFunction),
+			mGetSize(getSizeFunction),
+			mGetCapacity(getCapacityFunction),
+			mReserve(reserveFunction),
+			mResize(resizeFunction),
+			mEmplaceBack(emplaceBackFunction),
+			mClear(clearFunction)
 		{}
 
 		// Element type.
 		TypeInstanceInfo mElementType;
 
-		// Sets the size/capacity of the array.
+		// Distance in bytes between two consecutive elements.
+		size_t mElementStride;
+
+		// Sets the size/capacity of the array. Existing contents are discarded.
 		SetSizeFunction mSetSize;
 
 		// Returns a pointer to the start of the array data.
 		GetDataFunction mGetData;
+
+		// Returns the number of elements in the array.
+		GetSizeFunction mGetSize;
+
+		// Returns the number of elements the array can hold without reallocating.
+		GetCapacityFunction mGetCapacity;
+
+		// Ensures the array can hold at least the given number of elements without reallocating.
+		ReserveFunction mReserve;
+
+		// Resizes the array, preserving existing elements and default constructing new ones.
+		ResizeFunction mResize;
+
+		// Default constructs a new element at the end of the array and returns a pointer to it.
+		EmplaceBackFunction mEmplaceBack;
+
+		// Removes all elements from the array (capacity is retained).
+		ClearFunction mClear;
+
+	public:
+		// Returns a pointer to an element in the array. Does not do any bounds checking.
+		void* GetElement(void* arr, ArraySizeType index)const { return (std::byte*)mGetData(arr) + index * mElementStride; }
 	};
 
 #if CPPREFL_WITH_STL()
@@ -51,11 +104,63 @@ namespace cpprefl
 			return arr->data();
 		}
 
+		template <typename T>
+		static ArraySizeType GetSize(const void* obj)
+		{
+			const auto& arr = static_cast<const std::vector<T>*>(obj);
+			return (ArraySizeType)arr->size();
+		}
+
+		template <typename T>
+		static ArraySizeType GetCapacity(const void* obj)
+		{
+			const auto& arr = static_cast<const std::vector<T>*>(obj);
+			return (ArraySizeType)arr->capacity();
+		}
+
+		template <typename T>
+		static void Reserve(void* obj, ArraySizeType capacity)
+		{
+			const auto& arr = static_cast<std::vector<T>*>(obj);
+			arr->reserve(capacity);
+		}
+
+		template <typename T>
+		static void Resize(void* obj, ArraySizeType size)
+		{
+			const auto& arr = static_cast<std::vector<T>*>(obj);
+			arr->resize(size);
+		}
+
+		template <typename T>
+		static void* EmplaceBack(void* obj)
+		{
+			const auto& arr = static_cast<std::vector<T>*>(obj);
+			return &arr->emplace_back();
+		}
+
+		template <typename T>
+		static void Clear(void* obj)
+		{
+			const auto& arr = static_cast<std::vector<T>*>(obj);
+			arr->clear();
+		}
+
 	public:
 		template <typename T>
 		static DynamicArrayFunctions Create(const Name& elementTypeName)
 		{
-			return DynamicArrayFunctions(MakeTypeInstance<T>(elementTypeName), SetSize<T>, GetData<T>);
+			return DynamicArrayFunctions(
+				MakeTypeInstance<T>(elementTypeName),
+				sizeof(T),
+				SetSize<T>,
+				GetData<T>,
+				GetSize<T>,
+				GetCapacity<T>,
+				Reserve<T>,
+				Resize<T>,
+				EmplaceBack<T>,
+				Clear<T>);
 		}
 	};
 #endif
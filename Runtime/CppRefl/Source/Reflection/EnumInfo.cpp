@@ -1,5 +1,66 @@
 #include "EnumInfo.h"
 
+#include <algorithm>
+
 namespace cpprefl
 {
-}
\ No newline at end of file
+	EnumInfo::EnumInfo(const TypeInfo* type, const EnumValueView& values, const MetadataTagView& tags, const MetadataAttributeView& attributes) :
+		ObjectInfo(tags, attributes),
+		mType(type),
+		mValues(values)
+	{
+		BuildValueTable();
+	}
+
+	void EnumInfo::BuildValueTable()
+	{
+		if (mValues.size() == 0)
+		{
+			return;
+		}
+
+		int64_t minValue = mValues[0].mValue;
+		int64_t maxValue = mValues[0].mValue;
+		for (const EnumValueInfo& value : mValues)
+		{
+			minValue = std::min<int64_t>(minValue, value.mValue);
+			maxValue = std::max<int64_t>(maxValue, value.mValue);
+		}
+
+		// Use a dense table unless most of it would be holes, e.g. for flags.
+		const int64_t range = maxValue - minValue + 1;
+		if (range <= (int64_t)mValues.size() * 2 + 16)
+		{
+			mMinValue = (int)minValue;
+			mValuesByNumber.assign((size_t)range, nullptr);
+
+			// Iterate in reverse so that the first declared of several values with the same number wins.
+			for (const EnumValueInfo* value = mValues.end(); value != mValues.begin();)
+			{
+				--value;
+				mValuesByNumber[(size_t)(value->mValue - minValue)] = value;
+			}
+			return;
+		}
+
+		for (const EnumValueInfo& value : mValues)
+		{
+			mSortedValues.push_back(&value);
+		}
+
+		std::stable_sort(mSortedValues.begin(), mSortedValues.end(), [](const EnumValueInfo* lhs, const EnumValueInfo* rhs) { return lhs->mValue < rhs->mValue; });
+		mSortedValues.erase(std::unique(mSortedValues.begin(), mSortedValues.end(), [](const EnumValueInfo* lhs, const EnumValueInfo* rhs) { return lhs->mValue == rhs->mValue; }), mSortedValues.end());
+	}
+
+	const EnumValueInfo* EnumInfo::GetValue(int value)const
+	{
+		if (!mValuesByNumber.empty())
+		{
+			const int64_t index = (int64_t)value - mMinValue;
+			return index >= 0 && index < (int64_t)mValuesByNumber.size() ? mValuesByNumber[(size_t)index] : nullptr;
+		}
+
+		const auto it = std::lower_bound(mSortedValues.begin(), mSortedValues.end(), value, [](const EnumValueInfo* lhs, int rhs) { return lhs->mValue < rhs; });
+		return it != mSortedValues.end() && (*it)->mValue == value ? *it : nullptr;
+	}
+}
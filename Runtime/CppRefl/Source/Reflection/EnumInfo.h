@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string_view>
+#include <vector>
+
 #include "CppReflHash.h"
 #include "CppReflStatics.h"
 #include "ObjectInfo.h"
@@ -14,15 +17,19 @@ namespace cpprefl
 	public:
 		constexpr EnumValueInfo(
 			const Name& name, 
+			std::string_view nameString,
 			int value, 
 			const MetadataTagView& tags, 
-			const MetadataAttributeView& attributes) : ObjectInfo(tags, attributes), mName(name), mValue(value)
+			const MetadataAttributeView& attributes) : ObjectInfo(tags, attributes), mName(name), mNameString(nameString), mValue(value)
 		{
 		}
 
 		// Enum value name.
 		Name mName;
 
+		// Enum value name as a string (e.g. for text serialization).
+		std::string_view mNameString;
+
 		// Enum value.
 		int mValue;
 	};
@@ -33,9 +40,7 @@ namespace cpprefl
 	class EnumInfo : public ObjectInfo
 	{
 	public:
-		constexpr EnumInfo(const TypeInfo* type, const EnumValueView& values, const MetadataTagView& tags, const MetadataAttributeView& attributes) : ObjectInfo(tags, attributes), mType(type), mValues(values)
-		{
-		}
+		EnumInfo(const TypeInfo* type, const EnumValueView& values, const MetadataTagView& tags, const MetadataAttributeView& attributes);
 
 		// The type of this class.
 		const TypeInfo* mType;
@@ -46,7 +51,21 @@ namespace cpprefl
 	public:
 		constexpr const EnumValueInfo* GetValue(const Name& name)const { return mValues.Find(name, EnumEquals); }
 
+		// Returns the value with the given number (the first declared one if several share it). A table lookup, meant for
+		// writing enums as text.
+		const EnumValueInfo* GetValue(int value)const;
+
 	private:
 		static constexpr bool EnumEquals(const EnumValueInfo& value1, const Name& value2) { return value1.mName == value2; }
+
+		void BuildValueTable();
+
+		// Values indexed by their number minus mMinValue if the numbers are close together (as they usually are), with nullptr
+		// for numbers that aren't values. Otherwise empty, and mSortedValues is used instead.
+		std::vector<const EnumValueInfo*> mValuesByNumber;
+		int mMinValue = 0;
+
+		// Values sorted by number, without duplicates.
+		std::vector<const EnumValueInfo*> mSortedValues;
 	};
 }
@@ -11,4 +11,31 @@ namespace cpprefl
 	{
 		return (std::byte*)fieldObject - mOffset;
 	}
+
+	FieldRecord::FieldRecord(const FieldInfo& fieldInfo, uint16_t fieldIndex) :
+		mOffset((uint32_t)fieldInfo.mOffset),
+		mName(fieldInfo.mName),
+		mKind(fieldInfo.GetType().mKind),
+		mFlags(FieldFlags::None),
+		mFieldIndex(fieldIndex),
+		mArraySize(fieldInfo.mTypeInstance.mArraySize)
+	{
+		const auto& type = fieldInfo.mTypeInstance;
+		if (type.mIsConst)
+		{
+			mFlags = mFlags | FieldFlags::Const;
+		}
+		if (type.mIsArray)
+		{
+			mFlags = mFlags | FieldFlags::Array;
+		}
+		if (type.mIsPointer)
+		{
+			mFlags = mFlags | FieldFlags::Pointer;
+		}
+		if (fieldInfo.mContainerFunctions != nullptr)
+		{
+			mFlags = mFlags | FieldFlags::Container;
+		}
+	}
 }
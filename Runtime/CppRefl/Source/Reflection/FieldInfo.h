@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ContainerFunctions.h"
 #include "ObjectInfo.h"
 #include "TypeInstanceInfo.h"
 
@@ -11,11 +12,13 @@ namespace cpprefl
 	class FieldInfo : public ObjectInfo
 	{
 	public:
-		FieldInfo(TypeInstanceInfo type, size_t offset, const Name& name, const MetadataTagView& tags, const MetadataAttributeView& attributes) :
+		FieldInfo(TypeInstanceInfo type, size_t offset, const Name& name, std::string_view nameString, const MetadataTagView& tags, const MetadataAttributeView& attributes, const ContainerFunctions* containerFunctions = nullptr) :
 			ObjectInfo(tags, attributes),
 			mTypeInstance(std::move(type)),
 			mOffset(offset),
-			mName(name)
+			mName(name),
+			mNameString(nameString),
+			mContainerFunctions(containerFunctions)
 		{
 		}
 
@@ -28,9 +31,22 @@ namespace cpprefl
 		// Name of this field.
 		Name mName;
 
+		// Name of this field as a string (e.g. for text serialization).
+		std::string_view mNameString;
+
+		// Accessor table if this field is a container (std::vector, std::map, etc.), otherwise nullptr.
+		const ContainerFunctions* mContainerFunctions;
+
 	public:
 		const TypeInfo& GetType()const { return mTypeInstance.mType; }
 
+		// Returns the container accessor table for this field if it is of the given kind (e.g. DynamicArrayFunctions), otherwise nullptr.
+		template <typename T>
+		const T* GetContainerFunctions()const
+		{
+			return mContainerFunctions != nullptr && mContainerFunctions->mKind == T::Kind ? static_cast<const T*>(mContainerFunctions) : nullptr;
+		}
+
 		// Returns a raw pointer to this field in a class blob.
 		void* GetMemoryInClass(void* classObject)const;
 
@@ -40,4 +56,49 @@ namespace cpprefl
 		// Returns a raw pointer to the class blob that owns this field.
 		void* GetClassObject(void* fieldObject)const;
 	};
+
+	// Modifiers of a field, packed into a FieldRecord.
+	enum class FieldFlags : uint8_t
+	{
+		None = 0,
+		Const = 1 << 0,
+		Array = 1 << 1,
+		Pointer = 1 << 2,
+		Container = 1 << 3,
+	};
+
+	constexpr FieldFlags operator|(FieldFlags lhs, FieldFlags rhs) { return (FieldFlags)((uint8_t)lhs | (uint8_t)rhs); }
+	constexpr bool operator&(FieldFlags lhs, FieldFlags rhs) { return ((uint8_t)lhs & (uint8_t)rhs) != 0; }
+
+	// Compact copy of the data needed to walk the fields of a class (e.g. when serializing).
+	// Records are stored contiguously per class; everything else (type info, metadata, container accessors) lives in the FieldInfo they point at.
+	struct FieldRecord
+	{
+		explicit FieldRecord(const FieldInfo& fieldInfo, uint16_t fieldIndex);
+
+		// Offset of this field into the containing class.
+		uint32_t mOffset;
+
+		// Name of this field.
+		Name mName;
+
+		// Type kind of this field.
+		TypeKind mKind;
+
+		FieldFlags mFlags;
+
+		// Index of the full FieldInfo in ClassInfo::mFlattenedFields.
+		uint16_t mFieldIndex;
+
+		// Fixed array size (only relevant if the Array flag is set).
+		ArraySizeType mArraySize;
+
+	public:
+		bool HasFlag(FieldFlags flag)const { return mFlags & flag; }
+
+		// Returns a raw pointer to this field in a class blob.
+		void* GetMemoryInClass(void* classObject)const { return (std::byte*)classObject + mOffset; }
+	};
+
+	static_assert(sizeof(FieldRecord) == 16, "FieldRecord should fit four to a cache line.");
 }
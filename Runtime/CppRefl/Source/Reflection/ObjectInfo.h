@@ -1,27 +1,44 @@
 #pragma once
 
+#include <cstdint>
+
 #include "CppReflHash.h"
 #include "Span.h"
 
 namespace cpprefl
 {
+	// Type of the value of an attribute.
+	enum class MetadataAttributeType : uint8_t
+	{
+		String,
+		Int,
+		Float,
+	};
+
 	// Value associated with an attribute.
 	struct MetadataAttributeValue
 	{
-		explicit constexpr MetadataAttributeValue(const Name& value) : mString(value) {}
-		explicit constexpr MetadataAttributeValue(int value) : mInt(value) {}
-		explicit constexpr MetadataAttributeValue(float value) : mFloat(value) {}
+		explicit constexpr MetadataAttributeValue(const Name& value) : mString(value), mType(MetadataAttributeType::String) {}
+		explicit constexpr MetadataAttributeValue(int value) : mInt(value), mType(MetadataAttributeType::Int) {}
+		explicit constexpr MetadataAttributeValue(float value) : mFloat(value), mType(MetadataAttributeType::Float) {}
 
 		constexpr operator Name() const { return mString; }
 		constexpr operator int() const { return mInt; }
 		constexpr operator float() const { return mFloat; }
 
+		constexpr bool IsNumber()const { return mType != MetadataAttributeType::String; }
+
+		// Returns the value of a number attribute, whether it was written as an integer or not.
+		constexpr double GetNumber()const { return mType == MetadataAttributeType::Int ? (double)mInt : (double)mFloat; }
+
 		union
 		{
 			Name mString;
 			int mInt;
 			float mFloat;
 		};
+
+		MetadataAttributeType mType;
 	};
 
 	using MetadataTag = Name;
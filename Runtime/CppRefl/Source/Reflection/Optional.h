@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CppReflConfig.h"
+
+#if CPPREFL_WITH_STL()
+#include <memory>
+#include <optional>
+#include <type_traits>
+#endif
+
+#include "ContainerFunctions.h"
+#include "TypeInstanceInfo.h"
+#include "../CppReflStatics.h"
+
+namespace cpprefl
+{
+	// Functions that allow access to containers holding zero or one value (e.g. std::optional, std::unique_ptr).
+	class OptionalFunctions : public ContainerFunctions
+	{
+	public:
+		static constexpr ContainerKind Kind = ContainerKind::Optional;
+
+		using GetValueFunction = void*(*)(void* obj);
+		using EmplaceFunction = void*(*)(void* obj);
+		using ResetFunction = void(*)(void* obj);
+
+		OptionalFunctions(const TypeInstanceInfo& valueType, GetValueFunction getValueFunction, EmplaceFunction emplaceFunction, ResetFunction resetFunction) :
+			ContainerFunctions(Kind),
+			mValueType(valueType),
+			mGetValue(getValueFunction),
+			mEmplace(emplaceFunction),
+			mReset(resetFunction)
+		{}
+
+		// Value type.
+		TypeInstanceInfo mValueType;
+
+		// Returns a pointer to the contained value, or nullptr if there is none.
+		GetValueFunction mGetValue;
+
+		// Replaces the contained value with a default constructed one and returns a pointer to it.
+		// Returns nullptr if the value type is not default constructible (e.g. an abstract class).
+		EmplaceFunction mEmplace;
+
+		// Destroys the contained value, if any.
+		ResetFunction mReset;
+
+	public:
+		bool HasValue(void* obj)const { return mGetValue(obj) != nullptr; }
+	};
+
+#if CPPREFL_WITH_STL()
+	class StdOptionalFunctionsFactory
+	{
+	private:
+		template <typename T>
+		static void* GetValue(void* obj)
+		{
+			const auto& opt = static_cast<std::optional<T>*>(obj);
+			return opt->has_value() ? &opt->value() : nullptr;
+		}
+
+		template <typename T>
+		static void* Emplace(void* obj)
+		{
+			if constexpr (std::is_default_constructible_v<T>)
+			{
+				const auto& opt = static_cast<std::optional<T>*>(obj);
+				return &opt->emplace();
+			}
+			else
+			{
+				return nullptr;
+			}
+		}
+
+		template <typename T>
+		static void Reset(void* obj)
+		{
+			const auto& opt = static_cast<std::optional<T>*>(obj);
+			opt->reset();
+		}
+
+	public:
+		template <typename T>
+		static OptionalFunctions Create(const Name& valueTypeName)
+		{
+			return OptionalFunctions(MakeTypeInstance<T>(valueTypeName), GetValue<T>, Emplace<T>, Reset<T>);
+		}
+	};
+
+	class StdUniquePtrFunctionsFactory
+	{
+	private:
+		template <typename T>
+		static void* GetValue(void* obj)
+		{
+			const auto& ptr = static_cast<std::unique_ptr<T>*>(obj);
+			return ptr->get();
+		}
+
+		template <typename T>
+		static void* Emplace(void* obj)
+		{
+			if constexpr (std::is_default_constructible_v<T> && !std::is_abstract_v<T>)
+			{
+				const auto& ptr = static_cast<std::unique_ptr<T>*>(obj);
+				*ptr = std::make_unique<T>();
+				return ptr->get();
+			}
+			else
+			{
+				return nullptr;
+			}
+		}
+
+		template <typename T>
+		static void Reset(void* obj)
+		{
+			const auto& ptr = static_cast<std::unique_ptr<T>*>(obj);
+			ptr->reset();
+		}
+
+	public:
+		template <typename T>
+		static OptionalFunctions Create(const Name& valueTypeName)
+		{
+			return OptionalFunctions(MakeTypeInstance<T>(valueTypeName), GetValue<T>, Emplace<T>, Reset<T>);
+		}
+	};
+#endif
+}
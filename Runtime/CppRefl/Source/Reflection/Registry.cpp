@@ -68,6 +68,75 @@ namespace cpprefl
 		return nullptr;
 	}
 
+	const ArrayViewFunctions& Registry::AddArrayViewFunctions(const Name& name, ArrayViewFunctions functions)
+	{
+		if (mArrayViewFunctions.find(name) == mArrayViewFunctions.end())
+		{
+			return mArrayViewFunctions.emplace(name, functions).first->second;
+		}
+
+		return *GetArrayViewFunctions(name);
+	}
+
+	const ArrayViewFunctions* Registry::GetArrayViewFunctions(const Name& name)
+	{
+		if (mArrayViewFunctions.find(name) != mArrayViewFunctions.end())
+		{
+			return &mArrayViewFunctions.at(name);
+		}
+
+		return nullptr;
+	}
+
+	const AssociativeArrayFunctions& Registry::AddAssociativeArrayFunctions(const Name& name, AssociativeArrayFunctions functions)
+	{
+		if (mAssociativeArrayFunctions.find(name) == mAssociativeArrayFunctions.end())
+		{
+			return mAssociativeArrayFunctions.emplace(name, functions).first->second;
+		}
+
+		return *GetAssociativeArrayFunctions(name);
+	}
+
+	const AssociativeArrayFunctions* Registry::GetAssociativeArrayFunctions(const Name& name)
+	{
+		if (mAssociativeArrayFunctions.find(name) != mAssociativeArrayFunctions.end())
+		{
+			return &mAssociativeArrayFunctions.at(name);
+		}
+
+		return nullptr;
+	}
+
+	const OptionalFunctions& Registry::AddOptionalFunctions(const Name& name, OptionalFunctions functions)
+	{
+		if (mOptionalFunctions.find(name) == mOptionalFunctions.end())
+		{
+			return mOptionalFunctions.emplace(name, functions).first->second;
+		}
+
+		return *GetOptionalFunctions(name);
+	}
+
+	const OptionalFunctions* Registry::GetOptionalFunctions(const Name& name)
+	{
+		if (mOptionalFunctions.find(name) != mOptionalFunctions.end())
+		{
+			return &mOptionalFunctions.at(name);
+		}
+
+		return nullptr;
+	}
+
+	void Registry::SetSerializerFunctions(const ClassInfo& classInfo, const serialization::ClassSerializerFunctions& functions)
+	{
+		const auto cls = mClasses.find(classInfo.mType->mName);
+		if (cls != mClasses.end())
+		{
+			cls->second.mSerializerFunctions = &functions;
+		}
+	}
+
 	Span<const ClassInfo*> Registry::GetDerivedClasses(const ClassInfo& baseClass) const
 	{
 		if (mClassHierarchy.find(&baseClass) != mClassHierarchy.end())
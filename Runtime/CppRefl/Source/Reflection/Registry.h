@@ -2,10 +2,13 @@
 
 #include <map>
 
+#include "ArrayView.h"
+#include "AssociativeArray.h"
 #include "ClassInfo.h"
 #include "DynamicArray.h"
 #include "EnumInfo.h"
 #include "FunctionInfo.h"
+#include "Optional.h"
 #include "TypeInfo.h"
 #include "../CppReflStatics.h"
 
@@ -38,6 +41,18 @@ namespace cpprefl
 		const DynamicArrayFunctions& AddDynamicArrayFunctions(const Name& name, DynamicArrayFunctions functions);
 		const DynamicArrayFunctions* GetDynamicArrayFunctions(const Name& name);
 
+		const ArrayViewFunctions& AddArrayViewFunctions(const Name& name, ArrayViewFunctions functions);
+		const ArrayViewFunctions* GetArrayViewFunctions(const Name& name);
+
+		const AssociativeArrayFunctions& AddAssociativeArrayFunctions(const Name& name, AssociativeArrayFunctions functions);
+		const AssociativeArrayFunctions* GetAssociativeArrayFunctions(const Name& name);
+
+		const OptionalFunctions& AddOptionalFunctions(const Name& name, OptionalFunctions functions);
+		const OptionalFunctions* GetOptionalFunctions(const Name& name);
+
+		// Attaches generated serialization code to a class (see serialization::RegisterGeneratedSerializer()).
+		void SetSerializerFunctions(const ClassInfo& classInfo, const serialization::ClassSerializerFunctions& functions);
+
 		// Get a list of a derived classes.
 		Span<const ClassInfo*> GetDerivedClasses(const ClassInfo& baseClass)const;
 
@@ -60,6 +75,15 @@ namespace cpprefl
 		// Dynamic array accessors.
 		HashMap<Name, DynamicArrayFunctions> mDynamicArrayFunctions;
 
+		// Fixed size array accessors.
+		HashMap<Name, ArrayViewFunctions> mArrayViewFunctions;
+
+		// Key/value container accessors.
+		HashMap<Name, AssociativeArrayFunctions> mAssociativeArrayFunctions;
+
+		// Optional/owning pointer accessors.
+		HashMap<Name, OptionalFunctions> mOptionalFunctions;
+
 		// Base classes.
 		HashMap<const ClassInfo*, std::vector<const ClassInfo*>> mClassHierarchy;
 	};
@@ -91,6 +115,7 @@ namespace cpprefl
 
 		// Update the class heirarchy.
 		mClassHierarchy[&classInfo] = {};
+		classInfo.AddDerivedClass(classInfo);
 
 		// Update all base classes.
 		const ClassInfo* baseClass = classInfo.mBaseClass;
@@ -105,6 +130,13 @@ namespace cpprefl
 				mClassHierarchy[baseClass].push_back(&classInfo);
 			}
 
+			// Base classes are registered before the classes deriving from them, so they're ours to modify.
+			const auto base = mClasses.find(baseClass->mType->mName);
+			if (base != mClasses.end())
+			{
+				base->second.AddDerivedClass(classInfo);
+			}
+
 			baseClass = baseClass->mBaseClass;
 		}
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <string_view>
 #include <type_traits>
 
 #include "../CppReflHash.h"
@@ -9,7 +11,7 @@ namespace cpprefl
 	class ClassInfo;
 	class EnumInfo;
 
-	enum class TypeKind
+	enum class TypeKind : uint8_t
 	{
 		Invalid = 0,
 
@@ -45,7 +47,7 @@ namespace cpprefl
 	class TypeInfo
 	{
 	public:
-		TypeInfo(const Name& name, TypeKind kind, size_t size) : mName(name), mKind(kind), mSize(size)
+		TypeInfo(const Name& name, TypeKind kind, size_t size, std::string_view nameString = {}) : mName(name), mKind(kind), mSize(size), mNameString(nameString)
 		{
 		}
 
@@ -58,6 +60,9 @@ namespace cpprefl
 		// Size of this type.
 		size_t mSize;
 
+		// Name of this type as a string (only set for reflected classes and enums).
+		std::string_view mNameString;
+
 	public:
 		// Returns the class info represented by this type.
 		const ClassInfo* GetClassInfo()const;
@@ -77,6 +77,15 @@ namespace cpprefl
 	template <typename T>
 	constexpr TypeInstanceInfo MakeTypeInstance(const Name& typeName)
 	{
-		return MakeTypeInstance<T>(CppReflPrivate::MaybeCreateReflectedType<T>(typeName));
+		// Pointers/arrays of classes (e.g. the elements of a std::vector<Base*>) should refer to the reflected class itself.
+		using ValueType = std::remove_cv_t<std::remove_pointer_t<std::remove_all_extents_t<T>>>;
+		if constexpr (std::is_class_v<ValueType>)
+		{
+			return MakeTypeInstance<T>(CppReflPrivate::MaybeCreateReflectedType<ValueType>(typeName));
+		}
+		else
+		{
+			return MakeTypeInstance<T>(CppReflPrivate::MaybeCreateReflectedType<T>(typeName));
+		}
 	}
 }
@@ -0,0 +1,1007 @@
+#include "BinaryDeserializer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "DeserializationArena.h"
+#include "NumberConversion.h"
+#include "../CppReflConfig.h"
+#include "../Reflection/Registry.h"
+
+namespace cpprefl::binary
+{
+	namespace
+	{
+		// Bounds recursion on malformed input.
+		constexpr int MaxTypeDepth = 64;
+
+		// A number read as one type, to be stored as another.
+		struct Number
+		{
+			bool mIsFloatingPoint = false;
+			bool mIsSigned = false;
+			long double mFloat = 0;
+
+			// Sign extended if mIsSigned.
+			uint64_t mInteger = 0;
+		};
+
+		template <typename T>
+		T LoadBytes(const std::byte* bytes)
+		{
+			T value;
+			std::memcpy(&value, bytes, sizeof(T));
+			return value;
+		}
+
+		template <typename T>
+		void StoreBytes(std::byte* bytes, T value)
+		{
+			std::memcpy(bytes, &value, sizeof(T));
+		}
+
+		bool IsSignedType(TypeKind kind)
+		{
+			return kind == TypeKind::Int8 || kind == TypeKind::Int16 || kind == TypeKind::Int32 || kind == TypeKind::Int64 || kind == TypeKind::Enum;
+		}
+
+		bool LoadNumber(TypeKind kind, size_t size, const std::byte* bytes, Number& number)
+		{
+			if (IsFloatingPointType(kind))
+			{
+				number.mIsFloatingPoint = true;
+				if (size == sizeof(float))
+				{
+					number.mFloat = LoadBytes<float>(bytes);
+				}
+				else if (size == sizeof(double))
+				{
+					number.mFloat = LoadBytes<double>(bytes);
+				}
+				else if (size == sizeof(long double))
+				{
+					number.mFloat = LoadBytes<long double>(bytes);
+				}
+				else
+				{
+					return false;
+				}
+				return true;
+			}
+
+			// Bools, integers and enums.
+			number.mIsSigned = IsSignedType(kind);
+			switch (size)
+			{
+			case 1: number.mInteger = number.mIsSigned ? (uint64_t)LoadBytes<int8_t>(bytes) : LoadBytes<uint8_t>(bytes); return true;
+			case 2: number.mInteger = number.mIsSigned ? (uint64_t)LoadBytes<int16_t>(bytes) : LoadBytes<uint16_t>(bytes); return true;
+			case 4: number.mInteger = number.mIsSigned ? (uint64_t)LoadBytes<int32_t>(bytes) : LoadBytes<uint32_t>(bytes); return true;
+			case 8: number.mInteger = LoadBytes<uint64_t>(bytes); return true;
+			default: return false;
+			}
+		}
+
+		bool StoreNumber(const Number& number, TypeKind kind, size_t size, std::byte* bytes)
+		{
+			if (kind == TypeKind::Bool)
+			{
+				StoreBytes<bool>(bytes, number.mIsFloatingPoint ? number.mFloat != 0 : number.mInteger != 0);
+				return true;
+			}
+
+			if (IsFloatingPointType(kind))
+			{
+				const long double value = number.mIsFloatingPoint ? number.mFloat :
+					number.mIsSigned ? (long double)(int64_t)number.mInteger : (long double)number.mInteger;
+
+				if (size == sizeof(float))
+				{
+					StoreBytes(bytes, (float)value);
+				}
+				else if (size == sizeof(double))
+				{
+					StoreBytes(bytes, (double)value);
+				}
+				else if (size == sizeof(long double))
+				{
+					StoreBytes(bytes, value);
+				}
+				else
+				{
+					return false;
+				}
+				return true;
+			}
+
+			// Integers are truncated, floating point values are rounded towards zero (and become zero if out of range).
+			uint64_t integer = number.mInteger;
+			if (number.mIsFloatingPoint)
+			{
+				integer = number.mFloat > -9.2e18L && number.mFloat < 9.2e18L ? (uint64_t)(int64_t)number.mFloat : 0;
+			}
+
+			switch (size)
+			{
+			case 1: StoreBytes(bytes, (uint8_t)integer); return true;
+			case 2: StoreBytes(bytes, (uint16_t)integer); return true;
+			case 4: StoreBytes(bytes, (uint32_t)integer); return true;
+			case 8: StoreBytes(bytes, integer); return true;
+			default: return false;
+			}
+		}
+
+		// Returns the size of numbers of the given kind on this platform, or 0 if it isn't a number.
+		size_t GetNumberSize(TypeKind kind)
+		{
+			switch (kind)
+			{
+			case TypeKind::Uint8: case TypeKind::Int8: return 1;
+			case TypeKind::Uint16: case TypeKind::Int16: return 2;
+			case TypeKind::Uint32: case TypeKind::Int32: case TypeKind::Float: return 4;
+			case TypeKind::Uint64: case TypeKind::Int64: case TypeKind::Double: return 8;
+			case TypeKind::LongDouble: return sizeof(long double);
+			default: return 0;
+			}
+		}
+
+		// Returns true if stored numbers can be converted to the given type all at once (see ConvertNumbers()), which needs them
+		// to have the size of their kind on this platform.
+		bool CanConvertNumbers(const BinaryType& storedElementType, const TypeInfo& type)
+		{
+			return storedElementType.mKind == BinaryValueKind::Number && storedElementType.mSize == GetNumberSize(storedElementType.mNumberKind) &&
+				serialization::IsNumberKind(type.mKind);
+		}
+
+		bool IsStringType(const BinaryType& type)
+		{
+			return type.mKind == BinaryValueKind::CString || type.mKind == BinaryValueKind::StdString;
+		}
+	}
+
+	BinaryDeserializer::BinaryDeserializer(const void* data, size_t size) :
+		mBegin((const std::byte*)data),
+		mCurrent((const std::byte*)data),
+		mEnd((const std::byte*)data + size)
+	{
+	}
+
+	bool BinaryDeserializer::Deserialize(const ClassInfo& classInfo, void* classObject)
+	{
+		uint32_t index;
+		if (!ReadClass(index, 0))
+		{
+			return false;
+		}
+
+		BinaryStoredClass& storedClass = mClasses[index];
+		if (!(storedClass.mName == classInfo.mType->mName))
+		{
+			return SetError("The data holds a different class");
+		}
+
+		return DeserializeObjectFields(storedClass, classInfo, classObject);
+	}
+
+	bool BinaryDeserializer::DeserializeObjectFields(BinaryStoredClass& storedClass, const ClassInfo& classInfo, void* classObject)
+	{
+		for (const BinaryLoadStep& step : GetLoadPlan(storedClass, classInfo))
+		{
+			switch (step.mKind)
+			{
+			case BinaryLoadStepKind::Copy:
+				if (!Read((std::byte*)classObject + step.mOffset, step.mSize))
+				{
+					return false;
+				}
+				break;
+
+			case BinaryLoadStepKind::SkipBytes:
+				if (Consume(step.mSize) == nullptr)
+				{
+					return false;
+				}
+				break;
+
+			case BinaryLoadStepKind::SkipValue:
+				if (!SkipValue(*step.mStoredType))
+				{
+					return false;
+				}
+				break;
+
+			case BinaryLoadStepKind::Field:
+			{
+				const FieldInfo& field = *step.mField;
+				if (!DeserializeValue(*step.mStoredType, field.mTypeInstance, field.mContainerFunctions, field.GetMemoryInClass(classObject)))
+				{
+					return false;
+				}
+				break;
+			}
+			}
+		}
+
+		return true;
+	}
+
+	const std::vector<BinaryLoadStep>& BinaryDeserializer::GetLoadPlan(BinaryStoredClass& storedClass, const ClassInfo& classInfo)
+	{
+		// Plans are stored in a node based map, so plans being iterated stay valid while plans for nested objects are added.
+		const auto it = storedClass.mLoadPlans.find(&classInfo);
+		if (it != storedClass.mLoadPlans.end())
+		{
+			return it->second;
+		}
+
+		const BinaryClassSchema& schema = mSchemas.GetSchema(classInfo);
+
+		std::vector<BinaryLoadStep> plan;
+		for (const BinaryStoredField& storedField : storedClass.mFields)
+		{
+			// Nothing was written for the field.
+			if (storedField.mType.mKind == BinaryValueKind::None)
+			{
+				continue;
+			}
+
+			const auto field = std::find_if(schema.mFields.begin(), schema.mFields.end(), [&storedField](const BinarySchemaField& field)
+			{
+				return field.mField->mName.GetHash() == storedField.mName;
+			});
+
+			BinaryLoadStep* previousStep = plan.empty() ? nullptr : &plan.back();
+			const uint32_t fixedSize = storedField.mType.GetFixedSize();
+
+			// Removed field.
+			if (field == schema.mFields.end())
+			{
+				if (fixedSize == 0)
+				{
+					plan.push_back({ BinaryLoadStepKind::SkipValue, 0, 0, &storedField.mType, nullptr });
+				}
+				else if (previousStep != nullptr && previousStep->mKind == BinaryLoadStepKind::SkipBytes)
+				{
+					previousStep->mSize += fixedSize;
+				}
+				else
+				{
+					plan.push_back({ BinaryLoadStepKind::SkipBytes, 0, fixedSize, nullptr, nullptr });
+				}
+				continue;
+			}
+
+			// Unchanged field, merged with the previous one if it directly precedes it in the object too.
+			if (fixedSize > 0 && storedField.mType.HasSameBytes(field->mType))
+			{
+				const uint32_t offset = (uint32_t)field->mField->mOffset;
+				if (previousStep != nullptr && previousStep->mKind == BinaryLoadStepKind::Copy && previousStep->mOffset + previousStep->mSize == offset)
+				{
+					previousStep->mSize += fixedSize;
+				}
+				else
+				{
+					plan.push_back({ BinaryLoadStepKind::Copy, offset, fixedSize, nullptr, nullptr });
+				}
+				continue;
+			}
+
+			plan.push_back({ BinaryLoadStepKind::Field, 0, 0, &storedField.mType, field->mField });
+		}
+
+		return storedClass.mLoadPlans.emplace(&classInfo, std::move(plan)).first->second;
+	}
+
+	bool BinaryDeserializer::DeserializeValue(const BinaryType& storedType, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, void* value)
+	{
+		if (containerFunctions != nullptr)
+		{
+			return DeserializeContainer(storedType, *containerFunctions, value);
+		}
+
+		if (type.IsDynamicCString())
+		{
+			if (!IsStringType(storedType))
+			{
+				return SkipValue(storedType);
+			}
+
+			const char* string;
+			size_t length;
+			if (!ReadString(storedType, string, length))
+			{
+				return false;
+			}
+
+			*(char**)value = string != nullptr ? serialization::CopyString(std::string_view(string, length), mArena) : nullptr;
+			return true;
+		}
+
+		if (!type.mIsArray && storedType.mKind != BinaryValueKind::Array)
+		{
+			return DeserializeElement(storedType, type.mType, type.mIsPointer, value);
+		}
+
+		// Fixed arrays and single values load into each other. Elements past the end of the array are skipped.
+		const BinaryType& storedElementType = storedType.mKind == BinaryValueKind::Array ? storedType.mElements[0] : storedType;
+		const size_t storedCount = storedType.mKind == BinaryValueKind::Array ? storedType.mCount : 1;
+		const size_t count = type.mIsArray ? type.mArraySize : 1;
+
+		if (storedCount == count && BinarySchemaCache::IsTriviallyCopyable(type) && storedElementType.mKind == BinaryValueKind::Number &&
+			storedElementType.mNumberKind == type.mType.mKind && storedElementType.mSize == type.mType.mSize)
+		{
+			return Read(value, type.mType.mSize * count);
+		}
+
+		if (!type.mIsPointer && CanConvertNumbers(storedElementType, type.mType))
+		{
+			return DeserializeNumbers(storedElementType, type.mType, value, storedCount, std::min(storedCount, count));
+		}
+
+		const size_t stride = type.mIsPointer ? sizeof(void*) : type.mType.mSize;
+		for (size_t i = 0; i < storedCount; ++i)
+		{
+			const bool success = i < count ?
+				DeserializeElement(storedElementType, type.mType, type.mIsPointer, (std::byte*)value + i * stride) :
+				SkipValue(storedElementType);
+
+			if (!success)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool BinaryDeserializer::DeserializeContainer(const BinaryType& storedType, const ContainerFunctions& containerFunctions, void* value)
+	{
+		switch (containerFunctions.mKind)
+		{
+		case ContainerKind::DynamicArray:
+		{
+			if (storedType.mKind != BinaryValueKind::Sequence)
+			{
+				return SkipValue(storedType);
+			}
+
+			const auto& functions = static_cast<const DynamicArrayFunctions&>(containerFunctions);
+			const BinaryType& storedElementType = storedType.mElements[0];
+
+			size_t size;
+			if (!ReadSize(size))
+			{
+				return false;
+			}
+
+			if (BinarySchemaCache::IsTriviallyCopyable(functions.mElementType) && functions.mElementStride == functions.mElementType.mType.mSize &&
+				storedElementType.mKind == BinaryValueKind::Number && storedElementType.mNumberKind == functions.mElementType.mType.mKind && storedElementType.mSize == functions.mElementStride)
+			{
+				if (size > (size_t)(mEnd - mCurrent) / functions.mElementStride)
+				{
+					return SetError("Array is bigger than the input");
+				}
+
+				functions.mSetSize(value, (ArraySizeType)size);
+				return size == 0 || Read(functions.mGetData(value), size * functions.mElementStride);
+			}
+
+			if (!functions.mElementType.mIsPointer && !functions.mElementType.mIsArray && functions.mElementStride == functions.mElementType.mType.mSize &&
+				CanConvertNumbers(storedElementType, functions.mElementType.mType))
+			{
+				if (size > (size_t)(mEnd - mCurrent) / storedElementType.mSize)
+				{
+					return SetError("Array is bigger than the input");
+				}
+
+				functions.mSetSize(value, (ArraySizeType)size);
+				return size == 0 || DeserializeNumbers(storedElementType, functions.mElementType.mType, functions.mGetData(value), size, size);
+			}
+
+			// Don't trust the size for the reservation, every element takes up at least a byte (except for unreflected types, which aren't worth the reservation anyway).
+			functions.mClear(value);
+			functions.mReserve(value, (ArraySizeType)std::min<size_t>(size, mEnd - mCurrent));
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				if (!DeserializeValue(storedElementType, functions.mElementType, nullptr, functions.mEmplaceBack(value)))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		case ContainerKind::ArrayView:
+		{
+			if (storedType.mKind != BinaryValueKind::Sequence)
+			{
+				return SkipValue(storedType);
+			}
+
+			const auto& functions = static_cast<const ArrayViewFunctions&>(containerFunctions);
+
+			size_t size;
+			if (!ReadSize(size))
+			{
+				return false;
+			}
+
+			const ArraySizeType viewSize = functions.mGetSize(value);
+			if (!functions.mElementType.mIsPointer && !functions.mElementType.mIsArray && functions.mElementStride == functions.mElementType.mType.mSize &&
+				CanConvertNumbers(storedType.mElements[0], functions.mElementType.mType))
+			{
+				return DeserializeNumbers(storedType.mElements[0], functions.mElementType.mType, functions.mGetData(value), size, std::min<size_t>(size, viewSize));
+			}
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				const bool success = i < viewSize ?
+					DeserializeValue(storedType.mElements[0], functions.mElementType, nullptr, functions.GetElement(value, (ArraySizeType)i)) :
+					SkipValue(storedType.mElements[0]);
+
+				if (!success)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		case ContainerKind::AssociativeArray:
+		{
+			if (storedType.mKind != BinaryValueKind::Map)
+			{
+				return SkipValue(storedType);
+			}
+
+			const auto& functions = static_cast<const AssociativeArrayFunctions&>(containerFunctions);
+
+			size_t size;
+			if (!ReadSize(size))
+			{
+				return false;
+			}
+
+			functions.mClear(value);
+
+			// Keys are built in scratch memory and then moved into the container.
+			alignas(std::max_align_t) std::byte keyBuffer[64];
+			const bool useKeyBuffer = functions.mKeySize <= sizeof(keyBuffer) && functions.mKeyAlignment <= alignof(std::max_align_t);
+			void* key = useKeyBuffer ? keyBuffer : IConfig::Get().AllocateMemory(functions.mKeySize);
+
+			bool success = true;
+			for (size_t i = 0; success && i < size; ++i)
+			{
+				functions.mConstructKey(key);
+
+				success = DeserializeValue(storedType.mElements[0], functions.mKeyType, nullptr, key);
+				if (success)
+				{
+					void* entry = functions.mEmplace(value, key);
+					success = entry != nullptr ?
+						DeserializeValue(storedType.mElements[1], functions.mValueType, nullptr, entry) :
+						SetError("Duplicate map key");
+				}
+
+				functions.mDestructKey(key);
+			}
+
+			if (!useKeyBuffer)
+			{
+				IConfig::Get().FreeMemory(key);
+			}
+
+			return success;
+		}
+
+		case ContainerKind::Optional:
+		{
+			if (storedType.mKind != BinaryValueKind::Optional)
+			{
+				return SkipValue(storedType);
+			}
+
+			const auto& functions = static_cast<const OptionalFunctions&>(containerFunctions);
+
+			uint8_t hasValue;
+			if (!Read(hasValue))
+			{
+				return false;
+			}
+
+			if (hasValue == 0)
+			{
+				functions.mReset(value);
+				return true;
+			}
+
+			void* optionalValue = functions.mEmplace(value);
+			return optionalValue != nullptr ?
+				DeserializeValue(storedType.mElements[0], functions.mValueType, nullptr, optionalValue) :
+				SetError("Failed to emplace optional value");
+		}
+
+		default:
+			return SkipValue(storedType);
+		}
+	}
+
+	bool BinaryDeserializer::DeserializeElement(const BinaryType& storedType, const TypeInfo& type, bool isPointer, void* value)
+	{
+		// Values that can't be loaded into the current type are skipped, leaving the value as it was constructed.
+		if (isPointer)
+		{
+			const ClassInfo* classInfo = type.mKind == TypeKind::Class ? type.GetClassInfo() : nullptr;
+			return classInfo != nullptr && storedType.mKind == BinaryValueKind::Pointer ?
+				DeserializeDynamicObject(*classInfo, *(void**)value) :
+				SkipValue(storedType);
+		}
+
+		if (type.mKind == TypeKind::Class)
+		{
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type))
+			{
+				if (!IsStringType(storedType))
+				{
+					return SkipValue(storedType);
+				}
+
+				const char* string;
+				size_t length;
+				if (!ReadString(storedType, string, length))
+				{
+					return false;
+				}
+
+				static_cast<std::string*>(value)->assign(string != nullptr ? string : "", length);
+				return true;
+			}
+#endif
+
+			const ClassInfo* classInfo = type.GetClassInfo();
+			return classInfo != nullptr && storedType.mKind == BinaryValueKind::Object ?
+				DeserializeObjectFields(mClasses[storedType.mClassIndex], *classInfo, value) :
+				SkipValue(storedType);
+		}
+
+		if (BinarySchemaCache::IsTriviallyCopyable(type.mKind) && storedType.mKind == BinaryValueKind::Number)
+		{
+			return storedType.mNumberKind == type.mKind && storedType.mSize == type.mSize ?
+				Read(value, type.mSize) :
+				DeserializeNumber(storedType, type, value);
+		}
+
+		return SkipValue(storedType);
+	}
+
+	bool BinaryDeserializer::DeserializeNumber(const BinaryType& storedType, const TypeInfo& type, void* value)
+	{
+		const std::byte* bytes = Consume(storedType.mSize);
+		if (bytes == nullptr)
+		{
+			return false;
+		}
+
+		// Numbers of unsupported sizes are skipped.
+		Number number;
+		if (LoadNumber(storedType.mNumberKind, storedType.mSize, bytes, number))
+		{
+			StoreNumber(number, type.mKind, type.mSize, (std::byte*)value);
+		}
+
+		return true;
+	}
+
+	bool BinaryDeserializer::DeserializeNumbers(const BinaryType& storedElementType, const TypeInfo& type, void* values, size_t storedCount, size_t count)
+	{
+		if (storedCount > (size_t)(mEnd - mCurrent) / storedElementType.mSize)
+		{
+			return SetError("Array is bigger than the input");
+		}
+
+		const std::byte* bytes = Consume(storedCount * storedElementType.mSize);
+		if (bytes == nullptr)
+		{
+			return false;
+		}
+
+		serialization::ConvertNumbers(storedElementType.mNumberKind, bytes, type.mKind, values, count);
+		return true;
+	}
+
+	bool BinaryDeserializer::DeserializeDynamicObject(const ClassInfo& staticClassInfo, void*& value)
+	{
+		BinaryPointerTag tag;
+		if (!Read(tag))
+		{
+			return false;
+		}
+
+		if (tag == BinaryPointerTag::Null)
+		{
+			value = nullptr;
+			return true;
+		}
+
+		if (tag != BinaryPointerTag::Object)
+		{
+			return SetError("Invalid pointer tag");
+		}
+
+		uint32_t index;
+		if (!ReadClass(index, 0))
+		{
+			return false;
+		}
+
+		BinaryStoredClass& storedClass = mClasses[index];
+		const ClassInfo* classInfo = staticClassInfo.GetDerivedClass(storedClass.mName);
+		if (classInfo == nullptr)
+		{
+			return SetError("Unknown derived class");
+		}
+
+		value = IConfig::Get().AllocateMemory(classInfo->mType->mSize);
+		classInfo->Construct(value);
+
+		return DeserializeObjectFields(storedClass, *classInfo, value);
+	}
+
+	bool BinaryDeserializer::SkipValue(const BinaryType& storedType)
+	{
+		switch (storedType.mKind)
+		{
+		case BinaryValueKind::None:
+			return true;
+
+		case BinaryValueKind::Number:
+			return Consume(storedType.mSize) != nullptr;
+
+		case BinaryValueKind::CString:
+		case BinaryValueKind::StdString:
+		{
+			const char* string;
+			size_t length;
+			return ReadString(storedType, string, length);
+		}
+
+		case BinaryValueKind::Object:
+			return SkipObjectFields(mClasses[storedType.mClassIndex]);
+
+		case BinaryValueKind::Pointer:
+		{
+			BinaryPointerTag tag;
+			if (!Read(tag))
+			{
+				return false;
+			}
+
+			if (tag == BinaryPointerTag::Null)
+			{
+				return true;
+			}
+
+			uint32_t index;
+			return tag == BinaryPointerTag::Object ?
+				ReadClass(index, 0) && SkipObjectFields(mClasses[index]) :
+				SetError("Invalid pointer tag");
+		}
+
+		case BinaryValueKind::Array:
+		{
+			const uint32_t fixedSize = storedType.GetFixedSize();
+			if (fixedSize > 0)
+			{
+				return Consume(fixedSize) != nullptr;
+			}
+
+			for (uint32_t i = 0; i < storedType.mCount; ++i)
+			{
+				if (!SkipValue(storedType.mElements[0]))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		case BinaryValueKind::Sequence:
+		case BinaryValueKind::Map:
+		{
+			size_t size;
+			if (!ReadSize(size))
+			{
+				return false;
+			}
+
+			const uint32_t fixedSize = storedType.mElements[0].GetFixedSize();
+			if (storedType.mKind == BinaryValueKind::Sequence && fixedSize > 0)
+			{
+				return size <= (size_t)(mEnd - mCurrent) / fixedSize ?
+					Consume(size * fixedSize) != nullptr :
+					SetError("Array is bigger than the input");
+			}
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				for (const BinaryType& elementType : storedType.mElements)
+				{
+					if (!SkipValue(elementType))
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		case BinaryValueKind::Optional:
+		{
+			uint8_t hasValue;
+			if (!Read(hasValue))
+			{
+				return false;
+			}
+
+			return hasValue == 0 || SkipValue(storedType.mElements[0]);
+		}
+
+		default:
+			return SetError("Invalid value kind");
+		}
+	}
+
+	bool BinaryDeserializer::SkipObjectFields(const BinaryStoredClass& storedClass)
+	{
+		for (const BinaryStoredField& storedField : storedClass.mFields)
+		{
+			if (!SkipValue(storedField.mType))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool BinaryDeserializer::ReadClass(uint32_t& index, int depth)
+	{
+		size_t classIndex;
+		if (!ReadSize(classIndex))
+		{
+			return false;
+		}
+
+		if (classIndex < mClasses.size())
+		{
+			index = (uint32_t)classIndex;
+			return true;
+		}
+
+		if (classIndex != mClasses.size())
+		{
+			return SetError("Invalid class index");
+		}
+
+		if (depth > MaxTypeDepth)
+		{
+			return SetError("Classes are nested too deeply");
+		}
+
+		size_t nameSize;
+		if (!ReadSize(nameSize))
+		{
+			return false;
+		}
+
+		const std::byte* name = Consume(nameSize);
+		if (name == nullptr)
+		{
+			return false;
+		}
+
+		index = (uint32_t)classIndex;
+		BinaryStoredClass& storedClass = mClasses.emplace_back();
+		storedClass.mName = Name((const char*)name, nameSize);
+		storedClass.mClassInfo = Registry::GetSystemRegistry().TryGetClass(storedClass.mName);
+
+		size_t fieldCount;
+		if (!ReadSize(fieldCount))
+		{
+			return false;
+		}
+
+		// Every field takes up at least 5 bytes.
+		storedClass.mFields.reserve(std::min<size_t>(fieldCount, (mEnd - mCurrent) / 5));
+		for (size_t i = 0; i < fieldCount; ++i)
+		{
+			BinaryStoredField& storedField = storedClass.mFields.emplace_back();
+			if (!Read(storedField.mName) || !ReadType(storedField.mType, true, depth + 1))
+			{
+				return false;
+			}
+		}
+
+		storedClass.mIsComplete = true;
+		return true;
+	}
+
+	bool BinaryDeserializer::ReadType(BinaryType& type, bool isInline, int depth)
+	{
+		if (depth > MaxTypeDepth)
+		{
+			return SetError("Types are nested too deeply");
+		}
+
+		if (!Read(type.mKind))
+		{
+			return false;
+		}
+
+		switch (type.mKind)
+		{
+		case BinaryValueKind::None:
+		case BinaryValueKind::CString:
+		case BinaryValueKind::StdString:
+		case BinaryValueKind::Pointer:
+			return true;
+
+		case BinaryValueKind::Number:
+		{
+			size_t size;
+			if (!Read(type.mNumberKind) || !ReadSize(size))
+			{
+				return false;
+			}
+
+			if (!BinarySchemaCache::IsTriviallyCopyable(type.mNumberKind) || size == 0 || size > 16)
+			{
+				return SetError("Invalid number type");
+			}
+
+			type.mSize = (uint32_t)size;
+			return true;
+		}
+
+		case BinaryValueKind::Object:
+		{
+			if (!ReadClass(type.mClassIndex, depth + 1))
+			{
+				return false;
+			}
+
+			// Objects held inline can't contain themselves, only containers can hold objects of a class that is still being read.
+			if (isInline && !mClasses[type.mClassIndex].mIsComplete)
+			{
+				return SetError("Class contains itself");
+			}
+
+			return true;
+		}
+
+		case BinaryValueKind::Array:
+		{
+			size_t count;
+			if (!ReadSize(count) || !ReadType(type.mElements.emplace_back(), isInline, depth + 1))
+			{
+				return false;
+			}
+
+			if ((uint64_t)count * type.mElements[0].GetFixedSize() > UINT32_MAX || count > UINT32_MAX)
+			{
+				return SetError("Array is too big");
+			}
+
+			type.mCount = (uint32_t)count;
+			return true;
+		}
+
+		case BinaryValueKind::Sequence:
+		case BinaryValueKind::Optional:
+			return ReadType(type.mElements.emplace_back(), false, depth + 1);
+
+		case BinaryValueKind::Map:
+			return ReadType(type.mElements.emplace_back(), false, depth + 1) && ReadType(type.mElements.emplace_back(), false, depth + 1);
+
+		default:
+			return SetError("Invalid value kind");
+		}
+	}
+
+	bool BinaryDeserializer::ReadString(const BinaryType& storedType, const char*& string, size_t& length)
+	{
+		size_t size;
+		if (!ReadSize(size))
+		{
+			return false;
+		}
+
+		// C strings are written with their length plus one, so that zero can mean nullptr.
+		if (storedType.mKind == BinaryValueKind::CString)
+		{
+			if (size == 0)
+			{
+				string = nullptr;
+				length = 0;
+				return true;
+			}
+
+			--size;
+		}
+
+		const std::byte* bytes = Consume(size);
+		if (bytes == nullptr)
+		{
+			return false;
+		}
+
+		string = (const char*)bytes;
+		length = size;
+		return true;
+	}
+
+	bool BinaryDeserializer::Read(void* data, size_t size)
+	{
+		const std::byte* bytes = Consume(size);
+		if (bytes == nullptr)
+		{
+			return false;
+		}
+
+		std::memcpy(data, bytes, size);
+		return true;
+	}
+
+	bool BinaryDeserializer::ReadSize(size_t& size)
+	{
+		size = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			uint8_t byte;
+			if (!Read(byte))
+			{
+				return false;
+			}
+
+			size |= (size_t)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+
+		return SetError("Invalid size");
+	}
+
+	const std::byte* BinaryDeserializer::Consume(size_t size)
+	{
+		if (mError)
+		{
+			return nullptr;
+		}
+
+		if ((size_t)(mEnd - mCurrent) < size)
+		{
+			SetError("Unexpected end of input");
+			return nullptr;
+		}
+
+		const std::byte* bytes = mCurrent;
+		mCurrent += size;
+		return bytes;
+	}
+
+	bool BinaryDeserializer::SetError(const char* message)
+	{
+		if (!mError)
+		{
+			mError = true;
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "Binary parse error at offset %zu: %s", (size_t)(mCurrent - mBegin), message);
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+
+#include "BinarySchema.h"
+
+namespace cpprefl::serialization
+{
+	class DeserializationArena;
+}
+
+namespace cpprefl::binary
+{
+	enum class BinaryLoadStepKind : uint8_t
+	{
+		// Reads bytes straight into the object.
+		Copy,
+
+		// Skips bytes of fields that no longer exist.
+		SkipBytes,
+
+		// Skips a value of a field that no longer exists.
+		SkipValue,
+
+		// Reads a field that changed type, or isn't written as raw bytes.
+		Field,
+	};
+
+	// One step in loading the fields of a class, from data written with the field table of a (possibly different) build.
+	struct BinaryLoadStep
+	{
+		BinaryLoadStepKind mKind;
+
+		// Copy: byte range in the object. SkipBytes: number of bytes.
+		uint32_t mOffset;
+		uint32_t mSize;
+
+		// SkipValue and Field: the type the value was written with.
+		const BinaryType* mStoredType;
+
+		// Field: the field to read into.
+		const FieldInfo* mField;
+	};
+
+	// A field as read from a field table.
+	struct BinaryStoredField
+	{
+		Name::HashType mName;
+		BinaryType mType;
+	};
+
+	// A class as read from the class table of a stream.
+	struct BinaryStoredClass
+	{
+		Name mName;
+
+		// The class with this name in this build, if any.
+		const ClassInfo* mClassInfo = nullptr;
+
+		std::vector<BinaryStoredField> mFields;
+
+		// False while the field table is being read.
+		bool mIsComplete = false;
+
+		// Steps to load the fields, per class the data is loaded into (usually just mClassInfo).
+		std::unordered_map<const ClassInfo*, std::vector<BinaryLoadStep>> mLoadPlans;
+	};
+
+	// Reads objects written by the BinarySerializer.
+	//
+	// Fields are matched by name against the field table the data was written with, once per class per stream, to build a load plan.
+	// Fields that were added keep their constructed value, fields that were removed are skipped, and numbers are converted to the
+	// current type of their field. Runs of fields that are laid out the same in the data and the object are read with a single memcpy,
+	// so data written by the same build loads at the same speed as without the field table.
+	// The input must outlive the deserializer.
+	class BinaryDeserializer
+	{
+	public:
+		BinaryDeserializer(const void* data, size_t size);
+
+		// Reads the next object. Returns an empty value if the input is malformed or holds a different class.
+		template <typename T>
+		std::optional<T> Deserialize()
+		{
+			std::optional<T> result;
+			result.emplace();
+
+			if (!Deserialize(GetReflectedClass<T>(), &*result))
+			{
+				return std::nullopt;
+			}
+
+			return result;
+		}
+
+		// Reads the next object into an already constructed object.
+		bool Deserialize(const ClassInfo& classInfo, void* classObject);
+
+		// Allocates the strings of char* fields from the given arena (or from IConfig, if null), see Deserializer::SetArena().
+		void SetArena(serialization::DeserializationArena* arena) { mArena = arena; }
+
+		// Returns true if the input was malformed.
+		bool HasError()const { return mError; }
+
+	private:
+		bool DeserializeObjectFields(BinaryStoredClass& storedClass, const ClassInfo& classInfo, void* classObject);
+		const std::vector<BinaryLoadStep>& GetLoadPlan(BinaryStoredClass& storedClass, const ClassInfo& classInfo);
+
+		bool DeserializeValue(const BinaryType& storedType, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, void* value);
+		bool DeserializeContainer(const BinaryType& storedType, const ContainerFunctions& containerFunctions, void* value);
+		bool DeserializeElement(const BinaryType& storedType, const TypeInfo& type, bool isPointer, void* value);
+		bool DeserializeDynamicObject(const ClassInfo& staticClassInfo, void*& value);
+		bool DeserializeNumber(const BinaryType& storedType, const TypeInfo& type, void* value);
+
+		// Reads storedCount numbers and converts the first count of them at once. The element type must pass CanConvertNumbers().
+		bool DeserializeNumbers(const BinaryType& storedElementType, const TypeInfo& type, void* values, size_t storedCount, size_t count);
+
+		bool SkipValue(const BinaryType& storedType);
+		bool SkipObjectFields(const BinaryStoredClass& storedClass);
+
+		// Reads a class index, and the class's field table if this is the first time the class appears.
+		bool ReadClass(uint32_t& index, int depth);
+		bool ReadType(BinaryType& type, bool isInline, int depth);
+
+		// Reads a value written as a CString or StdString. Null C strings return nullptr.
+		bool ReadString(const BinaryType& storedType, const char*& string, size_t& length);
+
+		bool Read(void* data, size_t size);
+		bool ReadSize(size_t& size);
+
+		template <typename T>
+		bool Read(T& value) { return Read(&value, sizeof(T)); }
+
+		// Returns the next bytes in the input, or nullptr if there aren't enough left.
+		const std::byte* Consume(size_t size);
+
+		bool SetError(const char* message);
+
+		const std::byte* mBegin;
+		const std::byte* mCurrent;
+		const std::byte* mEnd;
+
+		bool mError = false;
+
+		serialization::DeserializationArena* mArena = nullptr;
+
+		BinarySchemaCache mSchemas;
+
+		// Class table of the stream. A deque, since classes are added while others are still being read.
+		std::deque<BinaryStoredClass> mClasses;
+	};
+}
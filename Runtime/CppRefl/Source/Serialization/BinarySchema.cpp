@@ -0,0 +1,272 @@
+#include "BinarySchema.h"
+
+#include <algorithm>
+
+#include "../Reflection/Registry.h"
+
+namespace cpprefl::binary
+{
+	namespace
+	{
+		// Hashed in as is, so data written on a machine with a different byte order doesn't match.
+		constexpr uint32_t ByteOrderMarker = 0x01020304;
+
+		// Returns the number of bytes a field takes up in its class.
+		uint32_t GetFieldSize(const TypeInstanceInfo& type)
+		{
+			return (uint32_t)(type.mType.mSize * (type.mIsArray ? type.mArraySize : 1));
+		}
+	}
+
+	const BinaryClassSchema& BinarySchemaCache::GetSchema(const ClassInfo& classInfo)
+	{
+		const auto it = mSchemas.find(&classInfo);
+		if (it != mSchemas.end())
+		{
+			return it->second;
+		}
+
+		BinaryClassSchema schema;
+
+		// Fingerprint
+		{
+			mPendingClasses.push_back(&classInfo);
+
+			std::vector<uint32_t> hash = { ByteOrderMarker, (uint32_t)classInfo.mType->mSize };
+			for (const FieldInfo& field : classInfo.mFlattenedFields)
+			{
+				hash.push_back(field.mName.GetHash());
+				hash.push_back((uint32_t)field.mOffset);
+				HashType(hash, field.mTypeInstance, field.mContainerFunctions);
+			}
+
+			mPendingClasses.pop_back();
+			schema.mFingerprint = Crc32((const char*)hash.data(), hash.size() * sizeof(uint32_t));
+		}
+
+		// Steps. Const fields are neither written nor read.
+		for (const FieldInfo& field : classInfo.mFlattenedFields)
+		{
+			if (field.mTypeInstance.mIsConst)
+			{
+				continue;
+			}
+
+			schema.mFields.push_back({ &field, GetBinaryType(field.mTypeInstance, field.mContainerFunctions) });
+
+			const bool isTriviallyCopyable = field.mContainerFunctions == nullptr && IsTriviallyCopyable(field.mTypeInstance);
+			if (!isTriviallyCopyable)
+			{
+				schema.mSteps.push_back({ &field, 0, 0 });
+				continue;
+			}
+
+			// Only merge fields that directly follow each other, the gaps in between may hold unreflected fields.
+			const uint32_t size = GetFieldSize(field.mTypeInstance);
+			if (!schema.mSteps.empty())
+			{
+				BinaryFieldStep& run = schema.mSteps.back();
+				if (run.mField == nullptr && run.mOffset + run.mSize == field.mOffset)
+				{
+					run.mSize += size;
+					continue;
+				}
+			}
+
+			schema.mSteps.push_back({ nullptr, (uint32_t)field.mOffset, size });
+		}
+
+		return mSchemas.emplace(&classInfo, std::move(schema)).first->second;
+	}
+
+	bool BinarySchemaCache::IsTriviallyCopyable(TypeKind kind)
+	{
+		return kind == TypeKind::Bool || kind == TypeKind::Enum || IsIntegerType(kind) || IsFloatingPointType(kind);
+	}
+
+	BinaryType BinarySchemaCache::GetBinaryType(const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions)
+	{
+		BinaryType binaryType;
+
+		if (containerFunctions != nullptr)
+		{
+			switch (containerFunctions->mKind)
+			{
+			case ContainerKind::DynamicArray:
+				binaryType.mKind = BinaryValueKind::Sequence;
+				binaryType.mElements.push_back(GetBinaryType(static_cast<const DynamicArrayFunctions*>(containerFunctions)->mElementType, nullptr));
+				break;
+
+			case ContainerKind::ArrayView:
+				binaryType.mKind = BinaryValueKind::Sequence;
+				binaryType.mElements.push_back(GetBinaryType(static_cast<const ArrayViewFunctions*>(containerFunctions)->mElementType, nullptr));
+				break;
+
+			case ContainerKind::AssociativeArray:
+				binaryType.mKind = BinaryValueKind::Map;
+				binaryType.mElements.push_back(GetBinaryType(static_cast<const AssociativeArrayFunctions*>(containerFunctions)->mKeyType, nullptr));
+				binaryType.mElements.push_back(GetBinaryType(static_cast<const AssociativeArrayFunctions*>(containerFunctions)->mValueType, nullptr));
+				break;
+
+			case ContainerKind::Optional:
+				binaryType.mKind = BinaryValueKind::Optional;
+				binaryType.mElements.push_back(GetBinaryType(static_cast<const OptionalFunctions*>(containerFunctions)->mValueType, nullptr));
+				break;
+
+			default:
+				break;
+			}
+
+			return binaryType;
+		}
+
+		if (type.IsDynamicCString())
+		{
+			binaryType.mKind = BinaryValueKind::CString;
+			return binaryType;
+		}
+
+		if (type.mIsArray)
+		{
+			binaryType.mKind = BinaryValueKind::Array;
+			binaryType.mCount = type.mArraySize;
+			binaryType.mElements.push_back(GetBinaryType(type.mType, type.mIsPointer));
+			return binaryType;
+		}
+
+		return GetBinaryType(type.mType, type.mIsPointer);
+	}
+
+	BinaryType BinarySchemaCache::GetBinaryType(const TypeInfo& type, bool isPointer)
+	{
+		BinaryType binaryType;
+
+		if (isPointer)
+		{
+			if (type.mKind == TypeKind::Class && type.GetClassInfo() != nullptr)
+			{
+				binaryType.mKind = BinaryValueKind::Pointer;
+			}
+			return binaryType;
+		}
+
+		if (type.mKind == TypeKind::Class)
+		{
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type))
+			{
+				binaryType.mKind = BinaryValueKind::StdString;
+				return binaryType;
+			}
+#endif
+
+			binaryType.mClassInfo = type.GetClassInfo();
+			if (binaryType.mClassInfo != nullptr)
+			{
+				binaryType.mKind = BinaryValueKind::Object;
+			}
+			return binaryType;
+		}
+
+		if (IsTriviallyCopyable(type.mKind))
+		{
+			binaryType.mKind = BinaryValueKind::Number;
+			binaryType.mNumberKind = type.mKind;
+			binaryType.mSize = (uint32_t)type.mSize;
+		}
+
+		return binaryType;
+	}
+
+	uint32_t BinaryType::GetFixedSize()const
+	{
+		switch (mKind)
+		{
+		case BinaryValueKind::Number:
+			return mSize;
+
+		case BinaryValueKind::Array:
+			return mCount * mElements[0].GetFixedSize();
+
+		default:
+			return 0;
+		}
+	}
+
+	bool BinaryType::HasSameBytes(const BinaryType& other)const
+	{
+		if (mKind != other.mKind)
+		{
+			return false;
+		}
+
+		switch (mKind)
+		{
+		case BinaryValueKind::Number:
+			return mNumberKind == other.mNumberKind && mSize == other.mSize;
+
+		case BinaryValueKind::Array:
+			return mCount == other.mCount && mElements[0].HasSameBytes(other.mElements[0]);
+
+		default:
+			return false;
+		}
+	}
+
+	uint32_t BinarySchemaCache::GetFingerprint(const ClassInfo& classInfo)
+	{
+		if (std::find(mPendingClasses.begin(), mPendingClasses.end(), &classInfo) != mPendingClasses.end())
+		{
+			return classInfo.mType->mName.GetHash();
+		}
+
+		return GetSchema(classInfo).mFingerprint;
+	}
+
+	void BinarySchemaCache::HashType(std::vector<uint32_t>& hash, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions)
+	{
+		hash.push_back(type.mType.mName.GetHash());
+		hash.push_back((uint32_t)type.mType.mKind | (type.mIsArray << 8) | (type.mIsPointer << 9));
+		hash.push_back((uint32_t)type.mType.mSize);
+		hash.push_back(type.mArraySize);
+
+		// Nested classes are written inline, so their layout is part of ours.
+		if (type.mType.mKind == TypeKind::Class && !type.mIsPointer)
+		{
+			const ClassInfo* classInfo = type.mType.GetClassInfo();
+			if (classInfo != nullptr)
+			{
+				hash.push_back(GetFingerprint(*classInfo));
+			}
+		}
+
+		if (containerFunctions == nullptr)
+		{
+			return;
+		}
+
+		hash.push_back((uint32_t)containerFunctions->mKind);
+		switch (containerFunctions->mKind)
+		{
+		case ContainerKind::DynamicArray:
+			HashType(hash, static_cast<const DynamicArrayFunctions*>(containerFunctions)->mElementType, nullptr);
+			break;
+
+		case ContainerKind::ArrayView:
+			HashType(hash, static_cast<const ArrayViewFunctions*>(containerFunctions)->mElementType, nullptr);
+			break;
+
+		case ContainerKind::AssociativeArray:
+			HashType(hash, static_cast<const AssociativeArrayFunctions*>(containerFunctions)->mKeyType, nullptr);
+			HashType(hash, static_cast<const AssociativeArrayFunctions*>(containerFunctions)->mValueType, nullptr);
+			break;
+
+		case ContainerKind::Optional:
+			HashType(hash, static_cast<const OptionalFunctions*>(containerFunctions)->mValueType, nullptr);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
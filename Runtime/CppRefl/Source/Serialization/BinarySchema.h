@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../Reflection/ClassInfo.h"
+
+namespace cpprefl::binary
+{
+	// Written before an object that is pointed to.
+	enum class BinaryPointerTag : uint8_t
+	{
+		Null = 0,
+
+		// The class of the object follows, then its fields.
+		Object,
+	};
+
+	// How a value is encoded, as recorded in the field tables of a stream.
+	enum class BinaryValueKind : uint8_t
+	{
+		// Values of unreflected types aren't written.
+		None = 0,
+
+		// Raw bytes of a bool, number or enum.
+		Number,
+
+		// Size plus one (zero for nullptr), then the characters.
+		CString,
+
+		// Size, then the characters.
+		StdString,
+
+		// Fields of a class, written inline.
+		Object,
+
+		// A BinaryPointerTag, followed by the class and fields of the object.
+		Pointer,
+
+		// Fixed size array: the elements one after the other.
+		Array,
+
+		// Dynamic array or array view: size, then the elements.
+		Sequence,
+
+		// Size, then a key and value per entry.
+		Map,
+
+		// One byte set to 1 if the value follows.
+		Optional,
+	};
+
+	// Type of a value in the binary format.
+	struct BinaryType
+	{
+		BinaryValueKind mKind = BinaryValueKind::None;
+
+		// Number: the reflected kind and size of the value.
+		TypeKind mNumberKind = TypeKind::Invalid;
+		uint32_t mSize = 0;
+
+		// Array: number of elements.
+		uint32_t mCount = 0;
+
+		// Object: the class, or its index in the class table of the stream when read back.
+		const ClassInfo* mClassInfo = nullptr;
+		uint32_t mClassIndex = 0;
+
+		// Array, Sequence and Optional: the element type. Map: the key and value types.
+		std::vector<BinaryType> mElements;
+
+		// Returns the size of values that are written as raw bytes (numbers and fixed arrays of them), otherwise 0.
+		uint32_t GetFixedSize()const;
+
+		// Returns true if values of both types are written as the same raw bytes.
+		bool HasSameBytes(const BinaryType& other)const;
+	};
+
+	// A field as written in the binary format.
+	struct BinarySchemaField
+	{
+		const FieldInfo* mField;
+		BinaryType mType;
+	};
+
+	// One step in reading/writing the fields of a class.
+	struct BinaryFieldStep
+	{
+		// Field to (de)serialize on its own, or nullptr if this step is a run of trivially copyable fields.
+		const FieldInfo* mField;
+
+		// Byte range in the object covered by the run (only relevant if mField is nullptr).
+		uint32_t mOffset;
+		uint32_t mSize;
+	};
+
+	// How the fields of a class are laid out in the binary format.
+	struct BinaryClassSchema
+	{
+		// Hash of the names, types and offsets of all fields (recursively for nested classes and containers).
+		// Frozen blobs are only opened if the fingerprint they were written with matches.
+		uint32_t mFingerprint = 0;
+
+		// Adjacent trivially copyable fields (numbers, enums and fixed arrays of them) are merged into a single run.
+		std::vector<BinaryFieldStep> mSteps;
+
+		// Written fields, in order. Written to the field table of a stream so that data can be loaded after the class changed.
+		std::vector<BinarySchemaField> mFields;
+	};
+
+	// Builds class schemas on first use.
+	class BinarySchemaCache
+	{
+	public:
+		const BinaryClassSchema& GetSchema(const ClassInfo& classInfo);
+
+		// Returns true if values of this type are written as their raw bytes.
+		static bool IsTriviallyCopyable(TypeKind kind);
+		static bool IsTriviallyCopyable(const TypeInstanceInfo& type) { return !type.mIsPointer && IsTriviallyCopyable(type.mType.mKind); }
+
+		// Returns how a value of this type is written.
+		static BinaryType GetBinaryType(const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions);
+		static BinaryType GetBinaryType(const TypeInfo& type, bool isPointer);
+
+	private:
+		uint32_t GetFingerprint(const ClassInfo& classInfo);
+		void HashType(std::vector<uint32_t>& hash, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions);
+
+		std::unordered_map<const ClassInfo*, BinaryClassSchema> mSchemas;
+
+		// Classes whose fingerprint is being computed, to break cycles (e.g. a class holding a std::vector of itself).
+		std::vector<const ClassInfo*> mPendingClasses;
+	};
+}
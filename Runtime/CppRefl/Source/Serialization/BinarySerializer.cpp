@@ -0,0 +1,292 @@
+#include "BinarySerializer.h"
+
+#include <cstring>
+
+#include "../Reflection/Registry.h"
+
+namespace cpprefl::binary
+{
+	void BinarySerializer::Serialize(const ClassInfo& classInfo, const void* classObject)
+	{
+		WriteClass(classInfo);
+		SerializeObjectFields(classInfo, classObject);
+	}
+
+	void BinarySerializer::SerializeObjectFields(const ClassInfo& classInfo, const void* classObject)
+	{
+		for (const BinaryFieldStep& step : mSchemas.GetSchema(classInfo).mSteps)
+		{
+			if (step.mField == nullptr)
+			{
+				Write((const std::byte*)classObject + step.mOffset, step.mSize);
+				continue;
+			}
+
+			const FieldInfo& field = *step.mField;
+			SerializeValue(field.mTypeInstance, field.mContainerFunctions, (const std::byte*)classObject + field.mOffset);
+		}
+	}
+
+	void BinarySerializer::SerializeValue(const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value)
+	{
+		if (containerFunctions != nullptr)
+		{
+			SerializeContainer(*containerFunctions, value);
+			return;
+		}
+
+		if (type.IsDynamicCString())
+		{
+			// Strings are prefixed with their length plus one, so that zero can mean nullptr.
+			const char* string = *(const char* const*)value;
+			if (string == nullptr)
+			{
+				WriteSize(0);
+				return;
+			}
+
+			const size_t length = std::strlen(string);
+			WriteSize(length + 1);
+			Write(string, length);
+			return;
+		}
+
+		// Covers fixed size C strings too.
+		if (BinarySchemaCache::IsTriviallyCopyable(type))
+		{
+			Write(value, type.mType.mSize * (type.mIsArray ? type.mArraySize : 1));
+			return;
+		}
+
+		if (type.mIsArray)
+		{
+			const size_t stride = type.mIsPointer ? sizeof(void*) : type.mType.mSize;
+			for (ArraySizeType i = 0; i < type.mArraySize; ++i)
+			{
+				SerializeElement(type.mType, type.mIsPointer, (const std::byte*)value + i * stride);
+			}
+			return;
+		}
+
+		SerializeElement(type.mType, type.mIsPointer, value);
+	}
+
+	void BinarySerializer::SerializeContainer(const ContainerFunctions& containerFunctions, const void* value)
+	{
+		// The accessor tables take mutable containers, but none of the functions used here modify them.
+		void* container = const_cast<void*>(value);
+
+		switch (containerFunctions.mKind)
+		{
+		case ContainerKind::DynamicArray:
+		{
+			const auto& functions = static_cast<const DynamicArrayFunctions&>(containerFunctions);
+			const ArraySizeType size = functions.mGetSize(container);
+			WriteSize(size);
+
+			if (BinarySchemaCache::IsTriviallyCopyable(functions.mElementType) && functions.mElementStride == functions.mElementType.mType.mSize)
+			{
+				if (size > 0)
+				{
+					Write(functions.mGetData(container), size * functions.mElementStride);
+				}
+				return;
+			}
+
+			for (ArraySizeType i = 0; i < size; ++i)
+			{
+				SerializeValue(functions.mElementType, nullptr, functions.GetElement(container, i));
+			}
+			return;
+		}
+
+		case ContainerKind::ArrayView:
+		{
+			const auto& functions = static_cast<const ArrayViewFunctions&>(containerFunctions);
+			const ArraySizeType size = functions.mGetSize(container);
+			WriteSize(size);
+
+			for (ArraySizeType i = 0; i < size; ++i)
+			{
+				SerializeValue(functions.mElementType, nullptr, functions.GetElement(container, i));
+			}
+			return;
+		}
+
+		case ContainerKind::AssociativeArray:
+		{
+			const auto& functions = static_cast<const AssociativeArrayFunctions&>(containerFunctions);
+			WriteSize(functions.mGetSize(container));
+
+			struct VisitContext
+			{
+				BinarySerializer& mSerializer;
+				const AssociativeArrayFunctions& mFunctions;
+			};
+
+			VisitContext context{ *this, functions };
+			functions.mForEach(container, [](void* contextPtr, const void* key, void* entry)
+			{
+				const VisitContext& context = *static_cast<VisitContext*>(contextPtr);
+				context.mSerializer.SerializeValue(context.mFunctions.mKeyType, nullptr, key);
+				context.mSerializer.SerializeValue(context.mFunctions.mValueType, nullptr, entry);
+				return true;
+			}, &context);
+			return;
+		}
+
+		case ContainerKind::Optional:
+		{
+			const auto& functions = static_cast<const OptionalFunctions&>(containerFunctions);
+			const void* optionalValue = functions.mGetValue(container);
+
+			Write<uint8_t>(optionalValue != nullptr);
+			if (optionalValue != nullptr)
+			{
+				SerializeValue(functions.mValueType, nullptr, optionalValue);
+			}
+			return;
+		}
+
+		default:
+			return;
+		}
+	}
+
+	void BinarySerializer::SerializeElement(const TypeInfo& type, bool isPointer, const void* value)
+	{
+		// Values of unreflected types aren't written at all. They have no type in the field table, so the reader skips them too.
+		if (isPointer)
+		{
+			const ClassInfo* classInfo = type.mKind == TypeKind::Class ? type.GetClassInfo() : nullptr;
+			if (classInfo != nullptr)
+			{
+				SerializeDynamicObject(*classInfo, *(const void* const*)value);
+			}
+			return;
+		}
+
+		if (type.mKind == TypeKind::Class)
+		{
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type))
+			{
+				const auto& string = *static_cast<const std::string*>(value);
+				WriteSize(string.size());
+				Write(string.data(), string.size());
+				return;
+			}
+#endif
+
+			const ClassInfo* classInfo = type.GetClassInfo();
+			if (classInfo != nullptr)
+			{
+				SerializeObjectFields(*classInfo, value);
+			}
+			return;
+		}
+
+		if (BinarySchemaCache::IsTriviallyCopyable(type.mKind))
+		{
+			Write(value, type.mSize);
+		}
+	}
+
+	void BinarySerializer::SerializeDynamicObject(const ClassInfo& staticClassInfo, const void* value)
+	{
+		if (value == nullptr)
+		{
+			Write(BinaryPointerTag::Null);
+			return;
+		}
+
+		const ClassInfo& classInfo = staticClassInfo.GetDynamicClass(value);
+		Write(BinaryPointerTag::Object);
+		WriteClass(classInfo);
+		SerializeObjectFields(classInfo, value);
+	}
+
+	void BinarySerializer::WriteClass(const ClassInfo& classInfo)
+	{
+		const auto [it, isNew] = mClassIndices.emplace(&classInfo, (uint32_t)mClassIndices.size());
+		WriteSize(it->second);
+		if (!isNew)
+		{
+			return;
+		}
+
+		const std::string_view name = classInfo.mType->mNameString;
+		WriteSize(name.size());
+		Write(name.data(), name.size());
+
+		const BinaryClassSchema& schema = mSchemas.GetSchema(classInfo);
+		WriteSize(schema.mFields.size());
+		for (const BinarySchemaField& field : schema.mFields)
+		{
+			Write(field.mField->mName.GetHash());
+			WriteType(field.mType);
+		}
+	}
+
+	void BinarySerializer::WriteType(const BinaryType& type)
+	{
+		Write(type.mKind);
+
+		switch (type.mKind)
+		{
+		case BinaryValueKind::Number:
+			Write(type.mNumberKind);
+			WriteSize(type.mSize);
+			break;
+
+		case BinaryValueKind::Object:
+			// Nested classes are written in full the first time, before the rest of this table.
+			WriteClass(*type.mClassInfo);
+			break;
+
+		case BinaryValueKind::Array:
+			WriteSize(type.mCount);
+			WriteType(type.mElements[0]);
+			break;
+
+		case BinaryValueKind::Sequence:
+		case BinaryValueKind::Optional:
+			WriteType(type.mElements[0]);
+			break;
+
+		case BinaryValueKind::Map:
+			WriteType(type.mElements[0]);
+			WriteType(type.mElements[1]);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	void BinarySerializer::Write(const void* data, size_t size)
+	{
+		const size_t offset = mBuffer.size();
+		mBuffer.resize(offset + size);
+		std::memcpy(mBuffer.data() + offset, data, size);
+	}
+
+	void BinarySerializer::WriteSize(size_t size)
+	{
+		// LEB128: 7 bits at a time, with the high bit set if more bytes follow.
+		uint8_t bytes[10];
+		size_t count = 0;
+		do
+		{
+			bytes[count] = (uint8_t)(size & 0x7F);
+			size >>= 7;
+			if (size != 0)
+			{
+				bytes[count] |= 0x80;
+			}
+			++count;
+		} while (size != 0);
+
+		Write(bytes, count);
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "BinarySchema.h"
+
+namespace cpprefl::binary
+{
+	// Writes reflected objects in a compact binary format, meant for fast save/load and IPC between builds of the same program.
+	//
+	// Each document starts with its class, followed by the field data in field order. Runs of adjacent trivially copyable fields
+	// are written with a single memcpy, as is the data of dynamic arrays of trivially copyable values. Everything is written in
+	// native byte order.
+	//
+	// Classes are written as an index into the class table of the stream. The first time a class is written, its name and field
+	// table (the name and BinaryType of each field) follow the index, which lets the reader load data written before fields were
+	// added, removed, reordered or changed type.
+	class BinarySerializer
+	{
+	public:
+		// Appends an object to the output.
+		template <typename T>
+		void Serialize(const T& object)
+		{
+			Serialize(GetReflectedClass<T>(), &object);
+		}
+
+		void Serialize(const ClassInfo& classInfo, const void* classObject);
+
+		// Returns everything written so far.
+		const std::vector<std::byte>& GetBuffer()const { return mBuffer; }
+
+		// Discards all output (and the class table that goes with it), keeping the buffer around for reuse.
+		void Clear() { mBuffer.clear(); mClassIndices.clear(); }
+
+	private:
+		void SerializeObjectFields(const ClassInfo& classInfo, const void* classObject);
+
+		void SerializeValue(const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value);
+		void SerializeContainer(const ContainerFunctions& containerFunctions, const void* value);
+		void SerializeElement(const TypeInfo& type, bool isPointer, const void* value);
+		void SerializeDynamicObject(const ClassInfo& staticClassInfo, const void* value);
+
+		void WriteClass(const ClassInfo& classInfo);
+		void WriteType(const BinaryType& type);
+
+		void Write(const void* data, size_t size);
+		void WriteSize(size_t size);
+
+		template <typename T>
+		void Write(const T& value) { Write(&value, sizeof(T)); }
+
+		std::vector<std::byte> mBuffer;
+		BinarySchemaCache mSchemas;
+
+		// Index of each class written so far.
+		std::unordered_map<const ClassInfo*, uint32_t> mClassIndices;
+	};
+}
@@ -0,0 +1,55 @@
+#include "BitPackDeserializer.h"
+
+#include "../CppReflConfig.h"
+
+namespace cpprefl::bitpack
+{
+	BitPackDeserializer::BitPackDeserializer(const void* data, size_t size) : mReader(data, size)
+	{
+	}
+
+	bool BitPackDeserializer::Deserialize(const ClassInfo& classInfo, void* classObject, const void* baseline)
+	{
+		const BitPackPlan& plan = mPlans.GetPlan(classInfo);
+		for (const BitPackStep& step : plan.mSteps)
+		{
+			if (baseline != nullptr)
+			{
+				uint64_t changed;
+				if (!mReader.Read(changed, 1))
+				{
+					return SetError("Unexpected end of input");
+				}
+
+				if (changed == 0)
+				{
+					step.Unpack(step.Pack(baseline), classObject);
+					continue;
+				}
+			}
+
+			uint64_t bits;
+			if (!mReader.Read(bits, step.mBits))
+			{
+				return SetError("Unexpected end of input");
+			}
+
+			step.Unpack(bits, classObject);
+		}
+
+		mReader.AlignToByte();
+		++mObjectCount;
+		return true;
+	}
+
+	bool BitPackDeserializer::SetError(const char* message)
+	{
+		if (!mError)
+		{
+			mError = true;
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "Bit-packed parse error in object %zu: %s", mObjectCount, message);
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "BitPackPlan.h"
+#include "BitStream.h"
+
+namespace cpprefl::bitpack
+{
+	// Reads objects written by the BitPackSerializer. The input must outlive the deserializer.
+	class BitPackDeserializer
+	{
+	public:
+		BitPackDeserializer(const void* data, size_t size);
+
+		// Reads the next object, which was written against the given baseline (if any). Fields that aren't bit-packed are copied
+		// from the baseline. Returns an empty value if the input is too short.
+		template <typename T>
+		std::optional<T> Deserialize(const T* baseline = nullptr)
+		{
+			std::optional<T> result;
+			if (baseline != nullptr)
+			{
+				result.emplace(*baseline);
+			}
+			else
+			{
+				result.emplace();
+			}
+
+			if (!Deserialize(GetReflectedClass<T>(), &*result, baseline))
+			{
+				return std::nullopt;
+			}
+
+			return result;
+		}
+
+		// Reads the next object into an already constructed object. Values that didn't change are taken from the baseline,
+		// which may be the object itself. Fields that aren't bit-packed are left untouched.
+		bool Deserialize(const ClassInfo& classInfo, void* classObject, const void* baseline = nullptr);
+
+		// Returns true if the whole input has been read.
+		bool IsAtEnd()const { return mReader.IsAtEnd(); }
+
+		// Returns true if the input was too short.
+		bool HasError()const { return mError; }
+
+	private:
+		bool SetError(const char* message);
+
+		BitReader mReader;
+		BitPackPlanCache mPlans;
+
+		// Number of objects read so far.
+		size_t mObjectCount = 0;
+
+		bool mError = false;
+	};
+}
@@ -0,0 +1,417 @@
+#include "BitPackPlan.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "../CppReflConfig.h"
+#include "../Reflection/EnumInfo.h"
+
+namespace cpprefl::bitpack
+{
+	namespace
+	{
+		// Most bits a float can be quantized to.
+		constexpr int MaxQuantizedBits = 32;
+
+		constexpr uint64_t GetMask(uint32_t bitCount)
+		{
+			return bitCount >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << bitCount) - 1;
+		}
+
+		uint32_t GetSize(TypeKind kind)
+		{
+			switch (kind)
+			{
+			case TypeKind::Bool:
+			case TypeKind::Uint8:
+			case TypeKind::Int8:
+				return 1;
+			case TypeKind::Uint16:
+			case TypeKind::Int16:
+				return 2;
+			case TypeKind::Uint32:
+			case TypeKind::Int32:
+			case TypeKind::Float:
+				return 4;
+			default:
+				return 8;
+			}
+		}
+
+		bool IsSigned(TypeKind kind)
+		{
+			return kind == TypeKind::Int8 || kind == TypeKind::Int16 || kind == TypeKind::Int32 || kind == TypeKind::Int64;
+		}
+
+		// Returns the integer kind an enum is packed as. The underlying type isn't reflected, so enums without negative values are
+		// treated as unsigned, so that values with the top bit set (e.g. 200 in a uint8_t enum) aren't sign extended.
+		TypeKind GetEnumKind(const TypeInfo& type)
+		{
+			const EnumInfo* enumInfo = type.GetEnumInfo();
+			const bool isSigned = enumInfo == nullptr ||
+				std::any_of(enumInfo->mValues.begin(), enumInfo->mValues.end(), [](const EnumValueInfo& value) { return value.mValue < 0; });
+
+			switch (type.mSize)
+			{
+			case 1: return isSigned ? TypeKind::Int8 : TypeKind::Uint8;
+			case 2: return isSigned ? TypeKind::Int16 : TypeKind::Uint16;
+			case 4: return isSigned ? TypeKind::Int32 : TypeKind::Uint32;
+			default: return isSigned ? TypeKind::Int64 : TypeKind::Uint64;
+			}
+		}
+
+		uint64_t LoadBits(const void* value, uint32_t size)
+		{
+			switch (size)
+			{
+			case 1: { uint8_t bits; std::memcpy(&bits, value, sizeof(bits)); return bits; }
+			case 2: { uint16_t bits; std::memcpy(&bits, value, sizeof(bits)); return bits; }
+			case 4: { uint32_t bits; std::memcpy(&bits, value, sizeof(bits)); return bits; }
+			default: { uint64_t bits; std::memcpy(&bits, value, sizeof(bits)); return bits; }
+			}
+		}
+
+		void StoreBits(void* value, uint32_t size, uint64_t bits)
+		{
+			switch (size)
+			{
+			case 1: { const uint8_t sized = (uint8_t)bits; std::memcpy(value, &sized, sizeof(sized)); break; }
+			case 2: { const uint16_t sized = (uint16_t)bits; std::memcpy(value, &sized, sizeof(sized)); break; }
+			case 4: { const uint32_t sized = (uint32_t)bits; std::memcpy(value, &sized, sizeof(sized)); break; }
+			default: std::memcpy(value, &bits, sizeof(bits)); break;
+			}
+		}
+
+		// Loads an integer, sign extending signed kinds. Unsigned 64 bit values that don't fit saturate.
+		int64_t LoadInteger(TypeKind kind, const void* value)
+		{
+			const uint32_t size = GetSize(kind);
+			const uint64_t bits = LoadBits(value, size);
+			if (IsSigned(kind))
+			{
+				const uint32_t shift = 64 - size * 8;
+				return (int64_t)(bits << shift) >> shift;
+			}
+
+			return (int64_t)std::min(bits, (uint64_t)std::numeric_limits<int64_t>::max());
+		}
+
+		void GetLimits(TypeKind kind, int64_t& min, int64_t& max)
+		{
+			const uint32_t bitCount = GetSize(kind) * 8;
+			if (IsSigned(kind))
+			{
+				min = -(int64_t)(GetMask(bitCount - 1)) - 1;
+				max = (int64_t)GetMask(bitCount - 1);
+			}
+			else
+			{
+				min = 0;
+				max = (int64_t)std::min(GetMask(bitCount), (uint64_t)std::numeric_limits<int64_t>::max());
+			}
+		}
+
+		// Returns the value of a number attribute of the field, or nullptr if there is none.
+		const MetadataAttributeValue* GetNumberAttribute(const FieldInfo& field, const char* key)
+		{
+			const MetadataAttributeValue* value = field.GetAttribute(Name(key));
+			if (value != nullptr && !value->IsNumber())
+			{
+				CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Ignoring '%s' of field '%.*s', it isn't a number.", key, (int)field.mNameString.size(), field.mNameString.data());
+				return nullptr;
+			}
+
+			return value;
+		}
+
+		void LogInvalidPacking(const FieldInfo& field, const char* message)
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Field '%.*s' %s, writing it whole.", (int)field.mNameString.size(), field.mNameString.data(), message);
+		}
+
+		void SetRange(BitPackStep& step, int64_t min, int64_t max)
+		{
+			step.mEncoding = BitPackEncoding::Range;
+			step.mMin = min;
+			step.mMax = max;
+			step.mBits = (uint8_t)std::bit_width((uint64_t)max - (uint64_t)min);
+		}
+
+		// Picks how an integer or enum is packed.
+		void PlanInteger(BitPackStep& step, const FieldInfo& field)
+		{
+			int64_t typeMin;
+			int64_t typeMax;
+			GetLimits(step.mKind, typeMin, typeMax);
+
+			const MetadataAttributeValue* minAttribute = GetNumberAttribute(field, "min");
+			const MetadataAttributeValue* maxAttribute = GetNumberAttribute(field, "max");
+			const MetadataAttributeValue* bitsAttribute = GetNumberAttribute(field, "bits");
+
+			int bits = 0;
+			if (bitsAttribute != nullptr)
+			{
+				bits = (int)bitsAttribute->GetNumber();
+				if (bits < 1 || bits > step.mBits)
+				{
+					LogInvalidPacking(field, "has an invalid bit count");
+					bits = 0;
+				}
+			}
+
+			const bool isSigned = IsSigned(step.mKind);
+			if (minAttribute != nullptr || maxAttribute != nullptr)
+			{
+				int64_t min = isSigned ? (bits > 0 ? -(int64_t)GetMask(bits - 1) - 1 : typeMin) : 0;
+				if (minAttribute != nullptr)
+				{
+					min = std::clamp((int64_t)std::llround(minAttribute->GetNumber()), typeMin, typeMax);
+				}
+
+				int64_t max = typeMax;
+				if (maxAttribute != nullptr)
+				{
+					max = std::clamp((int64_t)std::llround(maxAttribute->GetNumber()), typeMin, typeMax);
+				}
+				else if (bits > 0)
+				{
+					max = GetMask(bits) > (uint64_t)typeMax - (uint64_t)min ? typeMax : min + (int64_t)GetMask(bits);
+				}
+
+				if (max >= min)
+				{
+					SetRange(step, min, max);
+					if (bits > 0 && step.mBits > bits)
+					{
+						CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Field '%.*s' needs %d bits to cover its range.", (int)field.mNameString.size(), field.mNameString.data(), (int)step.mBits);
+					}
+					return;
+				}
+
+				LogInvalidPacking(field, "has an empty range");
+			}
+			else if (bits > 0 && bits < step.mBits)
+			{
+				if (isSigned)
+				{
+					SetRange(step, -(int64_t)GetMask(bits - 1) - 1, (int64_t)GetMask(bits - 1));
+				}
+				else
+				{
+					SetRange(step, 0, (int64_t)GetMask(bits));
+				}
+				return;
+			}
+
+			// Enums only ever hold one of their values.
+			const EnumInfo* enumInfo = field.GetType().mKind == TypeKind::Enum ? field.GetType().GetEnumInfo() : nullptr;
+			if (enumInfo != nullptr && enumInfo->mValues.size() > 0)
+			{
+				int64_t min = std::numeric_limits<int64_t>::max();
+				int64_t max = std::numeric_limits<int64_t>::min();
+				for (const EnumValueInfo& value : enumInfo->mValues)
+				{
+					min = std::min(min, (int64_t)value.mValue);
+					max = std::max(max, (int64_t)value.mValue);
+				}
+
+				SetRange(step, min, max);
+			}
+		}
+
+		// Picks how a float or double is packed.
+		void PlanFloat(BitPackStep& step, const FieldInfo& field)
+		{
+			const MetadataAttributeValue* minAttribute = GetNumberAttribute(field, "min");
+			const MetadataAttributeValue* maxAttribute = GetNumberAttribute(field, "max");
+			const MetadataAttributeValue* bitsAttribute = GetNumberAttribute(field, "bits");
+			if (minAttribute == nullptr && maxAttribute == nullptr && bitsAttribute == nullptr)
+			{
+				return;
+			}
+
+			if (minAttribute == nullptr || maxAttribute == nullptr || bitsAttribute == nullptr)
+			{
+				LogInvalidPacking(field, "needs \"bits\", \"min\" and \"max\" to be quantized");
+				return;
+			}
+
+			const int bits = (int)bitsAttribute->GetNumber();
+			const double min = minAttribute->GetNumber();
+			const double max = maxAttribute->GetNumber();
+			if (bits < 1 || bits > MaxQuantizedBits)
+			{
+				LogInvalidPacking(field, "has an invalid bit count");
+				return;
+			}
+
+			if (!(max > min))
+			{
+				LogInvalidPacking(field, "has an empty range");
+				return;
+			}
+
+			step.mEncoding = BitPackEncoding::Quantized;
+			step.mBits = (uint8_t)bits;
+			step.mMinValue = min;
+			step.mMaxValue = max;
+			step.mScale = (double)GetMask(bits) / (max - min);
+		}
+	}
+
+	uint64_t BitPackStep::Pack(const void* classObject)const
+	{
+		const std::byte* value = (const std::byte*)classObject + mOffset;
+		switch (mEncoding)
+		{
+		case BitPackEncoding::Range:
+		{
+			const int64_t integer = std::clamp(LoadInteger(mKind, value), mMin, mMax);
+			return (uint64_t)integer - (uint64_t)mMin;
+		}
+
+		case BitPackEncoding::Quantized:
+		{
+			double number = mKind == TypeKind::Float ? *(const float*)value : *(const double*)value;
+
+			// Written this way round so that NaN ends up at the minimum.
+			number = !(number >= mMinValue) ? mMinValue : std::min(number, mMaxValue);
+			return std::min((uint64_t)std::llround((number - mMinValue) * mScale), GetMask(mBits));
+		}
+
+		default:
+			return LoadBits(value, GetSize(mKind)) & GetMask(mBits);
+		}
+	}
+
+	void BitPackStep::Unpack(uint64_t bits, void* classObject)const
+	{
+		std::byte* value = (std::byte*)classObject + mOffset;
+		switch (mEncoding)
+		{
+		case BitPackEncoding::Range:
+		{
+			const uint64_t distance = std::min(bits, (uint64_t)mMax - (uint64_t)mMin);
+			StoreBits(value, GetSize(mKind), (uint64_t)mMin + distance);
+			break;
+		}
+
+		case BitPackEncoding::Quantized:
+		{
+			// The top code maps back to the maximum exactly, the rest are rounded to the nearest step.
+			const uint64_t code = std::min(bits, GetMask(mBits));
+			const double number = code == GetMask(mBits) ? mMaxValue : mMinValue + (double)code / mScale;
+			if (mKind == TypeKind::Float)
+			{
+				*(float*)value = (float)number;
+			}
+			else
+			{
+				*(double*)value = number;
+			}
+			break;
+		}
+
+		default:
+			StoreBits(value, GetSize(mKind), bits);
+			break;
+		}
+	}
+
+	const BitPackPlan& BitPackPlanCache::GetPlan(const ClassInfo& classInfo)
+	{
+		const auto it = mPlans.find(&classInfo);
+		if (it != mPlans.end())
+		{
+			return it->second;
+		}
+
+		BitPackPlan plan;
+		AddFields(plan, classInfo, 0);
+
+		for (const BitPackStep& step : plan.mSteps)
+		{
+			plan.mBitCount += step.mBits;
+		}
+
+		return mPlans.emplace(&classInfo, std::move(plan)).first->second;
+	}
+
+	void BitPackPlanCache::AddFields(BitPackPlan& plan, const ClassInfo& classInfo, uint32_t offset)
+	{
+		for (const FieldInfo& field : classInfo.mFlattenedFields)
+		{
+			if (!field.mTypeInstance.mIsConst)
+			{
+				AddValue(plan, field, offset + (uint32_t)field.mOffset);
+			}
+		}
+	}
+
+	void BitPackPlanCache::AddValue(BitPackPlan& plan, const FieldInfo& field, uint32_t offset)
+	{
+		const TypeInfo& type = field.GetType();
+		if (field.mTypeInstance.mIsPointer || field.mContainerFunctions != nullptr)
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping field '%.*s', pointers and containers can't be bit-packed.", (int)field.mNameString.size(), field.mNameString.data());
+			return;
+		}
+
+		const uint32_t count = field.mTypeInstance.mIsArray ? field.mTypeInstance.mArraySize : 1;
+		if (type.mKind == TypeKind::Class)
+		{
+			const ClassInfo* classInfo = type.GetClassInfo();
+			if (classInfo == nullptr)
+			{
+				CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping field '%.*s', its type is not reflected.", (int)field.mNameString.size(), field.mNameString.data());
+				return;
+			}
+
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				AddFields(plan, *classInfo, offset + i * (uint32_t)type.mSize);
+			}
+			return;
+		}
+
+		BitPackStep step;
+		step.mOffset = offset;
+		step.mKind = type.mKind;
+		step.mEncoding = BitPackEncoding::Raw;
+		step.mField = &field;
+
+		if (type.mKind == TypeKind::Enum)
+		{
+			step.mKind = GetEnumKind(type);
+		}
+
+		if (type.mKind == TypeKind::Bool)
+		{
+			step.mBits = 1;
+		}
+		else if (IsIntegerType(step.mKind))
+		{
+			step.mBits = (uint8_t)(GetSize(step.mKind) * 8);
+			PlanInteger(step, field);
+		}
+		else if (type.mKind == TypeKind::Float || type.mKind == TypeKind::Double)
+		{
+			step.mBits = (uint8_t)(GetSize(step.mKind) * 8);
+			PlanFloat(step, field);
+		}
+		else
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping field '%.*s', its type can't be bit-packed.", (int)field.mNameString.size(), field.mNameString.data());
+			return;
+		}
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			plan.mSteps.push_back(step);
+			step.mOffset += (uint32_t)type.mSize;
+		}
+	}
+}
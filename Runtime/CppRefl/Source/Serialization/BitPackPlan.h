@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../Reflection/ClassInfo.h"
+
+namespace cpprefl::bitpack
+{
+	// How a value is turned into the bits that get written.
+	enum class BitPackEncoding : uint8_t
+	{
+		// The low bits of the value (bools, unannotated numbers, and floats without a range).
+		Raw,
+
+		// An integer clamped to [mMin, mMax], written as its distance from mMin.
+		Range,
+
+		// A float clamped to [mMinValue, mMaxValue], mapped onto 2^bits evenly spaced values.
+		Quantized,
+	};
+
+	// One value in a bit-packed object.
+	struct BitPackStep
+	{
+		// Offset of the value in the (outermost) object.
+		uint32_t mOffset;
+
+		// Kind of the value. Enums use the signed integer kind of the same size.
+		TypeKind mKind;
+
+		BitPackEncoding mEncoding;
+
+		// Number of bits written.
+		uint8_t mBits;
+
+		// Range: bounds of the value.
+		int64_t mMin = 0;
+		int64_t mMax = 0;
+
+		// Quantized: bounds of the value, and the number of steps per unit.
+		double mMinValue = 0.0;
+		double mMaxValue = 0.0;
+		double mScale = 0.0;
+
+		// The field this value belongs to (the innermost one, for nested classes).
+		const FieldInfo* mField = nullptr;
+
+	public:
+		// Returns the bits to write for the value in the given object.
+		uint64_t Pack(const void* classObject)const;
+
+		// Stores the value decoded from the given bits in the object.
+		void Unpack(uint64_t bits, void* classObject)const;
+	};
+
+	// How the fields of a class are bit-packed.
+	struct BitPackPlan
+	{
+		// Every value that is written, in order. Fixed arrays and nested classes are flattened.
+		std::vector<BitPackStep> mSteps;
+
+		// Size of a full (non-delta) object, in bits.
+		uint32_t mBitCount = 0;
+	};
+
+	// Builds the plans of classes on first use.
+	//
+	// Values are packed according to the metadata of their field:
+	//  - REFL_META_RUNTIME("min", x) and REFL_META_RUNTIME("max", y) clamp integers (and enums) to a range, and write just enough bits
+	//    to cover it. Enums default to the range of their values.
+	//  - REFL_META_RUNTIME("bits", n) limits integers to n bits. Together with "min" and "max", it quantizes floats to n bits.
+	//  - Bools take a single bit, other values are written whole.
+	// Const fields are left out, as are pointers, containers and unreflected types.
+	class BitPackPlanCache
+	{
+	public:
+		const BitPackPlan& GetPlan(const ClassInfo& classInfo);
+
+	private:
+		void AddFields(BitPackPlan& plan, const ClassInfo& classInfo, uint32_t offset);
+		void AddValue(BitPackPlan& plan, const FieldInfo& field, uint32_t offset);
+
+		std::unordered_map<const ClassInfo*, BitPackPlan> mPlans;
+	};
+}
@@ -0,0 +1,26 @@
+#include "BitPackSerializer.h"
+
+namespace cpprefl::bitpack
+{
+	void BitPackSerializer::Serialize(const ClassInfo& classInfo, const void* classObject, const void* baseline)
+	{
+		const BitPackPlan& plan = mPlans.GetPlan(classInfo);
+		for (const BitPackStep& step : plan.mSteps)
+		{
+			const uint64_t bits = step.Pack(classObject);
+			if (baseline != nullptr)
+			{
+				const bool changed = bits != step.Pack(baseline);
+				mWriter.Write(changed, 1);
+				if (!changed)
+				{
+					continue;
+				}
+			}
+
+			mWriter.Write(bits, step.mBits);
+		}
+
+		mWriter.AlignToByte();
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "BitPackPlan.h"
+#include "BitStream.h"
+
+namespace cpprefl::bitpack
+{
+	// Writes reflected objects as tightly as their field metadata allows (see BitPackPlanCache), meant for snapshots sent over the
+	// network many times a second.
+	//
+	// Objects are written one after the other, each padded to a whole byte. There is no header: the reader has to know which class
+	// was written, and be built with the same metadata. When a baseline object is given, every value is preceded by a bit telling
+	// whether it changed, and only changed values are written. Values are compared after packing, so changes smaller than the
+	// precision of a field aren't written either.
+	class BitPackSerializer
+	{
+	public:
+		// Appends an object to the output, as a delta against the baseline if there is one.
+		template <typename T>
+		void Serialize(const T& object, const T* baseline = nullptr)
+		{
+			Serialize(GetReflectedClass<T>(), &object, baseline);
+		}
+
+		void Serialize(const ClassInfo& classInfo, const void* classObject, const void* baseline = nullptr);
+
+		// Returns everything written so far.
+		const std::vector<std::byte>& GetBuffer()const { return mWriter.GetBuffer(); }
+
+		// Discards all output, keeping the buffer around for reuse.
+		void Clear() { mWriter.Clear(); }
+
+		// Returns how objects of a class are packed.
+		const BitPackPlan& GetPlan(const ClassInfo& classInfo) { return mPlans.GetPlan(classInfo); }
+
+	private:
+		BitWriter mWriter;
+		BitPackPlanCache mPlans;
+	};
+}
@@ -0,0 +1,79 @@
+#include "BitStream.h"
+
+namespace cpprefl::bitpack
+{
+	namespace
+	{
+		// Largest number of bits handled in one go, so the pending bits never overflow.
+		constexpr uint32_t MaxChunkBits = 32;
+
+		constexpr uint64_t GetMask(uint32_t bitCount)
+		{
+			return bitCount >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << bitCount) - 1;
+		}
+	}
+
+	void BitWriter::Write(uint64_t value, uint32_t bitCount)
+	{
+		if (bitCount > MaxChunkBits)
+		{
+			Write(value, MaxChunkBits);
+			value >>= MaxChunkBits;
+			bitCount -= MaxChunkBits;
+		}
+
+		mPending |= (value & GetMask(bitCount)) << mPendingBitCount;
+		mPendingBitCount += bitCount;
+
+		while (mPendingBitCount >= 8)
+		{
+			mBuffer.push_back((std::byte)mPending);
+			mPending >>= 8;
+			mPendingBitCount -= 8;
+		}
+	}
+
+	void BitWriter::AlignToByte()
+	{
+		if (mPendingBitCount > 0)
+		{
+			Write(0, 8 - mPendingBitCount);
+		}
+	}
+
+	BitReader::BitReader(const void* data, size_t size) : mCurrent((const std::byte*)data), mEnd((const std::byte*)data + size)
+	{
+	}
+
+	bool BitReader::Read(uint64_t& value, uint32_t bitCount)
+	{
+		if (bitCount > MaxChunkBits)
+		{
+			uint64_t low;
+			uint64_t high;
+			if (!Read(low, MaxChunkBits) || !Read(high, bitCount - MaxChunkBits))
+			{
+				return false;
+			}
+
+			value = low | (high << MaxChunkBits);
+			return true;
+		}
+
+		while (mPendingBitCount < bitCount)
+		{
+			if (mCurrent == mEnd)
+			{
+				return false;
+			}
+
+			mPending |= (uint64_t)*mCurrent++ << mPendingBitCount;
+			mPendingBitCount += 8;
+		}
+
+		value = mPending & GetMask(bitCount);
+		mPending >>= bitCount;
+		mPendingBitCount -= bitCount;
+		return true;
+	}
+}
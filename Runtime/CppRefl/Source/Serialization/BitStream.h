@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cpprefl::bitpack
+{
+	// Appends values of any number of bits (up to 64) to a byte buffer, least significant bit first.
+	class BitWriter
+	{
+	public:
+		void Write(uint64_t value, uint32_t bitCount);
+
+		// Pads the output with zero bits up to the next byte.
+		void AlignToByte();
+
+		// Returns the output written so far, up to the last full byte.
+		const std::vector<std::byte>& GetBuffer()const { return mBuffer; }
+
+		// Returns the number of bits written so far.
+		size_t GetBitCount()const { return mBuffer.size() * 8 + mPendingBitCount; }
+
+		// Discards all output, keeping the buffer around for reuse.
+		void Clear() { mBuffer.clear(); mPending = 0; mPendingBitCount = 0; }
+
+	private:
+		std::vector<std::byte> mBuffer;
+
+		// Bits that don't make up a full byte yet (always fewer than 8).
+		uint64_t mPending = 0;
+		uint32_t mPendingBitCount = 0;
+	};
+
+	// Reads values written by a BitWriter. The input must outlive the reader.
+	class BitReader
+	{
+	public:
+		BitReader(const void* data, size_t size);
+
+		// Returns false if there aren't enough bits left.
+		bool Read(uint64_t& value, uint32_t bitCount);
+
+		// Skips the padding up to the next byte.
+		void AlignToByte() { mPending = 0; mPendingBitCount = 0; }
+
+		// Returns true if everything but the padding of the last byte has been read.
+		bool IsAtEnd()const { return mCurrent == mEnd; }
+
+	private:
+		const std::byte* mCurrent;
+		const std::byte* mEnd;
+
+		// Bits of the current byte(s) that haven't been read yet.
+		uint64_t mPending = 0;
+		uint32_t mPendingBitCount = 0;
+	};
+}
@@ -0,0 +1,642 @@
+#include "CborDeserializer.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "NumberConversion.h"
+#include "../CppReflConfig.h"
+
+namespace cpprefl::cbor
+{
+	using serialization::TruncateDouble;
+	using serialization::ValueType;
+
+	namespace
+	{
+		constexpr uint8_t MajorUnsigned = 0;
+		constexpr uint8_t MajorNegative = 1;
+		constexpr uint8_t MajorBytes = 2;
+		constexpr uint8_t MajorText = 3;
+		constexpr uint8_t MajorArray = 4;
+		constexpr uint8_t MajorMap = 5;
+		constexpr uint8_t MajorTag = 6;
+
+		// Additional information of items with indefinite length.
+		constexpr uint8_t Indefinite = 31;
+
+		constexpr std::byte Break{ 0xff };
+
+		// Maps the initial byte of each data item (other than tags) to its type.
+		constexpr std::array<ValueType, 256> BuildValueTypeTable()
+		{
+			std::array<ValueType, 256> table{};
+			for (int b = 0; b < 256; ++b)
+			{
+				// Additional information 28-30 is reserved, and only strings and containers can have indefinite lengths.
+				const int additionalInfo = b & 0x1f;
+				if (additionalInfo >= 28 && additionalInfo <= 30)
+				{
+					continue;
+				}
+
+				switch (b >> 5)
+				{
+				case MajorUnsigned:
+				case MajorNegative:
+					table[b] = additionalInfo == Indefinite ? ValueType::Invalid : ValueType::Number;
+					break;
+				case MajorBytes:
+				case MajorText: table[b] = ValueType::String; break;
+				case MajorArray: table[b] = ValueType::Array; break;
+				case MajorMap: table[b] = ValueType::Object; break;
+				default: break;
+				}
+			}
+
+			table[0xf4] = ValueType::Bool;		// False
+			table[0xf5] = ValueType::Bool;		// True
+			table[0xf6] = ValueType::Null;		// Null
+			table[0xf7] = ValueType::Null;		// Undefined
+			table[0xf9] = ValueType::Number;	// Half precision float
+			table[0xfa] = ValueType::Number;	// Single precision float
+			table[0xfb] = ValueType::Number;	// Double precision float
+			return table;
+		}
+
+		constexpr std::array<ValueType, 256> ValueTypeTable = BuildValueTypeTable();
+
+		double DecodeHalf(uint16_t half)
+		{
+			const int exponent = (half >> 10) & 0x1f;
+			const int mantissa = half & 0x3ff;
+
+			double value;
+			if (exponent == 0)
+			{
+				value = std::ldexp(mantissa, -24);
+			}
+			else if (exponent != 31)
+			{
+				value = std::ldexp(mantissa + 1024, exponent - 25);
+			}
+			else
+			{
+				value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+			}
+
+			return (half & 0x8000) ? -value : value;
+		}
+	}
+
+	CborDeserializer::CborDeserializer(const void* data, size_t size) :
+		mBegin((const std::byte*)data),
+		mCurrent((const std::byte*)data),
+		mEnd((const std::byte*)data + size)
+	{
+	}
+
+	CborDeserializer::CborDeserializer(const std::byte* document, const std::byte* begin, const std::byte* end, size_t elementCount) :
+		mBegin(document),
+		mCurrent(begin),
+		mEnd(end),
+		mRemaining({ elementCount })
+	{
+	}
+
+	ValueType CborDeserializer::PeekValue()
+	{
+		if (mError || !SkipTags() || mCurrent == mEnd)
+		{
+			return ValueType::Invalid;
+		}
+
+		return ValueTypeTable[(uint8_t)*mCurrent];
+	}
+
+	bool CborDeserializer::BeginObject()
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		if (token.mKind != TokenKind::Map)
+		{
+			return SetError("Expected a map");
+		}
+
+		return BeginContainer(token.mUInt, true);
+	}
+
+	bool CborDeserializer::NextKey(std::string_view& key)
+	{
+		if (!NextItem())
+		{
+			return false;
+		}
+
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		switch (token.mKind)
+		{
+		case TokenKind::String:
+			key = token.mString;
+			return true;
+
+		case TokenKind::UInt:
+			key = std::string_view(mKeyScratch, std::to_chars(mKeyScratch, mKeyScratch + sizeof(mKeyScratch), token.mUInt).ptr - mKeyScratch);
+			return true;
+
+		case TokenKind::Int:
+			key = std::string_view(mKeyScratch, std::to_chars(mKeyScratch, mKeyScratch + sizeof(mKeyScratch), token.mInt).ptr - mKeyScratch);
+			return true;
+
+		default:
+			return SetError("Expected a string or integer key");
+		}
+	}
+
+	bool CborDeserializer::BeginArray()
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		if (token.mKind != TokenKind::Array)
+		{
+			return SetError("Expected an array");
+		}
+
+		return BeginContainer(token.mUInt, false);
+	}
+
+	bool CborDeserializer::NextElement()
+	{
+		return NextItem();
+	}
+
+	bool CborDeserializer::ReadNull()
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		return token.mKind == TokenKind::Null || SetError("Expected null");
+	}
+
+	bool CborDeserializer::ReadBool(bool& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		if (token.mKind != TokenKind::Bool)
+		{
+			return SetError("Expected a boolean");
+		}
+
+		value = token.mBool;
+		return true;
+	}
+
+	bool CborDeserializer::ReadInt(int64_t& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		switch (token.mKind)
+		{
+		// Integers that are too big for a signed integer wrap around, the same as a cast would.
+		case TokenKind::UInt: value = (int64_t)token.mUInt; return true;
+		case TokenKind::Int: value = token.mInt; return true;
+		case TokenKind::Double: value = TruncateDouble<int64_t>(token.mDouble); return true;
+		default: return SetError("Expected a number");
+		}
+	}
+
+	bool CborDeserializer::ReadUInt(uint64_t& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		switch (token.mKind)
+		{
+		// Negative numbers wrap around, the same as a cast would.
+		case TokenKind::UInt: value = token.mUInt; return true;
+		case TokenKind::Int: value = (uint64_t)token.mInt; return true;
+		case TokenKind::Double: value = TruncateDouble<uint64_t>(token.mDouble); return true;
+		default: return SetError("Expected a number");
+		}
+	}
+
+	bool CborDeserializer::ReadDouble(double& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		switch (token.mKind)
+		{
+		case TokenKind::UInt: value = (double)token.mUInt; return true;
+		case TokenKind::Int: value = (double)token.mInt; return true;
+		case TokenKind::Double: value = token.mDouble; return true;
+		default: return SetError("Expected a number");
+		}
+	}
+
+	bool CborDeserializer::ReadString(std::string_view& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		if (token.mKind != TokenKind::String)
+		{
+			return SetError("Expected a string");
+		}
+
+		value = token.mString;
+		return true;
+	}
+
+	bool CborDeserializer::SkipValue()
+	{
+		// Skipped maps/arrays go on the same stack as the ones being read, on top of a pseudo array holding only the skipped value.
+		const size_t depth = mRemaining.size();
+		mRemaining.push_back(1);
+
+		while (mRemaining.size() > depth)
+		{
+			if (!NextItem())
+			{
+				if (mError)
+				{
+					return false;
+				}
+				continue;
+			}
+
+			Token token;
+			if (!ReadToken(token))
+			{
+				return false;
+			}
+
+			if (token.mKind == TokenKind::Array || token.mKind == TokenKind::Map)
+			{
+				if (token.mUInt == IndefiniteSize)
+				{
+					mRemaining.push_back(IndefiniteSize);
+				}
+				else if (!BeginContainer(token.mUInt, token.mKind == TokenKind::Map))
+				{
+					return false;
+				}
+				else if (token.mKind == TokenKind::Map)
+				{
+					// Keys and values are skipped alike.
+					mRemaining.back() *= 2;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool CborDeserializer::SplitArray(size_t chunkSize, std::vector<std::unique_ptr<serialization::IReader>>& chunks, size_t& elementCount)
+	{
+		// Finding the element boundaries only decodes the headers of the values, the elements are validated when the chunks are read.
+		const std::byte* chunkBegin = nullptr;
+		size_t chunkElementCount = 0;
+
+		elementCount = 0;
+		while (NextElement())
+		{
+			if (chunkElementCount == 0)
+			{
+				chunkBegin = mCurrent;
+			}
+
+			if (!SkipValue())
+			{
+				return false;
+			}
+
+			++elementCount;
+			if (++chunkElementCount == chunkSize)
+			{
+				chunks.emplace_back(new CborDeserializer(mBegin, chunkBegin, mCurrent, chunkElementCount));
+				chunkElementCount = 0;
+			}
+		}
+
+		if (mError)
+		{
+			return false;
+		}
+
+		if (chunkElementCount > 0)
+		{
+			chunks.emplace_back(new CborDeserializer(mBegin, chunkBegin, mCurrent, chunkElementCount));
+		}
+
+		return true;
+	}
+
+	bool CborDeserializer::ReadToken(Token& token)
+	{
+		if (mError || !SkipTags())
+		{
+			return false;
+		}
+
+		if (mCurrent == mEnd)
+		{
+			return SetError("Unexpected end of input");
+		}
+
+		const uint8_t initialByte = (uint8_t)*mCurrent++;
+		const uint8_t majorType = initialByte >> 5;
+		const uint8_t additionalInfo = initialByte & 0x1f;
+
+		uint64_t value;
+		switch (majorType)
+		{
+		case MajorUnsigned:
+			token.mKind = TokenKind::UInt;
+			return ReadArgument(additionalInfo, token.mUInt);
+
+		case MajorNegative:
+			if (!ReadArgument(additionalInfo, value))
+			{
+				return false;
+			}
+
+			// The value is -1 - n, clamped to the range of a signed integer.
+			token.mKind = TokenKind::Int;
+			token.mInt = value > (uint64_t)std::numeric_limits<int64_t>::max() ? std::numeric_limits<int64_t>::min() : -1 - (int64_t)value;
+			return true;
+
+		case MajorBytes:
+		case MajorText:
+			token.mKind = TokenKind::String;
+			if (additionalInfo == Indefinite)
+			{
+				return ReadIndefiniteString(majorType, token.mString);
+			}
+
+			return ReadArgument(additionalInfo, value) && ReadPayload(token.mString, value);
+
+		case MajorArray:
+		case MajorMap:
+			token.mKind = majorType == MajorArray ? TokenKind::Array : TokenKind::Map;
+			if (additionalInfo == Indefinite)
+			{
+				token.mUInt = IndefiniteSize;
+				return true;
+			}
+
+			return ReadArgument(additionalInfo, token.mUInt);
+
+		default:
+			break;
+		}
+
+		// Simple values and floats (tags were skipped above).
+		switch (additionalInfo)
+		{
+		case 20:
+		case 21:
+			token.mKind = TokenKind::Bool;
+			token.mBool = additionalInfo == 21;
+			return true;
+
+		// Null and undefined.
+		case 22:
+		case 23:
+			token.mKind = TokenKind::Null;
+			return true;
+
+		case 25:
+			if (!ReadBigEndian(value, 2))
+			{
+				return false;
+			}
+
+			token.mKind = TokenKind::Double;
+			token.mDouble = DecodeHalf((uint16_t)value);
+			return true;
+
+		case 26:
+		{
+			if (!ReadBigEndian(value, 4))
+			{
+				return false;
+			}
+
+			float number;
+			const uint32_t bits = (uint32_t)value;
+			std::memcpy(&number, &bits, sizeof(number));
+			token.mKind = TokenKind::Double;
+			token.mDouble = number;
+			return true;
+		}
+
+		case 27:
+			if (!ReadBigEndian(value, 8))
+			{
+				return false;
+			}
+
+			token.mKind = TokenKind::Double;
+			std::memcpy(&token.mDouble, &value, sizeof(double));
+			return true;
+
+		case Indefinite:
+			--mCurrent;
+			return SetError("Unexpected break");
+
+		default:
+			--mCurrent;
+			return SetError("Unsupported simple value");
+		}
+	}
+
+	bool CborDeserializer::ReadArgument(uint8_t additionalInfo, uint64_t& value)
+	{
+		if (additionalInfo < 24)
+		{
+			value = additionalInfo;
+			return true;
+		}
+
+		if (additionalInfo <= 27)
+		{
+			return ReadBigEndian(value, (size_t)1 << (additionalInfo - 24));
+		}
+
+		return SetError("Invalid additional information");
+	}
+
+	bool CborDeserializer::ReadBigEndian(uint64_t& value, size_t size)
+	{
+		if ((size_t)(mEnd - mCurrent) < size)
+		{
+			return SetError("Unexpected end of input");
+		}
+
+		value = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			value = (value << 8) | (uint8_t)mCurrent[i];
+		}
+
+		mCurrent += size;
+		return true;
+	}
+
+	bool CborDeserializer::ReadPayload(std::string_view& value, uint64_t size)
+	{
+		if ((uint64_t)(mEnd - mCurrent) < size)
+		{
+			return SetError("Unexpected end of input");
+		}
+
+		value = std::string_view((const char*)mCurrent, (size_t)size);
+		mCurrent += size;
+		return true;
+	}
+
+	bool CborDeserializer::ReadIndefiniteString(uint8_t majorType, std::string_view& value)
+	{
+		mScratch.clear();
+		while (mCurrent != mEnd)
+		{
+			if (*mCurrent == Break)
+			{
+				++mCurrent;
+				value = mScratch;
+				return true;
+			}
+
+			// Each chunk is a definite length string of the same type.
+			const uint8_t initialByte = (uint8_t)*mCurrent;
+			if ((initialByte >> 5) != majorType || (initialByte & 0x1f) == Indefinite)
+			{
+				return SetError("Invalid chunk in indefinite length string");
+			}
+
+			++mCurrent;
+
+			uint64_t size;
+			std::string_view chunk;
+			if (!ReadArgument(initialByte & 0x1f, size) || !ReadPayload(chunk, size))
+			{
+				return false;
+			}
+
+			mScratch.append(chunk);
+		}
+
+		return SetError("Unexpected end of input");
+	}
+
+	bool CborDeserializer::SkipTags()
+	{
+		while (mCurrent != mEnd && ((uint8_t)*mCurrent >> 5) == MajorTag)
+		{
+			const uint8_t additionalInfo = (uint8_t)*mCurrent++ & 0x1f;
+
+			uint64_t tag;
+			if (!ReadArgument(additionalInfo, tag))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool CborDeserializer::BeginContainer(uint64_t size, bool isMap)
+	{
+		// Every value takes at least one byte, which rejects bogus sizes before anything gets allocated for them.
+		const uint64_t available = mEnd - mCurrent;
+		if (size != IndefiniteSize && (size > available || (isMap && size * 2 > available)))
+		{
+			return SetError("Map or array is bigger than the input");
+		}
+
+		mRemaining.push_back(size);
+		return true;
+	}
+
+	bool CborDeserializer::NextItem()
+	{
+		if (mError || mRemaining.empty())
+		{
+			return false;
+		}
+
+		uint64_t& remaining = mRemaining.back();
+		if (remaining == IndefiniteSize)
+		{
+			if (mCurrent == mEnd)
+			{
+				return SetError("Unexpected end of input");
+			}
+
+			if (*mCurrent == Break)
+			{
+				++mCurrent;
+				mRemaining.pop_back();
+				return false;
+			}
+
+			return true;
+		}
+
+		if (remaining == 0)
+		{
+			mRemaining.pop_back();
+			return false;
+		}
+
+		--remaining;
+		return true;
+	}
+
+	bool CborDeserializer::SetError(const char* message)
+	{
+		if (!mError)
+		{
+			mError = true;
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "CBOR parse error at offset %zu: %s", (size_t)(mCurrent - mBegin), message);
+		}
+
+		return false;
+	}
+}
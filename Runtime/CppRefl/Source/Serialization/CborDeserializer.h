@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Reader.h"
+
+namespace cpprefl::cbor
+{
+	// CBOR (RFC 8949) reader. Values are decoded on demand straight out of the input buffer, so no DOM is ever built.
+	// The input must outlive the reader: text and byte strings (which read as strings) are returned as views into it, except
+	// for indefinite length strings, whose chunks are joined in a scratch buffer.
+	//
+	// Maps and arrays may have definite or indefinite lengths. Tags are skipped, undefined reads as null, and half precision floats
+	// are supported. Map keys must be strings or integers, integer keys are read as their decimal string (the way the Serializer
+	// writes the keys of integer maps).
+	class CborDeserializer : public serialization::IReader
+	{
+	public:
+		CborDeserializer(const void* data, size_t size);
+
+		serialization::ValueType PeekValue() override;
+
+		bool BeginObject() override;
+		bool NextKey(std::string_view& key) override;
+
+		bool BeginArray() override;
+		bool NextElement() override;
+
+		bool ReadNull() override;
+		bool ReadBool(bool& value) override;
+		bool ReadInt(int64_t& value) override;
+		bool ReadUInt(uint64_t& value) override;
+		bool ReadDouble(double& value) override;
+		bool ReadString(std::string_view& value) override;
+
+		bool SkipValue() override;
+
+		bool SplitArray(size_t chunkSize, std::vector<std::unique_ptr<serialization::IReader>>& chunks, size_t& elementCount) override;
+
+		bool HasError()const override { return mError; }
+
+		// Returns true if the whole input has been read.
+		bool IsAtEnd()const { return mCurrent == mEnd; }
+
+	private:
+		enum class TokenKind : uint8_t
+		{
+			Null,
+			Bool,
+			UInt,
+			Int,
+			Double,
+			String,
+			Array,
+			Map,
+		};
+
+		// A decoded data item header. Strings include their payload.
+		struct Token
+		{
+			TokenKind mKind;
+
+			union
+			{
+				bool mBool;
+				int64_t mInt;
+				double mDouble;
+
+				// Also the number of elements (or key/value pairs) of arrays and maps, IndefiniteSize if they end with a break.
+				uint64_t mUInt;
+			};
+
+			std::string_view mString;
+		};
+
+		static constexpr uint64_t IndefiniteSize = ~(uint64_t)0;
+
+		// Reads the given number of elements of an array between begin and end. See SplitArray().
+		CborDeserializer(const std::byte* document, const std::byte* begin, const std::byte* end, size_t elementCount);
+
+		bool ReadToken(Token& token);
+
+		// Reads the argument of a data item from its additional information.
+		bool ReadArgument(uint8_t additionalInfo, uint64_t& value);
+
+		// Reads a big endian number of the given size.
+		bool ReadBigEndian(uint64_t& value, size_t size);
+
+		// Reads a string payload of the given size.
+		bool ReadPayload(std::string_view& value, uint64_t size);
+
+		// Joins the chunks of an indefinite length string of the given major type.
+		bool ReadIndefiniteString(uint8_t majorType, std::string_view& value);
+
+		// Steps over any tags in front of the next data item.
+		bool SkipTags();
+
+		// Enters a map/array of the given size, checking that the input is big enough to hold its keys and values.
+		bool BeginContainer(uint64_t size, bool isMap);
+
+		// Moves to the next key/element of the current map/array.
+		bool NextItem();
+
+		bool SetError(const char* message);
+
+		const std::byte* mBegin;
+		const std::byte* mCurrent;
+		const std::byte* mEnd;
+
+		// Number of elements (or key/value pairs) left in each map/array that is being read, IndefiniteSize if it ends with a break.
+		std::vector<uint64_t> mRemaining;
+
+		bool mError = false;
+
+		// Holds joined indefinite length strings. Reused to avoid allocations.
+		std::string mScratch;
+
+		// Holds integer map keys converted to strings.
+		char mKeyScratch[24];
+	};
+}
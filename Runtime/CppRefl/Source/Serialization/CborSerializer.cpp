@@ -0,0 +1,212 @@
+#include "CborSerializer.h"
+
+#include <cstring>
+
+namespace cpprefl::cbor
+{
+	namespace
+	{
+		constexpr uint8_t MajorUnsigned = 0;
+		constexpr uint8_t MajorNegative = 1;
+		constexpr uint8_t MajorBytes = 2;
+		constexpr uint8_t MajorText = 3;
+		constexpr uint8_t MajorArray = 4;
+		constexpr uint8_t MajorMap = 5;
+
+		// Size of the largest map/array header (a 4 byte argument), reserved until the size of the container is known.
+		constexpr size_t MaxContainerHeaderSize = 5;
+
+		// Encodes the head of a data item into bytes, returning its size.
+		size_t EncodeHead(std::byte* bytes, uint8_t majorType, uint64_t argument)
+		{
+			const uint8_t major = (uint8_t)(majorType << 5);
+			if (argument < 24)
+			{
+				bytes[0] = (std::byte)(major | argument);
+				return 1;
+			}
+
+			size_t size;
+			if (argument <= UINT8_MAX)
+			{
+				bytes[0] = (std::byte)(major | 24);
+				size = 1;
+			}
+			else if (argument <= UINT16_MAX)
+			{
+				bytes[0] = (std::byte)(major | 25);
+				size = 2;
+			}
+			else if (argument <= UINT32_MAX)
+			{
+				bytes[0] = (std::byte)(major | 26);
+				size = 4;
+			}
+			else
+			{
+				bytes[0] = (std::byte)(major | 27);
+				size = 8;
+			}
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				bytes[size - i] = (std::byte)(argument >> (i * 8));
+			}
+
+			return size + 1;
+		}
+	}
+
+	void CborSerializer::BeginObject()
+	{
+		BeginValue();
+		BeginContainer(true);
+	}
+
+	void CborSerializer::Key(std::string_view key)
+	{
+		++mContainers.back().mSize;
+		WriteHead(MajorText, key.size());
+		Append(key.data(), key.size());
+	}
+
+	void CborSerializer::EndObject()
+	{
+		EndContainer(MajorMap);
+	}
+
+	void CborSerializer::BeginArray()
+	{
+		BeginValue();
+		BeginContainer(false);
+	}
+
+	void CborSerializer::EndArray()
+	{
+		EndContainer(MajorArray);
+	}
+
+	void CborSerializer::WriteNull()
+	{
+		BeginValue();
+		Append(0xf6);
+	}
+
+	void CborSerializer::WriteBool(bool value)
+	{
+		BeginValue();
+		Append(value ? 0xf5 : 0xf4);
+	}
+
+	void CborSerializer::WriteInt(int64_t value)
+	{
+		BeginValue();
+		if (value >= 0)
+		{
+			WriteHead(MajorUnsigned, (uint64_t)value);
+		}
+		else
+		{
+			// Negative integers are encoded as -1 - n.
+			WriteHead(MajorNegative, ~(uint64_t)value);
+		}
+	}
+
+	void CborSerializer::WriteUInt(uint64_t value)
+	{
+		BeginValue();
+		WriteHead(MajorUnsigned, value);
+	}
+
+	void CborSerializer::WriteFloat(float value)
+	{
+		BeginValue();
+
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		std::byte bytes[5] = { (std::byte)0xfa };
+		for (size_t i = 0; i < 4; ++i)
+		{
+			bytes[4 - i] = (std::byte)(bits >> (i * 8));
+		}
+
+		Append(bytes, sizeof(bytes));
+	}
+
+	void CborSerializer::WriteDouble(double value)
+	{
+		BeginValue();
+
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		std::byte bytes[9] = { (std::byte)0xfb };
+		for (size_t i = 0; i < 8; ++i)
+		{
+			bytes[8 - i] = (std::byte)(bits >> (i * 8));
+		}
+
+		Append(bytes, sizeof(bytes));
+	}
+
+	void CborSerializer::WriteString(std::string_view value)
+	{
+		BeginValue();
+		WriteHead(MajorText, value.size());
+		Append(value.data(), value.size());
+	}
+
+	void CborSerializer::WriteBytes(const void* data, size_t size)
+	{
+		BeginValue();
+		WriteHead(MajorBytes, size);
+		Append(data, size);
+	}
+
+	void CborSerializer::BeginContainer(bool isObject)
+	{
+		mContainers.push_back({ mBuffer.size(), 0, isObject });
+		mBuffer.resize(mBuffer.size() + MaxContainerHeaderSize);
+	}
+
+	void CborSerializer::EndContainer(uint8_t majorType)
+	{
+		const Container container = mContainers.back();
+		mContainers.pop_back();
+
+		// Encode the real header, then move the contents down over the bytes it doesn't use.
+		std::byte header[MaxContainerHeaderSize];
+		const size_t headerSize = EncodeHead(header, majorType, container.mSize);
+
+		std::byte* headerStart = mBuffer.data() + container.mHeaderOffset;
+		const size_t contentSize = mBuffer.size() - container.mHeaderOffset - MaxContainerHeaderSize;
+		if (headerSize != MaxContainerHeaderSize)
+		{
+			std::memmove(headerStart + headerSize, headerStart + MaxContainerHeaderSize, contentSize);
+			mBuffer.resize(mBuffer.size() - (MaxContainerHeaderSize - headerSize));
+		}
+
+		std::memcpy(headerStart, header, headerSize);
+	}
+
+	void CborSerializer::BeginValue()
+	{
+		if (!mContainers.empty() && !mContainers.back().mIsObject)
+		{
+			++mContainers.back().mSize;
+		}
+	}
+
+	void CborSerializer::WriteHead(uint8_t majorType, uint64_t argument)
+	{
+		std::byte bytes[9];
+		Append(bytes, EncodeHead(bytes, majorType, argument));
+	}
+
+	void CborSerializer::Append(const void* data, size_t size)
+	{
+		const std::byte* bytes = (const std::byte*)data;
+		mBuffer.insert(mBuffer.end(), bytes, bytes + size);
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Writer.h"
+
+namespace cpprefl::cbor
+{
+	// CBOR (RFC 8949) writer. Values are encoded straight into a single buffer that grows as needed, using the shortest
+	// argument for each integer, string and container size. Floats are written as single precision, doubles as double precision.
+	//
+	// Maps and arrays are written with definite lengths, like the MsgPackSerializer does: each object/array reserves room for the
+	// largest header, which is moved down over the unused bytes once the container ends.
+	class CborSerializer : public serialization::IWriter
+	{
+	public:
+		void BeginObject() override;
+		void Key(std::string_view key) override;
+		void EndObject() override;
+
+		void BeginArray() override;
+		void EndArray() override;
+
+		void WriteNull() override;
+		void WriteBool(bool value) override;
+		void WriteInt(int64_t value) override;
+		void WriteUInt(uint64_t value) override;
+		void WriteFloat(float value) override;
+		void WriteDouble(double value) override;
+		void WriteString(std::string_view value) override;
+
+		// Writes a byte string, which the CborDeserializer reads back as a string.
+		void WriteBytes(const void* data, size_t size);
+
+		// Returns everything written so far. Only complete once every object/array has ended.
+		const std::vector<std::byte>& GetBuffer()const { return mBuffer; }
+
+		// Discards all output, keeping the buffer around for reuse.
+		void Clear() { mBuffer.clear(); mContainers.clear(); }
+
+	private:
+		// An object/array that hasn't ended yet.
+		struct Container
+		{
+			// Offset of the reserved header in the buffer.
+			size_t mHeaderOffset;
+
+			// Number of elements, or key/value pairs, written so far.
+			uint32_t mSize;
+
+			bool mIsObject;
+		};
+
+		void BeginContainer(bool isObject);
+		void EndContainer(uint8_t majorType);
+
+		// Counts a value towards the current array. Values in objects are counted by their keys.
+		void BeginValue();
+
+		// Writes the initial byte of a data item, followed by its argument.
+		void WriteHead(uint8_t majorType, uint64_t argument);
+
+		void Append(uint8_t byte) { mBuffer.push_back((std::byte)byte); }
+		void Append(const void* data, size_t size);
+
+		std::vector<std::byte> mBuffer;
+
+		std::vector<Container> mContainers;
+	};
+}
@@ -0,0 +1,331 @@
+#include "ColumnarReader.h"
+
+#include <cstring>
+#include <unordered_set>
+
+#include "../CppReflConfig.h"
+#include "NumberConversion.h"
+#include "ThreadPool.h"
+
+namespace cpprefl::columnar
+{
+	namespace
+	{
+		constexpr size_t Align(size_t size)
+		{
+			return (size + 7) & ~(size_t)7;
+		}
+
+		// Scratch space for decoded and converted columns, reused between columns.
+		thread_local std::vector<std::byte> DecodedValues;
+		thread_local std::vector<std::byte> ConvertedValues;
+
+		// Skips a part of the input, and its padding. Returns false if the input is too short.
+		bool Skip(size_t& offset, size_t size, uint64_t partSize)
+		{
+			if (partSize > size - offset || Align((size_t)partSize) > size - offset)
+			{
+				return false;
+			}
+
+			offset += Align((size_t)partSize);
+			return true;
+		}
+
+		template <typename Bits>
+		const char* ExpandDictionary(const ColumnarColumnView& view, size_t count, std::byte* output)
+		{
+			const std::byte* dictionary = view.mData;
+			const uint8_t* indices = (const uint8_t*)(view.mData + view.mEntryCount * sizeof(Bits));
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (indices[i] >= view.mEntryCount)
+				{
+					return "Dictionary index out of range";
+				}
+
+				std::memcpy(output + i * sizeof(Bits), dictionary + indices[i] * sizeof(Bits), sizeof(Bits));
+			}
+
+			return nullptr;
+		}
+
+		template <typename Bits>
+		const char* ExpandRuns(const ColumnarColumnView& view, size_t count, std::byte* output)
+		{
+			const std::byte* runValues = view.mData;
+			const std::byte* runLengths = view.mData + view.mEntryCount * sizeof(Bits);
+
+			size_t position = 0;
+			for (uint32_t run = 0; run < view.mEntryCount; ++run)
+			{
+				Bits value;
+				uint32_t length;
+				std::memcpy(&value, runValues + run * sizeof(Bits), sizeof(Bits));
+				std::memcpy(&length, runLengths + run * sizeof(uint32_t), sizeof(uint32_t));
+				if (length == 0 || length > count - position)
+				{
+					return "Invalid run length";
+				}
+
+				for (const size_t end = position + length; position < end; ++position)
+				{
+					std::memcpy(output + position * sizeof(Bits), &value, sizeof(Bits));
+				}
+			}
+
+			return position == count ? nullptr : "Runs don't cover every row";
+		}
+
+		template <typename Bits>
+		const char* Expand(const ColumnarColumnView& view, size_t count, std::byte* output)
+		{
+			return view.mEncoding == ColumnEncoding::Dictionary ? ExpandDictionary<Bits>(view, count, output) : ExpandRuns<Bits>(view, count, output);
+		}
+
+		// Copies contiguous values into the objects.
+		template <typename Bits>
+		void ScatterValues(const std::byte* values, std::byte* objects, size_t count, size_t stride)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				std::memcpy(objects + i * stride, values + i * sizeof(Bits), sizeof(Bits));
+			}
+		}
+
+		// Bools are normalized, so that malformed input can't produce a bool that is neither true nor false.
+		void ScatterBools(const std::byte* values, std::byte* objects, size_t count, size_t stride)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				objects[i * stride] = std::byte(values[i] != std::byte(0) ? 1 : 0);
+			}
+		}
+	}
+
+	ColumnarReader::ColumnarReader(const void* data, size_t size)
+	{
+		const std::byte* bytes = (const std::byte*)data;
+		if (size < sizeof(ColumnarTableHeader))
+		{
+			SetError("Input is too short");
+			return;
+		}
+
+		std::memcpy(&mHeader, bytes, sizeof(mHeader));
+		if (mHeader.mMagic != ColumnarTableHeader::Magic)
+		{
+			SetError("Not a columnar table, or written with a different byte order");
+			return;
+		}
+
+		if (mHeader.mVersion != ColumnarTableHeader::Version)
+		{
+			SetError("Unsupported version");
+			return;
+		}
+
+		size_t offset = 0;
+		Skip(offset, size, sizeof(ColumnarTableHeader));
+
+		for (uint32_t i = 0; i < mHeader.mColumnCount; ++i)
+		{
+			ColumnarColumnHeader header;
+			if (size - offset < sizeof(header))
+			{
+				SetError("Input is too short");
+				return;
+			}
+			std::memcpy(&header, bytes + offset, sizeof(header));
+			offset += Align(sizeof(header));
+
+			ColumnarColumnView view;
+			view.mName = std::string_view((const char*)bytes + offset, header.mNameLength);
+			if (!Skip(offset, size, header.mNameLength))
+			{
+				SetError("Input is too short");
+				return;
+			}
+
+			const uint64_t valueSize = GetColumnValueSize(header.mKind);
+			if (valueSize == 0)
+			{
+				SetError("Invalid column kind");
+				return;
+			}
+
+			const uint64_t rowCount = mHeader.mRowCount;
+			bool validSize = false;
+			switch (header.mEncoding)
+			{
+			case ColumnEncoding::Plain:
+				validSize = header.mDataSize % valueSize == 0 && header.mDataSize / valueSize == rowCount;
+				break;
+
+			case ColumnEncoding::Dictionary:
+				validSize = header.mEntryCount > 0 && header.mEntryCount <= MaxDictionarySize && header.mDataSize >= header.mEntryCount * valueSize &&
+					header.mDataSize - header.mEntryCount * valueSize == rowCount;
+				break;
+
+			case ColumnEncoding::RunLength:
+				validSize = header.mEntryCount <= rowCount && header.mDataSize == header.mEntryCount * (valueSize + sizeof(uint32_t));
+				break;
+			}
+
+			if (!validSize)
+			{
+				SetError("Column size doesn't match its encoding");
+				return;
+			}
+
+			view.mKind = header.mKind;
+			view.mEncoding = header.mEncoding;
+			view.mEntryCount = header.mEntryCount;
+			view.mData = bytes + offset;
+			view.mDataSize = header.mDataSize;
+			if (!Skip(offset, size, header.mDataSize))
+			{
+				SetError("Input is too short");
+				return;
+			}
+
+			mColumns.push_back(view);
+		}
+	}
+
+	bool ColumnarReader::Read(const ClassInfo& classInfo, void* objects, size_t count, size_t stride)
+	{
+		if (mError)
+		{
+			return false;
+		}
+
+		if (count != mHeader.mRowCount)
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Can't read %llu rows into %zu objects.", (unsigned long long)mHeader.mRowCount, count);
+			return false;
+		}
+
+		const ColumnarSchema& schema = mSchemas.GetSchema(classInfo);
+
+		// Columns are read in parallel, so each value is only written by the first column with its name.
+		std::vector<const ColumnarColumn*> targets(mColumns.size());
+		std::unordered_set<const ColumnarColumn*> usedTargets;
+		for (size_t i = 0; i < mColumns.size(); ++i)
+		{
+			targets[i] = schema.FindColumn(mColumns[i].mName);
+			if (targets[i] == nullptr || !usedTargets.insert(targets[i]).second)
+			{
+				CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping column '%.*s', it has no matching field.", (int)mColumns[i].mName.size(), mColumns[i].mName.data());
+				targets[i] = nullptr;
+			}
+		}
+
+		std::vector<const char*> errors(mColumns.size(), nullptr);
+		const auto read = [&](size_t columnIndex)
+		{
+			if (targets[columnIndex] != nullptr)
+			{
+				errors[columnIndex] = ReadColumn(mColumns[columnIndex], *targets[columnIndex], (std::byte*)objects, count, stride);
+			}
+		};
+
+		if (mThreadPool != nullptr && mColumns.size() > 1 && !mThreadPool->IsInParallelFor())
+		{
+			mThreadPool->ParallelFor(mColumns.size(), read);
+		}
+		else
+		{
+			for (size_t i = 0; i < mColumns.size(); ++i)
+			{
+				read(i);
+			}
+		}
+
+		for (const char* error : errors)
+		{
+			if (error != nullptr)
+			{
+				return SetError(error);
+			}
+		}
+
+		return true;
+	}
+
+	bool ColumnarReader::SetError(const char* message)
+	{
+		if (!mError)
+		{
+			mError = true;
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "Columnar table parse error: %s", message);
+		}
+
+		return false;
+	}
+
+	const char* ColumnarReader::ReadColumn(const ColumnarColumnView& view, const ColumnarColumn& column, std::byte* objects, size_t count, size_t stride)
+	{
+		const bool convert = view.mKind != column.mKind;
+		if (convert && !(serialization::IsNumberKind(view.mKind) && serialization::IsNumberKind(column.mKind)))
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping column '%.*s', its values can't be converted to the field.", (int)view.mName.size(), view.mName.data());
+			return nullptr;
+		}
+
+		if (count == 0)
+		{
+			return nullptr;
+		}
+
+		const std::byte* values = view.mData;
+		if (view.mEncoding != ColumnEncoding::Plain)
+		{
+			DecodedValues.resize(count * GetColumnValueSize(view.mKind));
+
+			const char* error;
+			switch (GetColumnValueSize(view.mKind))
+			{
+			case 1: error = Expand<uint8_t>(view, count, DecodedValues.data()); break;
+			case 2: error = Expand<uint16_t>(view, count, DecodedValues.data()); break;
+			case 4: error = Expand<uint32_t>(view, count, DecodedValues.data()); break;
+			default: error = Expand<uint64_t>(view, count, DecodedValues.data()); break;
+			}
+
+			if (error != nullptr)
+			{
+				return error;
+			}
+
+			values = DecodedValues.data();
+		}
+
+		if (convert)
+		{
+			ConvertedValues.resize(count * column.mSize);
+			serialization::ConvertNumbers(view.mKind, values, column.mKind, ConvertedValues.data(), count, serialization::NumberOverflow::Saturate);
+			values = ConvertedValues.data();
+		}
+
+		std::byte* fields = objects + column.mOffset;
+		switch (column.mSize)
+		{
+		case 1:
+			if (column.mKind == TypeKind::Bool)
+			{
+				ScatterBools(values, fields, count, stride);
+			}
+			else
+			{
+				ScatterValues<uint8_t>(values, fields, count, stride);
+			}
+			break;
+
+		case 2: ScatterValues<uint16_t>(values, fields, count, stride); break;
+		case 4: ScatterValues<uint32_t>(values, fields, count, stride); break;
+		default: ScatterValues<uint64_t>(values, fields, count, stride); break;
+		}
+
+		return nullptr;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "ColumnarSchema.h"
+
+namespace cpprefl::serialization
+{
+	class ThreadPool;
+}
+
+namespace cpprefl::columnar
+{
+	// A column of a table, as stored.
+	struct ColumnarColumnView
+	{
+		std::string_view mName;
+		TypeKind mKind;
+		ColumnEncoding mEncoding;
+		uint32_t mEntryCount;
+
+		const std::byte* mData;
+		uint64_t mDataSize;
+	};
+
+	// Reads objects from a table written by the ColumnarWriter. The input must outlive the reader.
+	//
+	// Columns are matched to the values of the class by name, so tables can be read after the class changed: columns without a
+	// value are skipped, and values without a column are left as constructed. Numbers whose kind changed are converted,
+	// saturating values that don't fit.
+	class ColumnarReader
+	{
+	public:
+		// Validates the header and the layout of the columns, see HasError().
+		ColumnarReader(const void* data, size_t size);
+
+		// Decodes columns on the given pool, one column per task. The pool must outlive the reader.
+		void SetThreadPool(serialization::ThreadPool* threadPool) { mThreadPool = threadPool; }
+
+		// Replaces the contents of the vector with the rows of the table.
+		template <typename T>
+		bool Read(std::vector<T>& objects)
+		{
+			if (mError)
+			{
+				return false;
+			}
+
+			objects.clear();
+			objects.resize((size_t)mHeader.mRowCount);
+			return Read(GetReflectedClass<T>(), objects.data(), objects.size(), sizeof(T));
+		}
+
+		// Reads the rows into already constructed objects, which are stride bytes apart. The count must match the number of rows.
+		bool Read(const ClassInfo& classInfo, void* objects, size_t count, size_t stride);
+
+		uint64_t GetRowCount()const { return mHeader.mRowCount; }
+
+		// Name hash of the class the table was written from.
+		Name GetClassName()const { return Name::FromHash(mHeader.mClass); }
+
+		const std::vector<ColumnarColumnView>& GetColumns()const { return mColumns; }
+
+		// Returns true if the input is malformed.
+		bool HasError()const { return mError; }
+
+	private:
+		bool SetError(const char* message);
+
+		// Returns an error message, or nullptr if the column was read.
+		static const char* ReadColumn(const ColumnarColumnView& view, const ColumnarColumn& column, std::byte* objects, size_t count, size_t stride);
+
+		ColumnarTableHeader mHeader{};
+		std::vector<ColumnarColumnView> mColumns;
+
+		ColumnarSchemaCache mSchemas;
+		serialization::ThreadPool* mThreadPool = nullptr;
+
+		bool mError = false;
+	};
+}
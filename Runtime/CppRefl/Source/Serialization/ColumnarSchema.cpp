@@ -0,0 +1,152 @@
+#include "ColumnarSchema.h"
+
+#include "../CppReflConfig.h"
+
+namespace cpprefl::columnar
+{
+	namespace
+	{
+		// Returns the signed integer kind an enum of the given size is stored as.
+		TypeKind GetEnumKind(size_t size)
+		{
+			switch (size)
+			{
+			case 1: return TypeKind::Int8;
+			case 2: return TypeKind::Int16;
+			case 4: return TypeKind::Int32;
+			case 8: return TypeKind::Int64;
+			default: return TypeKind::Invalid;
+			}
+		}
+	}
+
+	TypeKind GetColumnKind(const TypeInfo& type)
+	{
+		switch (type.mKind)
+		{
+		case TypeKind::Bool:
+		case TypeKind::Uint8:
+		case TypeKind::Int8:
+		case TypeKind::Uint16:
+		case TypeKind::Int16:
+		case TypeKind::Uint32:
+		case TypeKind::Int32:
+		case TypeKind::Uint64:
+		case TypeKind::Int64:
+		case TypeKind::Float:
+		case TypeKind::Double:
+			return type.mKind;
+
+		case TypeKind::Enum:
+			return GetEnumKind(type.mSize);
+
+		default:
+			return TypeKind::Invalid;
+		}
+	}
+
+	uint8_t GetColumnValueSize(TypeKind kind)
+	{
+		switch (kind)
+		{
+		case TypeKind::Bool:
+		case TypeKind::Uint8:
+		case TypeKind::Int8:
+			return 1;
+		case TypeKind::Uint16:
+		case TypeKind::Int16:
+			return 2;
+		case TypeKind::Uint32:
+		case TypeKind::Int32:
+		case TypeKind::Float:
+			return 4;
+		case TypeKind::Uint64:
+		case TypeKind::Int64:
+		case TypeKind::Double:
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	const ColumnarColumn* ColumnarSchema::FindColumn(std::string_view name)const
+	{
+		const auto it = mColumnsByName.find(Name(name.data(), name.size()).GetHash());
+		return it != mColumnsByName.end() && mColumns[it->second].mName == name ? &mColumns[it->second] : nullptr;
+	}
+
+	const ColumnarSchema& ColumnarSchemaCache::GetSchema(const ClassInfo& classInfo)
+	{
+		const auto it = mSchemas.find(&classInfo);
+		if (it != mSchemas.end())
+		{
+			return it->second;
+		}
+
+		ColumnarSchema schema;
+		AddFields(schema, classInfo, "", 0);
+
+		for (size_t i = 0; i < schema.mColumns.size(); ++i)
+		{
+			const std::string& name = schema.mColumns[i].mName;
+			schema.mColumnsByName.emplace(Name(name.data(), name.size()).GetHash(), i);
+		}
+
+		return mSchemas.emplace(&classInfo, std::move(schema)).first->second;
+	}
+
+	void ColumnarSchemaCache::AddFields(ColumnarSchema& schema, const ClassInfo& classInfo, const std::string& prefix, uint32_t offset)
+	{
+		for (const FieldInfo& field : classInfo.mFlattenedFields)
+		{
+			if (field.mTypeInstance.mIsConst)
+			{
+				continue;
+			}
+
+			if (field.mTypeInstance.mIsPointer || field.mContainerFunctions != nullptr)
+			{
+				CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping field '%.*s', pointers and containers can't be stored in a column.", (int)field.mNameString.size(), field.mNameString.data());
+				continue;
+			}
+
+			const std::string name = prefix + std::string(field.mNameString);
+			const uint32_t fieldOffset = offset + (uint32_t)field.mOffset;
+			if (!field.mTypeInstance.mIsArray)
+			{
+				AddValue(schema, field.GetType(), name, fieldOffset);
+				continue;
+			}
+
+			for (uint32_t i = 0; i < field.mTypeInstance.mArraySize; ++i)
+			{
+				AddValue(schema, field.GetType(), name + "[" + std::to_string(i) + "]", fieldOffset + i * (uint32_t)field.GetType().mSize);
+			}
+		}
+	}
+
+	void ColumnarSchemaCache::AddValue(ColumnarSchema& schema, const TypeInfo& type, std::string name, uint32_t offset)
+	{
+		if (type.mKind == TypeKind::Class)
+		{
+			const ClassInfo* classInfo = type.GetClassInfo();
+			if (classInfo == nullptr)
+			{
+				CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping field '%s', its type is not reflected.", name.c_str());
+				return;
+			}
+
+			AddFields(schema, *classInfo, name + ".", offset);
+			return;
+		}
+
+		const TypeKind kind = GetColumnKind(type);
+		if (kind == TypeKind::Invalid)
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping field '%s', its type can't be stored in a column.", name.c_str());
+			return;
+		}
+
+		schema.mColumns.push_back({ std::move(name), offset, kind, GetColumnValueSize(kind) });
+	}
+}
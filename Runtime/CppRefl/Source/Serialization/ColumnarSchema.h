@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Reflection/ClassInfo.h"
+
+namespace cpprefl::columnar
+{
+	// Columnar tables hold an array of reflected objects as one column per value, for bulk export (e.g. telemetry dumps loaded
+	// by analytics tools) where writing objects one by one is too slow.
+	//
+	// A table is a ColumnarTableHeader followed by the columns, each a ColumnarColumnHeader, the column's name and its data, with
+	// every part aligned to 8 bytes. Values are stored in native byte order. Column data depends on the encoding:
+	// - Plain: mRowCount values.
+	// - Dictionary: mEntryCount distinct values, followed by a uint8_t index into them per row.
+	// - RunLength: mEntryCount values, followed by a uint32_t run length per value.
+
+	enum class ColumnEncoding : uint8_t
+	{
+		Plain,
+		Dictionary,
+		RunLength,
+	};
+
+	struct ColumnarTableHeader
+	{
+		static constexpr uint32_t Magic = 0x4C435243; // "CRCL"
+		static constexpr uint32_t Version = 1;
+
+		uint32_t mMagic;
+		uint32_t mVersion;
+
+		// Name hash of the class of the rows.
+		Name::HashType mClass;
+
+		uint32_t mColumnCount;
+
+		uint64_t mRowCount;
+	};
+
+	struct ColumnarColumnHeader
+	{
+		// Length of the name that follows the header (e.g. "mPosition.mX" or "mValues[2]").
+		uint32_t mNameLength;
+
+		// Kind of the values. Enums are stored as the signed integer kind of the same size.
+		TypeKind mKind;
+
+		ColumnEncoding mEncoding;
+
+		uint16_t mPadding;
+
+		// Number of dictionary values or runs.
+		uint32_t mEntryCount;
+
+		uint32_t mPadding2;
+
+		// Size of the column data, not including padding.
+		uint64_t mDataSize;
+	};
+
+	// Most distinct values a dictionary encoded column can have.
+	constexpr uint32_t MaxDictionarySize = 256;
+
+	// A value of a row that is stored as a column.
+	struct ColumnarColumn
+	{
+		// Path of the value in the object, see ColumnarColumnHeader::mNameLength.
+		std::string mName;
+
+		// Offset of the value in the (outermost) object.
+		uint32_t mOffset;
+
+		TypeKind mKind;
+
+		// Size of a value: 1, 2, 4 or 8 bytes.
+		uint8_t mSize;
+	};
+
+	// The columns a class is split into.
+	struct ColumnarSchema
+	{
+		std::vector<ColumnarColumn> mColumns;
+
+		// Columns by name hash, for matching the columns of a table to the class when reading.
+		std::unordered_map<Name::HashType, size_t> mColumnsByName;
+
+	public:
+		const ColumnarColumn* FindColumn(std::string_view name)const;
+	};
+
+	// Builds the schemas of classes on first use.
+	//
+	// Every number, bool and enum becomes a column, with nested classes and fixed arrays flattened into one column per value.
+	// Const fields are left out, as are strings, pointers, containers and long doubles.
+	class ColumnarSchemaCache
+	{
+	public:
+		const ColumnarSchema& GetSchema(const ClassInfo& classInfo);
+
+	private:
+		void AddFields(ColumnarSchema& schema, const ClassInfo& classInfo, const std::string& prefix, uint32_t offset);
+		void AddValue(ColumnarSchema& schema, const TypeInfo& type, std::string name, uint32_t offset);
+
+		std::unordered_map<const ClassInfo*, ColumnarSchema> mSchemas;
+	};
+
+	// Returns the kind a value of the given type is stored as, or TypeKind::Invalid if it can't be stored in a column.
+	TypeKind GetColumnKind(const TypeInfo& type);
+
+	// Returns the size of a value of a kind returned by GetColumnKind().
+	uint8_t GetColumnValueSize(TypeKind kind);
+}
@@ -0,0 +1,330 @@
+#include "ColumnarWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "ThreadPool.h"
+
+namespace cpprefl::columnar
+{
+	namespace
+	{
+		constexpr size_t Align(size_t size)
+		{
+			return (size + 7) & ~(size_t)7;
+		}
+
+		// Slots in the hash table used to build a dictionary. Twice the most entries, so that probe sequences stay short.
+		constexpr uint32_t DictionarySlotCount = MaxDictionarySize * 2;
+
+		// Scratch space for encoding a column, reused between columns.
+		thread_local std::vector<uint8_t> DictionaryIndices;
+		thread_local std::vector<std::byte> RunScratch;
+
+		template <typename Bits>
+		uint32_t HashValue(Bits value)
+		{
+			return (uint32_t)(((uint64_t)value * 0x9E3779B97F4A7C15ull) >> 32) % DictionarySlotCount;
+		}
+
+		// Rows gathered at a time. Every column of a block is copied before moving on, so the objects of the block stay in the
+		// cache instead of being read once per column.
+		constexpr size_t GatherBlockSize = 256;
+
+		// Copies the values of a column out of the objects.
+		template <typename Bits>
+		void GatherValues(const std::byte* objects, size_t count, size_t stride, std::byte* values)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				std::memcpy(values + i * sizeof(Bits), objects + i * stride, sizeof(Bits));
+			}
+		}
+
+		void GatherColumn(const ColumnarColumn& column, const std::byte* objects, size_t count, size_t stride, std::byte* values)
+		{
+			switch (column.mSize)
+			{
+			case 1: GatherValues<uint8_t>(objects + column.mOffset, count, stride, values); break;
+			case 2: GatherValues<uint16_t>(objects + column.mOffset, count, stride, values); break;
+			case 4: GatherValues<uint32_t>(objects + column.mOffset, count, stride, values); break;
+			default: GatherValues<uint64_t>(objects + column.mOffset, count, stride, values); break;
+			}
+		}
+
+		// Returns the number of runs of equal values, splitting runs that are too long for their length.
+		template <typename Bits>
+		size_t CountRuns(const std::byte* values, size_t count)
+		{
+			if (count == 0)
+			{
+				return 0;
+			}
+
+			// Runs can only be too long in huge columns, everything else takes the branchless (and vectorizable) loop.
+			if (count > std::numeric_limits<uint32_t>::max())
+			{
+				size_t runCount = 0;
+				uint32_t runLength = 0;
+				Bits previous{};
+				for (size_t i = 0; i < count; ++i)
+				{
+					Bits value;
+					std::memcpy(&value, values + i * sizeof(Bits), sizeof(Bits));
+					if (i == 0 || value != previous || runLength == std::numeric_limits<uint32_t>::max())
+					{
+						++runCount;
+						runLength = 0;
+					}
+
+					++runLength;
+					previous = value;
+				}
+
+				return runCount;
+			}
+
+			size_t runCount = 1;
+			for (size_t i = 1; i < count; ++i)
+			{
+				Bits previous;
+				Bits value;
+				std::memcpy(&previous, values + (i - 1) * sizeof(Bits), sizeof(Bits));
+				std::memcpy(&value, values + i * sizeof(Bits), sizeof(Bits));
+				runCount += value != previous;
+			}
+
+			return runCount;
+		}
+
+		// Fills in the dictionary index of every value. Returns the number of distinct values, or zero if there are too many.
+		template <typename Bits>
+		uint32_t BuildDictionary(const std::byte* values, size_t count, Bits* dictionary, uint8_t* indices)
+		{
+			Bits slotValues[DictionarySlotCount];
+			uint16_t slotEntries[DictionarySlotCount] = {}; // Index of the dictionary entry plus one, or zero if the slot is empty.
+
+			uint32_t entryCount = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				Bits value;
+				std::memcpy(&value, values + i * sizeof(Bits), sizeof(Bits));
+
+				uint32_t slot = HashValue(value);
+				while (slotEntries[slot] != 0 && slotValues[slot] != value)
+				{
+					slot = (slot + 1) % DictionarySlotCount;
+				}
+
+				if (slotEntries[slot] == 0)
+				{
+					if (entryCount == MaxDictionarySize)
+					{
+						return 0;
+					}
+
+					slotValues[slot] = value;
+					slotEntries[slot] = (uint16_t)++entryCount;
+					dictionary[entryCount - 1] = value;
+				}
+
+				indices[i] = (uint8_t)(slotEntries[slot] - 1);
+			}
+
+			return entryCount;
+		}
+
+		// Writes runs of equal values as the values, followed by their lengths.
+		template <typename Bits>
+		void WriteRuns(const std::byte* values, size_t count, size_t runCount, std::byte* output)
+		{
+			std::byte* runValues = output;
+			std::byte* runLengths = output + runCount * sizeof(Bits);
+
+			size_t run = 0;
+			size_t i = 0;
+			while (i < count)
+			{
+				Bits value;
+				std::memcpy(&value, values + i * sizeof(Bits), sizeof(Bits));
+
+				uint32_t length = 1;
+				for (++i; i < count && length < std::numeric_limits<uint32_t>::max(); ++i, ++length)
+				{
+					Bits next;
+					std::memcpy(&next, values + i * sizeof(Bits), sizeof(Bits));
+					if (next != value)
+					{
+						break;
+					}
+				}
+
+				std::memcpy(runValues + run * sizeof(Bits), &value, sizeof(Bits));
+				std::memcpy(runLengths + run * sizeof(uint32_t), &length, sizeof(uint32_t));
+				++run;
+			}
+		}
+
+		// Picks the encoding of a column whose values have been gathered into the data, and encodes them in place. The data keeps
+		// its size (so that it isn't cleared again on the next write), see ColumnarColumnHeader::mDataSize for the encoded size.
+		template <typename Bits>
+		void Encode(size_t count, ColumnarColumnHeader& header, std::vector<std::byte>& data)
+		{
+			const size_t runCount = CountRuns<Bits>(data.data(), count);
+
+			const size_t plainSize = count * sizeof(Bits);
+			const size_t runLengthSize = runCount * (sizeof(Bits) + sizeof(uint32_t));
+
+			// A dictionary only pays off for values wider than their one byte index.
+			Bits dictionary[MaxDictionarySize];
+			uint32_t entryCount = 0;
+			if constexpr (sizeof(Bits) > 1)
+			{
+				if (count > 0 && runLengthSize > count)
+				{
+					DictionaryIndices.resize(count);
+					entryCount = BuildDictionary<Bits>(data.data(), count, dictionary, DictionaryIndices.data());
+				}
+			}
+			const size_t dictionarySize = entryCount > 0 ? entryCount * sizeof(Bits) + count : std::numeric_limits<size_t>::max();
+
+			if (dictionarySize < plainSize && dictionarySize <= runLengthSize)
+			{
+				header.mEncoding = ColumnEncoding::Dictionary;
+				header.mEntryCount = entryCount;
+
+				std::memcpy(data.data(), dictionary, entryCount * sizeof(Bits));
+				std::memcpy(data.data() + entryCount * sizeof(Bits), DictionaryIndices.data(), count);
+				header.mDataSize = dictionarySize;
+			}
+			else if (runLengthSize < plainSize)
+			{
+				header.mEncoding = ColumnEncoding::RunLength;
+				header.mEntryCount = (uint32_t)runCount;
+
+				// Runs are written to scratch space, since they would overwrite values that haven't been read yet.
+				RunScratch.resize(runLengthSize);
+				WriteRuns<Bits>(data.data(), count, runCount, RunScratch.data());
+				std::memcpy(data.data(), RunScratch.data(), runLengthSize);
+				header.mDataSize = runLengthSize;
+			}
+			else
+			{
+				header.mEncoding = ColumnEncoding::Plain;
+				header.mEntryCount = 0;
+				header.mDataSize = plainSize;
+			}
+		}
+	}
+
+	void ColumnarWriter::Write(const ClassInfo& classInfo, const void* objects, size_t count, size_t stride)
+	{
+		const ColumnarSchema& schema = mSchemas.GetSchema(classInfo);
+		const std::vector<ColumnarColumn>& columns = schema.mColumns;
+
+		mEncodedColumns.resize(columns.size());
+		for (size_t i = 0; i < columns.size(); ++i)
+		{
+			// Only grows, shrinking and growing again would clear the data every time.
+			std::vector<std::byte>& data = mEncodedColumns[i].mData;
+			data.resize(std::max(data.size(), count * columns[i].mSize));
+		}
+
+		const std::byte* objectBytes = (const std::byte*)objects;
+		const auto gather = [&](size_t blockIndex)
+		{
+			const size_t first = blockIndex * GatherBlockSize;
+			const size_t blockCount = std::min(GatherBlockSize, count - first);
+			for (size_t i = 0; i < columns.size(); ++i)
+			{
+				GatherColumn(columns[i], objectBytes + first * stride, blockCount, stride, mEncodedColumns[i].mData.data() + first * columns[i].mSize);
+			}
+		};
+
+		const auto encode = [&](size_t columnIndex)
+		{
+			EncodeColumn(columns[columnIndex], count, mEncodedColumns[columnIndex]);
+		};
+
+		const size_t blockCount = (count + GatherBlockSize - 1) / GatherBlockSize;
+		if (mThreadPool != nullptr && !mThreadPool->IsInParallelFor())
+		{
+			mThreadPool->ParallelFor(blockCount, gather);
+			mThreadPool->ParallelFor(columns.size(), encode);
+		}
+		else
+		{
+			for (size_t i = 0; i < blockCount; ++i)
+			{
+				gather(i);
+			}
+
+			for (size_t i = 0; i < columns.size(); ++i)
+			{
+				encode(i);
+			}
+		}
+
+		size_t size = Align(sizeof(ColumnarTableHeader));
+		for (size_t i = 0; i < columns.size(); ++i)
+		{
+			size += Align(sizeof(ColumnarColumnHeader)) + Align(columns[i].mName.size()) + Align((size_t)mEncodedColumns[i].mHeader.mDataSize);
+		}
+
+		mBuffer.resize(size);
+
+		ColumnarTableHeader header{};
+		header.mMagic = ColumnarTableHeader::Magic;
+		header.mVersion = ColumnarTableHeader::Version;
+		header.mClass = classInfo.mType->mName.GetHash();
+		header.mColumnCount = (uint32_t)columns.size();
+		header.mRowCount = count;
+
+		size_t offset = 0;
+		WritePart(offset, &header, sizeof(header));
+		for (size_t i = 0; i < columns.size(); ++i)
+		{
+			const EncodedColumn& encoded = mEncodedColumns[i];
+			WritePart(offset, &encoded.mHeader, sizeof(ColumnarColumnHeader));
+			WritePart(offset, columns[i].mName.data(), columns[i].mName.size());
+			WritePart(offset, encoded.mData.data(), (size_t)encoded.mHeader.mDataSize);
+		}
+	}
+
+	void ColumnarWriter::WritePart(size_t& offset, const void* data, size_t size)
+	{
+		if (size > 0)
+		{
+			std::memcpy(mBuffer.data() + offset, data, size);
+		}
+
+		// Padding is zeroed, so that the same objects always produce the same bytes.
+		std::memset(mBuffer.data() + offset + size, 0, Align(size) - size);
+		offset += Align(size);
+	}
+
+	bool ColumnarWriter::WriteToFile(const char* path)const
+	{
+		std::ofstream file(path, std::ios::binary);
+		file.write((const char*)mBuffer.data(), mBuffer.size());
+		return file.good();
+	}
+
+	void ColumnarWriter::EncodeColumn(const ColumnarColumn& column, size_t count, EncodedColumn& encoded)
+	{
+		ColumnarColumnHeader& header = encoded.mHeader;
+		header = {};
+		header.mNameLength = (uint32_t)column.mName.size();
+		header.mKind = column.mKind;
+
+		switch (column.mSize)
+		{
+		case 1: Encode<uint8_t>(count, header, encoded.mData); break;
+		case 2: Encode<uint16_t>(count, header, encoded.mData); break;
+		case 4: Encode<uint32_t>(count, header, encoded.mData); break;
+		default: Encode<uint64_t>(count, header, encoded.mData); break;
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ColumnarSchema.h"
+
+namespace cpprefl::serialization
+{
+	class ThreadPool;
+}
+
+namespace cpprefl::columnar
+{
+	// Writes an array of reflected objects as a columnar table (see ColumnarSchema.h).
+	//
+	// Columns are copied out of the objects with strided copies, a block of rows at a time, and each is stored with whichever
+	// encoding is smallest: plain values, a dictionary of up to MaxDictionarySize distinct values, or runs of equal values.
+	// Values are compared bit for bit, so that tables round trip exactly (e.g. -0.0 and NaNs are kept).
+	class ColumnarWriter
+	{
+	public:
+		// Copies and encodes columns on the given pool. The pool must outlive the writer.
+		void SetThreadPool(serialization::ThreadPool* threadPool) { mThreadPool = threadPool; }
+
+		template <typename T>
+		void Write(const std::vector<T>& objects)
+		{
+			Write(GetReflectedClass<T>(), objects.data(), objects.size(), sizeof(T));
+		}
+
+		// Replaces the table with the given objects, which are stride bytes apart.
+		void Write(const ClassInfo& classInfo, const void* objects, size_t count, size_t stride);
+
+		const std::vector<std::byte>& GetBuffer()const { return mBuffer; }
+
+		bool WriteToFile(const char* path)const;
+
+	private:
+		struct EncodedColumn
+		{
+			ColumnarColumnHeader mHeader;
+			std::vector<std::byte> mData;
+		};
+
+		// Encodes the values gathered into the data of the column.
+		static void EncodeColumn(const ColumnarColumn& column, size_t count, EncodedColumn& encoded);
+
+		// Copies a part of the table to the buffer, followed by its padding.
+		void WritePart(size_t& offset, const void* data, size_t size);
+
+		std::vector<std::byte> mBuffer;
+
+		// Reused between writes.
+		std::vector<EncodedColumn> mEncodedColumns;
+
+		ColumnarSchemaCache mSchemas;
+		serialization::ThreadPool* mThreadPool = nullptr;
+	};
+}
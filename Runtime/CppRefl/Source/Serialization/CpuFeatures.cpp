@@ -0,0 +1,47 @@
+#include "CpuFeatures.h"
+
+#if CPPREFL_WITH_SIMD() && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace cpprefl::serialization
+{
+	namespace
+	{
+		CpuFeatures DetectCpuFeatures()
+		{
+			CpuFeatures features;
+
+#if CPPREFL_WITH_SIMD()
+#if defined(_MSC_VER) && !defined(__clang__)
+			int info[4];
+			__cpuid(info, 0);
+			const int maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			features.mSse42 = (info[2] & (1 << 20)) != 0;
+
+			// AVX2 also needs the OS to save the YMM registers.
+			if (maxLeaf >= 7 && (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6)
+			{
+				__cpuidex(info, 7, 0);
+				features.mAvx2 = (info[1] & (1 << 5)) != 0;
+			}
+#else
+			__builtin_cpu_init();
+			features.mSse42 = __builtin_cpu_supports("sse4.2");
+			features.mAvx2 = __builtin_cpu_supports("avx2");
+#endif
+#endif
+
+			return features;
+		}
+	}
+
+	const CpuFeatures& GetCpuFeatures()
+	{
+		static const CpuFeatures features = DetectCpuFeatures();
+		return features;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../CppReflConfig.h"
+
+// Compiles a function for an instruction set the rest of the build doesn't assume (MSVC doesn't need this).
+#if CPPREFL_WITH_SIMD()
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CPPREFL_INTERNAL_TARGET(instructionSet)
+#else
+#define CPPREFL_INTERNAL_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#endif
+#endif
+
+namespace cpprefl::serialization
+{
+	// Instruction sets the vectorized kernels can use. All false if CPPREFL_WITH_SIMD() is off.
+	struct CpuFeatures
+	{
+		bool mSse42 = false;
+
+		// Only set if the OS also saves the YMM registers.
+		bool mAvx2 = false;
+	};
+
+	// Returns the instruction sets supported by the CPU, detected on first use.
+	const CpuFeatures& GetCpuFeatures();
+}
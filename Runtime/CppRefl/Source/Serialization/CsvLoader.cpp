@@ -0,0 +1,482 @@
+#include "CsvLoader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "../CppReflConfig.h"
+#include "../Reflection/EnumInfo.h"
+#include "JsonScanner.h"
+#include "NumberConversion.h"
+#include "ThreadPool.h"
+
+namespace cpprefl::csv
+{
+	namespace
+	{
+		// Scratch space for fields with quotes, reused between fields.
+		thread_local std::string UnescapedField;
+
+		// Returns true if no record starts at begin, i.e. the previous record is followed by an empty line or the end of the text.
+		bool IsEmptyRecord(const char* begin, const char* dataEnd)
+		{
+			return begin == dataEnd || *begin == '\n' || (*begin == '\r' && (begin + 1 == dataEnd || begin[1] == '\n'));
+		}
+
+		// Removes the quotes from a field, and replaces each "" inside of quotes with a quote.
+		std::string_view Unescape(const char* begin, const char* end)
+		{
+			if (std::memchr(begin, '"', end - begin) == nullptr)
+			{
+				return std::string_view(begin, end - begin);
+			}
+
+			UnescapedField.clear();
+			bool quoted = false;
+			for (const char* c = begin; c < end; ++c)
+			{
+				if (*c != '"')
+				{
+					UnescapedField.push_back(*c);
+				}
+				else if (quoted && c + 1 < end && c[1] == '"')
+				{
+					UnescapedField.push_back('"');
+					++c;
+				}
+				else
+				{
+					quoted = !quoted;
+				}
+			}
+
+			return UnescapedField;
+		}
+
+		std::string_view Trim(std::string_view text)
+		{
+			while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+			{
+				text.remove_prefix(1);
+			}
+			while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+			{
+				text.remove_suffix(1);
+			}
+			return text;
+		}
+
+		// Parses a whole field as a JSON number. Returns false if there is anything else in the field.
+		bool ParseNumber(std::string_view text, json::JsonNumber& number)
+		{
+			return json::ParseNumber(text.data(), text.data() + text.size(), number) == text.data() + text.size();
+		}
+
+		// Returns true if the number is an integer that fits an int64_t.
+		bool GetInt(const json::JsonNumber& number, int64_t& value)
+		{
+			if (!number.mIsInteger || number.mTruncated || number.mExponent != 0 || number.mMantissa > (number.mNegative ? 0x8000000000000000ull : 0x7FFFFFFFFFFFFFFFull))
+			{
+				return false;
+			}
+
+			value = number.mNegative ? (int64_t)(0 - number.mMantissa) : (int64_t)number.mMantissa;
+			return true;
+		}
+
+		// Writes an enum value based on the size of the enum.
+		bool StoreEnum(const TypeInfo& type, void* value, int64_t number)
+		{
+			switch (type.mSize)
+			{
+			case 1: *(uint8_t*)value = (uint8_t)number; return true;
+			case 2: *(uint16_t*)value = (uint16_t)number; return true;
+			case 4: *(uint32_t*)value = (uint32_t)number; return true;
+			case 8: *(uint64_t*)value = (uint64_t)number; return true;
+			default: return false;
+			}
+		}
+
+		bool IsStringType(const TypeInfo& type)
+		{
+#if CPPREFL_WITH_STL()
+			return IsSameType<std::string>(type);
+#else
+			return false;
+#endif
+		}
+
+		// Returns true if columns can be stored in values of this type.
+		bool IsValueType(const TypeInfo& type)
+		{
+			return type.mKind == TypeKind::Bool || serialization::IsNumberKind(type.mKind) || type.mKind == TypeKind::Enum || IsStringType(type);
+		}
+	}
+
+	bool CsvLoader::Load(const char* data, size_t size, const ClassInfo& classInfo, const std::function<void*(size_t)>& resize, size_t stride)
+	{
+		mError = false;
+		mColumns.clear();
+
+		const char* dataEnd = data + size;
+		if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+		{
+			data += 3;
+		}
+
+		if (data == dataEnd)
+		{
+			resize(0);
+			return true;
+		}
+
+		// The header is small, so it is parsed on this thread.
+		const char* headerEnd = data;
+		for (const char* field = data; ; field = headerEnd + 1)
+		{
+			headerEnd = FindFieldEnd(field, dataEnd);
+
+			const bool lastField = headerEnd == dataEnd || *headerEnd == '\n';
+			const char* nameEnd = lastField && headerEnd > field && headerEnd[-1] == '\r' ? headerEnd - 1 : headerEnd;
+			const std::string_view name = Trim(Unescape(field, nameEnd));
+
+			ColumnBinding& binding = mColumns.emplace_back();
+			binding.mName = name;
+			if (!BindColumn(classInfo, name, binding))
+			{
+				CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping column '%.*s', it has no matching field.", (int)name.size(), name.data());
+				binding.mType = nullptr;
+			}
+
+			if (lastField)
+			{
+				break;
+			}
+		}
+
+		// Records start after newlines, so the data begins with the newline ending the header.
+		const char* rowsBegin = headerEnd;
+		const size_t rowsSize = dataEnd - rowsBegin;
+
+		const bool parallel = mThreadPool != nullptr && !mThreadPool->IsInParallelFor();
+		const size_t chunkSize = parallel ? mChunkSize : rowsSize;
+		const size_t chunkCount = rowsSize > 0 ? (rowsSize + chunkSize - 1) / chunkSize : 0;
+
+		const auto forEachChunk = [&](const std::function<void(size_t, const char*, const char*)>& task)
+		{
+			const auto runChunk = [&](size_t chunkIndex)
+			{
+				const char* begin = rowsBegin + chunkIndex * chunkSize;
+				task(chunkIndex, begin, begin + std::min(chunkSize, (size_t)(dataEnd - begin)));
+			};
+
+			if (parallel)
+			{
+				mThreadPool->ParallelFor(chunkCount, runChunk);
+			}
+			else
+			{
+				for (size_t i = 0; i < chunkCount; ++i)
+				{
+					runChunk(i);
+				}
+			}
+		};
+
+		std::vector<ChunkCounts> counts(chunkCount);
+		forEachChunk([&](size_t chunkIndex, const char* begin, const char* end)
+		{
+			CountChunk(begin, end, dataEnd, counts[chunkIndex]);
+		});
+
+		// Now that the quoting state at the end of every chunk is known, so is the state at the start of the next one.
+		bool quoted = false;
+		size_t rowCount = 0;
+		for (ChunkCounts& chunk : counts)
+		{
+			chunk.mStartsQuoted = quoted;
+			chunk.mFirstRow = rowCount;
+			rowCount += chunk.mRecords[quoted];
+			quoted ^= chunk.mOddQuotes;
+		}
+
+		if (quoted)
+		{
+			return SetError("Quoted field is never closed");
+		}
+
+		std::byte* rows = (std::byte*)resize(rowCount);
+		if (rowCount == 0)
+		{
+			return true;
+		}
+
+		std::vector<ChunkError> errors(chunkCount);
+		forEachChunk([&](size_t chunkIndex, const char* begin, const char* end)
+		{
+			ParseChunk(begin, end, dataEnd, counts[chunkIndex], rows, rowCount, stride, errors[chunkIndex]);
+		});
+
+		// Chunks are in order, so the first error is the first malformed record.
+		for (const ChunkError& error : errors)
+		{
+			if (error.mMessage != nullptr)
+			{
+				const std::string& column = mColumns[error.mColumn].mName;
+
+				char message[256];
+				std::snprintf(message, sizeof(message), "%s in record %zu, column '%.*s'", error.mMessage, error.mRow + 1, (int)column.size(), column.data());
+				return SetError(message);
+			}
+		}
+
+		return true;
+	}
+
+	bool CsvLoader::BindColumn(const ClassInfo& classInfo, std::string_view name, ColumnBinding& binding)
+	{
+		const ClassInfo* currentClass = &classInfo;
+		uint32_t offset = 0;
+		while (true)
+		{
+			const size_t separator = name.find('.');
+			std::string_view fieldName = name.substr(0, separator);
+
+			// Elements of arrays are named by their index, e.g. "mSamples[1]".
+			size_t index = 0;
+			const bool indexed = !fieldName.empty() && fieldName.back() == ']';
+			if (indexed)
+			{
+				const size_t bracket = fieldName.find('[');
+				if (bracket == std::string_view::npos || bracket + 2 >= fieldName.size())
+				{
+					return false;
+				}
+
+				for (const char c : fieldName.substr(bracket + 1, fieldName.size() - bracket - 2))
+				{
+					if (c < '0' || c > '9' || index > 0xFFFF)
+					{
+						return false;
+					}
+					index = index * 10 + (c - '0');
+				}
+				fieldName = fieldName.substr(0, bracket);
+			}
+
+			const FieldInfo* field = currentClass->GetField(Name(fieldName.data(), fieldName.size()));
+			if (field == nullptr || field->mTypeInstance.mIsConst || field->mTypeInstance.mIsPointer || field->mContainerFunctions != nullptr ||
+				indexed != field->mTypeInstance.mIsArray || (indexed && index >= field->mTypeInstance.mArraySize))
+			{
+				return false;
+			}
+
+			const TypeInfo& type = field->GetType();
+			offset += (uint32_t)(field->mOffset + index * type.mSize);
+
+			if (separator == std::string_view::npos)
+			{
+				binding.mType = &type;
+				binding.mOffset = offset;
+				return IsValueType(type);
+			}
+
+			currentClass = type.mKind == TypeKind::Class ? type.GetClassInfo() : nullptr;
+			if (currentClass == nullptr)
+			{
+				return false;
+			}
+
+			name.remove_prefix(separator + 1);
+		}
+	}
+
+	void CsvLoader::CountChunk(const char* begin, const char* end, const char* dataEnd, ChunkCounts& counts)const
+	{
+		// A newline is outside of quotes if the number of quotes before it in the chunk is even and the chunk starts outside of
+		// quotes, or if it is odd and the chunk starts inside of them.
+		size_t quotes = 0;
+		for (const char* c = begin; c < end; ++c)
+		{
+			quotes += *c == '"';
+			if (*c == '\n' && !IsEmptyRecord(c + 1, dataEnd))
+			{
+				++counts.mRecords[quotes & 1];
+			}
+		}
+
+		counts.mOddQuotes = (quotes & 1) != 0;
+	}
+
+	void CsvLoader::ParseChunk(const char* begin, const char* end, const char* dataEnd, const ChunkCounts& counts, std::byte* rows, size_t rowCount, size_t stride, ChunkError& error)const
+	{
+		// Skip to the first newline outside of quotes, the records before it belong to the previous chunk.
+		bool quoted = counts.mStartsQuoted;
+		const char* newline = begin;
+		for (; newline < end && (quoted || *newline != '\n'); ++newline)
+		{
+			quoted ^= *newline == '"';
+		}
+
+		size_t row = counts.mFirstRow;
+		while (newline < end)
+		{
+			const char* record = newline + 1;
+			if (IsEmptyRecord(record, dataEnd))
+			{
+				newline = record < dataEnd && *record == '\r' ? record + 1 : record;
+				continue;
+			}
+
+			if (row >= rowCount)
+			{
+				error = { "More records than counted", row, 0 };
+				return;
+			}
+
+			newline = ParseRecord(record, dataEnd, rows + row * stride, row, error);
+			if (error.mMessage != nullptr)
+			{
+				return;
+			}
+			++row;
+		}
+	}
+
+	const char* CsvLoader::ParseRecord(const char* begin, const char* dataEnd, std::byte* object, size_t row, ChunkError& error)const
+	{
+		for (size_t column = 0; ; ++column)
+		{
+			const char* fieldEnd = FindFieldEnd(begin, dataEnd);
+			const bool lastField = fieldEnd == dataEnd || *fieldEnd == '\n';
+
+			// Fields past the header's are ignored.
+			if (column < mColumns.size() && mColumns[column].mType != nullptr)
+			{
+				const ColumnBinding& binding = mColumns[column];
+
+				const char* textEnd = lastField && fieldEnd > begin && fieldEnd[-1] == '\r' ? fieldEnd - 1 : fieldEnd;
+				std::string_view text = Unescape(begin, textEnd);
+				if (!IsStringType(*binding.mType))
+				{
+					text = Trim(text);
+				}
+
+				if (!text.empty())
+				{
+					if (const char* message = StoreValue(binding, text, object))
+					{
+						error = { message, row, column };
+						return fieldEnd;
+					}
+				}
+			}
+
+			if (lastField)
+			{
+				return fieldEnd;
+			}
+			begin = fieldEnd + 1;
+		}
+	}
+
+	const char* CsvLoader::FindFieldEnd(const char* begin, const char* dataEnd)const
+	{
+		// Quotes are counted the same way as when counting records, "" inside of quotes leaves the field quoted.
+		bool quoted = false;
+		const char* c = begin;
+		for (; c < dataEnd; ++c)
+		{
+			if (*c == '"')
+			{
+				quoted = !quoted;
+			}
+			else if (!quoted && (*c == mDelimiter || *c == '\n'))
+			{
+				break;
+			}
+		}
+
+		return c;
+	}
+
+	const char* CsvLoader::StoreValue(const ColumnBinding& binding, std::string_view text, std::byte* object)
+	{
+		const TypeInfo& type = *binding.mType;
+		void* value = object + binding.mOffset;
+
+#if CPPREFL_WITH_STL()
+		if (IsSameType<std::string>(type))
+		{
+			static_cast<std::string*>(value)->assign(text);
+			return nullptr;
+		}
+#endif
+
+		if (type.mKind == TypeKind::Bool)
+		{
+			if (text == "true" || text == "TRUE" || text == "1")
+			{
+				*(bool*)value = true;
+			}
+			else if (text == "false" || text == "FALSE" || text == "0")
+			{
+				*(bool*)value = false;
+			}
+			else
+			{
+				return "Invalid bool";
+			}
+			return nullptr;
+		}
+
+		json::JsonNumber number;
+		if (type.mKind == TypeKind::Enum)
+		{
+			// Enums can be stored by name or by value.
+			int64_t integer;
+			if (ParseNumber(text, number) && GetInt(number, integer))
+			{
+				return StoreEnum(type, value, integer) ? nullptr : "Invalid enum value";
+			}
+
+			const EnumInfo* enumInfo = type.GetEnumInfo();
+			const EnumValueInfo* enumValue = enumInfo != nullptr ? enumInfo->GetValue(Name(text.data(), text.size())) : nullptr;
+			return enumValue != nullptr && StoreEnum(type, value, enumValue->mValue) ? nullptr : "Invalid enum value";
+		}
+
+		if (!ParseNumber(text, number))
+		{
+			return "Invalid number";
+		}
+
+		// Integers are converted exactly, everything else goes through a double. Values that don't fit the field saturate.
+		int64_t integer;
+		if (number.mIsInteger && !number.mTruncated && number.mExponent == 0 && !number.mNegative)
+		{
+			serialization::ConvertNumbers(TypeKind::Uint64, &number.mMantissa, type.mKind, value, 1, serialization::NumberOverflow::Saturate);
+		}
+		else if (GetInt(number, integer))
+		{
+			serialization::ConvertNumbers(TypeKind::Int64, &integer, type.mKind, value, 1, serialization::NumberOverflow::Saturate);
+		}
+		else
+		{
+			const double floatingPoint = number.ToDouble();
+			serialization::ConvertNumbers(TypeKind::Double, &floatingPoint, type.mKind, value, 1, serialization::NumberOverflow::Saturate);
+		}
+
+		return nullptr;
+	}
+
+	bool CsvLoader::SetError(const char* message)
+	{
+		if (!mError)
+		{
+			mError = true;
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "CSV parse error: %s", message);
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Reflection/ClassInfo.h"
+
+namespace cpprefl::serialization
+{
+	class ThreadPool;
+}
+
+namespace cpprefl::csv
+{
+	// Loads rows of reflected objects from CSV (or TSV, or any other single character delimiter) text.
+	//
+	// The first record names the field each column is stored in, e.g. "mId,mPosition.mX,mSamples[1]". Numbers (written as in
+	// JSON, and saturated if they don't fit the field), bools, enums (by name or by value) and strings can be loaded, columns
+	// without a matching field are skipped, and fields without a column (or with an empty value) are left as constructed. Fields
+	// can be quoted, with "" standing for a quote, to hold delimiters and newlines. Records end with either "\n" or "\r\n", and
+	// empty records are skipped.
+	//
+	// With a thread pool, the text is split into chunks that are parsed in parallel: a first pass counts the records that start
+	// in every chunk (for both possible quoting states at its start), which is enough to size the rows up front, and a second
+	// pass parses every record straight into its row.
+	class CsvLoader
+	{
+	public:
+		explicit CsvLoader(char delimiter = ',') : mDelimiter(delimiter) {}
+
+		// Parses chunks of about chunkSize bytes on the given pool. The pool must outlive the loader.
+		void SetThreadPool(serialization::ThreadPool* threadPool, size_t chunkSize = 1024 * 1024)
+		{
+			mThreadPool = threadPool;
+			mChunkSize = chunkSize > 0 ? chunkSize : 1;
+		}
+
+		// Replaces the contents of the vector with the records of the text.
+		template <typename T>
+		bool Load(const char* data, size_t size, std::vector<T>& rows)
+		{
+			rows.clear();
+			return Load(data, size, GetReflectedClass<T>(), [&rows](size_t count) -> void*
+			{
+				rows.resize(count);
+				return rows.data();
+			}, sizeof(T));
+		}
+
+		// Loads the records into objects that are stride bytes apart. Once the number of records is known, resize is called with it
+		// and returns the constructed objects. Returns false if the text is malformed, in which case some of the rows may
+		// not have been loaded.
+		bool Load(const char* data, size_t size, const ClassInfo& classInfo, const std::function<void*(size_t)>& resize, size_t stride);
+
+		// Returns true if the last text loaded was malformed.
+		bool HasError()const { return mError; }
+
+	private:
+		// Where the values of a column are stored.
+		struct ColumnBinding
+		{
+			const TypeInfo* mType = nullptr; // Null if the column is skipped.
+			uint32_t mOffset = 0;
+			std::string mName;
+		};
+
+		// The first malformed value of a chunk.
+		struct ChunkError
+		{
+			const char* mMessage = nullptr;
+			size_t mRow = 0;
+			size_t mColumn = 0;
+		};
+
+		// Records and quotes in a chunk, see Load().
+		struct ChunkCounts
+		{
+			// Records starting in the chunk, if the chunk starts outside or inside of quotes.
+			size_t mRecords[2] = {};
+			bool mOddQuotes = false;
+
+			// Filled in once every chunk is counted.
+			bool mStartsQuoted = false;
+			size_t mFirstRow = 0;
+		};
+
+		// Resolves a column name such as "mPosition.mX" or "mSamples[1]" to a field of the class.
+		static bool BindColumn(const ClassInfo& classInfo, std::string_view name, ColumnBinding& binding);
+
+		void CountChunk(const char* begin, const char* end, const char* dataEnd, ChunkCounts& counts)const;
+		void ParseChunk(const char* begin, const char* end, const char* dataEnd, const ChunkCounts& counts, std::byte* rows, size_t rowCount, size_t stride, ChunkError& error)const;
+
+		// Parses the record starting at begin into the object. Returns the newline ending the record, or dataEnd.
+		const char* ParseRecord(const char* begin, const char* dataEnd, std::byte* object, size_t row, ChunkError& error)const;
+
+		// Returns the end of the field starting at begin (its delimiter, newline or dataEnd).
+		const char* FindFieldEnd(const char* begin, const char* dataEnd)const;
+
+		// Stores the text of a field in the object. Returns an error message, or nullptr if the value was stored.
+		static const char* StoreValue(const ColumnBinding& binding, std::string_view text, std::byte* object);
+
+		bool SetError(const char* message);
+
+		char mDelimiter;
+		std::vector<ColumnBinding> mColumns;
+
+		serialization::ThreadPool* mThreadPool = nullptr;
+		size_t mChunkSize = 1024 * 1024;
+
+		bool mError = false;
+	};
+}
@@ -0,0 +1,175 @@
+#include "DeserializationArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "../CppReflConfig.h"
+
+namespace cpprefl::serialization
+{
+	namespace
+	{
+		constexpr size_t MaxBlockSize = 1024 * 1024;
+
+		// Room for the block header, keeping the memory after it aligned.
+		constexpr size_t BlockHeaderSize = alignof(std::max_align_t);
+	}
+
+	DeserializationArena::DeserializationArena(bool internStrings, size_t firstBlockSize) :
+		mInternStrings(internStrings),
+		mFirstBlockSize(std::max<size_t>(firstBlockSize, 256)),
+		mNextBlockSize(mFirstBlockSize)
+	{
+	}
+
+	DeserializationArena::~DeserializationArena()
+	{
+		Release();
+	}
+
+	char* DeserializationArena::AllocateString(std::string_view string)
+	{
+		if (mInternStrings)
+		{
+			return InternString(string);
+		}
+
+		char* copy = (char*)Allocate(string.size() + 1, 1);
+		std::memcpy(copy, string.data(), string.size());
+		copy[string.size()] = 0;
+		return copy;
+	}
+
+	void DeserializationArena::Release()
+	{
+		while (mBlocks != nullptr)
+		{
+			Block* next = mBlocks->mNext;
+			IConfig::Get().FreeMemory(mBlocks);
+			mBlocks = next;
+		}
+
+		mCurrent = mEnd = nullptr;
+		mNextBlockSize = mFirstBlockSize;
+		mAllocatedBytes = 0;
+		mInternedStringCount = 0;
+
+		mStrings.clear();
+		mStringCount = 0;
+	}
+
+	void* DeserializationArena::Allocate(size_t size, size_t alignment)
+	{
+		mAllocatedBytes += size;
+
+		std::byte* memory = (std::byte*)(((uintptr_t)mCurrent + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		if (mCurrent != nullptr && memory + size <= mEnd)
+		{
+			mCurrent = memory + size;
+			return memory;
+		}
+
+		// Allocations that would take up most of a block get a block of their own, so the rest of the current block isn't wasted.
+		const size_t requiredSize = BlockHeaderSize + size + alignment;
+		if (requiredSize > mNextBlockSize / 2)
+		{
+			Block* block = (Block*)IConfig::Get().AllocateMemory(requiredSize);
+			if (mBlocks != nullptr)
+			{
+				block->mNext = mBlocks->mNext;
+				mBlocks->mNext = block;
+			}
+			else
+			{
+				block->mNext = nullptr;
+				mBlocks = block;
+			}
+
+			return (void*)(((uintptr_t)block + BlockHeaderSize + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		}
+
+		Block* block = (Block*)IConfig::Get().AllocateMemory(mNextBlockSize);
+		block->mNext = mBlocks;
+		mBlocks = block;
+
+		mCurrent = (std::byte*)block + BlockHeaderSize;
+		mEnd = (std::byte*)block + mNextBlockSize;
+		mNextBlockSize = std::min(mNextBlockSize * 2, MaxBlockSize);
+
+		memory = (std::byte*)(((uintptr_t)mCurrent + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		mCurrent = memory + size;
+		return memory;
+	}
+
+	char* DeserializationArena::InternString(std::string_view string)
+	{
+		const size_t hash = std::hash<std::string_view>()(string);
+
+		if (!mStrings.empty())
+		{
+			const size_t mask = mStrings.size() - 1;
+			for (size_t slot = hash & mask; mStrings[slot].mString != nullptr; slot = (slot + 1) & mask)
+			{
+				const InternedString& entry = mStrings[slot];
+				if (entry.mHash == hash && std::string_view(entry.mString, entry.mLength) == string)
+				{
+					++mInternedStringCount;
+					return const_cast<char*>(entry.mString);
+				}
+			}
+		}
+
+		// Keep the table at most half full so probe sequences stay short.
+		if ((mStringCount + 1) * 2 > mStrings.size())
+		{
+			std::vector<InternedString> strings(std::max<size_t>(mStrings.size() * 2, 64), InternedString{ 0, nullptr, 0 });
+
+			const size_t mask = strings.size() - 1;
+			for (const InternedString& entry : mStrings)
+			{
+				if (entry.mString != nullptr)
+				{
+					size_t slot = entry.mHash & mask;
+					while (strings[slot].mString != nullptr)
+					{
+						slot = (slot + 1) & mask;
+					}
+
+					strings[slot] = entry;
+				}
+			}
+
+			mStrings.swap(strings);
+		}
+
+		char* copy = (char*)Allocate(string.size() + 1, 1);
+		std::memcpy(copy, string.data(), string.size());
+		copy[string.size()] = 0;
+
+		const size_t mask = mStrings.size() - 1;
+		size_t slot = hash & mask;
+		while (mStrings[slot].mString != nullptr)
+		{
+			slot = (slot + 1) & mask;
+		}
+
+		mStrings[slot] = { hash, copy, string.size() };
+		++mStringCount;
+
+		return copy;
+	}
+
+	char* CopyString(std::string_view string, DeserializationArena* arena)
+	{
+		if (arena != nullptr)
+		{
+			return arena->AllocateString(string);
+		}
+
+		char* copy = (char*)IConfig::Get().AllocateMemory(string.size() + 1);
+		std::memcpy(copy, string.data(), string.size());
+		copy[string.size()] = 0;
+		return copy;
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace cpprefl::serialization
+{
+	// Owns the memory deserializers allocate for objects (e.g. the strings of char* fields), so that it can all be freed at once
+	// instead of one allocation at a time. Memory is handed out from large blocks by bumping an offset.
+	//
+	// Strings can optionally be interned, in which case strings with the same contents share a single copy. Interned strings
+	// must not be modified.
+	// The arena isn't thread safe by itself, deserializers decoding in parallel lock GetMutex() around their allocations.
+	class DeserializationArena
+	{
+	public:
+		explicit DeserializationArena(bool internStrings = false, size_t firstBlockSize = 4096);
+		~DeserializationArena();
+
+		DeserializationArena(const DeserializationArena&) = delete;
+		DeserializationArena& operator=(const DeserializationArena&) = delete;
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		// Returns a null terminated copy of the string.
+		char* AllocateString(std::string_view string);
+
+		// Frees all memory handed out by the arena.
+		void Release();
+
+		// Returns the number of bytes handed out since the last release.
+		size_t GetAllocatedBytes()const { return mAllocatedBytes; }
+
+		// Returns the number of strings that were deduplicated since the last release.
+		size_t GetInternedStringCount()const { return mInternedStringCount; }
+
+		std::mutex& GetMutex() { return mMutex; }
+
+	private:
+		struct Block
+		{
+			Block* mNext;
+		};
+
+		struct InternedString
+		{
+			size_t mHash;
+			const char* mString;
+			size_t mLength;
+		};
+
+		char* InternString(std::string_view string);
+
+		std::mutex mMutex;
+
+		bool mInternStrings;
+		size_t mFirstBlockSize;
+		size_t mNextBlockSize;
+
+		// Blocks are linked through a header at their start, the newest block is first.
+		Block* mBlocks = nullptr;
+		std::byte* mCurrent = nullptr;
+		std::byte* mEnd = nullptr;
+
+		size_t mAllocatedBytes = 0;
+		size_t mInternedStringCount = 0;
+
+		// Open addressing table of interned strings.
+		std::vector<InternedString> mStrings;
+		size_t mStringCount = 0;
+	};
+
+	// Returns a null terminated copy of the string, allocated from the arena if there is one, otherwise from IConfig.
+	char* CopyString(std::string_view string, DeserializationArena* arena);
+}
@@ -0,0 +1,36 @@
+#include "EnumNames.h"
+
+#include "../Reflection/EnumInfo.h"
+
+namespace cpprefl::serialization
+{
+	int64_t LoadEnum(const TypeInfo& type, const void* value)
+	{
+		switch (type.mSize)
+		{
+		case 1: return *(const int8_t*)value;
+		case 2: return *(const int16_t*)value;
+		case 4: return *(const int32_t*)value;
+		case 8: return *(const int64_t*)value;
+		default: return 0;
+		}
+	}
+
+	std::string_view GetEnumValueName(const TypeInfo& type, int64_t number)
+	{
+		const EnumInfo* enumInfo = type.GetEnumInfo();
+		if (enumInfo == nullptr)
+		{
+			return {};
+		}
+
+		// Values are sign extended when loaded, so also try the unsigned interpretation for enums with small unsigned underlying types.
+		const EnumValueInfo* enumValue = enumInfo->GetValue((int)number);
+		if (enumValue == nullptr && number < 0 && type.mSize < sizeof(int))
+		{
+			enumValue = enumInfo->GetValue((int)(number & ((1 << (type.mSize * 8)) - 1)));
+		}
+
+		return enumValue != nullptr ? enumValue->mNameString : std::string_view();
+	}
+}
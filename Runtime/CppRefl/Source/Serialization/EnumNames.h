@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "../Reflection/TypeInfo.h"
+
+namespace cpprefl::serialization
+{
+	// Reads an enum value based on the size of the enum, sign extending it.
+	int64_t LoadEnum(const TypeInfo& type, const void* value);
+
+	// Returns the name of an enum value, or an empty string if the value isn't one of the enum's values.
+	std::string_view GetEnumValueName(const TypeInfo& type, int64_t number);
+}
@@ -0,0 +1,485 @@
+#include "Format.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include "../Reflection/ArrayView.h"
+#include "../Reflection/AssociativeArray.h"
+#include "../Reflection/DynamicArray.h"
+#include "../Reflection/Optional.h"
+#include "EnumNames.h"
+#include "NumberConversion.h"
+
+namespace cpprefl
+{
+	namespace
+	{
+		// Longest text std::to_chars() writes for any number (a long double with all of its digits, a sign and an exponent).
+		constexpr size_t MaxNumberLength = 64;
+
+		template <typename T>
+		std::to_chars_result ToChars(char* begin, char* end, const void* value)
+		{
+			return std::to_chars(begin, end, *(const T*)value);
+		}
+
+		void WriteNumber(TypeKind kind, const void* value, FormatOutput& output, char* buffer)
+		{
+			char* end = buffer + MaxNumberLength;
+			std::to_chars_result result{ buffer, std::errc() };
+			switch (kind)
+			{
+			case TypeKind::Uint8: result = ToChars<uint8_t>(buffer, end, value); break;
+			case TypeKind::Int8: result = ToChars<int8_t>(buffer, end, value); break;
+			case TypeKind::Uint16: result = ToChars<uint16_t>(buffer, end, value); break;
+			case TypeKind::Int16: result = ToChars<int16_t>(buffer, end, value); break;
+			case TypeKind::Uint32: result = ToChars<uint32_t>(buffer, end, value); break;
+			case TypeKind::Int32: result = ToChars<int32_t>(buffer, end, value); break;
+			case TypeKind::Uint64: result = ToChars<uint64_t>(buffer, end, value); break;
+			case TypeKind::Int64: result = ToChars<int64_t>(buffer, end, value); break;
+			case TypeKind::Float: result = ToChars<float>(buffer, end, value); break;
+			case TypeKind::Double: result = ToChars<double>(buffer, end, value); break;
+			case TypeKind::LongDouble: result = ToChars<long double>(buffer, end, value); break;
+			default: break;
+			}
+
+			output.Write(std::string_view(buffer, result.ptr - buffer));
+		}
+
+		// Writes a string in quotes, escaping quotes, backslashes and the common control characters.
+		void WriteQuoted(std::string_view string, FormatOutput& output)
+		{
+			output.Write('"');
+
+			size_t begin = 0;
+			for (size_t i = 0; i < string.size(); ++i)
+			{
+				const char* escape;
+				switch (string[i])
+				{
+				case '"': escape = "\\\""; break;
+				case '\\': escape = "\\\\"; break;
+				case '\n': escape = "\\n"; break;
+				case '\r': escape = "\\r"; break;
+				case '\t': escape = "\\t"; break;
+				default: continue;
+				}
+
+				output.Write(string.substr(begin, i - begin));
+				output.Write(escape);
+				begin = i + 1;
+			}
+
+			output.Write(string.substr(begin));
+			output.Write('"');
+		}
+
+		// Enums are written by name, falling back to the value if it isn't one of the enum's values.
+		void WriteEnum(const TypeInfo& type, const void* value, FormatOutput& output, char* buffer)
+		{
+			const int64_t number = serialization::LoadEnum(type, value);
+			const std::string_view name = serialization::GetEnumValueName(type, number);
+			if (!name.empty())
+			{
+				output.Write(name);
+				return;
+			}
+
+			WriteNumber(TypeKind::Int64, &number, output, buffer);
+		}
+	}
+
+	void FormatOutput::Write(std::string_view text)
+	{
+		while (!text.empty())
+		{
+			const size_t size = std::min(text.size(), mSize - mUsed);
+			std::memcpy(mBuffer + mUsed, text.data(), size);
+			mUsed += size;
+			text.remove_prefix(size);
+
+			if (!text.empty())
+			{
+				if (mFlush == nullptr || mSize == 0)
+				{
+					mDroppedLength += text.size();
+					return;
+				}
+
+				Flush();
+			}
+		}
+	}
+
+	void FormatOutput::Write(char c)
+	{
+		if (mUsed == mSize && mFlush != nullptr)
+		{
+			Flush();
+		}
+
+		if (mUsed < mSize)
+		{
+			mBuffer[mUsed++] = c;
+		}
+		else
+		{
+			++mDroppedLength;
+		}
+	}
+
+	void FormatOutput::Flush()
+	{
+		if (mFlush != nullptr && mUsed > 0)
+		{
+			mFlush(mContext, mBuffer, mUsed);
+			mFlushedLength += mUsed;
+			mUsed = 0;
+		}
+	}
+
+	FormatPlan::FormatPlan(const ClassInfo& classInfo)
+	{
+		std::string pendingText;
+		AddFields(classInfo, 0, pendingText);
+
+		mSuffixOffset = (uint32_t)mText.size();
+		mSuffixSize = (uint32_t)pendingText.size();
+		mText += pendingText;
+	}
+
+	const FormatPlan& FormatPlan::Get(const ClassInfo& classInfo)
+	{
+		std::call_once(classInfo.mFormatPlanFlag, [&classInfo]
+		{
+			classInfo.mFormatPlan = std::make_shared<const FormatPlan>(classInfo);
+		});
+
+		return *classInfo.mFormatPlan;
+	}
+
+	void FormatPlan::AddFields(const ClassInfo& classInfo, uint32_t offset, std::string& pendingText)
+	{
+		pendingText += '{';
+		for (size_t i = 0; i < classInfo.mFlattenedFields.size(); ++i)
+		{
+			const FieldInfo& field = classInfo.mFlattenedFields[i];
+			if (i > 0)
+			{
+				pendingText += ", ";
+			}
+			pendingText += field.mNameString;
+			pendingText += ": ";
+
+			const TypeInstanceInfo& typeInstance = field.mTypeInstance;
+			const TypeInfo& type = field.GetType();
+			if (field.mContainerFunctions != nullptr || typeInstance.mIsArray || typeInstance.mIsPointer)
+			{
+				AddStep(StepKind::Value, field, offset, pendingText);
+			}
+			else if (type.mKind == TypeKind::Bool)
+			{
+				AddStep(StepKind::Bool, field, offset, pendingText);
+			}
+			else if (type.mKind == TypeKind::Enum)
+			{
+				AddStep(StepKind::Enum, field, offset, pendingText);
+			}
+			else if (serialization::IsNumberKind(type.mKind))
+			{
+				AddStep(StepKind::Number, field, offset, pendingText);
+			}
+#if CPPREFL_WITH_STL()
+			else if (IsSameType<std::string>(type))
+			{
+				AddStep(StepKind::String, field, offset, pendingText);
+			}
+#endif
+			else if (type.mKind == TypeKind::Class && type.GetClassInfo() != nullptr)
+			{
+				// Objects held by value can't form cycles, so they are inlined.
+				AddFields(*type.GetClassInfo(), offset + (uint32_t)field.mOffset, pendingText);
+			}
+			else
+			{
+				AddStep(StepKind::Value, field, offset, pendingText);
+			}
+		}
+		pendingText += '}';
+	}
+
+	void FormatPlan::AddStep(StepKind kind, const FieldInfo& field, uint32_t offset, std::string& pendingText)
+	{
+		Step& step = mSteps.emplace_back();
+		step.mTextOffset = (uint32_t)mText.size();
+		step.mTextSize = (uint32_t)pendingText.size();
+		step.mOffset = offset + (uint32_t)field.mOffset;
+		step.mKind = kind;
+		step.mNumberKind = field.GetType().mKind;
+		step.mType = &field.GetType();
+		step.mField = &field;
+
+		mText += pendingText;
+		pendingText.clear();
+	}
+
+	void FormatPlan::Format(const void* object, FormatOutput& output, uint32_t depth)const
+	{
+		const std::byte* bytes = (const std::byte*)object;
+		char buffer[MaxNumberLength];
+
+		for (const Step& step : mSteps)
+		{
+			output.Write(std::string_view(mText.data() + step.mTextOffset, step.mTextSize));
+
+			const void* value = bytes + step.mOffset;
+			switch (step.mKind)
+			{
+			case StepKind::Bool:
+				output.Write(*(const bool*)value ? "true" : "false");
+				break;
+
+			case StepKind::Number:
+				WriteNumber(step.mNumberKind, value, output, buffer);
+				break;
+
+			case StepKind::Enum:
+				WriteEnum(*step.mType, value, output, buffer);
+				break;
+
+			case StepKind::String:
+#if CPPREFL_WITH_STL()
+				WriteQuoted(*(const std::string*)value, output);
+#endif
+				break;
+
+			case StepKind::Value:
+				FormatValue(step.mField->mTypeInstance, step.mField->mContainerFunctions, value, output, depth);
+				break;
+			}
+		}
+
+		output.Write(std::string_view(mText.data() + mSuffixOffset, mSuffixSize));
+	}
+
+	void FormatPlan::FormatValue(const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value, FormatOutput& output, uint32_t depth)
+	{
+		if (containerFunctions != nullptr)
+		{
+			// The accessor tables take mutable containers, but none of the functions used here modify them.
+			void* container = const_cast<void*>(value);
+
+			switch (containerFunctions->mKind)
+			{
+			case ContainerKind::DynamicArray:
+			{
+				const auto& functions = static_cast<const DynamicArrayFunctions&>(*containerFunctions);
+				const ArraySizeType size = functions.mGetSize(container);
+
+				output.Write('[');
+				for (ArraySizeType i = 0; i < size; ++i)
+				{
+					output.Write(i > 0 ? ", " : "");
+					FormatValue(functions.mElementType, nullptr, functions.GetElement(container, i), output, depth);
+				}
+				output.Write(']');
+				return;
+			}
+
+			case ContainerKind::ArrayView:
+			{
+				const auto& functions = static_cast<const ArrayViewFunctions&>(*containerFunctions);
+				const ArraySizeType size = functions.mGetSize(container);
+
+				output.Write('[');
+				for (ArraySizeType i = 0; i < size; ++i)
+				{
+					output.Write(i > 0 ? ", " : "");
+					FormatValue(functions.mElementType, nullptr, functions.GetElement(container, i), output, depth);
+				}
+				output.Write(']');
+				return;
+			}
+
+			case ContainerKind::AssociativeArray:
+			{
+				const auto& functions = static_cast<const AssociativeArrayFunctions&>(*containerFunctions);
+
+				struct VisitContext
+				{
+					const AssociativeArrayFunctions& mFunctions;
+					FormatOutput& mOutput;
+					uint32_t mDepth;
+					bool mFirst;
+				};
+
+				VisitContext context{ functions, output, depth, true };
+
+				output.Write('{');
+				functions.mForEach(container, [](void* contextPtr, const void* key, void* entry)
+				{
+					VisitContext& context = *static_cast<VisitContext*>(contextPtr);
+					context.mOutput.Write(context.mFirst ? "" : ", ");
+					context.mFirst = false;
+
+					FormatValue(context.mFunctions.mKeyType, nullptr, key, context.mOutput, context.mDepth);
+					context.mOutput.Write(": ");
+					FormatValue(context.mFunctions.mValueType, nullptr, entry, context.mOutput, context.mDepth);
+					return true;
+				}, &context);
+				output.Write('}');
+				return;
+			}
+
+			case ContainerKind::Optional:
+			{
+				const auto& functions = static_cast<const OptionalFunctions&>(*containerFunctions);
+				const void* optionalValue = functions.mGetValue(container);
+				if (optionalValue != nullptr)
+				{
+					FormatValue(functions.mValueType, nullptr, optionalValue, output, depth);
+				}
+				else
+				{
+					output.Write("null");
+				}
+				return;
+			}
+
+			default:
+				output.Write('?');
+				return;
+			}
+		}
+
+		if (type.IsFixedSizeCString())
+		{
+			WriteQuoted(std::string_view((const char*)value, strnlen((const char*)value, type.mArraySize)), output);
+			return;
+		}
+
+		if (type.IsDynamicCString())
+		{
+			const char* string = *(const char* const*)value;
+			if (string != nullptr)
+			{
+				WriteQuoted(string, output);
+			}
+			else
+			{
+				output.Write("null");
+			}
+			return;
+		}
+
+		if (type.mIsArray)
+		{
+			const size_t stride = type.mIsPointer ? sizeof(void*) : type.mType.mSize;
+
+			output.Write('[');
+			for (ArraySizeType i = 0; i < type.mArraySize; ++i)
+			{
+				output.Write(i > 0 ? ", " : "");
+				FormatElement(type.mType, type.mIsPointer, (const std::byte*)value + i * stride, output, depth);
+			}
+			output.Write(']');
+			return;
+		}
+
+		FormatElement(type.mType, type.mIsPointer, value, output, depth);
+	}
+
+	void FormatPlan::FormatElement(const TypeInfo& type, bool isPointer, const void* value, FormatOutput& output, uint32_t depth)
+	{
+		char buffer[MaxNumberLength];
+
+		if (isPointer)
+		{
+			const void* pointer = *(const void* const*)value;
+			const ClassInfo* classInfo = type.mKind == TypeKind::Class ? type.GetClassInfo() : nullptr;
+			if (pointer == nullptr)
+			{
+				output.Write("null");
+			}
+			else if (classInfo == nullptr)
+			{
+				// Only the address of anything else.
+				const std::to_chars_result result = std::to_chars(buffer, buffer + MaxNumberLength, (uintptr_t)pointer, 16);
+				output.Write("0x");
+				output.Write(std::string_view(buffer, result.ptr - buffer));
+			}
+			else if (depth >= MaxDepth)
+			{
+				output.Write("{...}");
+			}
+			else
+			{
+				// Name the class if it differs from the pointer type.
+				const ClassInfo& dynamicClass = classInfo->GetDynamicClass(pointer);
+				if (&dynamicClass != classInfo)
+				{
+					output.Write(dynamicClass.mType->mNameString);
+				}
+
+				Get(dynamicClass).Format(pointer, output, depth + 1);
+			}
+			return;
+		}
+
+		switch (type.mKind)
+		{
+		case TypeKind::Bool:
+			output.Write(*(const bool*)value ? "true" : "false");
+			return;
+
+		case TypeKind::Enum:
+			WriteEnum(type, value, output, buffer);
+			return;
+
+		case TypeKind::Class:
+		{
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type))
+			{
+				WriteQuoted(*(const std::string*)value, output);
+				return;
+			}
+#endif
+
+			const ClassInfo* classInfo = type.GetClassInfo();
+			if (classInfo == nullptr)
+			{
+				output.Write('?');
+			}
+			else if (depth >= MaxDepth)
+			{
+				output.Write("{...}");
+			}
+			else
+			{
+				Get(*classInfo).Format(value, output, depth + 1);
+			}
+			return;
+		}
+
+		default:
+			if (serialization::IsNumberKind(type.mKind))
+			{
+				WriteNumber(type.mKind, value, output, buffer);
+				return;
+			}
+
+			output.Write('?');
+			return;
+		}
+	}
+
+	size_t Format(const ClassInfo& classInfo, const void* object, char* buffer, size_t size)
+	{
+		FormatOutput output(buffer, size);
+		output.Write(classInfo.mType->mNameString);
+		FormatPlan::Get(classInfo).Format(object, output);
+		return output.GetLength();
+	}
+}
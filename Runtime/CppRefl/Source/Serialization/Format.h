@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../CppReflConfig.h"
+#include "../Reflection/ClassInfo.h"
+
+#ifndef CPPREFL_WITH_STD_FORMAT
+#if CPPREFL_WITH_STL() && CPPREFL_CONCEPTS() && defined(__has_include)
+#if __has_include(<format>)
+#define CPPREFL_WITH_STD_FORMAT() 1
+#endif
+#endif
+#endif
+
+#ifndef CPPREFL_WITH_STD_FORMAT
+#define CPPREFL_WITH_STD_FORMAT() 0
+#endif
+
+#if CPPREFL_WITH_STD_FORMAT()
+#include <algorithm>
+#include <format>
+#endif
+
+namespace cpprefl
+{
+	class FieldInfo;
+	class TypeInstanceInfo;
+
+	// Text being formatted into a fixed size buffer. Once the buffer is full, it is either handed to the flush function and
+	// reused, or (without a flush function) the rest of the text is dropped, but still counted.
+	class FormatOutput
+	{
+	public:
+		using FlushFunction = void(*)(void* context, const char* text, size_t size);
+
+		FormatOutput(char* buffer, size_t size, FlushFunction flush = nullptr, void* context = nullptr) :
+			mBuffer(buffer),
+			mSize(size),
+			mFlush(flush),
+			mContext(context)
+		{
+		}
+
+		void Write(std::string_view text);
+		void Write(char c);
+
+		// Hands the buffered text to the flush function.
+		void Flush();
+
+		// Returns the length of all of the text, including any that didn't fit the buffer.
+		size_t GetLength()const { return mFlushedLength + mUsed + mDroppedLength; }
+
+		// Returns the text in the buffer.
+		std::string_view GetText()const { return std::string_view(mBuffer, mUsed); }
+
+	private:
+		char* mBuffer;
+		size_t mSize;
+		size_t mUsed = 0;
+
+		size_t mFlushedLength = 0;
+		size_t mDroppedLength = 0;
+
+		FlushFunction mFlush;
+		void* mContext;
+	};
+
+	// The fields of a class flattened into a list of values to write, with the text between them, e.g. "{mX: ", ", mY: " and
+	// "}" for a point. Fields of nested classes are inlined, so formatting an object is a single pass over its plan.
+	//
+	// A plan is built once per class, the first time an object of the class is formatted, and cached on the ClassInfo.
+	class FormatPlan
+	{
+	public:
+		explicit FormatPlan(const ClassInfo& classInfo);
+
+		// Returns the plan of a class, building it if needed.
+		static const FormatPlan& Get(const ClassInfo& classInfo);
+
+		// Writes the fields of an object of the class.
+		void Format(const void* object, FormatOutput& output, uint32_t depth = 0)const;
+
+		// Writes any reflected value (e.g. container elements), formatting classes with their plans.
+		static void FormatValue(const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value, FormatOutput& output, uint32_t depth);
+
+		// Classes are nested through pointers and containers at most this deep, so that cycles end.
+		static constexpr uint32_t MaxDepth = 8;
+
+	private:
+		enum class StepKind : uint8_t
+		{
+			Bool,
+			Number,
+			Enum,
+			String,
+
+			// Anything else: pointers, arrays, containers and C strings.
+			Value,
+		};
+
+		struct Step
+		{
+			// Text written before the value, in mText.
+			uint32_t mTextOffset;
+			uint32_t mTextSize;
+
+			uint32_t mOffset;
+			StepKind mKind;
+			TypeKind mNumberKind;
+
+			const TypeInfo* mType;
+			const FieldInfo* mField;
+		};
+
+		void AddFields(const ClassInfo& classInfo, uint32_t offset, std::string& pendingText);
+		void AddStep(StepKind kind, const FieldInfo& field, uint32_t offset, std::string& pendingText);
+
+		static void FormatElement(const TypeInfo& type, bool isPointer, const void* value, FormatOutput& output, uint32_t depth);
+
+		std::string mText;
+		std::vector<Step> mSteps;
+
+		// Text written after the last value.
+		uint32_t mSuffixOffset = 0;
+		uint32_t mSuffixSize = 0;
+	};
+
+	// Writes an object of a reflected class as text, e.g. "Point{mX: 1.5, mY: -2}". Returns the length of the text, which is
+	// larger than the buffer if the text was cut off. The text isn't null terminated.
+	size_t Format(const ClassInfo& classInfo, const void* object, char* buffer, size_t size);
+
+	// Formats the most derived class of the object.
+	template <typename T>
+	size_t Format(const T& object, char* buffer, size_t size)
+	{
+		return Format(GetReflectedClass<T>().GetDynamicClass(&object), &object, buffer, size);
+	}
+
+	// Returns the text, cut off at the end of the buffer if it doesn't fit.
+	template <typename T, size_t N>
+	std::string_view Format(const T& object, char(&buffer)[N])
+	{
+		const size_t length = Format(object, buffer, N);
+		return std::string_view(buffer, length < N ? length : N);
+	}
+}
+
+#if CPPREFL_WITH_STD_FORMAT()
+namespace std
+{
+	// Formats reflected classes the same way as cpprefl::Format(), e.g. std::format("{}", point). Doesn't take any options.
+	template <cpprefl::ReflectedClass T>
+	struct formatter<T, char>
+	{
+		constexpr auto parse(std::format_parse_context& context)
+		{
+			return context.begin();
+		}
+
+		template <typename FormatContext>
+		auto format(const T& object, FormatContext& context)const
+		{
+			using Iterator = typename FormatContext::iterator;
+
+			// The text is written in pieces through a buffer on the stack, straight into the output.
+			Iterator iterator = context.out();
+			char buffer[256];
+			cpprefl::FormatOutput output(buffer, sizeof(buffer), [](void* iteratorContext, const char* text, size_t size)
+			{
+				Iterator& out = *static_cast<Iterator*>(iteratorContext);
+				out = std::copy_n(text, size, out);
+			}, &iterator);
+
+			const cpprefl::ClassInfo& classInfo = cpprefl::GetReflectedClass<T>().GetDynamicClass(&object);
+			output.Write(classInfo.mType->mNameString);
+			cpprefl::FormatPlan::Get(classInfo).Format(&object, output);
+			output.Flush();
+			return iterator;
+		}
+	};
+}
+#endif
@@ -0,0 +1,380 @@
+#include "FrozenBlob.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "../CppReflConfig.h"
+#include "../Reflection/Registry.h"
+
+namespace cpprefl::frozen
+{
+	namespace
+	{
+		// Alignment of every object in the blob (enough for any field, and blobs are mapped at page boundaries).
+		constexpr size_t ObjectAlignment = 16;
+
+		// Returns the target of a relative offset.
+		const std::byte* ResolveOffset(const std::byte* value)
+		{
+			int64_t offset;
+			std::memcpy(&offset, value, sizeof(offset));
+			return offset != 0 ? value + offset : nullptr;
+		}
+
+		std::string_view ReadString(const std::byte* value, const TypeInstanceInfo& type)
+		{
+			if (type.IsDynamicCString())
+			{
+				const std::byte* string = ResolveOffset(value);
+				return string != nullptr ? std::string_view((const char*)string) : std::string_view();
+			}
+
+			if (type.IsFixedSizeCString())
+			{
+				return std::string_view((const char*)value, strnlen((const char*)value, type.mArraySize));
+			}
+
+#if CPPREFL_WITH_STL()
+			if (!type.mIsPointer && !type.mIsArray && IsSameType<std::string>(type.mType))
+			{
+				FrozenArray array;
+				std::memcpy(&array, value, sizeof(array));
+				return array.mSize > 0 ? std::string_view((const char*)value + array.mOffset, array.mSize) : std::string_view();
+			}
+#endif
+
+			return {};
+		}
+
+		FrozenView ReadObject(const std::byte* value, const TypeInstanceInfo& type)
+		{
+			if (type.mType.mKind != TypeKind::Class || type.mIsArray)
+			{
+				return {};
+			}
+
+			if (type.mIsPointer)
+			{
+				const std::byte* object = ResolveOffset(value);
+				if (object == nullptr)
+				{
+					return {};
+				}
+
+				FrozenObjectHeader header;
+				std::memcpy(&header, object - sizeof(header), sizeof(header));
+
+				const ClassInfo* classInfo = Registry::GetSystemRegistry().TryGetClass(Name::FromHash(header.mClass));
+				return classInfo != nullptr ? FrozenView(object, *classInfo) : FrozenView();
+			}
+
+			const ClassInfo* classInfo = type.mType.GetClassInfo();
+			return classInfo != nullptr ? FrozenView(value, *classInfo) : FrozenView();
+		}
+
+		FrozenView BlobError(const char* message)
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "Invalid frozen blob: %s", message);
+			return {};
+		}
+	}
+
+	std::string_view FrozenView::GetString(const Name& fieldName)const
+	{
+		const FieldInfo* fieldInfo = GetField(fieldName);
+		return fieldInfo != nullptr && fieldInfo->mContainerFunctions == nullptr ?
+			ReadString(mObject + fieldInfo->mOffset, fieldInfo->mTypeInstance) :
+			std::string_view();
+	}
+
+	FrozenView FrozenView::GetObject(const Name& fieldName)const
+	{
+		const FieldInfo* fieldInfo = GetField(fieldName);
+		return fieldInfo != nullptr && fieldInfo->mContainerFunctions == nullptr ?
+			ReadObject(mObject + fieldInfo->mOffset, fieldInfo->mTypeInstance) :
+			FrozenView();
+	}
+
+	FrozenArrayView FrozenView::GetArray(const Name& fieldName)const
+	{
+		const FieldInfo* fieldInfo = GetField(fieldName);
+		if (fieldInfo == nullptr)
+		{
+			return {};
+		}
+
+		const std::byte* value = mObject + fieldInfo->mOffset;
+		const TypeInstanceInfo& type = fieldInfo->mTypeInstance;
+
+		if (const auto* functions = fieldInfo->GetContainerFunctions<DynamicArrayFunctions>())
+		{
+			FrozenArray array;
+			std::memcpy(&array, value, sizeof(array));
+			return FrozenArrayView(value + array.mOffset, array.mSize, functions->mElementType.mType, functions->mElementType.mIsPointer, functions->mElementStride);
+		}
+
+		if (type.mIsArray && fieldInfo->mContainerFunctions == nullptr)
+		{
+			return FrozenArrayView(value, type.mArraySize, type.mType, type.mIsPointer, type.mIsPointer ? sizeof(int64_t) : type.mType.mSize);
+		}
+
+		return {};
+	}
+
+	const FieldInfo* FrozenView::GetField(const Name& fieldName)const
+	{
+		return IsValid() ? mClassInfo->GetField(fieldName) : nullptr;
+	}
+
+	std::string_view FrozenArrayView::GetString(size_t index)const
+	{
+		return index < mSize ? ReadString(mData + index * mStride, TypeInstanceInfo(*mElementType, 0, false, false, mIsPointer)) : std::string_view();
+	}
+
+	FrozenView FrozenArrayView::GetObject(size_t index)const
+	{
+		return index < mSize ? ReadObject(mData + index * mStride, TypeInstanceInfo(*mElementType, 0, false, false, mIsPointer)) : FrozenView();
+	}
+
+	void FrozenWriter::Freeze(const ClassInfo& classInfo, const void* classObject)
+	{
+		mBuffer.clear();
+		mObjects.clear();
+		mClasses.assign(1, &classInfo);
+
+		Allocate(sizeof(FrozenBlobHeader), ObjectAlignment);
+
+		const uint64_t rootOffset = Allocate(classInfo.mType->mSize, ObjectAlignment);
+		FreezeObject(rootOffset, classInfo, classObject);
+
+		// Record the layout of every class in the blob, so it can be validated when the blob is opened.
+		const uint64_t classTableOffset = Allocate(mClasses.size() * sizeof(FrozenClassEntry), alignof(FrozenClassEntry));
+		for (size_t i = 0; i < mClasses.size(); ++i)
+		{
+			const FrozenClassEntry entry{ mClasses[i]->mType->mName.GetHash(), mSchemas.GetSchema(*mClasses[i]).mFingerprint };
+			std::memcpy(mBuffer.data() + classTableOffset + i * sizeof(entry), &entry, sizeof(entry));
+		}
+
+		FrozenBlobHeader header;
+		header.mMagic = FrozenBlobHeader::Magic;
+		header.mVersion = FrozenBlobHeader::Version;
+		header.mRootClass = classInfo.mType->mName.GetHash();
+		header.mClassCount = (uint32_t)mClasses.size();
+		header.mClassTableOffset = classTableOffset;
+		header.mRootOffset = rootOffset;
+		header.mSize = mBuffer.size();
+		std::memcpy(mBuffer.data(), &header, sizeof(header));
+	}
+
+	bool FrozenWriter::WriteToFile(const char* path)const
+	{
+		std::ofstream file(path, std::ios::binary);
+		file.write((const char*)mBuffer.data(), mBuffer.size());
+		return file.good();
+	}
+
+	void FrozenWriter::FreezeObject(uint64_t offset, const ClassInfo& classInfo, const void* classObject)
+	{
+		// Only reflected fields are written, everything else (padding, vtable pointers, unreflected fields) is left zeroed.
+		for (const FieldInfo& field : classInfo.mFlattenedFields)
+		{
+			FreezeValue(offset + field.mOffset, field.mTypeInstance, field.mContainerFunctions, (const std::byte*)classObject + field.mOffset);
+		}
+	}
+
+	void FrozenWriter::FreezeValue(uint64_t offset, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value)
+	{
+		if (containerFunctions != nullptr)
+		{
+			if (containerFunctions->mKind != ContainerKind::DynamicArray || type.mType.mSize < sizeof(FrozenArray))
+			{
+				return;
+			}
+
+			// The buffer may be reallocated while freezing, so everything is addressed by offset.
+			void* container = const_cast<void*>(value);
+			const auto& functions = static_cast<const DynamicArrayFunctions&>(*containerFunctions);
+			const ArraySizeType size = functions.mGetSize(container);
+			const uint64_t data = Allocate(size * functions.mElementStride, ObjectAlignment);
+
+			if (binary::BinarySchemaCache::IsTriviallyCopyable(functions.mElementType))
+			{
+				if (size > 0)
+				{
+					std::memcpy(mBuffer.data() + data, functions.mGetData(container), size * functions.mElementStride);
+				}
+			}
+			else
+			{
+				for (ArraySizeType i = 0; i < size; ++i)
+				{
+					FreezeValue(data + i * functions.mElementStride, functions.mElementType, nullptr, functions.GetElement(container, i));
+				}
+			}
+
+			WriteArray(offset, data, size);
+			return;
+		}
+
+		if (type.IsDynamicCString())
+		{
+			const char* string = *(const char* const*)value;
+			if (string != nullptr)
+			{
+				WriteOffset(offset, AllocateString(string));
+			}
+			return;
+		}
+
+		if (binary::BinarySchemaCache::IsTriviallyCopyable(type))
+		{
+			std::memcpy(mBuffer.data() + offset, value, type.mType.mSize * (type.mIsArray ? type.mArraySize : 1));
+			return;
+		}
+
+		if (type.mIsArray)
+		{
+			const size_t stride = type.mIsPointer ? sizeof(void*) : type.mType.mSize;
+			for (ArraySizeType i = 0; i < type.mArraySize; ++i)
+			{
+				FreezeElement(offset + i * stride, type.mType, type.mIsPointer, (const std::byte*)value + i * stride);
+			}
+			return;
+		}
+
+		FreezeElement(offset, type.mType, type.mIsPointer, value);
+	}
+
+	void FrozenWriter::FreezeElement(uint64_t offset, const TypeInfo& type, bool isPointer, const void* value)
+	{
+		if (isPointer)
+		{
+			const ClassInfo* classInfo = type.mKind == TypeKind::Class ? type.GetClassInfo() : nullptr;
+			const void* object = *(const void* const*)value;
+			if (classInfo != nullptr && object != nullptr)
+			{
+				WriteOffset(offset, FreezePointer(*classInfo, object));
+			}
+			return;
+		}
+
+		if (type.mKind == TypeKind::Class)
+		{
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type))
+			{
+				const auto& string = *static_cast<const std::string*>(value);
+				WriteArray(offset, AllocateString(string), string.size());
+				return;
+			}
+#endif
+
+			const ClassInfo* classInfo = type.GetClassInfo();
+			if (classInfo != nullptr)
+			{
+				FreezeObject(offset, *classInfo, value);
+			}
+			return;
+		}
+
+		if (binary::BinarySchemaCache::IsTriviallyCopyable(type.mKind))
+		{
+			std::memcpy(mBuffer.data() + offset, value, type.mSize);
+		}
+	}
+
+	uint64_t FrozenWriter::FreezePointer(const ClassInfo& staticClassInfo, const void* value)
+	{
+		const auto it = mObjects.find(value);
+		if (it != mObjects.end())
+		{
+			return it->second;
+		}
+
+		const ClassInfo& classInfo = staticClassInfo.GetDynamicClass(value);
+		if (std::find(mClasses.begin(), mClasses.end(), &classInfo) == mClasses.end())
+		{
+			mClasses.push_back(&classInfo);
+		}
+
+		const uint64_t offset = Allocate(classInfo.mType->mSize, ObjectAlignment, sizeof(FrozenObjectHeader));
+		mObjects.emplace(value, offset);
+
+		const FrozenObjectHeader header{ classInfo.mType->mName.GetHash(), 0 };
+		std::memcpy(mBuffer.data() + offset - sizeof(header), &header, sizeof(header));
+
+		FreezeObject(offset, classInfo, value);
+		return offset;
+	}
+
+	uint64_t FrozenWriter::Allocate(size_t size, size_t alignment, size_t prefixSize)
+	{
+		const uint64_t offset = (mBuffer.size() + prefixSize + alignment - 1) / alignment * alignment;
+		mBuffer.resize(offset + size);
+		return offset;
+	}
+
+	uint64_t FrozenWriter::AllocateString(std::string_view string)
+	{
+		const uint64_t offset = Allocate(string.size() + 1, 1);
+		std::memcpy(mBuffer.data() + offset, string.data(), string.size());
+		return offset;
+	}
+
+	void FrozenWriter::WriteOffset(uint64_t offset, uint64_t target)
+	{
+		const int64_t relativeOffset = (int64_t)(target - offset);
+		std::memcpy(mBuffer.data() + offset, &relativeOffset, sizeof(relativeOffset));
+	}
+
+	void FrozenWriter::WriteArray(uint64_t offset, uint64_t target, uint64_t size)
+	{
+		const FrozenArray array{ (int64_t)(target - offset), size };
+		std::memcpy(mBuffer.data() + offset, &array, sizeof(array));
+	}
+
+	FrozenView OpenFrozenBlob(const void* data, size_t size, const ClassInfo& rootClassInfo)
+	{
+		const std::byte* blob = (const std::byte*)data;
+
+		FrozenBlobHeader header;
+		if (size < sizeof(header))
+		{
+			return BlobError("too small");
+		}
+
+		std::memcpy(&header, blob, sizeof(header));
+		if (header.mMagic != FrozenBlobHeader::Magic || header.mVersion != FrozenBlobHeader::Version)
+		{
+			return BlobError("unknown format");
+		}
+
+		if (header.mSize > size ||
+			header.mRootOffset + rootClassInfo.mType->mSize > header.mSize ||
+			header.mClassTableOffset + (uint64_t)header.mClassCount * sizeof(FrozenClassEntry) > header.mSize)
+		{
+			return BlobError("truncated");
+		}
+
+		if (header.mRootClass != rootClassInfo.mType->mName.GetHash())
+		{
+			return BlobError("the root object is of a different class");
+		}
+
+		binary::BinarySchemaCache schemas;
+		for (uint32_t i = 0; i < header.mClassCount; ++i)
+		{
+			FrozenClassEntry entry;
+			std::memcpy(&entry, blob + header.mClassTableOffset + i * sizeof(entry), sizeof(entry));
+
+			const ClassInfo* classInfo = Registry::GetSystemRegistry().TryGetClass(Name::FromHash(entry.mClass));
+			if (classInfo == nullptr || schemas.GetSchema(*classInfo).mFingerprint != entry.mFingerprint)
+			{
+				return BlobError("the layout of a class has changed since the blob was written");
+			}
+		}
+
+		return FrozenView(blob + header.mRootOffset, rootClassInfo);
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "BinarySchema.h"
+
+namespace cpprefl::frozen
+{
+	// Frozen blobs hold reflected objects in a form that can be used in place (e.g. straight out of a memory mapped file),
+	// without deserializing.
+	//
+	// Objects keep their native layout, with all pointers replaced by offsets relative to the field holding them:
+	// - T* and char* fields hold an int64_t offset to the target (0 is nullptr).
+	// - std::vector and std::string fields hold a FrozenArray. Strings are null terminated.
+	// Objects that are pointed to are preceded by a FrozenObjectHeader naming their runtime class.
+	// Associative arrays, optionals and array views aren't supported and read as empty.
+
+	struct FrozenArray
+	{
+		// Offset of the first element, relative to this struct.
+		int64_t mOffset;
+		uint64_t mSize;
+	};
+
+	struct FrozenObjectHeader
+	{
+		// Name hash of the runtime class of the object.
+		Name::HashType mClass;
+		uint32_t mPadding;
+	};
+
+	struct FrozenBlobHeader
+	{
+		static constexpr uint32_t Magic = 0x5A465243; // "CRFZ"
+		static constexpr uint32_t Version = 1;
+
+		uint32_t mMagic;
+		uint32_t mVersion;
+
+		// Name hash of the root object's class.
+		Name::HashType mRootClass;
+
+		// Number of entries in the class table (one for the root class, plus one for each class that is pointed to).
+		uint32_t mClassCount;
+
+		// Offset of the class table: a FrozenClassEntry per class.
+		uint64_t mClassTableOffset;
+
+		uint64_t mRootOffset;
+
+		// Size of the whole blob.
+		uint64_t mSize;
+	};
+
+	struct FrozenClassEntry
+	{
+		Name::HashType mClass;
+
+		// Layout hash of the class when the blob was written, see BinaryClassSchema::mFingerprint.
+		uint32_t mFingerprint;
+	};
+
+	class FrozenArrayView;
+
+	// A reflected object inside a frozen blob. Fields are looked up through the FieldInfo of the class, with pointers resolved on access.
+	class FrozenView
+	{
+	public:
+		FrozenView() = default;
+		FrozenView(const void* object, const ClassInfo& classInfo) : mObject((const std::byte*)object), mClassInfo(&classInfo) {}
+
+		// Returns false for null pointers and missing fields.
+		bool IsValid()const { return mObject != nullptr; }
+
+		const ClassInfo& GetClass()const { return *mClassInfo; }
+		const void* GetData()const { return mObject; }
+
+		// Returns a field of a trivially copyable type (a number, enum or bool), or nullptr if there is no such field of type T.
+		// Fixed arrays return their first element.
+		// Types are matched by name, enum fields don't share a TypeInfo with GetReflectedType<T>().
+		template <typename T>
+		const T* GetValue(const Name& fieldName)const
+		{
+			const FieldInfo* fieldInfo = GetField(fieldName);
+			return fieldInfo != nullptr && !fieldInfo->mTypeInstance.mIsPointer && fieldInfo->mContainerFunctions == nullptr && fieldInfo->GetType().mName == GetReflectedType<T>().mName ?
+				(const T*)(mObject + fieldInfo->mOffset) :
+				nullptr;
+		}
+
+		// Returns a std::string, char* or char[] field.
+		std::string_view GetString(const Name& fieldName)const;
+
+		// Returns a nested object, or the object a pointer field points to.
+		FrozenView GetObject(const Name& fieldName)const;
+
+		// Returns a std::vector or fixed array field.
+		FrozenArrayView GetArray(const Name& fieldName)const;
+
+	private:
+		const FieldInfo* GetField(const Name& fieldName)const;
+
+		const std::byte* mObject = nullptr;
+		const ClassInfo* mClassInfo = nullptr;
+	};
+
+	// An array inside a frozen blob.
+	class FrozenArrayView
+	{
+	public:
+		FrozenArrayView() = default;
+		FrozenArrayView(const void* data, size_t size, const TypeInfo& elementType, bool isPointer, size_t stride) :
+			mData((const std::byte*)data), mSize(size), mElementType(&elementType), mIsPointer(isPointer), mStride(stride) {}
+
+		size_t size()const { return mSize; }
+		bool empty()const { return mSize == 0; }
+
+		// Returns the elements if they are of the trivially copyable type T, otherwise nullptr.
+		template <typename T>
+		const T* GetData()const
+		{
+			return mElementType != nullptr && !mIsPointer && mElementType->mName == GetReflectedType<T>().mName ? (const T*)mData : nullptr;
+		}
+
+		// Returns a string element (std::string or char*).
+		std::string_view GetString(size_t index)const;
+
+		// Returns an object element (a class or a pointer to one).
+		FrozenView GetObject(size_t index)const;
+
+	private:
+		const std::byte* mData = nullptr;
+		size_t mSize = 0;
+		const TypeInfo* mElementType = nullptr;
+		bool mIsPointer = false;
+		size_t mStride = 0;
+	};
+
+	// Lays out a reflected object, and everything it points to, as a frozen blob.
+	class FrozenWriter
+	{
+	public:
+		template <typename T>
+		void Freeze(const T& object)
+		{
+			Freeze(GetReflectedClass<T>(), &object);
+		}
+
+		// Replaces the blob with the given object.
+		void Freeze(const ClassInfo& classInfo, const void* classObject);
+
+		const std::vector<std::byte>& GetBuffer()const { return mBuffer; }
+
+		bool WriteToFile(const char* path)const;
+
+	private:
+		void FreezeObject(uint64_t offset, const ClassInfo& classInfo, const void* classObject);
+		void FreezeValue(uint64_t offset, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value);
+		void FreezeElement(uint64_t offset, const TypeInfo& type, bool isPointer, const void* value);
+		uint64_t FreezePointer(const ClassInfo& staticClassInfo, const void* value);
+
+		// Appends zeroed memory, returning its offset. Room for a prefix (e.g. an object header) can be reserved in front of the aligned memory.
+		uint64_t Allocate(size_t size, size_t alignment, size_t prefixSize = 0);
+		uint64_t AllocateString(std::string_view string);
+
+		void WriteOffset(uint64_t offset, uint64_t target);
+		void WriteArray(uint64_t offset, uint64_t target, uint64_t size);
+
+		std::vector<std::byte> mBuffer;
+
+		// Objects that have already been frozen, so that shared (and cyclic) pointers are only written once.
+		std::unordered_map<const void*, uint64_t> mObjects;
+
+		std::vector<const ClassInfo*> mClasses;
+
+		binary::BinarySchemaCache mSchemas;
+	};
+
+	// Validates a frozen blob and returns its root object, or an invalid view if the blob is malformed or was written
+	// with a different layout of any of its classes. Only the header and class table are checked, not the object data.
+	FrozenView OpenFrozenBlob(const void* data, size_t size, const ClassInfo& rootClassInfo);
+
+	template <typename T>
+	FrozenView OpenFrozenBlob(const void* data, size_t size)
+	{
+		return OpenFrozenBlob(data, size, GetReflectedClass<T>());
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+
+#include "NumberConversion.h"
+#include "Serializer.h"
+#include "../Reflection/Registry.h"
+
+namespace cpprefl::serialization
+{
+	// Serialization code generated for a reflected class (see ClassSerializerGenerator in the compiler). The Serializer and Deserializer
+	// call these instead of walking the fields of the class, unless they were told not to (see SetUseGeneratedCode()).
+	// The generated code accesses members directly and finds fields with a switch over the hashes of their names, which the compiler
+	// computes ahead of time. Fields it can't handle directly (containers, pointers, enums, nested classes, ...) go through the
+	// reflection data as usual.
+	struct ClassSerializerFunctions
+	{
+		// Writes the keys and values of all fields of an object, including those of its base classes.
+		void (*mSerializeFields)(Serializer& serializer, IWriter& writer, const void* classObject);
+
+		// Reads the value of one key of an object. Values of keys that aren't fields are skipped. Sets the changed flag if the field changes.
+		bool (*mDeserializeField)(Deserializer& deserializer, IReader& reader, void* classObject, const Name& key, bool& changed);
+	};
+
+	// Base of the generated serializers (CppReflPrivate::GeneratedSerializer<T>), with the helpers the generated code is made of.
+	class GeneratedSerializerBase
+	{
+	protected:
+		template <typename T>
+		static void SerializeMember(Serializer& serializer, IWriter& writer, const ClassInfo& classInfo, const void* classObject, const T& value, const Name& fieldName)
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				writer.WriteBool(value);
+			}
+			else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+			{
+				writer.WriteInt((int64_t)value);
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				writer.WriteUInt((uint64_t)value);
+			}
+			else if constexpr (std::is_same_v<T, float>)
+			{
+				writer.WriteFloat(value);
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				writer.WriteDouble((double)value);
+			}
+#if CPPREFL_WITH_STL()
+			else if constexpr (std::is_same_v<T, std::string>)
+			{
+				writer.WriteString(value);
+			}
+#endif
+			else
+			{
+				SerializeReflectedField(serializer, writer, classInfo, classObject, fieldName);
+			}
+		}
+
+		template <typename T>
+		static bool DeserializeMember(Deserializer& deserializer, IReader& reader, const ClassInfo& classInfo, void* classObject, T& value, const Name& fieldName, bool& changed)
+		{
+			if constexpr (std::is_const_v<T>)
+			{
+				return DeserializeReflectedField(deserializer, reader, classInfo, classObject, fieldName, changed);
+			}
+			else if constexpr (std::is_same_v<T, bool>)
+			{
+				bool newValue;
+				return reader.ReadBool(newValue) && StoreValue(value, newValue, changed);
+			}
+			else if constexpr (std::is_arithmetic_v<T>)
+			{
+				Deserializer::ReadNumberValue number;
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					if (!reader.ReadDouble(number.mDouble))
+					{
+						return false;
+					}
+				}
+				else if constexpr (std::is_signed_v<T>)
+				{
+					if (!reader.ReadInt(number.mInt))
+					{
+						return false;
+					}
+				}
+				else
+				{
+					if (!reader.ReadUInt(number.mUInt))
+					{
+						return false;
+					}
+				}
+
+				return StoreNumber(classInfo, value, number, fieldName, changed);
+			}
+#if CPPREFL_WITH_STL()
+			else if constexpr (std::is_same_v<T, std::string>)
+			{
+				std::string_view string;
+				if (!reader.ReadString(string))
+				{
+					return false;
+				}
+
+				if (value != string)
+				{
+					value.assign(string);
+					changed = true;
+				}
+				return true;
+			}
+#endif
+			else
+			{
+				return DeserializeReflectedField(deserializer, reader, classInfo, classObject, fieldName, changed);
+			}
+		}
+
+		// Writes the fields of a base class, through its own generated code if it has any.
+		static void SerializeBaseFields(Serializer& serializer, IWriter& writer, const ClassInfo& baseClassInfo, const void* baseObject)
+		{
+			serializer.SerializeObjectFields(writer, baseClassInfo, baseObject);
+		}
+
+		// Reads a key that may belong to a base class, through its own generated code if it has any.
+		static bool DeserializeBaseField(Deserializer& deserializer, IReader& reader, const ClassInfo& baseClassInfo, void* baseObject, const Name& key, bool& changed)
+		{
+			return deserializer.DeserializeField(reader, baseClassInfo, baseObject, key, changed);
+		}
+
+	private:
+		template <typename T>
+		static bool StoreValue(T& value, T newValue, bool& changed)
+		{
+			// Compare the bytes, like the reflected path does, so NaNs don't count as changes every time.
+			changed |= std::memcmp(&value, &newValue, sizeof(T)) != 0;
+			value = newValue;
+			return true;
+		}
+
+		// Converts a number the way the reflected path does (see Deserializer::StoreNumbers()), so values that don't fit are
+		// truncated with the same warning instead of being narrowed by a cast.
+		template <typename T>
+		static bool StoreNumber(const ClassInfo& classInfo, T& value, const Deserializer::ReadNumberValue& number, const Name& fieldName, bool& changed)
+		{
+			constexpr TypeKind readKind = std::is_floating_point_v<T> ? TypeKind::Double : std::is_signed_v<T> ? TypeKind::Int64 : TypeKind::Uint64;
+
+			T newValue;
+			const size_t overflowCount = ConvertNumbers(readKind, &number, GetTypeKind<T>(), &newValue, 1);
+			if (overflowCount > 0)
+			{
+				Deserializer::LogNumberOverflow(*classInfo.GetField(fieldName), overflowCount);
+			}
+			return StoreValue(value, newValue, changed);
+		}
+
+		static void SerializeReflectedField(Serializer& serializer, IWriter& writer, const ClassInfo& classInfo, const void* classObject, const Name& fieldName)
+		{
+			const FieldInfo* fieldInfo = classInfo.GetField(fieldName);
+			serializer.SerializeValue(writer, fieldInfo->mTypeInstance, fieldInfo->mContainerFunctions, fieldInfo->GetMemoryInClass(const_cast<void*>(classObject)));
+		}
+
+		static bool DeserializeReflectedField(Deserializer& deserializer, IReader& reader, const ClassInfo& classInfo, void* classObject, const Name& fieldName, bool& changed)
+		{
+			return deserializer.DeserializeReflectedField(reader, classInfo, classObject, fieldName, changed);
+		}
+	};
+
+	// Attaches the generated serializer of a class to its class info. Called by the generated code during static initialization.
+	template <typename T>
+	const ClassSerializerFunctions& RegisterGeneratedSerializer()
+	{
+		static const ClassSerializerFunctions Functions =
+		{
+			&CppReflPrivate::GeneratedSerializer<T>::SerializeFields,
+			&CppReflPrivate::GeneratedSerializer<T>::DeserializeField,
+		};
+
+		Registry::GetSystemRegistry().SetSerializerFunctions(GetReflectedClass<T>(), Functions);
+		return Functions;
+	}
+}
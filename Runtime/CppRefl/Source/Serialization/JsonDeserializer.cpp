@@ -0,0 +1,568 @@
+#include "JsonDeserializer.h"
+
+#include <cstring>
+
+#include "JsonScanner.h"
+#include "NumberConversion.h"
+#include "../CppReflConfig.h"
+
+namespace cpprefl::json
+{
+	using serialization::TruncateDouble;
+	using serialization::ValueType;
+
+	namespace
+	{
+		bool IsWhitespace(char c)
+		{
+			return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+		}
+
+		int HexDigit(char c)
+		{
+			if (c >= '0' && c <= '9') return c - '0';
+			if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+			if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+			return -1;
+		}
+
+		void AppendUtf8(std::string& str, uint32_t codepoint)
+		{
+			if (codepoint < 0x80)
+			{
+				str += (char)codepoint;
+			}
+			else if (codepoint < 0x800)
+			{
+				str += (char)(0xC0 | (codepoint >> 6));
+				str += (char)(0x80 | (codepoint & 0x3F));
+			}
+			else if (codepoint < 0x10000)
+			{
+				str += (char)(0xE0 | (codepoint >> 12));
+				str += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+				str += (char)(0x80 | (codepoint & 0x3F));
+			}
+			else
+			{
+				str += (char)(0xF0 | (codepoint >> 18));
+				str += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+				str += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+				str += (char)(0x80 | (codepoint & 0x3F));
+			}
+		}
+	}
+
+	JsonDeserializer::JsonDeserializer(const char* json) : JsonDeserializer(json, std::strlen(json))
+	{
+	}
+
+	JsonDeserializer::JsonDeserializer(const char* json, size_t length) : mBegin(json), mCurrent(json), mEnd(json + length)
+	{
+	}
+
+	JsonDeserializer::JsonDeserializer(const char* document, const char* begin, const char* end) : mBegin(document), mCurrent(begin), mEnd(end), mIsArrayChunk(true)
+	{
+	}
+
+	ValueType JsonDeserializer::PeekValue()
+	{
+		if (mError)
+		{
+			return ValueType::Invalid;
+		}
+
+		SkipWhitespace();
+		if (mCurrent == mEnd)
+		{
+			return ValueType::Invalid;
+		}
+
+		switch (*mCurrent)
+		{
+		case '{': return ValueType::Object;
+		case '[': return ValueType::Array;
+		case '"': return ValueType::String;
+		case 't':
+		case 'f': return ValueType::Bool;
+		case 'n': return ValueType::Null;
+		case '-':
+		case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			return ValueType::Number;
+		default:
+			return ValueType::Invalid;
+		}
+	}
+
+	bool JsonDeserializer::BeginObject()
+	{
+		if (!Consume('{'))
+		{
+			return SetError("Expected '{'");
+		}
+
+		mExpectComma = false;
+		return true;
+	}
+
+	bool JsonDeserializer::NextKey(std::string_view& key)
+	{
+		if (EndOfScope('}') || mError)
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+		if (!ParseString(key))
+		{
+			return false;
+		}
+
+		if (!Consume(':'))
+		{
+			return SetError("Expected ':'");
+		}
+
+		mExpectComma = true;
+		return true;
+	}
+
+	bool JsonDeserializer::BeginArray()
+	{
+		if (!Consume('['))
+		{
+			return SetError("Expected '['");
+		}
+
+		mExpectComma = false;
+		return true;
+	}
+
+	bool JsonDeserializer::NextElement()
+	{
+		if (EndOfScope(']') || mError)
+		{
+			return false;
+		}
+
+		mExpectComma = true;
+		return true;
+	}
+
+	bool JsonDeserializer::ReadNull()
+	{
+		return ParseLiteral("null");
+	}
+
+	bool JsonDeserializer::ReadBool(bool& value)
+	{
+		if (PeekValue() != ValueType::Bool)
+		{
+			return SetError("Expected a boolean");
+		}
+
+		value = *mCurrent == 't';
+		return ParseLiteral(value ? "true" : "false");
+	}
+
+	bool JsonDeserializer::ReadInt(int64_t& value)
+	{
+		JsonNumber number;
+		if (!ScanNumber(number))
+		{
+			return false;
+		}
+
+		if (number.mIsInteger && !number.mTruncated && number.mExponent == 0)
+		{
+			// Integers that are too big for a signed integer wrap around, the same as a cast would.
+			value = number.mNegative ? (int64_t)(0 - number.mMantissa) : (int64_t)number.mMantissa;
+			return true;
+		}
+
+		value = TruncateDouble<int64_t>(number.ToDouble());
+		return true;
+	}
+
+	bool JsonDeserializer::ReadUInt(uint64_t& value)
+	{
+		JsonNumber number;
+		if (!ScanNumber(number))
+		{
+			return false;
+		}
+
+		if (number.mIsInteger && !number.mTruncated && number.mExponent == 0)
+		{
+			// Negative numbers wrap around, the same as a cast would.
+			value = number.mNegative ? 0 - number.mMantissa : number.mMantissa;
+			return true;
+		}
+
+		value = TruncateDouble<uint64_t>(number.ToDouble());
+		return true;
+	}
+
+	bool JsonDeserializer::ReadDouble(double& value)
+	{
+		JsonNumber number;
+		if (!ScanNumber(number))
+		{
+			return false;
+		}
+
+		value = number.ToDouble();
+		return true;
+	}
+
+	bool JsonDeserializer::ReadString(std::string_view& value)
+	{
+		if (PeekValue() != ValueType::String)
+		{
+			return SetError("Expected a string");
+		}
+
+		return ParseString(value);
+	}
+
+	bool JsonDeserializer::SkipValue()
+	{
+		switch (PeekValue())
+		{
+		case ValueType::Null:
+			return ReadNull();
+
+		case ValueType::Bool:
+		{
+			bool value;
+			return ReadBool(value);
+		}
+
+		case ValueType::Number:
+		{
+			JsonNumber number;
+			return ScanNumber(number);
+		}
+
+		case ValueType::String:
+		{
+			std::string_view value;
+			return ParseString(value);
+		}
+
+		case ValueType::Object:
+		case ValueType::Array:
+			return SkipContainer();
+
+		default:
+			return SetError("Expected a value");
+		}
+	}
+
+	bool JsonDeserializer::SplitArray(size_t chunkSize, std::vector<std::unique_ptr<serialization::IReader>>& chunks, size_t& elementCount)
+	{
+		// Finding the element boundaries only matches up brackets and quotes, the elements are validated when the chunks are read.
+		const char* chunkBegin = nullptr;
+		size_t chunkElementCount = 0;
+
+		elementCount = 0;
+		while (NextElement())
+		{
+			SkipWhitespace();
+			if (chunkElementCount == 0)
+			{
+				chunkBegin = mCurrent;
+			}
+
+			if (!SkipValue())
+			{
+				return false;
+			}
+
+			++elementCount;
+			if (++chunkElementCount == chunkSize)
+			{
+				chunks.emplace_back(new JsonDeserializer(mBegin, chunkBegin, mCurrent));
+				chunkElementCount = 0;
+			}
+		}
+
+		if (mError)
+		{
+			return false;
+		}
+
+		if (chunkElementCount > 0)
+		{
+			chunks.emplace_back(new JsonDeserializer(mBegin, chunkBegin, mCurrent));
+		}
+
+		return true;
+	}
+
+	bool JsonDeserializer::IsAtEnd()
+	{
+		SkipWhitespace();
+		return mCurrent == mEnd;
+	}
+
+	void JsonDeserializer::SkipWhitespace()
+	{
+		// Most tokens are separated by at most a single space, so only hand runs of whitespace to the scanner.
+		if (mCurrent != mEnd && IsWhitespace(*mCurrent))
+		{
+			++mCurrent;
+			if (mCurrent != mEnd && IsWhitespace(*mCurrent))
+			{
+				mCurrent = FindNonWhitespace(mCurrent, mEnd);
+			}
+		}
+	}
+
+	bool JsonDeserializer::Consume(char c)
+	{
+		if (mError)
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+		if (mCurrent != mEnd && *mCurrent == c)
+		{
+			++mCurrent;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool JsonDeserializer::EndOfScope(char close)
+	{
+		if (Consume(close))
+		{
+			// The object/array we just closed was a value in its parent.
+			mExpectComma = true;
+			return true;
+		}
+
+		if (mIsArrayChunk && close == ']' && mCurrent == mEnd && !mError)
+		{
+			return true;
+		}
+
+		if (mExpectComma && !Consume(','))
+		{
+			SetError("Expected ','");
+		}
+
+		return false;
+	}
+
+	bool JsonDeserializer::ParseString(std::string_view& value)
+	{
+		if (!Consume('"'))
+		{
+			return SetError("Expected '\"'");
+		}
+
+		// Fast path: return a view into the input if there aren't any escape sequences.
+		const char* start = mCurrent;
+		mCurrent = FindStringSpecial(mCurrent, mEnd);
+		if (mCurrent == mEnd)
+		{
+			return SetError("Unterminated string");
+		}
+
+		if (*mCurrent == '\\')
+		{
+			return ParseEscapedString(start, value);
+		}
+
+		value = std::string_view(start, mCurrent - start);
+		++mCurrent;
+		return true;
+	}
+
+	bool JsonDeserializer::ParseEscapedString(const char* start, std::string_view& value)
+	{
+		mScratch.assign(start, mCurrent);
+
+		while (mCurrent != mEnd)
+		{
+			// Copy everything up to the next quote or escape sequence in one go.
+			const char* run = mCurrent;
+			mCurrent = FindStringSpecial(mCurrent, mEnd);
+			mScratch.append(run, mCurrent);
+
+			if (mCurrent == mEnd)
+			{
+				break;
+			}
+
+			if (*mCurrent++ == '"')
+			{
+				value = mScratch;
+				return true;
+			}
+
+			if (mCurrent == mEnd)
+			{
+				break;
+			}
+
+			switch (*mCurrent++)
+			{
+			case '"': mScratch += '"'; break;
+			case '\\': mScratch += '\\'; break;
+			case '/': mScratch += '/'; break;
+			case 'b': mScratch += '\b'; break;
+			case 'f': mScratch += '\f'; break;
+			case 'n': mScratch += '\n'; break;
+			case 'r': mScratch += '\r'; break;
+			case 't': mScratch += '\t'; break;
+			case 'u':
+			{
+				auto parseHex = [this](uint32_t& codepoint)
+				{
+					if (mEnd - mCurrent < 4)
+					{
+						return false;
+					}
+
+					codepoint = 0;
+					for (int i = 0; i < 4; ++i)
+					{
+						const int digit = HexDigit(*mCurrent++);
+						if (digit < 0)
+						{
+							return false;
+						}
+
+						codepoint = (codepoint << 4) | digit;
+					}
+
+					return true;
+				};
+
+				uint32_t codepoint;
+				if (!parseHex(codepoint))
+				{
+					return SetError("Invalid unicode escape sequence");
+				}
+
+				// Combine surrogate pairs.
+				if (codepoint >= 0xD800 && codepoint <= 0xDBFF && mEnd - mCurrent >= 2 && mCurrent[0] == '\\' && mCurrent[1] == 'u')
+				{
+					mCurrent += 2;
+
+					uint32_t low;
+					if (!parseHex(low) || low < 0xDC00 || low > 0xDFFF)
+					{
+						return SetError("Invalid unicode surrogate pair");
+					}
+
+					codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+
+				AppendUtf8(mScratch, codepoint);
+				break;
+			}
+
+			default:
+				return SetError("Invalid escape sequence");
+			}
+		}
+
+		return SetError("Unterminated string");
+	}
+
+	bool JsonDeserializer::ParseLiteral(std::string_view literal)
+	{
+		SkipWhitespace();
+		if ((size_t)(mEnd - mCurrent) < literal.size() || std::memcmp(mCurrent, literal.data(), literal.size()) != 0)
+		{
+			return SetError("Invalid literal");
+		}
+
+		mCurrent += literal.size();
+		return true;
+	}
+
+	bool JsonDeserializer::ScanNumber(JsonNumber& number)
+	{
+		if (PeekValue() != ValueType::Number)
+		{
+			return SetError("Expected a number");
+		}
+
+		const char* end = ParseNumber(mCurrent, mEnd, number);
+		if (end == nullptr)
+		{
+			return SetError("Invalid number");
+		}
+
+		mCurrent = end;
+		return true;
+	}
+
+	bool JsonDeserializer::SkipContainer()
+	{
+		// Only the brackets are matched up, the contents of skipped objects/arrays aren't validated.
+		int depth = 0;
+		while (true)
+		{
+			mCurrent = FindStructural(mCurrent, mEnd);
+			if (mCurrent == mEnd)
+			{
+				return SetError("Unterminated object or array");
+			}
+
+			switch (*mCurrent++)
+			{
+			case '"':
+				// Step over the string, including any escaped quotes.
+				while (true)
+				{
+					mCurrent = FindStringSpecial(mCurrent, mEnd);
+					if (mEnd - mCurrent < 2)
+					{
+						return SetError("Unterminated string");
+					}
+
+					if (*mCurrent++ == '"')
+					{
+						break;
+					}
+
+					++mCurrent;
+				}
+				break;
+
+			case '{':
+			case '[':
+				++depth;
+				break;
+
+			default:
+				if (--depth == 0)
+				{
+					mExpectComma = true;
+					return true;
+				}
+				break;
+			}
+		}
+	}
+
+	bool JsonDeserializer::SetError(const char* message)
+	{
+		if (!mError)
+		{
+			mError = true;
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "JSON parse error at offset %zu: %s", (size_t)(mCurrent - mBegin), message);
+		}
+
+		return false;
+	}
+}
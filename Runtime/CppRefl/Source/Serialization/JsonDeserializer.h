@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+
+#include "JsonScanner.h"
+#include "Reader.h"
+
+namespace cpprefl::json
+{
+	// Streaming JSON reader. Tokens are parsed on demand straight out of the input buffer, so no DOM is ever built.
+	// The input must outlive the reader: strings without escape sequences are returned as views into it.
+	class JsonDeserializer : public serialization::IReader
+	{
+	public:
+		// Reads a null terminated JSON document.
+		explicit JsonDeserializer(const char* json);
+
+		JsonDeserializer(const char* json, size_t length);
+
+		serialization::ValueType PeekValue() override;
+
+		bool BeginObject() override;
+		bool NextKey(std::string_view& key) override;
+
+		bool BeginArray() override;
+		bool NextElement() override;
+
+		bool ReadNull() override;
+		bool ReadBool(bool& value) override;
+		bool ReadInt(int64_t& value) override;
+		bool ReadUInt(uint64_t& value) override;
+		bool ReadDouble(double& value) override;
+		bool ReadString(std::string_view& value) override;
+
+		bool SkipValue() override;
+
+		bool SplitArray(size_t chunkSize, std::vector<std::unique_ptr<serialization::IReader>>& chunks, size_t& elementCount) override;
+
+		bool HasError()const override { return mError; }
+
+		// Returns true if only whitespace is left in the input.
+		bool IsAtEnd();
+
+	private:
+		// Reads the elements of an array between begin and end, without the brackets. See SplitArray().
+		JsonDeserializer(const char* document, const char* begin, const char* end);
+
+		void SkipWhitespace();
+
+		// Consumes the next token if it is the given character.
+		bool Consume(char c);
+
+		// Consumes a comma if we're in the middle of an object/array, and returns true if the object/array ends with the given character.
+		bool EndOfScope(char close);
+
+		bool ParseString(std::string_view& value);
+		bool ParseEscapedString(const char* start, std::string_view& value);
+		bool ParseLiteral(std::string_view literal);
+
+		bool ScanNumber(JsonNumber& number);
+
+		// Skips an object or array without decoding its contents.
+		bool SkipContainer();
+
+		bool SetError(const char* message);
+
+		const char* mBegin;
+		const char* mCurrent;
+		const char* mEnd;
+
+		// True if a value has been read in the current object/array, which means the next key/element needs to be preceded by a comma.
+		bool mExpectComma = false;
+
+		bool mError = false;
+
+		// True if the input holds the elements of an array, which end with the input instead of a ']'.
+		bool mIsArrayChunk = false;
+
+		// Holds unescaped strings. Reused to avoid allocations.
+		std::string mScratch;
+	};
+}
@@ -0,0 +1,378 @@
+#include "JsonScanner.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+#include "CpuFeatures.h"
+#include "../CppReflConfig.h"
+
+#if CPPREFL_WITH_SIMD()
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace cpprefl::json
+{
+	namespace
+	{
+		enum CharClass : uint8_t
+		{
+			Whitespace = 1 << 0,
+			StringSpecial = 1 << 1,
+			Structural = 1 << 2,
+		};
+
+		constexpr auto CharClasses = []()
+		{
+			std::array<uint8_t, 256> classes{};
+			classes[' '] = classes['\t'] = classes['\n'] = classes['\r'] = Whitespace;
+			classes['\\'] = StringSpecial;
+			classes['"'] = StringSpecial | Structural;
+			classes['{'] = classes['}'] = classes['['] = classes[']'] = Structural;
+			return classes;
+		}();
+
+		template <uint8_t Class, bool Match>
+		const char* FindScalar(const char* begin, const char* end)
+		{
+			while (begin != end && ((CharClasses[(uint8_t)*begin] & Class) != 0) != Match)
+			{
+				++begin;
+			}
+
+			return begin;
+		}
+
+#if CPPREFL_WITH_SIMD()
+		uint32_t CountTrailingZeros(uint32_t value)
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			unsigned long index;
+			_BitScanForward(&index, value);
+			return index;
+#else
+			return __builtin_ctz(value);
+#endif
+		}
+
+		CPPREFL_INTERNAL_TARGET("avx2")
+		const char* FindNonWhitespaceAvx2(const char* begin, const char* end)
+		{
+			const __m256i space = _mm256_set1_epi8(' ');
+			const __m256i tab = _mm256_set1_epi8('\t');
+			const __m256i newline = _mm256_set1_epi8('\n');
+			const __m256i carriageReturn = _mm256_set1_epi8('\r');
+
+			for (; end - begin >= 32; begin += 32)
+			{
+				const __m256i chunk = _mm256_loadu_si256((const __m256i*)begin);
+				const __m256i whitespace = _mm256_or_si256(
+					_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+					_mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline), _mm256_cmpeq_epi8(chunk, carriageReturn)));
+
+				const uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(whitespace);
+				if (mask != 0)
+				{
+					return begin + CountTrailingZeros(mask);
+				}
+			}
+
+			return FindScalar<Whitespace, false>(begin, end);
+		}
+
+		CPPREFL_INTERNAL_TARGET("avx2")
+		const char* FindStringSpecialAvx2(const char* begin, const char* end)
+		{
+			const __m256i quote = _mm256_set1_epi8('"');
+			const __m256i backslash = _mm256_set1_epi8('\\');
+
+			for (; end - begin >= 32; begin += 32)
+			{
+				const __m256i chunk = _mm256_loadu_si256((const __m256i*)begin);
+				const __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+
+				const uint32_t mask = (uint32_t)_mm256_movemask_epi8(special);
+				if (mask != 0)
+				{
+					return begin + CountTrailingZeros(mask);
+				}
+			}
+
+			return FindScalar<StringSpecial, true>(begin, end);
+		}
+
+		CPPREFL_INTERNAL_TARGET("avx2")
+		const char* FindStructuralAvx2(const char* begin, const char* end)
+		{
+			// '[' and ']' only differ from '{' and '}' by 0x20, so they can share a comparison.
+			const __m256i quote = _mm256_set1_epi8('"');
+			const __m256i caseBit = _mm256_set1_epi8(0x20);
+			const __m256i openBrace = _mm256_set1_epi8('{');
+			const __m256i closeBrace = _mm256_set1_epi8('}');
+
+			for (; end - begin >= 32; begin += 32)
+			{
+				const __m256i chunk = _mm256_loadu_si256((const __m256i*)begin);
+				const __m256i folded = _mm256_or_si256(chunk, caseBit);
+				const __m256i structural = _mm256_or_si256(
+					_mm256_cmpeq_epi8(chunk, quote),
+					_mm256_or_si256(_mm256_cmpeq_epi8(folded, openBrace), _mm256_cmpeq_epi8(folded, closeBrace)));
+
+				const uint32_t mask = (uint32_t)_mm256_movemask_epi8(structural);
+				if (mask != 0)
+				{
+					return begin + CountTrailingZeros(mask);
+				}
+			}
+
+			return FindScalar<Structural, true>(begin, end);
+		}
+
+		// Finds the first character that is (or with negative polarity, isn't) in the set.
+		template <uint8_t Class, int Mode>
+		CPPREFL_INTERNAL_TARGET("sse4.2")
+		const char* FindSse42(const char* begin, const char* end, __m128i set, int setSize)
+		{
+			for (; end - begin >= 16; begin += 16)
+			{
+				const __m128i chunk = _mm_loadu_si128((const __m128i*)begin);
+				const int index = _mm_cmpestri(set, setSize, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT | Mode);
+				if (index < 16)
+				{
+					return begin + index;
+				}
+			}
+
+			return FindScalar<Class, Mode != _SIDD_NEGATIVE_POLARITY>(begin, end);
+		}
+
+		CPPREFL_INTERNAL_TARGET("sse4.2")
+		const char* FindNonWhitespaceSse42(const char* begin, const char* end)
+		{
+			return FindSse42<Whitespace, _SIDD_NEGATIVE_POLARITY>(begin, end, _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), 4);
+		}
+
+		CPPREFL_INTERNAL_TARGET("sse4.2")
+		const char* FindStringSpecialSse42(const char* begin, const char* end)
+		{
+			return FindSse42<StringSpecial, _SIDD_POSITIVE_POLARITY>(begin, end, _mm_setr_epi8('"', '\\', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), 2);
+		}
+
+		CPPREFL_INTERNAL_TARGET("sse4.2")
+		const char* FindStructuralSse42(const char* begin, const char* end)
+		{
+			return FindSse42<Structural, _SIDD_POSITIVE_POLARITY>(begin, end, _mm_setr_epi8('"', '{', '}', '[', ']', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), 5);
+		}
+#endif
+
+		bool IsKernelSupported(ScannerKernel kernel)
+		{
+			const serialization::CpuFeatures& features = serialization::GetCpuFeatures();
+			switch (kernel)
+			{
+			case ScannerKernel::Scalar: return true;
+			case ScannerKernel::Sse42: return features.mSse42;
+			case ScannerKernel::Avx2: return features.mAvx2;
+			default: return false;
+			}
+		}
+
+		using FindFunction = const char*(*)(const char* begin, const char* end);
+
+		struct Scanner
+		{
+			ScannerKernel mKernel;
+			FindFunction mFindNonWhitespace;
+			FindFunction mFindStringSpecial;
+			FindFunction mFindStructural;
+		};
+
+		Scanner CreateScanner(ScannerKernel kernel)
+		{
+			switch (kernel)
+			{
+#if CPPREFL_WITH_SIMD()
+			case ScannerKernel::Avx2:
+				return { kernel, FindNonWhitespaceAvx2, FindStringSpecialAvx2, FindStructuralAvx2 };
+
+			case ScannerKernel::Sse42:
+				return { kernel, FindNonWhitespaceSse42, FindStringSpecialSse42, FindStructuralSse42 };
+#endif
+
+			default:
+				return { ScannerKernel::Scalar, FindScalar<Whitespace, false>, FindScalar<StringSpecial, true>, FindScalar<Structural, true> };
+			}
+		}
+
+		Scanner& GetScanner()
+		{
+			static Scanner scanner = CreateScanner(
+				IsKernelSupported(ScannerKernel::Avx2) ? ScannerKernel::Avx2 :
+				IsKernelSupported(ScannerKernel::Sse42) ? ScannerKernel::Sse42 :
+				ScannerKernel::Scalar);
+
+			return scanner;
+		}
+
+		bool IsDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		// Larger exponents are out of range regardless of the mantissa.
+		constexpr int32_t MaxExponent = 100000;
+
+		// Powers of ten that are exactly representable as a double.
+		constexpr double ExactPowersOfTen[] =
+		{
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+	}
+
+	ScannerKernel GetScannerKernel()
+	{
+		return GetScanner().mKernel;
+	}
+
+	bool SetScannerKernel(ScannerKernel kernel)
+	{
+		if (!IsKernelSupported(kernel))
+		{
+			return false;
+		}
+
+		GetScanner() = CreateScanner(kernel);
+		return true;
+	}
+
+	const char* FindNonWhitespace(const char* begin, const char* end)
+	{
+		return GetScanner().mFindNonWhitespace(begin, end);
+	}
+
+	const char* FindStringSpecial(const char* begin, const char* end)
+	{
+		return GetScanner().mFindStringSpecial(begin, end);
+	}
+
+	const char* FindStructural(const char* begin, const char* end)
+	{
+		return GetScanner().mFindStructural(begin, end);
+	}
+
+	double JsonNumber::ToDouble() const
+	{
+		// Fast path: both the mantissa and the power of ten are exact doubles, so a single multiply/divide is correctly rounded.
+		if (!mTruncated && mMantissa <= (1ull << 53) && mExponent >= -22 && mExponent <= 22)
+		{
+			double value = (double)mMantissa;
+			value = mExponent < 0 ? value / ExactPowersOfTen[-mExponent] : value * ExactPowersOfTen[mExponent];
+			return mNegative ? -value : value;
+		}
+
+		// Slow path: std::from_chars is exact and doesn't allocate.
+		double value;
+		const auto result = std::from_chars(mText.data(), mText.data() + mText.size(), value);
+		if (result.ec == std::errc::result_out_of_range)
+		{
+			value = mExponent < 0 ? 0.0 : HUGE_VAL;
+		}
+
+		return std::copysign(value, mNegative ? -1.0 : 1.0);
+	}
+
+	const char* ParseNumber(const char* begin, const char* end, JsonNumber& number)
+	{
+		number = JsonNumber();
+
+		const char* it = begin;
+		if (it != end && *it == '-')
+		{
+			number.mNegative = true;
+			++it;
+		}
+
+		if (it == end || !IsDigit(*it))
+		{
+			return nullptr;
+		}
+
+		// Digits are kept for as long as they fit in the mantissa, so that every 64 bit integer is exact.
+		bool mantissaFull = false;
+		auto addDigit = [&number, &mantissaFull](char c, bool isFraction)
+		{
+			const uint64_t digit = c - '0';
+			mantissaFull |= number.mMantissa > (std::numeric_limits<uint64_t>::max() - digit) / 10;
+			if (!mantissaFull)
+			{
+				number.mMantissa = number.mMantissa * 10 + digit;
+				number.mExponent -= isFraction;
+			}
+			else
+			{
+				// Dropped integer digits scale the mantissa, dropped fraction digits only lose precision.
+				number.mTruncated |= digit != 0;
+				number.mExponent += !isFraction;
+			}
+		};
+
+		for (; it != end && IsDigit(*it); ++it)
+		{
+			addDigit(*it, false);
+		}
+
+		if (it != end && *it == '.')
+		{
+			++it;
+			number.mIsInteger = false;
+
+			if (it == end || !IsDigit(*it))
+			{
+				return nullptr;
+			}
+
+			for (; it != end && IsDigit(*it); ++it)
+			{
+				addDigit(*it, true);
+			}
+		}
+
+		if (it != end && (*it == 'e' || *it == 'E'))
+		{
+			++it;
+			number.mIsInteger = false;
+
+			bool negativeExponent = false;
+			if (it != end && (*it == '-' || *it == '+'))
+			{
+				negativeExponent = *it == '-';
+				++it;
+			}
+
+			if (it == end || !IsDigit(*it))
+			{
+				return nullptr;
+			}
+
+			int32_t exponent = 0;
+			for (; it != end && IsDigit(*it); ++it)
+			{
+				if (exponent < MaxExponent)
+				{
+					exponent = exponent * 10 + (*it - '0');
+				}
+			}
+
+			number.mExponent += negativeExponent ? -exponent : exponent;
+		}
+
+		number.mText = std::string_view(begin, it - begin);
+		return it;
+	}
+}
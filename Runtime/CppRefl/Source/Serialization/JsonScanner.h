@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace cpprefl::json
+{
+	// Instruction set used to scan JSON text.
+	enum class ScannerKernel : uint8_t
+	{
+		Scalar,
+		Sse42,
+		Avx2,
+	};
+
+	// Returns the kernel currently in use. Defaults to the best kernel the CPU supports.
+	ScannerKernel GetScannerKernel();
+
+	// Overrides the kernel (e.g. to compare kernels). Returns false, and leaves the kernel unchanged, if the CPU doesn't support it.
+	bool SetScannerKernel(ScannerKernel kernel);
+
+	// Returns the first character that isn't whitespace, or end.
+	const char* FindNonWhitespace(const char* begin, const char* end);
+
+	// Returns the first quote or backslash, or end.
+	const char* FindStringSpecial(const char* begin, const char* end);
+
+	// Returns the first quote, brace or bracket, or end.
+	const char* FindStructural(const char* begin, const char* end);
+
+	// A number split into its decimal parts.
+	struct JsonNumber
+	{
+		// The original text.
+		std::string_view mText;
+
+		// The significant digits, as many as fit (at least 19, and all of them for integers that fit in a uint64_t).
+		uint64_t mMantissa = 0;
+
+		// Power of ten applied to the mantissa.
+		int32_t mExponent = 0;
+
+		bool mNegative = false;
+
+		// True if there is no fraction or exponent.
+		bool mIsInteger = true;
+
+		// True if there were more significant digits than fit in the mantissa.
+		bool mTruncated = false;
+
+	public:
+		// Converts to a double, rounding correctly. Out of range values saturate to infinity (or zero).
+		double ToDouble()const;
+	};
+
+	// Parses a JSON number starting at begin. Returns the end of the number, or nullptr if it is malformed.
+	const char* ParseNumber(const char* begin, const char* end, JsonNumber& number);
+}
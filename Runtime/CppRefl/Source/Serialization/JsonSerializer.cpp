@@ -0,0 +1,267 @@
+#include "JsonSerializer.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace cpprefl::json
+{
+	namespace
+	{
+		// Largest number of characters std::to_chars writes for any of the number types.
+		constexpr size_t MaxNumberLength = 32;
+
+		// Maps each character to the character following the backslash in its escape sequence, or 0 if it can be written as is.
+		constexpr std::array<char, 256> BuildEscapeTable()
+		{
+			std::array<char, 256> table{};
+			for (int c = 0; c < 0x20; ++c)
+			{
+				table[c] = 'u';
+			}
+
+			table['"'] = '"';
+			table['\\'] = '\\';
+			table['\b'] = 'b';
+			table['\f'] = 'f';
+			table['\n'] = 'n';
+			table['\r'] = 'r';
+			table['\t'] = 't';
+			return table;
+		}
+
+		constexpr std::array<char, 256> EscapeTable = BuildEscapeTable();
+
+		// Non-finite values aren't valid JSON. Infinity is written as a number that is out of range of a double, which reads back as infinity.
+		template <typename T>
+		const char* GetNonFiniteLiteral(T value)
+		{
+			if (std::isnan(value))
+			{
+				return "null";
+			}
+
+			return value < 0 ? "-1e999" : "1e999";
+		}
+	}
+
+	JsonSerializer::JsonSerializer(SinkFunction sink, void* context, size_t bufferSize) : mSink(sink), mSinkContext(context)
+	{
+		mBuffer.resize(std::max(bufferSize, MaxNumberLength));
+	}
+
+	JsonSerializer::~JsonSerializer()
+	{
+		Flush();
+	}
+
+	void JsonSerializer::BeginObject()
+	{
+		BeginValue();
+		Append('{');
+		mNeedComma = false;
+	}
+
+	void JsonSerializer::Key(std::string_view key)
+	{
+		BeginValue();
+		WriteEscapedString(key);
+		Append(':');
+		mNeedComma = false;
+	}
+
+	void JsonSerializer::EndObject()
+	{
+		Append('}');
+		mNeedComma = true;
+	}
+
+	void JsonSerializer::BeginArray()
+	{
+		BeginValue();
+		Append('[');
+		mNeedComma = false;
+	}
+
+	void JsonSerializer::EndArray()
+	{
+		Append(']');
+		mNeedComma = true;
+	}
+
+	void JsonSerializer::WriteNull()
+	{
+		BeginValue();
+		Append("null", 4);
+	}
+
+	void JsonSerializer::WriteBool(bool value)
+	{
+		BeginValue();
+		if (value)
+		{
+			Append("true", 4);
+		}
+		else
+		{
+			Append("false", 5);
+		}
+	}
+
+	void JsonSerializer::WriteInt(int64_t value)
+	{
+		BeginValue();
+		char* buffer = Reserve(MaxNumberLength);
+		Commit(std::to_chars(buffer, buffer + MaxNumberLength, value).ptr);
+	}
+
+	void JsonSerializer::WriteUInt(uint64_t value)
+	{
+		BeginValue();
+		char* buffer = Reserve(MaxNumberLength);
+		Commit(std::to_chars(buffer, buffer + MaxNumberLength, value).ptr);
+	}
+
+	void JsonSerializer::WriteFloat(float value)
+	{
+		BeginValue();
+		if (!std::isfinite(value))
+		{
+			const char* literal = GetNonFiniteLiteral(value);
+			Append(literal, std::strlen(literal));
+			return;
+		}
+
+		// Shortest representation that reads back as the same float.
+		char* buffer = Reserve(MaxNumberLength);
+		Commit(std::to_chars(buffer, buffer + MaxNumberLength, value).ptr);
+	}
+
+	void JsonSerializer::WriteDouble(double value)
+	{
+		BeginValue();
+		if (!std::isfinite(value))
+		{
+			const char* literal = GetNonFiniteLiteral(value);
+			Append(literal, std::strlen(literal));
+			return;
+		}
+
+		char* buffer = Reserve(MaxNumberLength);
+		Commit(std::to_chars(buffer, buffer + MaxNumberLength, value).ptr);
+	}
+
+	void JsonSerializer::WriteString(std::string_view value)
+	{
+		BeginValue();
+		WriteEscapedString(value);
+	}
+
+	void JsonSerializer::Clear()
+	{
+		mSize = 0;
+		mNeedComma = false;
+	}
+
+	void JsonSerializer::Flush()
+	{
+		if (mSink != nullptr && mSize > 0)
+		{
+			mSink(mSinkContext, mBuffer.data(), mSize);
+			mSize = 0;
+		}
+	}
+
+	char* JsonSerializer::Reserve(size_t size)
+	{
+		if (mSize + size > mBuffer.size())
+		{
+			if (mSink != nullptr)
+			{
+				// The sink buffer is always at least MaxNumberLength long, so this always makes enough room.
+				Flush();
+			}
+			else
+			{
+				mBuffer.resize(std::max(mBuffer.size() * 2, mSize + size));
+			}
+		}
+
+		return mBuffer.data() + mSize;
+	}
+
+	void JsonSerializer::Append(const char* data, size_t size)
+	{
+		if (mSink != nullptr)
+		{
+			// Data bigger than the buffer is passed on in chunks.
+			while (mSize + size > mBuffer.size())
+			{
+				const size_t chunk = mBuffer.size() - mSize;
+				std::memcpy(mBuffer.data() + mSize, data, chunk);
+				mSize += chunk;
+				Flush();
+
+				data += chunk;
+				size -= chunk;
+			}
+		}
+
+		char* buffer = Reserve(size);
+		std::memcpy(buffer, data, size);
+		mSize += size;
+	}
+
+	void JsonSerializer::Append(char c)
+	{
+		*Reserve(1) = c;
+		++mSize;
+	}
+
+	void JsonSerializer::BeginValue()
+	{
+		if (mNeedComma)
+		{
+			Append(',');
+		}
+
+		mNeedComma = true;
+	}
+
+	void JsonSerializer::WriteEscapedString(std::string_view value)
+	{
+		Append('"');
+
+		// Copy everything between escaped characters in one go.
+		const char* run = value.data();
+		const char* end = value.data() + value.size();
+		for (const char* it = run; it != end; ++it)
+		{
+			const char escape = EscapeTable[(uint8_t)*it];
+			if (escape == 0)
+			{
+				continue;
+			}
+
+			Append(run, it - run);
+			run = it + 1;
+
+			if (escape == 'u')
+			{
+				static constexpr char HexDigits[] = "0123456789abcdef";
+				const char sequence[6] = { '\\', 'u', '0', '0', HexDigits[(uint8_t)*it >> 4], HexDigits[*it & 0xF] };
+				Append(sequence, sizeof(sequence));
+			}
+			else
+			{
+				const char sequence[2] = { '\\', escape };
+				Append(sequence, sizeof(sequence));
+			}
+		}
+
+		Append(run, end - run);
+		Append('"');
+	}
+}
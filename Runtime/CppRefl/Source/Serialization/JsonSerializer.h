@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "Writer.h"
+
+namespace cpprefl::json
+{
+	// Compact JSON writer. Output is formatted straight into a single buffer (numbers with std::to_chars), which is either
+	// grown as needed or handed to a sink whenever it fills up, so writing does not allocate per value.
+	class JsonSerializer : public serialization::IWriter
+	{
+	public:
+		// Receives a chunk of output.
+		using SinkFunction = void(*)(void* context, const char* data, size_t size);
+
+		static constexpr size_t DefaultSinkBufferSize = 64 * 1024;
+
+		// Writes into an internal buffer that grows as needed. See GetString().
+		JsonSerializer() = default;
+
+		// Writes through a fixed size buffer that is flushed to the sink whenever it fills up.
+		JsonSerializer(SinkFunction sink, void* context, size_t bufferSize = DefaultSinkBufferSize);
+
+		// Flushes any remaining output to the sink.
+		~JsonSerializer() override;
+
+		JsonSerializer(const JsonSerializer&) = delete;
+		JsonSerializer& operator=(const JsonSerializer&) = delete;
+
+		void BeginObject() override;
+		void Key(std::string_view key) override;
+		void EndObject() override;
+
+		void BeginArray() override;
+		void EndArray() override;
+
+		void WriteNull() override;
+		void WriteBool(bool value) override;
+		void WriteInt(int64_t value) override;
+		void WriteUInt(uint64_t value) override;
+		void WriteFloat(float value) override;
+		void WriteDouble(double value) override;
+		void WriteString(std::string_view value) override;
+
+		// Returns the output written so far. Only valid until the next write.
+		// When writing to a sink, this is only the output that hasn't been flushed yet.
+		std::string_view GetString()const { return std::string_view(mBuffer.data(), mSize); }
+
+		// Discards all output, keeping the buffer around for reuse.
+		void Clear();
+
+		// Passes all buffered output to the sink.
+		void Flush();
+
+	private:
+		// Returns space for at least the given number of characters. Call Commit() with the number of characters actually used.
+		char* Reserve(size_t size);
+		void Commit(char* end) { mSize = end - mBuffer.data(); }
+
+		void Append(const char* data, size_t size);
+		void Append(char c);
+
+		// Writes a comma if this isn't the first value in the current object/array.
+		void BeginValue();
+
+		void WriteEscapedString(std::string_view value);
+
+		std::vector<char> mBuffer;
+		size_t mSize = 0;
+
+		SinkFunction mSink = nullptr;
+		void* mSinkContext = nullptr;
+
+		// True if the next value (or key) needs to be preceded by a comma.
+		bool mNeedComma = false;
+	};
+}
@@ -0,0 +1,437 @@
+#include "JsonStreamDeserializer.h"
+
+#include "JsonDeserializer.h"
+#include "JsonScanner.h"
+#include "../CppReflConfig.h"
+
+namespace cpprefl::json
+{
+	namespace
+	{
+		bool IsScalarEnd(char c)
+		{
+			return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ':' || c == '}' || c == ']';
+		}
+
+		// Returns the class of values of the given type if they can be walked with a frame, otherwise nullptr.
+		const ClassInfo* GetFrameClass(const TypeInstanceInfo& type)
+		{
+			if (type.mIsPointer || type.mIsArray || type.mType.mKind != TypeKind::Class)
+			{
+				return nullptr;
+			}
+
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type.mType))
+			{
+				return nullptr;
+			}
+#endif
+
+			return type.mType.GetClassInfo();
+		}
+	}
+
+	JsonStreamDeserializer::JsonStreamDeserializer(serialization::Deserializer& deserializer, const ClassInfo& classInfo, void* classObject) :
+		mDeserializer(deserializer)
+	{
+		PushObject(classInfo, classObject, nullptr);
+	}
+
+	JsonStreamStatus JsonStreamDeserializer::Feed(const char* data, size_t size)
+	{
+		mChunkBegin = data;
+		mCurrent = data;
+		mEnd = data + size;
+		mScanBegin = data;
+
+		while (mCurrent != mEnd && mStatus != JsonStreamStatus::Error)
+		{
+			if (mScanTarget != ScanTarget::None)
+			{
+				ContinueScan();
+				continue;
+			}
+
+			mCurrent = FindNonWhitespace(mCurrent, mEnd);
+			if (mCurrent == mEnd)
+			{
+				break;
+			}
+
+			if (mFrames.empty())
+			{
+				SetError("Unexpected data after the end of the document");
+				break;
+			}
+
+			Step(mFrames.back());
+		}
+
+		mOffset += size;
+		mChunkBegin = mCurrent = mEnd = mScanBegin = nullptr;
+		return mStatus;
+	}
+
+	JsonStreamStatus JsonStreamDeserializer::Finish()
+	{
+		if (mStatus == JsonStreamStatus::NeedMoreInput)
+		{
+			SetError("Unexpected end of input");
+		}
+
+		return mStatus;
+	}
+
+	void JsonStreamDeserializer::Step(Frame& frame)
+	{
+		const char c = *mCurrent;
+		switch (frame.mState)
+		{
+		case FrameState::ObjectBegin:
+			if (c != '{')
+			{
+				return SetError("Expected '{'");
+			}
+
+			++mCurrent;
+			frame.mState = FrameState::FirstKey;
+			return;
+
+		case FrameState::FirstKey:
+			if (c == '}')
+			{
+				++mCurrent;
+				return PopFrame();
+			}
+
+			[[fallthrough]];
+
+		case FrameState::Key:
+			if (c != '"')
+			{
+				return SetError("Expected a key");
+			}
+
+			frame.mState = FrameState::Colon;
+			return BeginScan(ScanTarget::Key);
+
+		case FrameState::Colon:
+			if (c != ':')
+			{
+				return SetError("Expected ':'");
+			}
+
+			++mCurrent;
+			frame.mState = FrameState::Value;
+			return;
+
+		case FrameState::Value:
+		{
+			frame.mState = FrameState::CommaOrObjectEnd;
+			if (mField == nullptr)
+			{
+				return BeginScan(ScanTarget::Skip);
+			}
+
+			// Nested objects and dynamic arrays get their own frames, everything else is decoded in one go.
+			void* value = mField->GetMemoryInClass(frame.mObject);
+			if (mField->mContainerFunctions == nullptr)
+			{
+				const ClassInfo* classInfo = GetFrameClass(mField->mTypeInstance);
+				return classInfo != nullptr ? PushObject(*classInfo, value, mField) : BeginScan(ScanTarget::Value);
+			}
+
+			if (mField->mContainerFunctions->mKind == ContainerKind::DynamicArray)
+			{
+				return PushArray(static_cast<const DynamicArrayFunctions&>(*mField->mContainerFunctions), *mField, value);
+			}
+
+			return BeginScan(ScanTarget::Value);
+		}
+
+		case FrameState::CommaOrObjectEnd:
+			if (c != ',' && c != '}')
+			{
+				return SetError("Expected ',' or '}'");
+			}
+
+			++mCurrent;
+			if (c == '}')
+			{
+				return PopFrame();
+			}
+
+			frame.mState = FrameState::Key;
+			return;
+
+		case FrameState::ArrayBegin:
+			if (c != '[')
+			{
+				return SetError("Expected '['");
+			}
+
+			++mCurrent;
+			frame.mChanged = frame.mArrayFunctions->mGetSize(frame.mObject) != 0;
+			frame.mArrayFunctions->mClear(frame.mObject);
+			frame.mState = FrameState::FirstElement;
+			return;
+
+		case FrameState::FirstElement:
+			if (c == ']')
+			{
+				++mCurrent;
+				return PopFrame();
+			}
+
+			[[fallthrough]];
+
+		case FrameState::Element:
+			frame.mState = FrameState::CommaOrArrayEnd;
+			frame.mChanged = true;
+			return BeginElement(frame);
+
+		case FrameState::CommaOrArrayEnd:
+			if (c != ',' && c != ']')
+			{
+				return SetError("Expected ',' or ']'");
+			}
+
+			++mCurrent;
+			if (c == ']')
+			{
+				return PopFrame();
+			}
+
+			frame.mState = FrameState::Element;
+			return;
+		}
+	}
+
+	void JsonStreamDeserializer::PushObject(const ClassInfo& classInfo, void* classObject, const FieldInfo* field)
+	{
+		mFrames.push_back({ &classInfo, classObject, nullptr, field, FrameState::ObjectBegin, false });
+	}
+
+	void JsonStreamDeserializer::PushArray(const DynamicArrayFunctions& functions, const FieldInfo& field, void* array)
+	{
+		mFrames.push_back({ GetFrameClass(functions.mElementType), array, &functions, &field, FrameState::ArrayBegin, false });
+	}
+
+	void JsonStreamDeserializer::BeginElement(Frame& frame)
+	{
+		if (frame.mClassInfo != nullptr)
+		{
+			return PushObject(*frame.mClassInfo, frame.mArrayFunctions->mEmplaceBack(frame.mObject), nullptr);
+		}
+
+		// The element is added once its value is complete, so that nothing is held on to between chunks.
+		BeginScan(ScanTarget::Element);
+	}
+
+	void JsonStreamDeserializer::PopFrame()
+	{
+		const Frame frame = mFrames.back();
+		mFrames.pop_back();
+		if (mFrames.empty())
+		{
+			mStatus = JsonStreamStatus::Done;
+			return;
+		}
+
+		// The field holding the object or array is reported once it is complete, the same as the Deserializer does.
+		Frame& owner = mFrames.back();
+		if (frame.mChanged && frame.mField != nullptr)
+		{
+			mDeserializer.NotifyFieldChanged(owner.mObject, *owner.mClassInfo, *frame.mField);
+		}
+
+		owner.mChanged |= frame.mChanged;
+	}
+
+	void JsonStreamDeserializer::BeginScan(ScanTarget target)
+	{
+		const char c = *mCurrent;
+
+		mScanTarget = target;
+		mScanBegin = mCurrent;
+		mScanDepth = 0;
+		mScanIsScalar = c != '"' && c != '{' && c != '[';
+		mScanInString = false;
+		mScanEscape = false;
+	}
+
+	void JsonStreamDeserializer::ContinueScan()
+	{
+		// Skipped objects and arrays are never copied, only their brackets matter.
+		const bool keepValue = mScanTarget != ScanTarget::Skip || mScanIsScalar;
+
+		const char* valueEnd = ScanValue(mCurrent);
+		if (valueEnd == nullptr)
+		{
+			if (keepValue)
+			{
+				mToken.append(mScanBegin, mEnd);
+			}
+
+			mCurrent = mEnd;
+			return;
+		}
+
+		// Values that are entirely inside of this chunk are decoded in place.
+		std::string_view value(mScanBegin, valueEnd - mScanBegin);
+		if (!mToken.empty())
+		{
+			mToken.append(value);
+			value = mToken;
+		}
+
+		mCurrent = valueEnd;
+
+		const ScanTarget target = mScanTarget;
+		mScanTarget = ScanTarget::None;
+
+		bool success = true;
+		switch (target)
+		{
+		case ScanTarget::Key: success = ReadKey(value); break;
+		case ScanTarget::Value: success = ReadValue(value); break;
+		case ScanTarget::Element: success = ReadElement(value); break;
+		case ScanTarget::Skip: success = !mScanIsScalar || SkipScalar(value); break;
+		default: break;
+		}
+
+		mToken.clear();
+
+		if (!success)
+		{
+			SetError("Invalid value");
+		}
+	}
+
+	const char* JsonStreamDeserializer::ScanValue(const char* current)
+	{
+		if (mScanIsScalar)
+		{
+			while (current != mEnd && !IsScalarEnd(*current))
+			{
+				++current;
+			}
+
+			return current != mEnd ? current : nullptr;
+		}
+
+		// Strings and containers are scanned the same way, a string is a value that ends when the quote at depth 0 is closed.
+		while (true)
+		{
+			if (mScanInString)
+			{
+				while (true)
+				{
+					if (mScanEscape)
+					{
+						if (current == mEnd)
+						{
+							return nullptr;
+						}
+
+						++current;
+						mScanEscape = false;
+					}
+
+					current = FindStringSpecial(current, mEnd);
+					if (current == mEnd)
+					{
+						return nullptr;
+					}
+
+					if (*current++ == '"')
+					{
+						break;
+					}
+
+					mScanEscape = true;
+				}
+
+				mScanInString = false;
+				if (mScanDepth == 0)
+				{
+					return current;
+				}
+			}
+
+			current = FindStructural(current, mEnd);
+			if (current == mEnd)
+			{
+				return nullptr;
+			}
+
+			switch (*current++)
+			{
+			case '"':
+				mScanInString = true;
+				break;
+
+			case '{':
+			case '[':
+				++mScanDepth;
+				break;
+
+			default:
+				if (--mScanDepth == 0)
+				{
+					return current;
+				}
+				break;
+			}
+		}
+	}
+
+	bool JsonStreamDeserializer::ReadKey(std::string_view key)
+	{
+		JsonDeserializer reader(key.data(), key.size());
+
+		std::string_view keyString;
+		if (!reader.ReadString(keyString) || !reader.IsAtEnd())
+		{
+			return false;
+		}
+
+		const Frame& frame = mFrames.back();
+		mField = mDeserializer.FindField(*frame.mClassInfo, frame.mObject, Name(keyString.data(), keyString.size()));
+		return true;
+	}
+
+	bool JsonStreamDeserializer::ReadValue(std::string_view value)
+	{
+		JsonDeserializer reader(value.data(), value.size());
+
+		Frame& frame = mFrames.back();
+		return mDeserializer.DeserializeFieldValue(reader, *frame.mClassInfo, frame.mObject, *mField, frame.mChanged) && !reader.HasError() && reader.IsAtEnd();
+	}
+
+	bool JsonStreamDeserializer::ReadElement(std::string_view value)
+	{
+		JsonDeserializer reader(value.data(), value.size());
+
+		Frame& array = mFrames.back();
+		const Frame& owner = mFrames[mFrames.size() - 2];
+		void* element = array.mArrayFunctions->mEmplaceBack(array.mObject);
+		return mDeserializer.DeserializeFieldElement(reader, *owner.mClassInfo, owner.mObject, *array.mField, element, array.mChanged) && !reader.HasError() && reader.IsAtEnd();
+	}
+
+	bool JsonStreamDeserializer::SkipScalar(std::string_view value)
+	{
+		JsonDeserializer reader(value.data(), value.size());
+		return reader.SkipValue() && reader.IsAtEnd();
+	}
+
+	void JsonStreamDeserializer::SetError(const char* message)
+	{
+		if (mStatus != JsonStreamStatus::Error)
+		{
+			mStatus = JsonStreamStatus::Error;
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "JSON parse error at offset %zu: %s", mOffset + (size_t)(mCurrent - mChunkBegin), message);
+		}
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Serializer.h"
+
+namespace cpprefl::json
+{
+	enum class JsonStreamStatus : uint8_t
+	{
+		NeedMoreInput,
+		Done,
+		Error,
+	};
+
+	// Deserializes a JSON document that arrives in chunks (e.g. from a pipe or a decompressor), filling the object as the input comes in.
+	// Chunks may be split anywhere, even in the middle of a token, and don't need to outlive the call to Feed().
+	//
+	// Objects and dynamic arrays are walked with an explicit stack of frames, so parsing can stop at the end of any chunk and resume with
+	// the next one. All other values (numbers, strings, maps, objects behind pointers, ...), including each element of a dynamic array
+	// that isn't an object, are decoded by the Deserializer once they are complete, and only values that are split between chunks are
+	// copied. Memory use is therefore bounded by the largest of those values rather than by the size of the document. Values of unknown
+	// fields are skipped without being copied.
+	class JsonStreamDeserializer
+	{
+	public:
+		// Deserializes into an already constructed object. The deserializer and object must outlive the stream.
+		JsonStreamDeserializer(serialization::Deserializer& deserializer, const ClassInfo& classInfo, void* classObject);
+
+		template <typename T>
+		JsonStreamDeserializer(serialization::Deserializer& deserializer, T& object) :
+			JsonStreamDeserializer(deserializer, GetReflectedClass<T>(), &object)
+		{
+		}
+
+		// Parses the next chunk of the document. Returns Done once the root object is complete (only whitespace may follow).
+		JsonStreamStatus Feed(const char* data, size_t size);
+		JsonStreamStatus Feed(std::string_view data) { return Feed(data.data(), data.size()); }
+
+		// Signals the end of the input. Returns Error if the document is incomplete.
+		JsonStreamStatus Finish();
+
+		JsonStreamStatus GetStatus()const { return mStatus; }
+
+		// Returns the memory held for values split between chunks, e.g. to check that it stays bounded.
+		size_t GetBufferCapacity()const { return mToken.capacity(); }
+
+	private:
+		enum class FrameState : uint8_t
+		{
+			ObjectBegin,
+			FirstKey,
+			Key,
+			Colon,
+			Value,
+			CommaOrObjectEnd,
+
+			ArrayBegin,
+			FirstElement,
+			Element,
+			CommaOrArrayEnd,
+		};
+
+		// An object being filled, or a dynamic array (always a field of the object in the frame below it).
+		struct Frame
+		{
+			// The class of the object, or of the elements of the array (nullptr if they aren't objects that get frames).
+			const ClassInfo* mClassInfo;
+
+			// The object, or the array.
+			void* mObject;
+
+			// Set for arrays only.
+			const DynamicArrayFunctions* mArrayFunctions;
+
+			// The field of the object in the frame below that holds this object or array (nullptr for the root object and elements).
+			const FieldInfo* mField;
+
+			FrameState mState;
+
+			// Set when anything inside of the object or array changes, so that the field holding it can be reported once it ends.
+			bool mChanged;
+		};
+
+		// What a scanned value is for.
+		enum class ScanTarget : uint8_t
+		{
+			None,
+			Key,
+			Value,
+			Element,
+			Skip,
+		};
+
+		void Step(Frame& frame);
+
+		void PushObject(const ClassInfo& classInfo, void* classObject, const FieldInfo* field);
+		void PushArray(const DynamicArrayFunctions& functions, const FieldInfo& field, void* array);
+
+		// Starts the next element of the array in the frame: objects get their own frame, other values are scanned.
+		void BeginElement(Frame& frame);
+		void PopFrame();
+
+		// Starts scanning the value (or key) at the current position.
+		void BeginScan(ScanTarget target);
+
+		// Scans the rest of the current value, and decodes it once it is complete.
+		void ContinueScan();
+
+		// Returns the end of the current value, or nullptr if it doesn't end in this chunk.
+		const char* ScanValue(const char* current);
+
+		bool ReadKey(std::string_view key);
+		bool ReadValue(std::string_view value);
+		bool ReadElement(std::string_view value);
+		bool SkipScalar(std::string_view value);
+
+		void SetError(const char* message);
+
+		serialization::Deserializer& mDeserializer;
+
+		std::vector<Frame> mFrames;
+
+		JsonStreamStatus mStatus = JsonStreamStatus::NeedMoreInput;
+
+		// The chunk being parsed.
+		const char* mChunkBegin = nullptr;
+		const char* mCurrent = nullptr;
+		const char* mEnd = nullptr;
+
+		// Number of bytes in earlier chunks, for error messages.
+		size_t mOffset = 0;
+
+		// The field the value after the current key is written to, or nullptr if the value is skipped.
+		const FieldInfo* mField = nullptr;
+
+		// State of the value being scanned.
+		ScanTarget mScanTarget = ScanTarget::None;
+		const char* mScanBegin = nullptr;
+		uint32_t mScanDepth = 0;
+		bool mScanIsScalar = false;
+		bool mScanInString = false;
+		bool mScanEscape = false;
+
+		// The part of the current value that was in earlier chunks. Reused to avoid allocations.
+		std::string mToken;
+	};
+}
@@ -0,0 +1,120 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cpprefl::serialization
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#if defined(_WIN32)
+	bool MappedFile::Open(const char* path)
+	{
+		Close();
+
+		mFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (mFile == INVALID_HANDLE_VALUE)
+		{
+			mFile = nullptr;
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mMapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		mData = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+		if (mData == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		mSize = (size_t)size.QuadPart;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (mData != nullptr)
+		{
+			UnmapViewOfFile(mData);
+		}
+
+		if (mMapping != nullptr)
+		{
+			CloseHandle(mMapping);
+		}
+
+		if (mFile != nullptr)
+		{
+			CloseHandle(mFile);
+		}
+
+		mData = nullptr;
+		mSize = 0;
+		mMapping = nullptr;
+		mFile = nullptr;
+	}
+#else
+	bool MappedFile::Open(const char* path)
+	{
+		Close();
+
+		const int file = open(path, O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		// The mapping stays valid after the file is closed.
+		struct stat status;
+		void* data = fstat(file, &status) == 0 && status.st_size > 0 ?
+			mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0) :
+			MAP_FAILED;
+
+		close(file);
+
+		if (data == MAP_FAILED)
+		{
+			return false;
+		}
+
+		mData = data;
+		mSize = (size_t)status.st_size;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (mData != nullptr)
+		{
+			munmap(const_cast<void*>(mData), mSize);
+		}
+
+		mData = nullptr;
+		mSize = 0;
+	}
+#endif
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cpprefl::serialization
+{
+	// A read-only memory mapped file. Pages are loaded on first access, so opening a file costs the same regardless of its size.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// Maps a file, closing any previously mapped file. Returns false if the file can't be mapped.
+		bool Open(const char* path);
+		void Close();
+
+		const void* GetData()const { return mData; }
+		size_t GetSize()const { return mSize; }
+
+	private:
+		const void* mData = nullptr;
+		size_t mSize = 0;
+
+#if defined(_WIN32)
+		void* mFile = nullptr;
+		void* mMapping = nullptr;
+#endif
+	};
+}
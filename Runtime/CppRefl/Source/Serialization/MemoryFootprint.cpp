@@ -0,0 +1,359 @@
+#include "MemoryFootprint.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+#include "../Reflection/ArrayView.h"
+#include "../Reflection/AssociativeArray.h"
+#include "../Reflection/DynamicArray.h"
+#include "../Reflection/Optional.h"
+#include "ThreadPool.h"
+
+namespace cpprefl
+{
+	namespace
+	{
+		// Objects measured in parallel at a time.
+		constexpr size_t ChunkSize = 1024;
+
+		// Objects behind pointers that were already counted by this thread, during the current measurement.
+		thread_local std::unordered_set<const void*> VisitedObjects;
+
+		size_t MeasureValue(const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value);
+
+		// Returns the size of a value inside of the object or container holding it.
+		size_t GetInlineSize(const TypeInstanceInfo& type)
+		{
+			const size_t size = type.mIsPointer ? sizeof(void*) : type.mType.mSize;
+			return type.mIsArray ? size * type.mArraySize : size;
+		}
+
+		bool IsStringType(const TypeInfo& type)
+		{
+#if CPPREFL_WITH_STL()
+			return IsSameType<std::string>(type);
+#else
+			return false;
+#endif
+		}
+
+		// Returns true if values of the type (ignoring whether it is an array) can own memory.
+		bool CanOwnMemory(const TypeInstanceInfo& type)
+		{
+			if (type.mType.mKind != TypeKind::Class)
+			{
+				return false;
+			}
+
+			if (IsStringType(type.mType))
+			{
+				return !type.mIsPointer;
+			}
+
+			const ClassInfo* classInfo = type.mType.GetClassInfo();
+			return classInfo != nullptr && (type.mIsPointer || MemoryPlan::Get(*classInfo).HasHeap());
+		}
+
+#if CPPREFL_WITH_STL()
+		size_t MeasureString(const std::string& string)
+		{
+			// Short strings are stored inside of the string object.
+			const std::byte* data = (const std::byte*)string.data();
+			const std::byte* object = (const std::byte*)&string;
+			return data >= object && data < object + sizeof(std::string) ? 0 : string.capacity() + 1;
+		}
+#endif
+
+		size_t MeasureElement(const TypeInfo& type, bool isPointer, const void* value)
+		{
+			if (type.mKind != TypeKind::Class)
+			{
+				return 0;
+			}
+
+#if CPPREFL_WITH_STL()
+			if (!isPointer && IsStringType(type))
+			{
+				return MeasureString(*(const std::string*)value);
+			}
+#endif
+
+			const ClassInfo* classInfo = type.GetClassInfo();
+			if (classInfo == nullptr)
+			{
+				return 0;
+			}
+
+			if (!isPointer)
+			{
+				return MemoryPlan::Get(*classInfo).MeasureHeap(value);
+			}
+
+			const void* object = *(const void* const*)value;
+			if (object == nullptr || !VisitedObjects.insert(object).second)
+			{
+				return 0;
+			}
+
+			const ClassInfo& dynamicClass = classInfo->GetDynamicClass(object);
+			return dynamicClass.mType->mSize + MemoryPlan::Get(dynamicClass).MeasureHeap(object);
+		}
+
+		size_t MeasureContainer(const TypeInstanceInfo& type, const ContainerFunctions& containerFunctions, const void* value)
+		{
+			// The accessor tables take mutable containers, but none of the functions used here modify them.
+			void* container = const_cast<void*>(value);
+
+			switch (containerFunctions.mKind)
+			{
+			case ContainerKind::DynamicArray:
+			{
+				const auto& functions = static_cast<const DynamicArrayFunctions&>(containerFunctions);
+				const ArraySizeType size = functions.mGetSize(container);
+
+				size_t bytes = (size_t)functions.mGetCapacity(container) * functions.mElementStride;
+				if (size > 0 && CanOwnMemory(functions.mElementType))
+				{
+					for (ArraySizeType i = 0; i < size; ++i)
+					{
+						bytes += MeasureValue(functions.mElementType, nullptr, functions.GetElement(container, i));
+					}
+				}
+				return bytes;
+			}
+
+			case ContainerKind::ArrayView:
+			{
+				// The elements are either inside of the container (std::array) or not owned by it (std::span).
+				const auto& functions = static_cast<const ArrayViewFunctions&>(containerFunctions);
+				const ArraySizeType size = functions.mGetSize(container);
+
+				size_t bytes = 0;
+				if (size > 0 && CanOwnMemory(functions.mElementType))
+				{
+					for (ArraySizeType i = 0; i < size; ++i)
+					{
+						bytes += MeasureValue(functions.mElementType, nullptr, functions.GetElement(container, i));
+					}
+				}
+				return bytes;
+			}
+
+			case ContainerKind::AssociativeArray:
+			{
+				const auto& functions = static_cast<const AssociativeArrayFunctions&>(containerFunctions);
+
+				size_t bytes = (size_t)functions.mGetSize(container) * (functions.mKeySize + GetInlineSize(functions.mValueType));
+				if (CanOwnMemory(functions.mKeyType) || CanOwnMemory(functions.mValueType))
+				{
+					struct VisitContext
+					{
+						const AssociativeArrayFunctions& mFunctions;
+						size_t mBytes;
+					};
+
+					VisitContext context{ functions, 0 };
+					functions.mForEach(container, [](void* contextPtr, const void* key, void* entry)
+					{
+						VisitContext& context = *static_cast<VisitContext*>(contextPtr);
+						context.mBytes += MeasureValue(context.mFunctions.mKeyType, nullptr, key) + MeasureValue(context.mFunctions.mValueType, nullptr, entry);
+						return true;
+					}, &context);
+					bytes += context.mBytes;
+				}
+				return bytes;
+			}
+
+			case ContainerKind::Optional:
+			{
+				const auto& functions = static_cast<const OptionalFunctions&>(containerFunctions);
+				const void* optionalValue = functions.mGetValue(container);
+				if (optionalValue == nullptr)
+				{
+					return 0;
+				}
+
+				// Values inside of the container (std::optional) are part of it, others (std::unique_ptr) are owned by it.
+				const std::byte* containerBytes = (const std::byte*)value;
+				const bool isInline = optionalValue >= containerBytes && optionalValue < containerBytes + type.mType.mSize;
+
+				const TypeInstanceInfo& valueType = functions.mValueType;
+				const ClassInfo* classInfo = valueType.mType.mKind == TypeKind::Class && !valueType.mIsPointer ? valueType.mType.GetClassInfo() : nullptr;
+				if (classInfo == nullptr)
+				{
+					return (isInline ? 0 : GetInlineSize(valueType)) + MeasureValue(valueType, nullptr, optionalValue);
+				}
+
+				const ClassInfo& dynamicClass = classInfo->GetDynamicClass(optionalValue);
+				return (isInline ? 0 : dynamicClass.mType->mSize) + MemoryPlan::Get(dynamicClass).MeasureHeap(optionalValue);
+			}
+
+			default:
+				return 0;
+			}
+		}
+
+		size_t MeasureValue(const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value)
+		{
+			if (containerFunctions != nullptr)
+			{
+				return MeasureContainer(type, *containerFunctions, value);
+			}
+
+			if (!type.mIsArray)
+			{
+				return MeasureElement(type.mType, type.mIsPointer, value);
+			}
+
+			if (!CanOwnMemory(type))
+			{
+				return 0;
+			}
+
+			const size_t stride = type.mIsPointer ? sizeof(void*) : type.mType.mSize;
+
+			size_t bytes = 0;
+			for (ArraySizeType i = 0; i < type.mArraySize; ++i)
+			{
+				bytes += MeasureElement(type.mType, type.mIsPointer, (const std::byte*)value + i * stride);
+			}
+			return bytes;
+		}
+	}
+
+	MemoryPlan::MemoryPlan(const ClassInfo& classInfo)
+	{
+		AddFields(classInfo, 0, NoOuterField);
+	}
+
+	const MemoryPlan& MemoryPlan::Get(const ClassInfo& classInfo)
+	{
+		std::call_once(classInfo.mMemoryPlanFlag, [&classInfo]
+		{
+			classInfo.mMemoryPlan = std::make_shared<const MemoryPlan>(classInfo);
+		});
+
+		return *classInfo.mMemoryPlan;
+	}
+
+	void MemoryPlan::AddFields(const ClassInfo& classInfo, uint32_t offset, uint32_t outerFieldIndex)
+	{
+		for (size_t i = 0; i < classInfo.mFlattenedFields.size(); ++i)
+		{
+			const FieldInfo& field = classInfo.mFlattenedFields[i];
+			const TypeInstanceInfo& type = field.mTypeInstance;
+			const uint32_t fieldIndex = outerFieldIndex != NoOuterField ? outerFieldIndex : (uint32_t)i;
+			const uint32_t fieldOffset = offset + (uint32_t)field.mOffset;
+
+			// Only classes can own memory. Whether arrays of them do is checked when they are measured, since checking it here
+			// would need the plans of other classes while this one is being built.
+			if (field.mContainerFunctions != nullptr || (type.mType.mKind == TypeKind::Class && (type.mIsArray || type.mIsPointer)))
+			{
+				mEntries.push_back({ fieldOffset, fieldIndex, EntryKind::Value, &field });
+			}
+			else if (IsStringType(type.mType))
+			{
+				mEntries.push_back({ fieldOffset, fieldIndex, EntryKind::String, &field });
+			}
+			else if (type.mType.mKind == TypeKind::Class && type.mType.GetClassInfo() != nullptr)
+			{
+				// Objects held by value are inlined.
+				AddFields(*type.mType.GetClassInfo(), fieldOffset, fieldIndex);
+			}
+		}
+	}
+
+	size_t MemoryPlan::MeasureHeap(const void* object, size_t* fieldHeapBytes)const
+	{
+		const std::byte* bytes = (const std::byte*)object;
+
+		size_t total = 0;
+		for (const Entry& entry : mEntries)
+		{
+			const void* value = bytes + entry.mOffset;
+
+			size_t entryBytes;
+#if CPPREFL_WITH_STL()
+			if (entry.mKind == EntryKind::String)
+			{
+				entryBytes = MeasureString(*(const std::string*)value);
+			}
+			else
+#endif
+			{
+				entryBytes = MeasureValue(entry.mField->mTypeInstance, entry.mField->mContainerFunctions, value);
+			}
+
+			if (fieldHeapBytes != nullptr)
+			{
+				fieldHeapBytes[entry.mFieldIndex] += entryBytes;
+			}
+			total += entryBytes;
+		}
+
+		return total;
+	}
+
+	MemoryFootprint MeasureDeep(const ClassInfo& classInfo, const void* objects, size_t count, size_t stride, serialization::ThreadPool* threadPool)
+	{
+		MemoryFootprint footprint;
+		footprint.mInlineBytes = count * classInfo.mType->mSize;
+
+		const FieldView& fields = classInfo.mFlattenedFields;
+		footprint.mFields.resize(fields.size());
+		for (size_t i = 0; i < fields.size(); ++i)
+		{
+			footprint.mFields[i].mField = &fields[i];
+			footprint.mFields[i].mInlineBytes = count * GetInlineSize(fields[i].mTypeInstance);
+		}
+
+		const MemoryPlan& plan = MemoryPlan::Get(classInfo);
+		if (!plan.HasHeap() || count == 0)
+		{
+			return footprint;
+		}
+
+		const bool parallel = threadPool != nullptr && count > ChunkSize && !threadPool->IsInParallelFor();
+		const size_t chunkCount = parallel ? (count + ChunkSize - 1) / ChunkSize : 1;
+		const size_t chunkSize = parallel ? ChunkSize : count;
+
+		// Each chunk adds up its own fields, so that chunks don't share anything.
+		std::vector<size_t> fieldHeapBytes(chunkCount * fields.size());
+		const auto measure = [&](size_t chunkIndex)
+		{
+			VisitedObjects.clear();
+
+			size_t* chunkFieldHeapBytes = fieldHeapBytes.data() + chunkIndex * fields.size();
+			const size_t end = std::min(count, (chunkIndex + 1) * chunkSize);
+			for (size_t i = chunkIndex * chunkSize; i < end; ++i)
+			{
+				plan.MeasureHeap((const std::byte*)objects + i * stride, chunkFieldHeapBytes);
+			}
+		};
+
+		if (parallel)
+		{
+			threadPool->ParallelFor(chunkCount, measure);
+		}
+		else
+		{
+			measure(0);
+		}
+
+		for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			for (size_t i = 0; i < fields.size(); ++i)
+			{
+				footprint.mFields[i].mHeapBytes += fieldHeapBytes[chunk * fields.size() + i];
+			}
+		}
+
+		for (const FieldFootprint& field : footprint.mFields)
+		{
+			footprint.mHeapBytes += field.mHeapBytes;
+		}
+
+		return footprint;
+	}
+}
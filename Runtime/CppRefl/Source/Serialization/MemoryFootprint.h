@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Reflection/ClassInfo.h"
+
+namespace cpprefl::serialization
+{
+	class ThreadPool;
+}
+
+namespace cpprefl
+{
+	// Memory held through one field of a class.
+	struct FieldFootprint
+	{
+		const FieldInfo* mField = nullptr;
+
+		// Size of the field inside of its objects.
+		size_t mInlineBytes = 0;
+
+		// Memory the field owns outside of its objects.
+		size_t mHeapBytes = 0;
+	};
+
+	// Memory held by reflected objects, e.g. to track memory budgets.
+	//
+	// Heap memory is what the objects own through their fields: the capacity of dynamic arrays and strings (strings short
+	// enough to be stored inside of the string object don't count), the entries of maps, values of optionals stored outside of
+	// them (e.g. std::unique_ptr), and objects of reflected classes behind pointers, all including the memory they own in turn.
+	// Memory used by the allocator itself or by map nodes (beyond their keys and values) isn't counted, neither are C strings,
+	// which are rarely owned. Objects behind pointers are counted once per measurement, so cycles and shared objects are fine.
+	struct MemoryFootprint
+	{
+		// Size of the objects themselves.
+		size_t mInlineBytes = 0;
+
+		// Memory the objects own.
+		size_t mHeapBytes = 0;
+
+		// Every field of the class, including those of base classes. Memory owned through nested classes held by value counts
+		// towards their field in the outer class.
+		std::vector<FieldFootprint> mFields;
+
+	public:
+		size_t GetTotalBytes()const { return mInlineBytes + mHeapBytes; }
+	};
+
+	// The fields of a class that own memory, with fields of nested classes held by value inlined, so that objects without any
+	// (e.g. arrays of vectors or points) are skipped entirely.
+	//
+	// A plan is built once per class, the first time an object of the class is measured, and cached on the ClassInfo.
+	class MemoryPlan
+	{
+	public:
+		explicit MemoryPlan(const ClassInfo& classInfo);
+
+		// Returns the plan of a class, building it if needed.
+		static const MemoryPlan& Get(const ClassInfo& classInfo);
+
+		// Returns true if objects of the class can own memory.
+		bool HasHeap()const { return !mEntries.empty(); }
+
+		// Returns the memory an object of the class owns. If fieldHeapBytes isn't null, the memory owned through each field of
+		// the class (in the order of mFlattenedFields) is added to it.
+		size_t MeasureHeap(const void* object, size_t* fieldHeapBytes = nullptr)const;
+
+	private:
+		enum class EntryKind : uint8_t
+		{
+			String,
+
+			// Anything else: containers, pointers and arrays.
+			Value,
+		};
+
+		struct Entry
+		{
+			uint32_t mOffset;
+
+			// Index of the field of the class the entry belongs to (it is nested in that field if the class holds it by value).
+			uint32_t mFieldIndex;
+
+			EntryKind mKind;
+			const FieldInfo* mField;
+		};
+
+		// Adds the fields of a class nested at the offset. Fields of nested classes belong to the outer field they are nested in.
+		void AddFields(const ClassInfo& classInfo, uint32_t offset, uint32_t outerFieldIndex);
+
+		static constexpr uint32_t NoOuterField = UINT32_MAX;
+
+		std::vector<Entry> mEntries;
+	};
+
+	// Measures objects of a reflected class, which are stride bytes apart. With a thread pool, chunks of objects are measured in
+	// parallel, in which case objects behind pointers from different chunks can be counted more than once.
+	MemoryFootprint MeasureDeep(const ClassInfo& classInfo, const void* objects, size_t count, size_t stride, serialization::ThreadPool* threadPool = nullptr);
+
+	// Measures the most derived class of the object.
+	template <typename T>
+	MemoryFootprint MeasureDeep(const T& object)
+	{
+		return MeasureDeep(GetReflectedClass<T>().GetDynamicClass(&object), &object, 1, sizeof(T));
+	}
+
+	// Measures the objects in the vector (but not the vector's own unused capacity).
+	template <typename T>
+	MemoryFootprint MeasureDeep(const std::vector<T>& objects, serialization::ThreadPool* threadPool = nullptr)
+	{
+		return MeasureDeep(GetReflectedClass<T>(), objects.data(), objects.size(), sizeof(T), threadPool);
+	}
+}
@@ -0,0 +1,537 @@
+#include "MsgPackDeserializer.h"
+
+#include <array>
+#include <charconv>
+#include <cstring>
+
+#include "NumberConversion.h"
+#include "../CppReflConfig.h"
+
+namespace cpprefl::msgpack
+{
+	using serialization::TruncateDouble;
+	using serialization::ValueType;
+
+	namespace
+	{
+		// Maps the first byte of each value to its type.
+		constexpr std::array<ValueType, 256> BuildValueTypeTable()
+		{
+			std::array<ValueType, 256> table{};
+			for (int b = 0x00; b <= 0x7f; ++b) table[b] = ValueType::Number;	// Positive fixint
+			for (int b = 0x80; b <= 0x8f; ++b) table[b] = ValueType::Object;	// Fixmap
+			for (int b = 0x90; b <= 0x9f; ++b) table[b] = ValueType::Array;		// Fixarray
+			for (int b = 0xa0; b <= 0xbf; ++b) table[b] = ValueType::String;	// Fixstr
+			for (int b = 0xca; b <= 0xd3; ++b) table[b] = ValueType::Number;	// Float 32/64, uint 8-64, int 8-64
+			for (int b = 0xe0; b <= 0xff; ++b) table[b] = ValueType::Number;	// Negative fixint
+
+			table[0xc0] = ValueType::Null;
+			table[0xc2] = ValueType::Bool;
+			table[0xc3] = ValueType::Bool;
+			table[0xc4] = ValueType::String;	// Bin 8/16/32
+			table[0xc5] = ValueType::String;
+			table[0xc6] = ValueType::String;
+			table[0xd9] = ValueType::String;	// Str 8/16/32
+			table[0xda] = ValueType::String;
+			table[0xdb] = ValueType::String;
+			table[0xdc] = ValueType::Array;		// Array 16/32
+			table[0xdd] = ValueType::Array;
+			table[0xde] = ValueType::Object;	// Map 16/32
+			table[0xdf] = ValueType::Object;
+			return table;
+		}
+
+		constexpr std::array<ValueType, 256> ValueTypeTable = BuildValueTypeTable();
+
+		// Sign extends a number of the given size in bytes.
+		int64_t SignExtend(uint64_t value, size_t size)
+		{
+			const int shift = 64 - (int)size * 8;
+			return (int64_t)(value << shift) >> shift;
+		}
+	}
+
+	MsgPackDeserializer::MsgPackDeserializer(const void* data, size_t size) :
+		mBegin((const std::byte*)data),
+		mCurrent((const std::byte*)data),
+		mEnd((const std::byte*)data + size)
+	{
+	}
+
+	MsgPackDeserializer::MsgPackDeserializer(const std::byte* document, const std::byte* begin, const std::byte* end, size_t elementCount) :
+		mBegin(document),
+		mCurrent(begin),
+		mEnd(end),
+		mRemaining({ elementCount })
+	{
+	}
+
+	ValueType MsgPackDeserializer::PeekValue()
+	{
+		if (mError || mCurrent == mEnd)
+		{
+			return ValueType::Invalid;
+		}
+
+		return ValueTypeTable[(uint8_t)*mCurrent];
+	}
+
+	bool MsgPackDeserializer::BeginObject()
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		if (token.mKind != TokenKind::Map)
+		{
+			return SetError("Expected a map");
+		}
+
+		return BeginContainer(token.mUInt, true);
+	}
+
+	bool MsgPackDeserializer::NextKey(std::string_view& key)
+	{
+		if (!NextItem())
+		{
+			return false;
+		}
+
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		switch (token.mKind)
+		{
+		case TokenKind::String:
+			key = token.mString;
+			return true;
+
+		case TokenKind::UInt:
+			key = std::string_view(mKeyScratch, std::to_chars(mKeyScratch, mKeyScratch + sizeof(mKeyScratch), token.mUInt).ptr - mKeyScratch);
+			return true;
+
+		case TokenKind::Int:
+			key = std::string_view(mKeyScratch, std::to_chars(mKeyScratch, mKeyScratch + sizeof(mKeyScratch), token.mInt).ptr - mKeyScratch);
+			return true;
+
+		default:
+			return SetError("Expected a string or integer key");
+		}
+	}
+
+	bool MsgPackDeserializer::BeginArray()
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		if (token.mKind != TokenKind::Array)
+		{
+			return SetError("Expected an array");
+		}
+
+		return BeginContainer(token.mUInt, false);
+	}
+
+	bool MsgPackDeserializer::NextElement()
+	{
+		return NextItem();
+	}
+
+	bool MsgPackDeserializer::ReadNull()
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		return token.mKind == TokenKind::Null || SetError("Expected nil");
+	}
+
+	bool MsgPackDeserializer::ReadBool(bool& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		if (token.mKind != TokenKind::Bool)
+		{
+			return SetError("Expected a boolean");
+		}
+
+		value = token.mBool;
+		return true;
+	}
+
+	bool MsgPackDeserializer::ReadInt(int64_t& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		switch (token.mKind)
+		{
+		// Integers that are too big for a signed integer wrap around, the same as a cast would.
+		case TokenKind::UInt: value = (int64_t)token.mUInt; return true;
+		case TokenKind::Int: value = token.mInt; return true;
+		case TokenKind::Double: value = TruncateDouble<int64_t>(token.mDouble); return true;
+		default: return SetError("Expected a number");
+		}
+	}
+
+	bool MsgPackDeserializer::ReadUInt(uint64_t& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		switch (token.mKind)
+		{
+		// Negative numbers wrap around, the same as a cast would.
+		case TokenKind::UInt: value = token.mUInt; return true;
+		case TokenKind::Int: value = (uint64_t)token.mInt; return true;
+		case TokenKind::Double: value = TruncateDouble<uint64_t>(token.mDouble); return true;
+		default: return SetError("Expected a number");
+		}
+	}
+
+	bool MsgPackDeserializer::ReadDouble(double& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		switch (token.mKind)
+		{
+		case TokenKind::UInt: value = (double)token.mUInt; return true;
+		case TokenKind::Int: value = (double)token.mInt; return true;
+		case TokenKind::Double: value = token.mDouble; return true;
+		default: return SetError("Expected a number");
+		}
+	}
+
+	bool MsgPackDeserializer::ReadString(std::string_view& value)
+	{
+		Token token;
+		if (!ReadToken(token))
+		{
+			return false;
+		}
+
+		if (token.mKind != TokenKind::String)
+		{
+			return SetError("Expected a string");
+		}
+
+		value = token.mString;
+		return true;
+	}
+
+	bool MsgPackDeserializer::SkipValue()
+	{
+		// Containers are skipped by counting the values left in them, without keeping track of where each one ends.
+		uint64_t valueCount = 1;
+		while (valueCount > 0)
+		{
+			Token token;
+			if (!ReadToken(token))
+			{
+				return false;
+			}
+
+			--valueCount;
+			if (token.mKind == TokenKind::Array || token.mKind == TokenKind::Map)
+			{
+				const uint64_t size = token.mKind == TokenKind::Map ? token.mUInt * 2 : token.mUInt;
+				if (size > (uint64_t)(mEnd - mCurrent))
+				{
+					return SetError("Map or array is bigger than the input");
+				}
+
+				valueCount += size;
+			}
+		}
+
+		return true;
+	}
+
+	bool MsgPackDeserializer::SplitArray(size_t chunkSize, std::vector<std::unique_ptr<serialization::IReader>>& chunks, size_t& elementCount)
+	{
+		// Finding the element boundaries only decodes the headers of the values, the elements are validated when the chunks are read.
+		const std::byte* chunkBegin = nullptr;
+		size_t chunkElementCount = 0;
+
+		elementCount = 0;
+		while (NextElement())
+		{
+			if (chunkElementCount == 0)
+			{
+				chunkBegin = mCurrent;
+			}
+
+			if (!SkipValue())
+			{
+				return false;
+			}
+
+			++elementCount;
+			if (++chunkElementCount == chunkSize)
+			{
+				chunks.emplace_back(new MsgPackDeserializer(mBegin, chunkBegin, mCurrent, chunkElementCount));
+				chunkElementCount = 0;
+			}
+		}
+
+		if (mError)
+		{
+			return false;
+		}
+
+		if (chunkElementCount > 0)
+		{
+			chunks.emplace_back(new MsgPackDeserializer(mBegin, chunkBegin, mCurrent, chunkElementCount));
+		}
+
+		return true;
+	}
+
+	bool MsgPackDeserializer::ReadToken(Token& token)
+	{
+		if (mError)
+		{
+			return false;
+		}
+
+		if (mCurrent == mEnd)
+		{
+			return SetError("Unexpected end of input");
+		}
+
+		const uint8_t prefix = (uint8_t)*mCurrent++;
+		if (prefix <= 0x7f)
+		{
+			token.mKind = TokenKind::UInt;
+			token.mUInt = prefix;
+			return true;
+		}
+
+		if (prefix >= 0xe0)
+		{
+			token.mKind = TokenKind::Int;
+			token.mInt = (int8_t)prefix;
+			return true;
+		}
+
+		if (prefix <= 0x8f)
+		{
+			token.mKind = TokenKind::Map;
+			token.mUInt = prefix & 0x0f;
+			return true;
+		}
+
+		if (prefix <= 0x9f)
+		{
+			token.mKind = TokenKind::Array;
+			token.mUInt = prefix & 0x0f;
+			return true;
+		}
+
+		if (prefix <= 0xbf)
+		{
+			token.mKind = TokenKind::String;
+			return ReadPayload(token.mString, prefix & 0x1f);
+		}
+
+		uint64_t value;
+		switch (prefix)
+		{
+		case 0xc0:
+			token.mKind = TokenKind::Null;
+			return true;
+
+		case 0xc2:
+		case 0xc3:
+			token.mKind = TokenKind::Bool;
+			token.mBool = prefix == 0xc3;
+			return true;
+
+		// Bin 8/16/32 and str 8/16/32.
+		case 0xc4:
+		case 0xc5:
+		case 0xc6:
+		case 0xd9:
+		case 0xda:
+		case 0xdb:
+		{
+			const size_t sizeBytes = (size_t)1 << ((prefix <= 0xc6 ? prefix - 0xc4 : prefix - 0xd9));
+			token.mKind = TokenKind::String;
+			return ReadBigEndian(value, sizeBytes) && ReadPayload(token.mString, value);
+		}
+
+		// Ext 8/16/32: size, type, data.
+		case 0xc7:
+		case 0xc8:
+		case 0xc9:
+			token.mKind = TokenKind::Extension;
+			return ReadBigEndian(value, (size_t)1 << (prefix - 0xc7)) && ReadPayload(token.mString, value + 1);
+
+		case 0xca:
+		{
+			if (!ReadBigEndian(value, 4))
+			{
+				return false;
+			}
+
+			float number;
+			const uint32_t bits = (uint32_t)value;
+			std::memcpy(&number, &bits, sizeof(number));
+			token.mKind = TokenKind::Double;
+			token.mDouble = number;
+			return true;
+		}
+
+		case 0xcb:
+			if (!ReadBigEndian(value, 8))
+			{
+				return false;
+			}
+
+			token.mKind = TokenKind::Double;
+			std::memcpy(&token.mDouble, &value, sizeof(double));
+			return true;
+
+		// Uint 8/16/32/64.
+		case 0xcc:
+		case 0xcd:
+		case 0xce:
+		case 0xcf:
+			token.mKind = TokenKind::UInt;
+			return ReadBigEndian(token.mUInt, (size_t)1 << (prefix - 0xcc));
+
+		// Int 8/16/32/64.
+		case 0xd0:
+		case 0xd1:
+		case 0xd2:
+		case 0xd3:
+		{
+			const size_t size = (size_t)1 << (prefix - 0xd0);
+			if (!ReadBigEndian(value, size))
+			{
+				return false;
+			}
+
+			token.mKind = TokenKind::Int;
+			token.mInt = SignExtend(value, size);
+			return true;
+		}
+
+		// Fixext 1/2/4/8/16: type, data.
+		case 0xd4:
+		case 0xd5:
+		case 0xd6:
+		case 0xd7:
+		case 0xd8:
+			token.mKind = TokenKind::Extension;
+			return ReadPayload(token.mString, ((size_t)1 << (prefix - 0xd4)) + 1);
+
+		case 0xdc:
+		case 0xdd:
+			token.mKind = TokenKind::Array;
+			return ReadBigEndian(token.mUInt, prefix == 0xdc ? 2 : 4);
+
+		case 0xde:
+		case 0xdf:
+			token.mKind = TokenKind::Map;
+			return ReadBigEndian(token.mUInt, prefix == 0xde ? 2 : 4);
+
+		default:
+			--mCurrent;
+			return SetError("Invalid type prefix");
+		}
+	}
+
+	bool MsgPackDeserializer::ReadBigEndian(uint64_t& value, size_t size)
+	{
+		if ((size_t)(mEnd - mCurrent) < size)
+		{
+			return SetError("Unexpected end of input");
+		}
+
+		value = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			value = (value << 8) | (uint8_t)mCurrent[i];
+		}
+
+		mCurrent += size;
+		return true;
+	}
+
+	bool MsgPackDeserializer::ReadPayload(std::string_view& value, size_t size)
+	{
+		if ((size_t)(mEnd - mCurrent) < size)
+		{
+			return SetError("Unexpected end of input");
+		}
+
+		value = std::string_view((const char*)mCurrent, size);
+		mCurrent += size;
+		return true;
+	}
+
+	bool MsgPackDeserializer::BeginContainer(uint64_t size, bool isMap)
+	{
+		// Every value takes at least one byte, which rejects bogus sizes before anything gets allocated for them.
+		if ((isMap ? size * 2 : size) > (uint64_t)(mEnd - mCurrent))
+		{
+			return SetError("Map or array is bigger than the input");
+		}
+
+		mRemaining.push_back(size);
+		return true;
+	}
+
+	bool MsgPackDeserializer::NextItem()
+	{
+		if (mError || mRemaining.empty())
+		{
+			return false;
+		}
+
+		if (mRemaining.back() == 0)
+		{
+			mRemaining.pop_back();
+			return false;
+		}
+
+		--mRemaining.back();
+		return true;
+	}
+
+	bool MsgPackDeserializer::SetError(const char* message)
+	{
+		if (!mError)
+		{
+			mError = true;
+			CPPREFL_INTERNAL_LOG(LogLevel::Error, "MessagePack parse error at offset %zu: %s", (size_t)(mCurrent - mBegin), message);
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Reader.h"
+
+namespace cpprefl::msgpack
+{
+	// MessagePack reader. Values are decoded on demand straight out of the input buffer, so no DOM is ever built.
+	// The input must outlive the reader: strings and binary values (which read as strings) are returned as views into it.
+	//
+	// Map keys must be strings or integers, integer keys are read as their decimal string (the way the Serializer writes the
+	// keys of integer maps). Extension values can only be skipped.
+	class MsgPackDeserializer : public serialization::IReader
+	{
+	public:
+		MsgPackDeserializer(const void* data, size_t size);
+
+		serialization::ValueType PeekValue() override;
+
+		bool BeginObject() override;
+		bool NextKey(std::string_view& key) override;
+
+		bool BeginArray() override;
+		bool NextElement() override;
+
+		bool ReadNull() override;
+		bool ReadBool(bool& value) override;
+		bool ReadInt(int64_t& value) override;
+		bool ReadUInt(uint64_t& value) override;
+		bool ReadDouble(double& value) override;
+		bool ReadString(std::string_view& value) override;
+
+		bool SkipValue() override;
+
+		bool SplitArray(size_t chunkSize, std::vector<std::unique_ptr<serialization::IReader>>& chunks, size_t& elementCount) override;
+
+		bool HasError()const override { return mError; }
+
+		// Returns true if the whole input has been read.
+		bool IsAtEnd()const { return mCurrent == mEnd; }
+
+	private:
+		enum class TokenKind : uint8_t
+		{
+			Null,
+			Bool,
+			UInt,
+			Int,
+			Double,
+			String,
+			Array,
+			Map,
+			Extension,
+		};
+
+		// A decoded value header. Strings, binary and extension values include their payload.
+		struct Token
+		{
+			TokenKind mKind;
+
+			union
+			{
+				bool mBool;
+				int64_t mInt;
+				double mDouble;
+
+				// Also the number of elements (or key/value pairs) of arrays and maps.
+				uint64_t mUInt;
+			};
+
+			std::string_view mString;
+		};
+
+		// Reads the given number of elements of an array between begin and end. See SplitArray().
+		MsgPackDeserializer(const std::byte* document, const std::byte* begin, const std::byte* end, size_t elementCount);
+
+		bool ReadToken(Token& token);
+
+		// Reads a big endian number of the given size.
+		bool ReadBigEndian(uint64_t& value, size_t size);
+
+		// Reads a string, binary or extension payload of the given size.
+		bool ReadPayload(std::string_view& value, size_t size);
+
+		// Enters a map/array of the given size, checking that the input is big enough to hold its keys and values.
+		bool BeginContainer(uint64_t size, bool isMap);
+
+		// Moves to the next key/element of the current map/array.
+		bool NextItem();
+
+		bool SetError(const char* message);
+
+		const std::byte* mBegin;
+		const std::byte* mCurrent;
+		const std::byte* mEnd;
+
+		// Number of elements (or key/value pairs) left in each map/array that is being read.
+		std::vector<uint64_t> mRemaining;
+
+		bool mError = false;
+
+		// Holds integer map keys converted to strings.
+		char mKeyScratch[24];
+	};
+}
@@ -0,0 +1,248 @@
+#include "MsgPackSerializer.h"
+
+#include <cstring>
+
+namespace cpprefl::msgpack
+{
+	namespace
+	{
+		// Size of the largest map/array header (map 32/array 32), reserved until the size of the container is known.
+		constexpr size_t MaxContainerHeaderSize = 5;
+	}
+
+	void MsgPackSerializer::BeginObject()
+	{
+		BeginValue();
+		BeginContainer(true);
+	}
+
+	void MsgPackSerializer::Key(std::string_view key)
+	{
+		++mContainers.back().mSize;
+		WriteStringHeader(key.size());
+		Append(key.data(), key.size());
+	}
+
+	void MsgPackSerializer::EndObject()
+	{
+		EndContainer(0x80, 0xde, 0xdf);
+	}
+
+	void MsgPackSerializer::BeginArray()
+	{
+		BeginValue();
+		BeginContainer(false);
+	}
+
+	void MsgPackSerializer::EndArray()
+	{
+		EndContainer(0x90, 0xdc, 0xdd);
+	}
+
+	void MsgPackSerializer::WriteNull()
+	{
+		BeginValue();
+		Append(0xc0);
+	}
+
+	void MsgPackSerializer::WriteBool(bool value)
+	{
+		BeginValue();
+		Append(value ? 0xc3 : 0xc2);
+	}
+
+	void MsgPackSerializer::WriteInt(int64_t value)
+	{
+		if (value >= 0)
+		{
+			WriteUInt((uint64_t)value);
+			return;
+		}
+
+		BeginValue();
+		if (value >= -32)
+		{
+			// Negative fixint.
+			Append((uint8_t)value);
+		}
+		else if (value >= INT8_MIN)
+		{
+			WritePrefixed(0xd0, (uint64_t)value, 1);
+		}
+		else if (value >= INT16_MIN)
+		{
+			WritePrefixed(0xd1, (uint64_t)value, 2);
+		}
+		else if (value >= INT32_MIN)
+		{
+			WritePrefixed(0xd2, (uint64_t)value, 4);
+		}
+		else
+		{
+			WritePrefixed(0xd3, (uint64_t)value, 8);
+		}
+	}
+
+	void MsgPackSerializer::WriteUInt(uint64_t value)
+	{
+		BeginValue();
+		if (value < 0x80)
+		{
+			// Positive fixint.
+			Append((uint8_t)value);
+		}
+		else if (value <= UINT8_MAX)
+		{
+			WritePrefixed(0xcc, value, 1);
+		}
+		else if (value <= UINT16_MAX)
+		{
+			WritePrefixed(0xcd, value, 2);
+		}
+		else if (value <= UINT32_MAX)
+		{
+			WritePrefixed(0xce, value, 4);
+		}
+		else
+		{
+			WritePrefixed(0xcf, value, 8);
+		}
+	}
+
+	void MsgPackSerializer::WriteFloat(float value)
+	{
+		BeginValue();
+
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		WritePrefixed(0xca, bits, 4);
+	}
+
+	void MsgPackSerializer::WriteDouble(double value)
+	{
+		BeginValue();
+
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		WritePrefixed(0xcb, bits, 8);
+	}
+
+	void MsgPackSerializer::WriteString(std::string_view value)
+	{
+		BeginValue();
+		WriteStringHeader(value.size());
+		Append(value.data(), value.size());
+	}
+
+	void MsgPackSerializer::WriteBinary(const void* data, size_t size)
+	{
+		BeginValue();
+		if (size <= UINT8_MAX)
+		{
+			WritePrefixed(0xc4, size, 1);
+		}
+		else if (size <= UINT16_MAX)
+		{
+			WritePrefixed(0xc5, size, 2);
+		}
+		else
+		{
+			WritePrefixed(0xc6, size, 4);
+		}
+
+		Append(data, size);
+	}
+
+	void MsgPackSerializer::BeginContainer(bool isObject)
+	{
+		mContainers.push_back({ mBuffer.size(), 0, isObject });
+		mBuffer.resize(mBuffer.size() + MaxContainerHeaderSize);
+	}
+
+	void MsgPackSerializer::EndContainer(uint8_t fixPrefix, uint8_t prefix16, uint8_t prefix32)
+	{
+		const Container container = mContainers.back();
+		mContainers.pop_back();
+
+		// Encode the real header, then move the contents down over the bytes it doesn't use.
+		std::byte header[MaxContainerHeaderSize];
+		size_t headerSize;
+		if (container.mSize < 16)
+		{
+			header[0] = (std::byte)(fixPrefix | container.mSize);
+			headerSize = 1;
+		}
+		else if (container.mSize <= UINT16_MAX)
+		{
+			header[0] = (std::byte)prefix16;
+			header[1] = (std::byte)(container.mSize >> 8);
+			header[2] = (std::byte)container.mSize;
+			headerSize = 3;
+		}
+		else
+		{
+			header[0] = (std::byte)prefix32;
+			header[1] = (std::byte)(container.mSize >> 24);
+			header[2] = (std::byte)(container.mSize >> 16);
+			header[3] = (std::byte)(container.mSize >> 8);
+			header[4] = (std::byte)container.mSize;
+			headerSize = 5;
+		}
+
+		std::byte* headerStart = mBuffer.data() + container.mHeaderOffset;
+		const size_t contentSize = mBuffer.size() - container.mHeaderOffset - MaxContainerHeaderSize;
+		if (headerSize != MaxContainerHeaderSize)
+		{
+			std::memmove(headerStart + headerSize, headerStart + MaxContainerHeaderSize, contentSize);
+			mBuffer.resize(mBuffer.size() - (MaxContainerHeaderSize - headerSize));
+		}
+
+		std::memcpy(headerStart, header, headerSize);
+	}
+
+	void MsgPackSerializer::BeginValue()
+	{
+		if (!mContainers.empty() && !mContainers.back().mIsObject)
+		{
+			++mContainers.back().mSize;
+		}
+	}
+
+	void MsgPackSerializer::WriteStringHeader(size_t size)
+	{
+		if (size < 32)
+		{
+			Append((uint8_t)(0xa0 | size));
+		}
+		else if (size <= UINT8_MAX)
+		{
+			WritePrefixed(0xd9, size, 1);
+		}
+		else if (size <= UINT16_MAX)
+		{
+			WritePrefixed(0xda, size, 2);
+		}
+		else
+		{
+			WritePrefixed(0xdb, size, 4);
+		}
+	}
+
+	void MsgPackSerializer::WritePrefixed(uint8_t prefix, uint64_t value, size_t size)
+	{
+		std::byte bytes[9];
+		bytes[0] = (std::byte)prefix;
+		for (size_t i = 0; i < size; ++i)
+		{
+			bytes[size - i] = (std::byte)(value >> (i * 8));
+		}
+
+		Append(bytes, size + 1);
+	}
+
+	void MsgPackSerializer::Append(const void* data, size_t size)
+	{
+		const std::byte* bytes = (const std::byte*)data;
+		mBuffer.insert(mBuffer.end(), bytes, bytes + size);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Writer.h"
+
+namespace cpprefl::msgpack
+{
+	// MessagePack writer. Values are encoded straight into a single buffer that grows as needed, using the smallest encoding
+	// for each integer, string and container size. Floats are written as float 32, doubles as float 64.
+	//
+	// MessagePack prefixes maps and arrays with their size, which the writer interface doesn't know up front. Each object/array
+	// reserves room for the largest header, which is moved down over the unused bytes once the container ends.
+	class MsgPackSerializer : public serialization::IWriter
+	{
+	public:
+		void BeginObject() override;
+		void Key(std::string_view key) override;
+		void EndObject() override;
+
+		void BeginArray() override;
+		void EndArray() override;
+
+		void WriteNull() override;
+		void WriteBool(bool value) override;
+		void WriteInt(int64_t value) override;
+		void WriteUInt(uint64_t value) override;
+		void WriteFloat(float value) override;
+		void WriteDouble(double value) override;
+		void WriteString(std::string_view value) override;
+
+		// Writes a binary value (bin 8/16/32), which the MsgPackDeserializer reads back as a string.
+		void WriteBinary(const void* data, size_t size);
+
+		// Returns everything written so far. Only complete once every object/array has ended.
+		const std::vector<std::byte>& GetBuffer()const { return mBuffer; }
+
+		// Discards all output, keeping the buffer around for reuse.
+		void Clear() { mBuffer.clear(); mContainers.clear(); }
+
+	private:
+		// An object/array that hasn't ended yet.
+		struct Container
+		{
+			// Offset of the reserved header in the buffer.
+			size_t mHeaderOffset;
+
+			// Number of elements, or key/value pairs, written so far.
+			uint32_t mSize;
+
+			bool mIsObject;
+		};
+
+		void BeginContainer(bool isObject);
+		void EndContainer(uint8_t fixPrefix, uint8_t prefix16, uint8_t prefix32);
+
+		// Counts a value towards the current array. Values in objects are counted by their keys.
+		void BeginValue();
+
+		void WriteStringHeader(size_t size);
+
+		// Writes a prefix byte followed by a big endian number of the given size.
+		void WritePrefixed(uint8_t prefix, uint64_t value, size_t size);
+
+		void Append(uint8_t byte) { mBuffer.push_back((std::byte)byte); }
+		void Append(const void* data, size_t size);
+
+		std::vector<std::byte> mBuffer;
+
+		std::vector<Container> mContainers;
+	};
+}
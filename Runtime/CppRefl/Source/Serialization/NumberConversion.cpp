@@ -0,0 +1,454 @@
+#include "NumberConversion.h"
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "CpuFeatures.h"
+
+#if CPPREFL_WITH_SIMD()
+#include <immintrin.h>
+#endif
+
+namespace cpprefl::serialization
+{
+	namespace
+	{
+		using ConvertFunction = size_t(*)(const void* source, void* destination, size_t count);
+
+		// Calls the visitor with a value of the C++ type of a number kind.
+		template <typename Visitor>
+		ConvertFunction VisitNumberType(TypeKind kind, Visitor&& visitor)
+		{
+			switch (kind)
+			{
+			case TypeKind::Uint8: return visitor(uint8_t());
+			case TypeKind::Int8: return visitor(int8_t());
+			case TypeKind::Uint16: return visitor(uint16_t());
+			case TypeKind::Int16: return visitor(int16_t());
+			case TypeKind::Uint32: return visitor(uint32_t());
+			case TypeKind::Int32: return visitor(int32_t());
+			case TypeKind::Uint64: return visitor(uint64_t());
+			case TypeKind::Int64: return visitor(int64_t());
+			case TypeKind::Float: return visitor(float());
+			case TypeKind::Double: return visitor(double());
+			case TypeKind::LongDouble: return visitor((long double)0);
+			default: return nullptr;
+			}
+		}
+
+		// Converts a single value. Returns false if it doesn't fit.
+		template <typename Source, typename Destination, bool Saturate>
+		bool ConvertValue(Source value, Destination& result)
+		{
+			using Limits = std::numeric_limits<Destination>;
+
+			if constexpr (std::is_integral_v<Source> && std::is_integral_v<Destination>)
+			{
+				const bool fits = std::in_range<Destination>(value);
+				result = Saturate && !fits ? (value < 0 ? Limits::min() : Limits::max()) : (Destination)value;
+				return fits;
+			}
+			else if constexpr (std::is_integral_v<Source> || sizeof(Destination) >= sizeof(Source))
+			{
+				result = (Destination)value;
+				return true;
+			}
+			else if constexpr (std::is_floating_point_v<Destination>)
+			{
+				result = (Destination)value;
+				const bool fits = !std::isinf(result) || std::isinf(value);
+				if (Saturate && !fits)
+				{
+					result = value < 0 ? Limits::lowest() : Limits::max();
+				}
+				return fits;
+			}
+			else
+			{
+				// Fractions are dropped, so anything between the neighbours of the limits fits. NaN doesn't.
+				const bool fits = (long double)value > (long double)Limits::min() - 1 && (long double)value < (long double)Limits::max() + 1;
+				if constexpr (Saturate)
+				{
+					result = fits ? (Destination)value : std::isnan(value) ? 0 : value < 0 ? Limits::min() : Limits::max();
+				}
+				else
+				{
+					constexpr long double Int64Limit = 9223372036854775808.0L;
+					result = (long double)value >= -Int64Limit && (long double)value < Int64Limit ? (Destination)(int64_t)value : 0;
+				}
+				return fits;
+			}
+		}
+
+		template <typename Source, typename Destination, bool Saturate>
+		size_t ConvertScalar(const void* source, void* destination, size_t count)
+		{
+			if constexpr (std::is_same_v<Source, Destination>)
+			{
+				std::memmove(destination, source, count * sizeof(Source));
+				return 0;
+			}
+			else
+			{
+				size_t overflowCount = 0;
+				for (size_t i = 0; i < count; ++i)
+				{
+					Source value;
+					std::memcpy(&value, (const std::byte*)source + i * sizeof(Source), sizeof(Source));
+
+					Destination result;
+					overflowCount += !ConvertValue<Source, Destination, Saturate>(value, result);
+					std::memcpy((std::byte*)destination + i * sizeof(Destination), &result, sizeof(Destination));
+				}
+
+				return overflowCount;
+			}
+		}
+
+		ConvertFunction GetScalarFunction(TypeKind sourceKind, TypeKind destinationKind, bool saturate)
+		{
+			return VisitNumberType(sourceKind, [&](auto source)
+			{
+				return VisitNumberType(destinationKind, [&](auto destination) -> ConvertFunction
+				{
+					using Source = decltype(source);
+					using Destination = decltype(destination);
+					return saturate ? ConvertScalar<Source, Destination, true> : ConvertScalar<Source, Destination, false>;
+				});
+			});
+		}
+
+#if CPPREFL_WITH_SIMD()
+		// Narrows 64 bit integers to smaller ones, four at a time.
+		template <typename Source, typename Destination, bool Saturate>
+		CPPREFL_INTERNAL_TARGET("avx2")
+		size_t NarrowIntegersAvx2(const void* source, void* destination, size_t count)
+		{
+			// The range of values that fit, in terms of the source type.
+			constexpr Source Lower = std::in_range<Source>(std::numeric_limits<Destination>::min()) ? (Source)std::numeric_limits<Destination>::min() : 0;
+			constexpr Source Upper = (Source)std::numeric_limits<Destination>::max();
+
+			// Unsigned values are compared as signed ones with their top bit flipped.
+			const __m256i flip = _mm256_set1_epi64x(std::is_signed_v<Source> ? 0 : std::numeric_limits<int64_t>::min());
+			const __m256i lower = _mm256_set1_epi64x((int64_t)Lower);
+			const __m256i upper = _mm256_set1_epi64x((int64_t)Upper);
+			const __m256i flippedLower = _mm256_xor_si256(lower, flip);
+			const __m256i flippedUpper = _mm256_xor_si256(upper, flip);
+
+			// Picks the low half of each 64 bit value, then the low bytes of those for smaller types.
+			const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+			const __m128i lowBytes = sizeof(Destination) == 2 ?
+				_mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1) :
+				_mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+			const std::byte* sourceBytes = (const std::byte*)source;
+			std::byte* destinationBytes = (std::byte*)destination;
+
+			size_t overflowCount = 0;
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m256i values = _mm256_loadu_si256((const __m256i*)(sourceBytes + i * sizeof(Source)));
+
+				const __m256i flipped = _mm256_xor_si256(values, flip);
+				const __m256i tooLarge = _mm256_cmpgt_epi64(flipped, flippedUpper);
+				const __m256i tooSmall = _mm256_cmpgt_epi64(flippedLower, flipped);
+				overflowCount += std::popcount((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_or_si256(tooLarge, tooSmall))));
+
+				if constexpr (Saturate)
+				{
+					values = _mm256_blendv_epi8(values, upper, tooLarge);
+					values = _mm256_blendv_epi8(values, lower, tooSmall);
+				}
+
+				const __m128i narrowed = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(values, lowHalves));
+				std::byte* output = destinationBytes + i * sizeof(Destination);
+				if constexpr (sizeof(Destination) == 4)
+				{
+					_mm_storeu_si128((__m128i*)output, narrowed);
+				}
+				else if constexpr (sizeof(Destination) == 2)
+				{
+					_mm_storel_epi64((__m128i*)output, _mm_shuffle_epi8(narrowed, lowBytes));
+				}
+				else
+				{
+					const int32_t packed = _mm_cvtsi128_si32(_mm_shuffle_epi8(narrowed, lowBytes));
+					std::memcpy(output, &packed, sizeof(packed));
+				}
+			}
+
+			return overflowCount + ConvertScalar<Source, Destination, Saturate>(sourceBytes + i * sizeof(Source), destinationBytes + i * sizeof(Destination), count - i);
+		}
+
+		// Widens integers to 64 bits (keeping their signedness), four at a time.
+		template <typename Source, typename Destination>
+		CPPREFL_INTERNAL_TARGET("avx2")
+		size_t WidenIntegersAvx2(const void* source, void* destination, size_t count)
+		{
+			const std::byte* sourceBytes = (const std::byte*)source;
+			std::byte* destinationBytes = (std::byte*)destination;
+
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i values = _mm_setzero_si128();
+				std::memcpy(&values, sourceBytes + i * sizeof(Source), 4 * sizeof(Source));
+
+				__m256i widened;
+				if constexpr (sizeof(Source) == 4)
+				{
+					widened = std::is_signed_v<Source> ? _mm256_cvtepi32_epi64(values) : _mm256_cvtepu32_epi64(values);
+				}
+				else if constexpr (sizeof(Source) == 2)
+				{
+					widened = std::is_signed_v<Source> ? _mm256_cvtepi16_epi64(values) : _mm256_cvtepu16_epi64(values);
+				}
+				else
+				{
+					widened = std::is_signed_v<Source> ? _mm256_cvtepi8_epi64(values) : _mm256_cvtepu8_epi64(values);
+				}
+
+				_mm256_storeu_si256((__m256i*)(destinationBytes + i * sizeof(Destination)), widened);
+			}
+
+			return ConvertScalar<Source, Destination, false>(sourceBytes + i * sizeof(Source), destinationBytes + i * sizeof(Destination), count - i);
+		}
+
+		template <bool Saturate>
+		CPPREFL_INTERNAL_TARGET("avx2")
+		size_t DoubleToFloatAvx2(const void* source, void* destination, size_t count)
+		{
+			const __m256d max = _mm256_set1_pd(std::numeric_limits<float>::max());
+			const __m256d lowest = _mm256_set1_pd(std::numeric_limits<float>::lowest());
+			const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(std::numeric_limits<int64_t>::max()));
+			const __m256d infinity = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+			const __m128 floatAbsMask = _mm_castsi128_ps(_mm_set1_epi32(std::numeric_limits<int32_t>::max()));
+			const __m128 floatInfinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+
+			const double* input = (const double*)source;
+			float* output = (float*)destination;
+
+			size_t overflowCount = 0;
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m256d values = _mm256_loadu_pd(input + i);
+				__m128 result = _mm256_cvtpd_ps(values);
+
+				// Finite values that became infinite didn't fit.
+				const __m256d absValues = _mm256_and_pd(values, absMask);
+				const __m256d finite = _mm256_cmp_pd(absValues, infinity, _CMP_LT_OQ);
+				const int infinite = _mm_movemask_ps(_mm_cmpeq_ps(_mm_and_ps(result, floatAbsMask), floatInfinity));
+				const int overflow = _mm256_movemask_pd(finite) & infinite;
+				overflowCount += std::popcount((uint32_t)overflow);
+
+				if (Saturate && overflow != 0)
+				{
+					// Only finite values are clamped, infinity and NaN are kept.
+					const __m256d clamp = _mm256_and_pd(finite, _mm256_cmp_pd(absValues, max, _CMP_GT_OQ));
+					values = _mm256_blendv_pd(values, _mm256_max_pd(lowest, _mm256_min_pd(max, values)), clamp);
+					result = _mm256_cvtpd_ps(values);
+				}
+
+				_mm_storeu_ps(output + i, result);
+			}
+
+			return overflowCount + ConvertScalar<double, float, Saturate>(input + i, output + i, count - i);
+		}
+
+		CPPREFL_INTERNAL_TARGET("avx2")
+		size_t FloatToDoubleAvx2(const void* source, void* destination, size_t count)
+		{
+			const float* input = (const float*)source;
+			double* output = (double*)destination;
+
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				_mm256_storeu_pd(output + i, _mm256_cvtps_pd(_mm_loadu_ps(input + i)));
+			}
+
+			return ConvertScalar<float, double, false>(input + i, output + i, count - i);
+		}
+
+		template <bool Saturate>
+		CPPREFL_INTERNAL_TARGET("avx2")
+		size_t DoubleToInt32Avx2(const void* source, void* destination, size_t count)
+		{
+			const __m256d aboveMin = _mm256_set1_pd(-2147483649.0);
+			const __m256d belowMax = _mm256_set1_pd(2147483648.0);
+			const __m256d min = _mm256_set1_pd(-2147483648.0);
+			const __m256d max = _mm256_set1_pd(2147483647.0);
+
+			const double* input = (const double*)source;
+			int32_t* output = (int32_t*)destination;
+
+			size_t overflowCount = 0;
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m256d values = _mm256_loadu_pd(input + i);
+
+				const __m256d fits = _mm256_and_pd(_mm256_cmp_pd(values, aboveMin, _CMP_GT_OQ), _mm256_cmp_pd(values, belowMax, _CMP_LT_OQ));
+				const int fitMask = _mm256_movemask_pd(fits);
+				if (fitMask != 0xf)
+				{
+					if constexpr (!Saturate)
+					{
+						// Values that don't fit are truncated through an Int64, which there is no instruction for.
+						overflowCount += ConvertScalar<double, int32_t, false>(input + i, output + i, 4);
+						continue;
+					}
+
+					overflowCount += 4 - std::popcount((uint32_t)fitMask);
+
+					// NaN becomes zero, everything else is clamped.
+					values = _mm256_and_pd(values, _mm256_cmp_pd(values, values, _CMP_ORD_Q));
+					values = _mm256_min_pd(_mm256_max_pd(values, min), max);
+				}
+
+				_mm_storeu_si128((__m128i*)(output + i), _mm256_cvttpd_epi32(values));
+			}
+
+			return overflowCount + ConvertScalar<double, int32_t, Saturate>(input + i, output + i, count - i);
+		}
+
+		CPPREFL_INTERNAL_TARGET("avx2")
+		size_t Int32ToDoubleAvx2(const void* source, void* destination, size_t count)
+		{
+			const int32_t* input = (const int32_t*)source;
+			double* output = (double*)destination;
+
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				_mm256_storeu_pd(output + i, _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(input + i))));
+			}
+
+			return ConvertScalar<int32_t, double, false>(input + i, output + i, count - i);
+		}
+
+		CPPREFL_INTERNAL_TARGET("avx2")
+		size_t Int32ToFloatAvx2(const void* source, void* destination, size_t count)
+		{
+			const int32_t* input = (const int32_t*)source;
+			float* output = (float*)destination;
+
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm256_storeu_ps(output + i, _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(input + i))));
+			}
+
+			return ConvertScalar<int32_t, float, false>(input + i, output + i, count - i);
+		}
+
+		// Returns the AVX2 kernel for a conversion, or nullptr if there is none.
+		ConvertFunction GetAvx2Function(TypeKind sourceKind, TypeKind destinationKind, bool saturate)
+		{
+			return VisitNumberType(sourceKind, [&](auto source)
+			{
+				return VisitNumberType(destinationKind, [&](auto destination) -> ConvertFunction
+				{
+					using Source = decltype(source);
+					using Destination = decltype(destination);
+
+					if constexpr (std::is_integral_v<Source> && std::is_integral_v<Destination>)
+					{
+						// Values read as Int64/Uint64 into integer fields.
+						if constexpr (sizeof(Source) == 8 && sizeof(Destination) < 8)
+						{
+							return saturate ? NarrowIntegersAvx2<Source, Destination, true> : NarrowIntegersAvx2<Source, Destination, false>;
+						}
+
+						// Integer fields written as Int64/Uint64.
+						if constexpr (sizeof(Source) < 8 && sizeof(Destination) == 8 && std::is_signed_v<Source> == std::is_signed_v<Destination>)
+						{
+							return WidenIntegersAvx2<Source, Destination>;
+						}
+					}
+
+					if constexpr (std::is_same_v<Source, double> && std::is_same_v<Destination, float>)
+					{
+						return saturate ? DoubleToFloatAvx2<true> : DoubleToFloatAvx2<false>;
+					}
+
+					if constexpr (std::is_same_v<Source, float> && std::is_same_v<Destination, double>)
+					{
+						return FloatToDoubleAvx2;
+					}
+
+					if constexpr (std::is_same_v<Source, double> && std::is_same_v<Destination, int32_t>)
+					{
+						return saturate ? DoubleToInt32Avx2<true> : DoubleToInt32Avx2<false>;
+					}
+
+					if constexpr (std::is_same_v<Source, int32_t> && std::is_same_v<Destination, double>)
+					{
+						return Int32ToDoubleAvx2;
+					}
+
+					if constexpr (std::is_same_v<Source, int32_t> && std::is_same_v<Destination, float>)
+					{
+						return Int32ToFloatAvx2;
+					}
+
+					return nullptr;
+				});
+			});
+		}
+#endif
+
+		ConversionKernel& GetKernel()
+		{
+			static ConversionKernel kernel = GetCpuFeatures().mAvx2 ? ConversionKernel::Avx2 : ConversionKernel::Scalar;
+			return kernel;
+		}
+	}
+
+	ConversionKernel GetConversionKernel()
+	{
+		return GetKernel();
+	}
+
+	bool SetConversionKernel(ConversionKernel kernel)
+	{
+		if (kernel == ConversionKernel::Avx2 && !GetCpuFeatures().mAvx2)
+		{
+			return false;
+		}
+
+		GetKernel() = kernel;
+		return true;
+	}
+
+	bool IsNumberKind(TypeKind kind)
+	{
+		return IsIntegerType(kind) || IsFloatingPointType(kind);
+	}
+
+	size_t ConvertNumbers(TypeKind sourceKind, const void* source, TypeKind destinationKind, void* destination, size_t count, NumberOverflow overflow)
+	{
+		const bool saturate = overflow == NumberOverflow::Saturate;
+
+		ConvertFunction function = nullptr;
+#if CPPREFL_WITH_SIMD()
+		if (GetKernel() == ConversionKernel::Avx2)
+		{
+			function = GetAvx2Function(sourceKind, destinationKind, saturate);
+		}
+#endif
+
+		if (function == nullptr)
+		{
+			function = GetScalarFunction(sourceKind, destinationKind, saturate);
+		}
+
+		return function != nullptr && count > 0 ? function(source, destination, count) : 0;
+	}
+}
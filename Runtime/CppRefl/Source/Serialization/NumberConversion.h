@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "../Reflection/TypeInfo.h"
+
+namespace cpprefl::serialization
+{
+	// Instruction set used to convert arrays of numbers.
+	enum class ConversionKernel : uint8_t
+	{
+		Scalar,
+		Avx2,
+	};
+
+	// Returns the kernel currently in use. Defaults to the best kernel the CPU supports.
+	ConversionKernel GetConversionKernel();
+
+	// Overrides the kernel (e.g. to compare kernels). Returns false, and leaves the kernel unchanged, if the CPU doesn't support it.
+	bool SetConversionKernel(ConversionKernel kernel);
+
+	// What happens to values that don't fit the kind they are converted to.
+	enum class NumberOverflow : uint8_t
+	{
+		// Integers keep their low bits, the way a cast does. Floating point values are rounded towards zero and converted as an
+		// Int64 (zero if they don't fit one, or are NaN), and too large values become infinity when narrowed to a float.
+		Truncate,
+
+		// Values are clamped to the closest value that fits. NaN becomes zero when converted to an integer.
+		Saturate,
+	};
+
+	// Converts a double to an integer, truncating the fraction and clamping out of range values, the same as a NumberOverflow::Saturate
+	// conversion of a single value (NaN becomes zero).
+	template <typename T>
+	T TruncateDouble(double value)
+	{
+		if (value != value)
+		{
+			return 0;
+		}
+
+		if (value <= (double)std::numeric_limits<T>::min())
+		{
+			return std::numeric_limits<T>::min();
+		}
+
+		if (value >= (double)std::numeric_limits<T>::max())
+		{
+			return std::numeric_limits<T>::max();
+		}
+
+		return (T)value;
+	}
+
+	// Returns true if values of this kind can be converted by ConvertNumbers() (integers and floating point values).
+	bool IsNumberKind(TypeKind kind);
+
+	// Converts an array of numbers from one kind to another. Neither array needs to be aligned, but they can't overlap unless
+	// both kinds are the same. Fractions are dropped when converting to an integer, and integers are rounded to the nearest
+	// value when converting to a floating point kind, neither of which counts as an overflow.
+	// Returns the number of values that didn't fit the destination kind, see NumberOverflow for what happens to them.
+	size_t ConvertNumbers(TypeKind sourceKind, const void* source, TypeKind destinationKind, void* destination, size_t count, NumberOverflow overflow = NumberOverflow::Truncate);
+}
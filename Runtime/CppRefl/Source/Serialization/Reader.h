@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace cpprefl::serialization
+{
+	// The kind of value a reader is positioned at.
+	enum class ValueType : uint8_t
+	{
+		Invalid = 0, // End of input or malformed data.
+
+		Null,
+		Bool,
+		Number,
+		String,
+		Object,
+		Array,
+	};
+
+	// Pull interface over a serialized document. The Deserializer drives the reader, so values are decoded straight into
+	// their final location without building an intermediate document.
+	//
+	// Objects are read with BeginObject() followed by NextKey() until it returns false, reading (or skipping) one value after each key.
+	// Arrays are read with BeginArray() followed by NextElement() until it returns false, reading (or skipping) one value after each call.
+	// All functions return false on malformed input, after which HasError() is true and every other call fails.
+	class IReader
+	{
+	public:
+		virtual ~IReader() = default;
+
+		// Returns the type of the next value without consuming it.
+		virtual ValueType PeekValue() = 0;
+
+		// Enters an object.
+		virtual bool BeginObject() = 0;
+
+		// Moves to the next key of the current object. Returns false at the end of the object.
+		// The key is only valid until the next call to the reader.
+		virtual bool NextKey(std::string_view& key) = 0;
+
+		// Enters an array.
+		virtual bool BeginArray() = 0;
+
+		// Moves to the next element of the current array. Returns false at the end of the array.
+		virtual bool NextElement() = 0;
+
+		// Reads a null value.
+		virtual bool ReadNull() = 0;
+
+		virtual bool ReadBool(bool& value) = 0;
+
+		// Reads a number. Any number can be read as any of these types, conversions truncate (e.g. 3.9 read as an integer is 3).
+		virtual bool ReadInt(int64_t& value) = 0;
+		virtual bool ReadUInt(uint64_t& value) = 0;
+		virtual bool ReadDouble(double& value) = 0;
+
+		// Reads a string. The string is only valid until the next call to the reader, and may point directly into the input.
+		virtual bool ReadString(std::string_view& value) = 0;
+
+		// Skips the next value (including any nested objects or arrays).
+		virtual bool SkipValue() = 0;
+
+		// Splits the rest of the current array (right after BeginArray()) into readers over consecutive runs of at most chunkSize
+		// elements, consuming the array. Each reader acts as if BeginArray() was just called on an array holding only its elements,
+		// and can be used on another thread, which lets large arrays be decoded in parallel.
+		// Readers that can't do this (e.g. over streamed input) return false without consuming anything.
+		virtual bool SplitArray(size_t chunkSize, std::vector<std::unique_ptr<IReader>>& chunks, size_t& elementCount) { return false; }
+
+		// Returns true if the input was malformed.
+		virtual bool HasError()const = 0;
+	};
+}
@@ -0,0 +1,1342 @@
+#include "Serializer.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include "DeserializationArena.h"
+#include "EnumNames.h"
+#include "GeneratedSerializer.h"
+#include "NumberConversion.h"
+#include "ThreadPool.h"
+
+namespace cpprefl::serialization
+{
+	namespace
+	{
+		constexpr const char* DynamicTypeKeyString = "__type__";
+		constexpr Name DynamicTypeKey = Name(DynamicTypeKeyString);
+
+		bool IsSignedType(TypeKind kind)
+		{
+			return kind == TypeKind::Int8 || kind == TypeKind::Int16 || kind == TypeKind::Int32 || kind == TypeKind::Int64;
+		}
+
+		// Returns the kind numbers are read as before they are stored in a value of the given kind.
+		TypeKind GetReadKind(TypeKind kind)
+		{
+			return IsFloatingPointType(kind) ? TypeKind::Double : IsSignedType(kind) ? TypeKind::Int64 : TypeKind::Uint64;
+		}
+
+		// Returns true if a dynamic array or view stores numbers contiguously, so that they can be converted at once.
+		template <typename Functions>
+		bool IsContiguousNumberArray(const Functions& functions)
+		{
+			const TypeInstanceInfo& elementType = functions.mElementType;
+			return !elementType.mIsPointer && !elementType.mIsArray && IsNumberKind(elementType.mType.mKind) &&
+				functions.mElementStride == elementType.mType.mSize;
+		}
+
+		// Old values of arrays of numbers being deserialized, to detect changes.
+		thread_local std::vector<std::byte> OldNumbers;
+
+		// Arrays of numbers being serialized, converted to the kind they are written as.
+		thread_local std::vector<uint64_t> WrittenNumbers;
+
+		// Writes a number into a value of the given kind, truncating it if necessary.
+		template <typename T>
+		bool StoreNumber(TypeKind kind, void* value, T number)
+		{
+			switch (kind)
+			{
+			case TypeKind::Uint8: *(uint8_t*)value = (uint8_t)number; return true;
+			case TypeKind::Int8: *(int8_t*)value = (int8_t)number; return true;
+			case TypeKind::Uint16: *(uint16_t*)value = (uint16_t)number; return true;
+			case TypeKind::Int16: *(int16_t*)value = (int16_t)number; return true;
+			case TypeKind::Uint32: *(uint32_t*)value = (uint32_t)number; return true;
+			case TypeKind::Int32: *(int32_t*)value = (int32_t)number; return true;
+			case TypeKind::Uint64: *(uint64_t*)value = (uint64_t)number; return true;
+			case TypeKind::Int64: *(int64_t*)value = (int64_t)number; return true;
+			case TypeKind::Float: *(float*)value = (float)number; return true;
+			case TypeKind::Double: *(double*)value = (double)number; return true;
+			case TypeKind::LongDouble: *(long double*)value = (long double)number; return true;
+			default: return false;
+			}
+		}
+
+		// Writes an enum value based on the size of the enum.
+		bool StoreEnum(const TypeInfo& type, void* value, int64_t number)
+		{
+			switch (type.mSize)
+			{
+			case 1: *(uint8_t*)value = (uint8_t)number; return true;
+			case 2: *(uint16_t*)value = (uint16_t)number; return true;
+			case 4: *(uint32_t*)value = (uint32_t)number; return true;
+			case 8: *(uint64_t*)value = (uint64_t)number; return true;
+			default: return false;
+			}
+		}
+
+		// Converts an object key into a map key (strings, integers and enums are supported).
+		bool ParseKey(std::string_view string, const TypeInstanceInfo& keyType, void* key)
+		{
+			const TypeInfo& type = keyType.mType;
+
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type))
+			{
+				static_cast<std::string*>(key)->assign(string);
+				return true;
+			}
+#endif
+
+			if (type.mKind == TypeKind::Enum)
+			{
+				const EnumInfo* enumInfo = type.GetEnumInfo();
+				const EnumValueInfo* enumValue = enumInfo != nullptr ? enumInfo->GetValue(Name(string.data(), string.size())) : nullptr;
+				return enumValue != nullptr && StoreEnum(type, key, enumValue->mValue);
+			}
+
+			if (IsIntegerType(type.mKind))
+			{
+				if (IsSignedType(type.mKind))
+				{
+					int64_t number;
+					const auto result = std::from_chars(string.data(), string.data() + string.size(), number);
+					return result.ec == std::errc() && StoreNumber(type.mKind, key, number);
+				}
+
+				uint64_t number;
+				const auto result = std::from_chars(string.data(), string.data() + string.size(), number);
+				return result.ec == std::errc() && StoreNumber(type.mKind, key, number);
+			}
+
+			return false;
+		}
+
+		// Reads an integer value of the given kind.
+		template <typename T>
+		T LoadInteger(TypeKind kind, const void* value)
+		{
+			switch (kind)
+			{
+			case TypeKind::Uint8: return (T)*(const uint8_t*)value;
+			case TypeKind::Int8: return (T)*(const int8_t*)value;
+			case TypeKind::Uint16: return (T)*(const uint16_t*)value;
+			case TypeKind::Int16: return (T)*(const int16_t*)value;
+			case TypeKind::Uint32: return (T)*(const uint32_t*)value;
+			case TypeKind::Int32: return (T)*(const int32_t*)value;
+			case TypeKind::Uint64: return (T)*(const uint64_t*)value;
+			case TypeKind::Int64: return (T)*(const int64_t*)value;
+			default: return 0;
+			}
+		}
+
+		// Converts a map key into an object key (strings, integers and enums are supported). Integers are formatted into the given buffer.
+		bool FormatKey(const TypeInstanceInfo& keyType, const void* key, char (&buffer)[32], std::string_view& string)
+		{
+			const TypeInfo& type = keyType.mType;
+
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type))
+			{
+				string = *static_cast<const std::string*>(key);
+				return true;
+			}
+#endif
+
+			if (type.mKind == TypeKind::Enum)
+			{
+				string = GetEnumValueName(type, LoadEnum(type, key));
+				return !string.empty();
+			}
+
+			if (IsIntegerType(type.mKind))
+			{
+				const auto result = IsSignedType(type.mKind) ?
+					std::to_chars(buffer, buffer + sizeof(buffer), LoadInteger<int64_t>(type.mKind, key)) :
+					std::to_chars(buffer, buffer + sizeof(buffer), LoadInteger<uint64_t>(type.mKind, key));
+
+				string = std::string_view(buffer, result.ptr - buffer);
+				return true;
+			}
+
+			return false;
+		}
+
+		// Map entries written while updating an object, so that entries missing from the input can be removed afterwards.
+		// Nested maps use it as a stack.
+		thread_local std::vector<const void*> VisitedEntries;
+
+		// Removes the entries of a map that weren't visited since the given index into VisitedEntries. Returns true if any were removed.
+		bool EraseUnvisitedEntries(const AssociativeArrayFunctions& functions, void* map, size_t firstVisitedEntry)
+		{
+			struct Context
+			{
+				const void* const* mVisitedBegin;
+				const void* const* mVisitedEnd;
+				std::vector<const void*> mKeys;
+			};
+
+			std::sort(VisitedEntries.begin() + firstVisitedEntry, VisitedEntries.end());
+			Context context{ VisitedEntries.data() + firstVisitedEntry, VisitedEntries.data() + VisitedEntries.size(), {} };
+
+			functions.mForEach(map, [](void* context, const void* key, void* value)
+			{
+				auto& visitContext = *static_cast<Context*>(context);
+				if (!std::binary_search(visitContext.mVisitedBegin, visitContext.mVisitedEnd, (const void*)value))
+				{
+					visitContext.mKeys.push_back(key);
+				}
+				return true;
+			}, &context);
+
+			// Entries of maps don't move when other entries are removed, so the keys stay valid.
+			for (const void* key : context.mKeys)
+			{
+				functions.mErase(map, key);
+			}
+
+			return !context.mKeys.empty();
+		}
+	}
+
+	void Deserializer::RegisterExtension(IObjectDeserializerExtension& extension)
+	{
+		mExtensions.push_back(&extension);
+	}
+
+	void Deserializer::SetThreadPool(ThreadPool* threadPool, size_t chunkSize)
+	{
+		mThreadPool = threadPool;
+		mChunkSize = std::max<size_t>(chunkSize, 1);
+	}
+
+	bool Deserializer::Deserialize(IReader& reader, const ClassInfo& classInfo, void* classObject)
+	{
+		bool changed = false;
+		return DeserializeObject(reader, classInfo, classObject, changed) && !reader.HasError();
+	}
+
+	bool Deserializer::Update(IReader& reader, const ClassInfo& classInfo, void* classObject)
+	{
+		mReuseMemory = true;
+		const bool success = Deserialize(reader, classInfo, classObject);
+		mReuseMemory = false;
+
+		return success;
+	}
+
+	bool Deserializer::DeserializeObject(IReader& reader, const ClassInfo& classInfo, void* classObject, bool& changed)
+	{
+		return reader.BeginObject() && DeserializeObjectFields(reader, classInfo, classObject, changed);
+	}
+
+	bool Deserializer::DeserializeObjectFields(IReader& reader, const ClassInfo& classInfo, void* classObject, bool& changed)
+	{
+		std::string_view key;
+		while (reader.NextKey(key))
+		{
+			// Hash the key in place, the reader's view is all we need.
+			if (!DeserializeField(reader, classInfo, classObject, Name(key.data(), key.size()), changed))
+			{
+				return false;
+			}
+		}
+
+		return !reader.HasError();
+	}
+
+	const FieldInfo* Deserializer::FindField(const ClassInfo& classInfo, void* classObject, const Name& fieldName)const
+	{
+		const FieldInfo* fieldInfo = classInfo.GetField(fieldName);
+		if (fieldInfo == nullptr || fieldInfo->mTypeInstance.mIsConst)
+		{
+			return nullptr;
+		}
+
+		for (IObjectDeserializerExtension* extension : mExtensions)
+		{
+			if (!extension->CanDeserialize(classObject, classInfo, *fieldInfo))
+			{
+				return nullptr;
+			}
+		}
+
+		return fieldInfo;
+	}
+
+	bool Deserializer::DeserializeFieldValue(IReader& reader, const ClassInfo& classInfo, void* classObject, const FieldInfo& fieldInfo, bool& changed)
+	{
+		return DeserializeField(reader, classInfo, classObject, fieldInfo, changed);
+	}
+
+	bool Deserializer::DeserializeFieldElement(IReader& reader, const ClassInfo& classInfo, void* classObject, const FieldInfo& fieldInfo, void* element, bool& changed)
+	{
+		const auto* functions = fieldInfo.GetContainerFunctions<DynamicArrayFunctions>();
+		if (functions == nullptr)
+		{
+			return false;
+		}
+
+		const FieldContext context{ classObject, classInfo, fieldInfo, changed };
+		return DeserializeValue(reader, context, functions->mElementType, nullptr, element);
+	}
+
+	void Deserializer::NotifyFieldChanged(void* classObject, const ClassInfo& classInfo, const FieldInfo& fieldInfo)
+	{
+		for (IObjectDeserializerExtension* extension : mExtensions)
+		{
+			extension->OnFieldChanged(classObject, classInfo, fieldInfo);
+		}
+	}
+
+	bool Deserializer::DeserializeField(IReader& reader, const ClassInfo& classInfo, void* classObject, const Name& fieldName, bool& changed)
+	{
+		const ClassSerializerFunctions* generatedFunctions = mUseGeneratedCode && mExtensions.empty() ? classInfo.GetSerializerFunctions() : nullptr;
+		return generatedFunctions != nullptr ?
+			generatedFunctions->mDeserializeField(*this, reader, classObject, fieldName, changed) :
+			DeserializeReflectedField(reader, classInfo, classObject, fieldName, changed);
+	}
+
+	bool Deserializer::DeserializeReflectedField(IReader& reader, const ClassInfo& classInfo, void* classObject, const Name& fieldName, bool& changed)
+	{
+		const FieldInfo* fieldInfo = FindField(classInfo, classObject, fieldName);
+		return fieldInfo != nullptr ?
+			DeserializeField(reader, classInfo, classObject, *fieldInfo, changed) :
+			reader.SkipValue();
+	}
+
+	bool Deserializer::DeserializeField(IReader& reader, const ClassInfo& classInfo, void* classObject, const FieldInfo& fieldInfo, bool& changed)
+	{
+		bool fieldChanged = false;
+		const FieldContext context{ classObject, classInfo, fieldInfo, fieldChanged };
+		if (!DeserializeValue(reader, context, fieldInfo.mTypeInstance, fieldInfo.mContainerFunctions, fieldInfo.GetMemoryInClass(classObject)))
+		{
+			return false;
+		}
+
+		if (fieldChanged)
+		{
+			NotifyFieldChanged(classObject, classInfo, fieldInfo);
+			changed = true;
+		}
+
+		return true;
+	}
+
+	bool Deserializer::DeserializeValue(IReader& reader, const FieldContext& context, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, void* value)
+	{
+		if (containerFunctions != nullptr)
+		{
+			return DeserializeContainer(reader, context, *containerFunctions, value);
+		}
+
+		if (type.IsFixedSizeCString())
+		{
+			std::string_view string;
+			if (!reader.ReadString(string))
+			{
+				return false;
+			}
+
+			// Truncate to fit, leaving room for the null terminator.
+			const size_t length = type.mArraySize > 0 ? std::min<size_t>(string.size(), type.mArraySize - 1) : 0;
+			if (std::memcmp(value, string.data(), length) != 0 || ((char*)value)[length] != 0)
+			{
+				std::memcpy(value, string.data(), length);
+				((char*)value)[length] = 0;
+				context.mChanged = true;
+			}
+
+			return true;
+		}
+
+		if (type.IsDynamicCString())
+		{
+			char*& currentString = *(char**)value;
+			if (reader.PeekValue() == ValueType::Null)
+			{
+				context.mChanged |= !mReuseMemory || currentString != nullptr;
+				FreeString(currentString);
+				return reader.ReadNull();
+			}
+
+			std::string_view string;
+			if (!reader.ReadString(string))
+			{
+				return false;
+			}
+
+			// Keep the current string if it's the same. Only objects being updated are known to hold valid strings.
+			if (mReuseMemory && currentString != nullptr && std::strlen(currentString) == string.size() && std::memcmp(currentString, string.data(), string.size()) == 0)
+			{
+				return true;
+			}
+
+			FreeString(currentString);
+
+			if (mArena != nullptr && mThreadPool != nullptr && mThreadPool->IsInParallelFor())
+			{
+				std::lock_guard<std::mutex> lock(mArena->GetMutex());
+				currentString = mArena->AllocateString(string);
+			}
+			else
+			{
+				currentString = CopyString(string, mArena);
+			}
+			context.mChanged = true;
+			return true;
+		}
+
+		if (type.mIsArray)
+		{
+			if (!reader.BeginArray())
+			{
+				return false;
+			}
+
+			if (!type.mIsPointer && IsNumberKind(type.mType.mKind))
+			{
+				size_t count;
+				if (!ReadNumberArray(reader, context, type.mType.mKind, type.mArraySize, count))
+				{
+					return false;
+				}
+
+				StoreNumberArray(context, type.mType, value, count);
+				return true;
+			}
+
+			const size_t stride = type.mIsPointer ? sizeof(void*) : type.mType.mSize;
+
+			ArraySizeType index = 0;
+			while (reader.NextElement())
+			{
+				// Skip any values that don't fit.
+				const bool success = index < type.mArraySize ?
+					DeserializeElement(reader, context, type.mType, type.mIsPointer, (std::byte*)value + index * stride) :
+					reader.SkipValue();
+
+				if (!success)
+				{
+					return false;
+				}
+
+				++index;
+			}
+
+			return !reader.HasError();
+		}
+
+		return DeserializeElement(reader, context, type.mType, type.mIsPointer, value);
+	}
+
+	bool Deserializer::DeserializeContainer(IReader& reader, const FieldContext& context, const ContainerFunctions& containerFunctions, void* value)
+	{
+		switch (containerFunctions.mKind)
+		{
+		case ContainerKind::DynamicArray:
+		{
+			const auto& functions = static_cast<const DynamicArrayFunctions&>(containerFunctions);
+			if (!reader.BeginArray())
+			{
+				return false;
+			}
+
+			// Only arrays of objects are worth splitting, since the array is scanned once more to find the element boundaries.
+			// Arrays inside of a chunk are decoded on the thread of the chunk.
+			if (mThreadPool != nullptr && !mThreadPool->IsInParallelFor() &&
+				functions.mElementType.mType.mKind == TypeKind::Class && functions.mElementType.mType.GetClassInfo() != nullptr)
+			{
+				std::vector<std::unique_ptr<IReader>> chunks;
+				size_t size;
+				if (reader.SplitArray(mChunkSize, chunks, size))
+				{
+					return DeserializeArrayChunks(chunks, size, context, functions, value);
+				}
+
+				if (reader.HasError())
+				{
+					return false;
+				}
+			}
+
+			// When updating, existing elements are overwritten and the rest are removed at the end. Otherwise the array is rebuilt,
+			// so any array that isn't empty before and after counts as changed.
+			const ArraySizeType oldSize = functions.mGetSize(value);
+
+			if (IsContiguousNumberArray(functions))
+			{
+				size_t count;
+				if (!ReadNumberArray(reader, context, functions.mElementType.mType.mKind, std::numeric_limits<ArraySizeType>::max(), count))
+				{
+					return false;
+				}
+
+				if (!mReuseMemory)
+				{
+					functions.mClear(value);
+				}
+				functions.mResize(value, (ArraySizeType)count);
+
+				context.mChanged |= mReuseMemory ? count != oldSize : count != 0 || oldSize != 0;
+				StoreNumberArray(context, functions.mElementType.mType, functions.mGetData(value), count);
+				return true;
+			}
+
+			if (!mReuseMemory)
+			{
+				functions.mClear(value);
+			}
+
+			ArraySizeType size = 0;
+			while (reader.NextElement())
+			{
+				void* element = size < oldSize && mReuseMemory ? functions.GetElement(value, size) : functions.mEmplaceBack(value);
+				if (!DeserializeValue(reader, context, functions.mElementType, nullptr, element))
+				{
+					return false;
+				}
+
+				++size;
+			}
+
+			if (size < functions.mGetSize(value))
+			{
+				// Objects behind pointers that are removed are owned by the array.
+				const ClassInfo* elementClass = functions.mElementType.mIsPointer && functions.mElementType.mType.mKind == TypeKind::Class ?
+					functions.mElementType.mType.GetClassInfo() : nullptr;
+				for (ArraySizeType i = size; elementClass != nullptr && i < functions.mGetSize(value); ++i)
+				{
+					FreeDynamicObject(*elementClass, *(void**)functions.GetElement(value, i));
+				}
+
+				functions.mResize(value, size);
+			}
+
+			context.mChanged |= mReuseMemory ? size != oldSize : size != 0 || oldSize != 0;
+			return !reader.HasError();
+		}
+
+		case ContainerKind::ArrayView:
+		{
+			const auto& functions = static_cast<const ArrayViewFunctions&>(containerFunctions);
+			if (!reader.BeginArray())
+			{
+				return false;
+			}
+
+			const ArraySizeType size = functions.mGetSize(value);
+
+			if (IsContiguousNumberArray(functions))
+			{
+				size_t count;
+				if (!ReadNumberArray(reader, context, functions.mElementType.mType.mKind, size, count))
+				{
+					return false;
+				}
+
+				StoreNumberArray(context, functions.mElementType.mType, functions.mGetData(value), count);
+				return true;
+			}
+
+			ArraySizeType index = 0;
+			while (reader.NextElement())
+			{
+				// Skip any values that don't fit.
+				const bool success = index < size ?
+					DeserializeValue(reader, context, functions.mElementType, nullptr, functions.GetElement(value, index)) :
+					reader.SkipValue();
+
+				if (!success)
+				{
+					return false;
+				}
+
+				++index;
+			}
+
+			return !reader.HasError();
+		}
+
+		case ContainerKind::AssociativeArray:
+		{
+			const auto& functions = static_cast<const AssociativeArrayFunctions&>(containerFunctions);
+			if (!reader.BeginObject())
+			{
+				return false;
+			}
+
+			// When updating, entries for keys that are already present are overwritten, and entries for keys missing from the input
+			// are removed at the end.
+			const ArraySizeType oldSize = functions.mGetSize(value);
+			if (!mReuseMemory)
+			{
+				functions.mClear(value);
+			}
+
+			// Keys are built in scratch memory and then moved into the container.
+			alignas(std::max_align_t) std::byte keyBuffer[64];
+			const bool useKeyBuffer = functions.mKeySize <= sizeof(keyBuffer) && functions.mKeyAlignment <= alignof(std::max_align_t);
+			void* key = useKeyBuffer ? keyBuffer : IConfig::Get().AllocateMemory(functions.mKeySize);
+
+			const size_t firstVisitedEntry = VisitedEntries.size();
+
+			bool success = true;
+			std::string_view keyString;
+			while (success && reader.NextKey(keyString))
+			{
+				functions.mConstructKey(key);
+
+				void* entry = ParseKey(keyString, functions.mKeyType, key) ? functions.mEmplace(value, key) : nullptr;
+				success = entry != nullptr ?
+					DeserializeValue(reader, context, functions.mValueType, nullptr, entry) :
+					reader.SkipValue();
+
+				if (entry != nullptr && mReuseMemory)
+				{
+					VisitedEntries.push_back(entry);
+				}
+
+				functions.mDestructKey(key);
+			}
+
+			if (!useKeyBuffer)
+			{
+				IConfig::Get().FreeMemory(key);
+			}
+
+			const ArraySizeType newSize = functions.mGetSize(value);
+			bool erased = false;
+			if (success && mReuseMemory && newSize != VisitedEntries.size() - firstVisitedEntry)
+			{
+				erased = EraseUnvisitedEntries(functions, value, firstVisitedEntry);
+			}
+
+			VisitedEntries.resize(firstVisitedEntry);
+
+			context.mChanged |= mReuseMemory ? newSize != oldSize || erased : newSize != 0 || oldSize != 0;
+			return success && !reader.HasError();
+		}
+
+		case ContainerKind::Optional:
+		{
+			const auto& functions = static_cast<const OptionalFunctions&>(containerFunctions);
+			if (reader.PeekValue() == ValueType::Null)
+			{
+				context.mChanged |= functions.HasValue(value);
+				functions.mReset(value);
+				return reader.ReadNull();
+			}
+
+			void* optionalValue = mReuseMemory ? functions.mGetValue(value) : nullptr;
+			if (optionalValue == nullptr)
+			{
+				optionalValue = functions.mEmplace(value);
+				context.mChanged = true;
+			}
+
+			return optionalValue != nullptr ?
+				DeserializeValue(reader, context, functions.mValueType, nullptr, optionalValue) :
+				reader.SkipValue();
+		}
+
+		default:
+			return reader.SkipValue();
+		}
+	}
+
+	bool Deserializer::DeserializeArrayChunks(std::vector<std::unique_ptr<IReader>>& chunks, size_t size, const FieldContext& context, const DynamicArrayFunctions& functions, void* value)
+	{
+		// Every chunk decodes into its own elements, so the result doesn't depend on how the chunks are scheduled.
+		context.mChanged |= functions.mGetSize(value) != (ArraySizeType)size;
+		functions.mSetSize(value, (ArraySizeType)size);
+
+		// Chunks track changes separately, they run on different threads.
+		std::vector<uint8_t> chunkResults(chunks.size(), false);
+		std::vector<uint8_t> chunkChanges(chunks.size(), false);
+		mThreadPool->ParallelFor(chunks.size(), [&](size_t chunkIndex)
+		{
+			IReader& chunk = *chunks[chunkIndex];
+
+			bool changed = false;
+			const FieldContext chunkContext{ context.mClassObject, context.mClassInfo, context.mFieldInfo, changed };
+
+			ArraySizeType index = (ArraySizeType)(chunkIndex * mChunkSize);
+			bool success = true;
+			while (success && chunk.NextElement())
+			{
+				success = DeserializeValue(chunk, chunkContext, functions.mElementType, nullptr, functions.GetElement(value, index++));
+			}
+
+			chunkResults[chunkIndex] = success && !chunk.HasError();
+			chunkChanges[chunkIndex] = changed;
+		});
+
+		context.mChanged |= std::any_of(chunkChanges.begin(), chunkChanges.end(), [](uint8_t changed) { return changed != 0; });
+		return std::all_of(chunkResults.begin(), chunkResults.end(), [](uint8_t result) { return result != 0; });
+	}
+
+	bool Deserializer::DeserializeElement(IReader& reader, const FieldContext& context, const TypeInfo& type, bool isPointer, void* value)
+	{
+		if (isPointer)
+		{
+			const ClassInfo* classInfo = type.mKind == TypeKind::Class ? type.GetClassInfo() : nullptr;
+			if (classInfo == nullptr)
+			{
+				CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping field '%s', only pointers to reflected classes can be deserialized.", GetNameDebugString(context.mFieldInfo.mName));
+				return reader.SkipValue();
+			}
+
+			return DeserializeDynamicObject(reader, context, *classInfo, *(void**)value);
+		}
+
+		if (type.mKind != TypeKind::Class)
+		{
+			return DeserializeScalar(reader, context, type, value);
+		}
+
+#if CPPREFL_WITH_STL()
+		if (IsSameType<std::string>(type))
+		{
+			std::string_view string;
+			if (!reader.ReadString(string))
+			{
+				return false;
+			}
+
+			std::string& currentString = *static_cast<std::string*>(value);
+			if (currentString != string)
+			{
+				currentString.assign(string);
+				context.mChanged = true;
+			}
+
+			return true;
+		}
+#endif
+
+		const ClassInfo* classInfo = type.GetClassInfo();
+		if (classInfo == nullptr)
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping field '%s', its type is not reflected.", GetNameDebugString(context.mFieldInfo.mName));
+			return reader.SkipValue();
+		}
+
+		return DeserializeObject(reader, *classInfo, value, context.mChanged);
+	}
+
+	bool Deserializer::DeserializeScalar(IReader& reader, const FieldContext& context, const TypeInfo& type, void* value)
+	{
+		// Compare the bytes of the value before and after to detect changes.
+		std::byte oldValue[sizeof(long double)];
+		const size_t size = std::min(type.mSize, sizeof(oldValue));
+		std::memcpy(oldValue, value, size);
+
+		bool success;
+		switch (type.mKind)
+		{
+		case TypeKind::Bool:
+			success = reader.ReadBool(*(bool*)value);
+			break;
+
+		case TypeKind::Enum:
+			success = DeserializeEnum(reader, type, value);
+			break;
+
+		default:
+			if (!IsIntegerType(type.mKind) && !IsFloatingPointType(type.mKind))
+			{
+				return reader.SkipValue();
+			}
+
+			success = DeserializeNumber(reader, context, type.mKind, value);
+			break;
+		}
+
+		context.mChanged |= std::memcmp(oldValue, value, size) != 0;
+		return success;
+	}
+
+	bool Deserializer::DeserializeDynamicObject(IReader& reader, const FieldContext& context, const ClassInfo& staticClassInfo, void*& value)
+	{
+		if (reader.PeekValue() == ValueType::Null)
+		{
+			context.mChanged |= value != nullptr;
+			FreeDynamicObject(staticClassInfo, value);
+			return reader.ReadNull();
+		}
+
+		if (!reader.BeginObject())
+		{
+			return false;
+		}
+
+		// The first key may name the class to create.
+		const ClassInfo* classInfo = &staticClassInfo;
+
+		std::string_view key;
+		const bool hasFields = reader.NextKey(key);
+		Name firstField = hasFields ? Name(key.data(), key.size()) : Name::Invalid();
+
+		if (hasFields && firstField == DynamicTypeKey)
+		{
+			std::string_view typeName;
+			if (!reader.ReadString(typeName))
+			{
+				return false;
+			}
+
+			const ClassInfo* dynamicClassInfo = staticClassInfo.GetDerivedClass(Name(typeName.data(), typeName.size()));
+			if (dynamicClassInfo == nullptr)
+			{
+				CPPREFL_INTERNAL_LOG(LogLevel::Error, "'%.*s' is not a reflected class derived from '%s'.", (int)typeName.size(), typeName.data(), GetNameDebugString(staticClassInfo.mType->mName));
+				return false;
+			}
+
+			classInfo = dynamicClassInfo;
+			firstField = Name::Invalid();
+		}
+
+		// An existing object of the same class is updated in place, one of another class is replaced.
+		if (value != nullptr && mReuseMemory && &staticClassInfo.GetDynamicClass(value) != classInfo)
+		{
+			FreeDynamicObject(staticClassInfo, value);
+		}
+
+		if (value == nullptr || !mReuseMemory)
+		{
+			value = IConfig::Get().AllocateMemory(classInfo->mType->mSize);
+			classInfo->Construct(value);
+			context.mChanged = true;
+		}
+
+		if (!(firstField == Name::Invalid()) && !DeserializeField(reader, *classInfo, value, firstField, context.mChanged))
+		{
+			return false;
+		}
+
+		return !hasFields || DeserializeObjectFields(reader, *classInfo, value, context.mChanged);
+	}
+
+	void Deserializer::FreeDynamicObject(const ClassInfo& staticClassInfo, void*& value)
+	{
+		if (value != nullptr && mReuseMemory)
+		{
+			const ClassInfo& classInfo = staticClassInfo.GetDynamicClass(value);
+			classInfo.Destruct(value);
+			IConfig::Get().FreeMemory(value);
+		}
+
+		value = nullptr;
+	}
+
+	void Deserializer::FreeString(char*& string)
+	{
+		// Strings in an arena are freed when it is released.
+		if (string != nullptr && mReuseMemory && mArena == nullptr)
+		{
+			IConfig::Get().FreeMemory(string);
+		}
+
+		string = nullptr;
+	}
+
+	bool Deserializer::DeserializeNumber(IReader& reader, const FieldContext& context, TypeKind kind, void* value)
+	{
+		ReadNumberValue number;
+		if (!ReadNumber(reader, context, kind, number))
+		{
+			return false;
+		}
+
+		StoreNumbers(context, kind, &number, value, 1);
+		return true;
+	}
+
+	bool Deserializer::ReadNumber(IReader& reader, const FieldContext& context, TypeKind kind, ReadNumberValue& number)
+	{
+		if (IsFloatingPointType(kind))
+		{
+			if (!reader.ReadDouble(number.mDouble))
+			{
+				return false;
+			}
+
+			for (IObjectDeserializerExtension* extension : mExtensions)
+			{
+				extension->ModifyValue(context.mClassObject, context.mClassInfo, context.mFieldInfo, number.mDouble);
+			}
+
+			return true;
+		}
+
+		if (IsSignedType(kind))
+		{
+			if (!reader.ReadInt(number.mInt))
+			{
+				return false;
+			}
+
+			for (IObjectDeserializerExtension* extension : mExtensions)
+			{
+				extension->ModifyValue(context.mClassObject, context.mClassInfo, context.mFieldInfo, number.mInt);
+			}
+
+			return true;
+		}
+
+		if (!reader.ReadUInt(number.mUInt))
+		{
+			return false;
+		}
+
+		for (IObjectDeserializerExtension* extension : mExtensions)
+		{
+			extension->ModifyValue(context.mClassObject, context.mClassInfo, context.mFieldInfo, number.mUInt);
+		}
+
+		return true;
+	}
+
+	void Deserializer::StoreNumbers(const FieldContext& context, TypeKind kind, const ReadNumberValue* numbers, void* values, size_t count)
+	{
+		// Values that don't fit are truncated, the way a cast would.
+		const size_t overflowCount = ConvertNumbers(GetReadKind(kind), numbers, kind, values, count);
+		if (overflowCount > 0)
+		{
+			LogNumberOverflow(context.mFieldInfo, overflowCount);
+		}
+	}
+
+	void Deserializer::LogNumberOverflow(const FieldInfo& fieldInfo, size_t overflowCount)
+	{
+		CPPREFL_INTERNAL_LOG(LogLevel::Warning, "%zu value(s) of field '%.*s' didn't fit its type and were truncated.", overflowCount,
+			(int)fieldInfo.mNameString.size(), fieldInfo.mNameString.data());
+	}
+
+	bool Deserializer::ReadNumberArray(IReader& reader, const FieldContext& context, TypeKind kind, size_t maxCount, size_t& count)
+	{
+		std::vector<ReadNumberValue>& numbers = GetReadNumbers();
+		numbers.clear();
+
+		while (reader.NextElement())
+		{
+			// Skip any values that don't fit.
+			if (numbers.size() == maxCount)
+			{
+				if (!reader.SkipValue())
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			if (!ReadNumber(reader, context, kind, numbers.emplace_back()))
+			{
+				return false;
+			}
+		}
+
+		count = numbers.size();
+		return !reader.HasError();
+	}
+
+	void Deserializer::StoreNumberArray(const FieldContext& context, const TypeInfo& type, void* values, size_t count)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		// Only compare the values if nothing else changed yet.
+		const size_t size = count * type.mSize;
+		const bool detectChanges = !context.mChanged;
+		if (detectChanges)
+		{
+			OldNumbers.assign((const std::byte*)values, (const std::byte*)values + size);
+		}
+
+		StoreNumbers(context, type.mKind, GetReadNumbers().data(), values, count);
+
+		if (detectChanges)
+		{
+			context.mChanged = std::memcmp(OldNumbers.data(), values, size) != 0;
+		}
+	}
+
+	std::vector<Deserializer::ReadNumberValue>& Deserializer::GetReadNumbers()
+	{
+		thread_local std::vector<ReadNumberValue> numbers;
+		return numbers;
+	}
+
+	bool Deserializer::DeserializeEnum(IReader& reader, const TypeInfo& type, void* value)
+	{
+		// Enums can be stored by name or by value.
+		if (reader.PeekValue() == ValueType::Number)
+		{
+			int64_t number;
+			return reader.ReadInt(number) && StoreEnum(type, value, number);
+		}
+
+		std::string_view name;
+		if (!reader.ReadString(name))
+		{
+			return false;
+		}
+
+		const EnumInfo* enumInfo = type.GetEnumInfo();
+		const EnumValueInfo* enumValue = enumInfo != nullptr ? enumInfo->GetValue(Name(name.data(), name.size())) : nullptr;
+		if (enumValue == nullptr)
+		{
+			CPPREFL_INTERNAL_LOG(LogLevel::Warning, "'%.*s' is not a valid enum value.", (int)name.size(), name.data());
+			return true;
+		}
+
+		return StoreEnum(type, value, enumValue->mValue);
+	}
+
+	void Serializer::Serialize(IWriter& writer, const ClassInfo& classInfo, const void* classObject)
+	{
+		writer.BeginObject();
+		SerializeObjectFields(writer, classInfo, classObject);
+		writer.EndObject();
+	}
+
+	void Serializer::SerializeObjectFields(IWriter& writer, const ClassInfo& classInfo, const void* classObject)
+	{
+		const ClassSerializerFunctions* generatedFunctions = mUseGeneratedCode ? classInfo.GetSerializerFunctions() : nullptr;
+		if (generatedFunctions != nullptr)
+		{
+			generatedFunctions->mSerializeFields(*this, writer, classObject);
+			return;
+		}
+
+		for (const FieldRecord& record : classInfo.GetFieldRecords())
+		{
+			const FieldInfo& fieldInfo = classInfo.GetFieldInfo(record);
+			const void* value = (const std::byte*)classObject + record.mOffset;
+
+			writer.Key(fieldInfo.mNameString);
+
+			// Plain numbers can be written straight off the record.
+			if (record.mFlags == FieldFlags::None && (IsIntegerType(record.mKind) || IsFloatingPointType(record.mKind)))
+			{
+				SerializeNumber(writer, record.mKind, value);
+				continue;
+			}
+
+			SerializeValue(writer, fieldInfo.mTypeInstance, fieldInfo.mContainerFunctions, value);
+		}
+	}
+
+	void Serializer::SerializeValue(IWriter& writer, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value)
+	{
+		if (containerFunctions != nullptr)
+		{
+			SerializeContainer(writer, *containerFunctions, value);
+			return;
+		}
+
+		if (type.IsFixedSizeCString())
+		{
+			writer.WriteString(std::string_view((const char*)value, strnlen((const char*)value, type.mArraySize)));
+			return;
+		}
+
+		if (type.IsDynamicCString())
+		{
+			const char* string = *(const char* const*)value;
+			if (string != nullptr)
+			{
+				writer.WriteString(string);
+			}
+			else
+			{
+				writer.WriteNull();
+			}
+			return;
+		}
+
+		if (type.mIsArray)
+		{
+			if (!type.mIsPointer && IsNumberKind(type.mType.mKind))
+			{
+				SerializeNumberArray(writer, type.mType.mKind, value, type.mArraySize);
+				return;
+			}
+
+			const size_t stride = type.mIsPointer ? sizeof(void*) : type.mType.mSize;
+
+			writer.BeginArray();
+			for (ArraySizeType i = 0; i < type.mArraySize; ++i)
+			{
+				SerializeElement(writer, type.mType, type.mIsPointer, (const std::byte*)value + i * stride);
+			}
+			writer.EndArray();
+			return;
+		}
+
+		SerializeElement(writer, type.mType, type.mIsPointer, value);
+	}
+
+	void Serializer::SerializeContainer(IWriter& writer, const ContainerFunctions& containerFunctions, const void* value)
+	{
+		// The accessor tables take mutable containers, but none of the functions used here modify them.
+		void* container = const_cast<void*>(value);
+
+		switch (containerFunctions.mKind)
+		{
+		case ContainerKind::DynamicArray:
+		{
+			const auto& functions = static_cast<const DynamicArrayFunctions&>(containerFunctions);
+			const ArraySizeType size = functions.mGetSize(container);
+
+			if (IsContiguousNumberArray(functions))
+			{
+				SerializeNumberArray(writer, functions.mElementType.mType.mKind, functions.mGetData(container), size);
+				return;
+			}
+
+			writer.BeginArray();
+			for (ArraySizeType i = 0; i < size; ++i)
+			{
+				SerializeValue(writer, functions.mElementType, nullptr, functions.GetElement(container, i));
+			}
+			writer.EndArray();
+			return;
+		}
+
+		case ContainerKind::ArrayView:
+		{
+			const auto& functions = static_cast<const ArrayViewFunctions&>(containerFunctions);
+			const ArraySizeType size = functions.mGetSize(container);
+
+			if (IsContiguousNumberArray(functions))
+			{
+				SerializeNumberArray(writer, functions.mElementType.mType.mKind, functions.mGetData(container), size);
+				return;
+			}
+
+			writer.BeginArray();
+			for (ArraySizeType i = 0; i < size; ++i)
+			{
+				SerializeValue(writer, functions.mElementType, nullptr, functions.GetElement(container, i));
+			}
+			writer.EndArray();
+			return;
+		}
+
+		case ContainerKind::AssociativeArray:
+		{
+			const auto& functions = static_cast<const AssociativeArrayFunctions&>(containerFunctions);
+
+			struct VisitContext
+			{
+				Serializer& mSerializer;
+				IWriter& mWriter;
+				const AssociativeArrayFunctions& mFunctions;
+			};
+
+			VisitContext context{ *this, writer, functions };
+
+			writer.BeginObject();
+			functions.mForEach(container, [](void* contextPtr, const void* key, void* entry)
+			{
+				const VisitContext& context = *static_cast<VisitContext*>(contextPtr);
+
+				char buffer[32];
+				std::string_view keyString;
+				if (!FormatKey(context.mFunctions.mKeyType, key, buffer, keyString))
+				{
+					CPPREFL_INTERNAL_LOG(LogLevel::Warning, "Skipping map entry, its key can't be written as a string (%s).", GetNameDebugString(context.mFunctions.mKeyType.mType.mName));
+					return true;
+				}
+
+				context.mWriter.Key(keyString);
+				context.mSerializer.SerializeValue(context.mWriter, context.mFunctions.mValueType, nullptr, entry);
+				return true;
+			}, &context);
+			writer.EndObject();
+			return;
+		}
+
+		case ContainerKind::Optional:
+		{
+			const auto& functions = static_cast<const OptionalFunctions&>(containerFunctions);
+			const void* optionalValue = functions.mGetValue(container);
+			if (optionalValue != nullptr)
+			{
+				SerializeValue(writer, functions.mValueType, nullptr, optionalValue);
+			}
+			else
+			{
+				writer.WriteNull();
+			}
+			return;
+		}
+
+		default:
+			writer.WriteNull();
+			return;
+		}
+	}
+
+	void Serializer::SerializeElement(IWriter& writer, const TypeInfo& type, bool isPointer, const void* value)
+	{
+		if (isPointer)
+		{
+			const ClassInfo* classInfo = type.mKind == TypeKind::Class ? type.GetClassInfo() : nullptr;
+			if (classInfo == nullptr)
+			{
+				writer.WriteNull();
+				return;
+			}
+
+			SerializeDynamicObject(writer, *classInfo, *(const void* const*)value);
+			return;
+		}
+
+		switch (type.mKind)
+		{
+		case TypeKind::Bool:
+			writer.WriteBool(*(const bool*)value);
+			return;
+
+		case TypeKind::Enum:
+			SerializeEnum(writer, type, value);
+			return;
+
+		case TypeKind::Class:
+		{
+#if CPPREFL_WITH_STL()
+			if (IsSameType<std::string>(type))
+			{
+				writer.WriteString(*static_cast<const std::string*>(value));
+				return;
+			}
+#endif
+
+			const ClassInfo* classInfo = type.GetClassInfo();
+			if (classInfo == nullptr)
+			{
+				writer.WriteNull();
+				return;
+			}
+
+			Serialize(writer, *classInfo, value);
+			return;
+		}
+
+		default:
+			if (IsIntegerType(type.mKind) || IsFloatingPointType(type.mKind))
+			{
+				SerializeNumber(writer, type.mKind, value);
+				return;
+			}
+
+			writer.WriteNull();
+			return;
+		}
+	}
+
+	void Serializer::SerializeDynamicObject(IWriter& writer, const ClassInfo& staticClassInfo, const void* value)
+	{
+		if (value == nullptr)
+		{
+			writer.WriteNull();
+			return;
+		}
+
+		writer.BeginObject();
+
+		// Only name the class if it differs from the pointer type, so the common case reads back without a registry lookup.
+		const ClassInfo& classInfo = staticClassInfo.GetDynamicClass(value);
+		if (&classInfo != &staticClassInfo)
+		{
+			writer.Key(DynamicTypeKeyString);
+			writer.WriteString(classInfo.mType->mNameString);
+		}
+
+		SerializeObjectFields(writer, classInfo, value);
+		writer.EndObject();
+	}
+
+	void Serializer::SerializeNumber(IWriter& writer, TypeKind kind, const void* value)
+	{
+		switch (kind)
+		{
+		case TypeKind::Float: writer.WriteFloat(*(const float*)value); return;
+		case TypeKind::Double: writer.WriteDouble(*(const double*)value); return;
+		case TypeKind::LongDouble: writer.WriteDouble((double)*(const long double*)value); return;
+		default:
+			if (IsSignedType(kind))
+			{
+				writer.WriteInt(LoadInteger<int64_t>(kind, value));
+			}
+			else
+			{
+				writer.WriteUInt(LoadInteger<uint64_t>(kind, value));
+			}
+			return;
+		}
+	}
+
+	void Serializer::SerializeNumberArray(IWriter& writer, TypeKind kind, const void* values, size_t count)
+	{
+		writer.BeginArray();
+		if (kind == TypeKind::Float)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				writer.WriteFloat(((const float*)values)[i]);
+			}
+		}
+		else if (kind == TypeKind::Double)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				writer.WriteDouble(((const double*)values)[i]);
+			}
+		}
+		else
+		{
+			// Widen all of the values at once.
+			const TypeKind writeKind = kind == TypeKind::LongDouble ? TypeKind::Double : IsSignedType(kind) ? TypeKind::Int64 : TypeKind::Uint64;
+			WrittenNumbers.resize(count);
+			ConvertNumbers(kind, values, writeKind, WrittenNumbers.data(), count);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				switch (writeKind)
+				{
+				case TypeKind::Double: writer.WriteDouble(std::bit_cast<double>(WrittenNumbers[i])); break;
+				case TypeKind::Int64: writer.WriteInt((int64_t)WrittenNumbers[i]); break;
+				default: writer.WriteUInt(WrittenNumbers[i]); break;
+				}
+			}
+		}
+		writer.EndArray();
+	}
+
+	void Serializer::SerializeEnum(IWriter& writer, const TypeInfo& type, const void* value)
+	{
+		// Enums are written by name, falling back to the value if it isn't one of the enum's values.
+		const int64_t number = LoadEnum(type, value);
+		const std::string_view name = GetEnumValueName(type, number);
+		if (!name.empty())
+		{
+			writer.WriteString(name);
+		}
+		else
+		{
+			writer.WriteInt(number);
+		}
+	}
+}
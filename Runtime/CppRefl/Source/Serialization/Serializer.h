@@ -0,0 +1,209 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "Reader.h"
+#include "Writer.h"
+#include "../Reflection/ClassInfo.h"
+#include "../Reflection/DynamicArray.h"
+
+namespace cpprefl::serialization
+{
+	class DeserializationArena;
+	class GeneratedSerializerBase;
+	class ThreadPool;
+
+	// Hooks into deserialization of individual fields (e.g. to implement metadata driven behaviour).
+	class IObjectDeserializerExtension
+	{
+	public:
+		virtual ~IObjectDeserializerExtension() = default;
+
+		// Determines if a field can be deserialized. If not, its value is skipped.
+		virtual bool CanDeserialize(void* classObject, const ClassInfo& classInfo, const FieldInfo& fieldInfo) { return true; }
+
+		// Modifies a value before it is written to a field.
+		virtual void ModifyValue(void* classObject, const ClassInfo& classInfo, const FieldInfo& fieldInfo, int64_t& value) {}
+		virtual void ModifyValue(void* classObject, const ClassInfo& classInfo, const FieldInfo& fieldInfo, uint64_t& value) {}
+		virtual void ModifyValue(void* classObject, const ClassInfo& classInfo, const FieldInfo& fieldInfo, double& value) {}
+
+		// Called after a field was deserialized if its value changed, including changes to nested fields and container elements.
+		virtual void OnFieldChanged(void* classObject, const ClassInfo& classInfo, const FieldInfo& fieldInfo) {}
+	};
+
+	// Deserializes reflected objects out of a reader.
+	// Values are written straight into the object through the field offsets, so the only copies made are for strings
+	// that end up in a std::string, char[] or const char* field.
+	//
+	// Pointers to reflected classes are deserialized polymorphically: if the first key of the object is "__type__", that class is
+	// created instead of the static type of the pointer. Only single inheritance is supported (the base class must be at offset 0).
+	class Deserializer
+	{
+	public:
+		// Registers an extension. The extension must outlive the deserializer.
+		void RegisterExtension(IObjectDeserializerExtension& extension);
+
+		// Decodes dynamic arrays of objects in parallel on the given pool (or on one thread, if null), in chunks of the given number
+		// of elements. Only readers that can split arrays support this (see IReader::SplitArray()), and the elements of each array
+		// are constructed up front. Extensions are called from the threads of the pool. The pool must outlive the deserializer.
+		void SetThreadPool(ThreadPool* threadPool, size_t chunkSize = 256);
+
+		// Allocates the strings of char* fields from the given arena (or from IConfig, if null), so they can be freed all at once.
+		// The arena must outlive the deserializer, and the strings are only valid until the arena is released.
+		void SetArena(DeserializationArena* arena) { mArena = arena; }
+
+		// Uses the generated serialization code of classes that have it (see GeneratedSerializer.h), which is on by default.
+		// Generated code is never used while extensions are registered, since it doesn't call them.
+		void SetUseGeneratedCode(bool useGeneratedCode) { mUseGeneratedCode = useGeneratedCode; }
+
+		// Deserializes an object of the given type. Returns an empty value if the input is malformed.
+		template <typename T>
+		std::optional<T> Deserialize(IReader& reader)
+		{
+			std::optional<T> result;
+			result.emplace();
+
+			if (!Deserialize(reader, GetReflectedClass<T>(), &*result))
+			{
+				return std::nullopt;
+			}
+
+			return result;
+		}
+
+		// Deserializes into an already constructed object.
+		bool Deserialize(IReader& reader, const ClassInfo& classInfo, void* classObject);
+
+		// Deserializes into an existing object, reusing the memory it holds (e.g. to reload a config): elements of dynamic arrays,
+		// map entries, optional values and objects behind pointers (if they are of the class being read) are overwritten in place
+		// instead of being recreated, and strings keep their capacity. Fields missing from the input, including fields of reused
+		// elements, keep their values.
+		// Returns false if the input is malformed, in which case the object may have been partially updated.
+		//
+		// The object is assumed to own what it points to, as if it had been deserialized: objects behind pointers that are replaced
+		// or removed are destroyed and freed through IConfig, and so are replaced char* strings (unless an arena is set, in which
+		// case they are freed when the arena is released).
+		template <typename T>
+		bool Update(IReader& reader, T& object)
+		{
+			return Update(reader, GetReflectedClass<T>(), &object);
+		}
+
+		bool Update(IReader& reader, const ClassInfo& classInfo, void* classObject);
+
+		// Returns the field a key of an object maps to, or nullptr if its value should be skipped (unknown and const fields,
+		// and fields rejected by an extension). Together with DeserializeFieldValue(), this lets other drivers walk objects themselves.
+		const FieldInfo* FindField(const ClassInfo& classInfo, void* classObject, const Name& fieldName)const;
+
+		// Deserializes the value of a single field. The changed flag is set if the field changes.
+		bool DeserializeFieldValue(IReader& reader, const ClassInfo& classInfo, void* classObject, const FieldInfo& fieldInfo, bool& changed);
+
+		// Deserializes a single element of a dynamic array field into the given element (e.g. one just added to the array), so that
+		// other drivers can walk arrays themselves. The changed flag is set if the element changes, but extensions aren't told until
+		// the driver calls NotifyFieldChanged() once the whole array is read.
+		bool DeserializeFieldElement(IReader& reader, const ClassInfo& classInfo, void* classObject, const FieldInfo& fieldInfo, void* element, bool& changed);
+
+		// Tells the extensions that a field changed, for drivers that read the value of the field themselves (e.g. nested objects).
+		void NotifyFieldChanged(void* classObject, const ClassInfo& classInfo, const FieldInfo& fieldInfo);
+
+	private:
+		// The field currently being deserialized, passed on to extensions.
+		struct FieldContext
+		{
+			void* mClassObject;
+			const ClassInfo& mClassInfo;
+			const FieldInfo& mFieldInfo;
+
+			// Set when any part of the value of the field changes.
+			bool& mChanged;
+		};
+
+		// The changed flag is set if any field of the object changes.
+		bool DeserializeObject(IReader& reader, const ClassInfo& classInfo, void* classObject, bool& changed);
+		bool DeserializeObjectFields(IReader& reader, const ClassInfo& classInfo, void* classObject, bool& changed);
+		bool DeserializeField(IReader& reader, const ClassInfo& classInfo, void* classObject, const Name& fieldName, bool& changed);
+		bool DeserializeReflectedField(IReader& reader, const ClassInfo& classInfo, void* classObject, const Name& fieldName, bool& changed);
+		bool DeserializeField(IReader& reader, const ClassInfo& classInfo, void* classObject, const FieldInfo& fieldInfo, bool& changed);
+
+		bool DeserializeValue(IReader& reader, const FieldContext& context, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, void* value);
+		bool DeserializeContainer(IReader& reader, const FieldContext& context, const ContainerFunctions& containerFunctions, void* value);
+		bool DeserializeArrayChunks(std::vector<std::unique_ptr<IReader>>& chunks, size_t size, const FieldContext& context, const DynamicArrayFunctions& functions, void* value);
+		bool DeserializeElement(IReader& reader, const FieldContext& context, const TypeInfo& type, bool isPointer, void* value);
+		bool DeserializeDynamicObject(IReader& reader, const FieldContext& context, const ClassInfo& staticClassInfo, void*& value);
+
+		// Frees what an object being updated holds before it is replaced (see Update()), and clears the pointer.
+		void FreeDynamicObject(const ClassInfo& staticClassInfo, void*& value);
+		void FreeString(char*& string);
+		bool DeserializeScalar(IReader& reader, const FieldContext& context, const TypeInfo& type, void* value);
+		bool DeserializeNumber(IReader& reader, const FieldContext& context, TypeKind kind, void* value);
+		bool DeserializeEnum(IReader& reader, const TypeInfo& type, void* value);
+
+		// A number as read from the input: an Int64, Uint64 or Double depending on the kind it will be stored as.
+		union ReadNumberValue
+		{
+			int64_t mInt;
+			uint64_t mUInt;
+			double mDouble;
+		};
+		bool ReadNumber(IReader& reader, const FieldContext& context, TypeKind kind, ReadNumberValue& number);
+		void StoreNumbers(const FieldContext& context, TypeKind kind, const ReadNumberValue* numbers, void* values, size_t count);
+		static void LogNumberOverflow(const FieldInfo& fieldInfo, size_t overflowCount);
+
+		// Arrays of numbers are read whole and then converted to the kind of their elements at once (see NumberConversion.h).
+		// The array must have been begun, and values past maxCount are skipped. The values are kept in a thread local buffer until
+		// they are stored, which sets the changed flag if any of them changes.
+		bool ReadNumberArray(IReader& reader, const FieldContext& context, TypeKind kind, size_t maxCount, size_t& count);
+		void StoreNumberArray(const FieldContext& context, const TypeInfo& type, void* values, size_t count);
+		static std::vector<ReadNumberValue>& GetReadNumbers();
+
+		std::vector<IObjectDeserializerExtension*> mExtensions;
+
+		ThreadPool* mThreadPool = nullptr;
+		size_t mChunkSize = 0;
+
+		DeserializationArena* mArena = nullptr;
+
+		// True while updating an object, see Update().
+		bool mReuseMemory = false;
+
+		bool mUseGeneratedCode = true;
+
+		friend class GeneratedSerializerBase;
+	};
+
+	// Serializes reflected objects into a writer, reading values straight out of the object through the field offsets.
+	// The output can be read back with the Deserializer.
+	//
+	// Pointers to reflected classes are serialized polymorphically: if the object is of a derived class, its class name is written
+	// as the first key ("__type__"). Values of unreflected types are written as null.
+	class Serializer
+	{
+	public:
+		template <typename T>
+		void Serialize(IWriter& writer, const T& object)
+		{
+			Serialize(writer, GetReflectedClass<T>(), &object);
+		}
+
+		void Serialize(IWriter& writer, const ClassInfo& classInfo, const void* classObject);
+
+		// Uses the generated serialization code of classes that have it (see GeneratedSerializer.h), which is on by default.
+		void SetUseGeneratedCode(bool useGeneratedCode) { mUseGeneratedCode = useGeneratedCode; }
+
+	private:
+		void SerializeObjectFields(IWriter& writer, const ClassInfo& classInfo, const void* classObject);
+
+		void SerializeValue(IWriter& writer, const TypeInstanceInfo& type, const ContainerFunctions* containerFunctions, const void* value);
+		void SerializeContainer(IWriter& writer, const ContainerFunctions& containerFunctions, const void* value);
+		void SerializeElement(IWriter& writer, const TypeInfo& type, bool isPointer, const void* value);
+		void SerializeDynamicObject(IWriter& writer, const ClassInfo& staticClassInfo, const void* value);
+		void SerializeNumber(IWriter& writer, TypeKind kind, const void* value);
+		void SerializeNumberArray(IWriter& writer, TypeKind kind, const void* values, size_t count);
+		void SerializeEnum(IWriter& writer, const TypeInfo& type, const void* value);
+
+		bool mUseGeneratedCode = true;
+
+		friend class GeneratedSerializerBase;
+	};
+}
@@ -0,0 +1,184 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace cpprefl::serialization
+{
+	namespace
+	{
+		// The pool whose task the current thread is running, if any.
+		thread_local const ThreadPool* CurrentPool = nullptr;
+
+		constexpr uint64_t MakeRange(uint32_t begin, uint32_t end)
+		{
+			return begin | ((uint64_t)end << 32);
+		}
+
+		constexpr uint32_t RangeBegin(uint64_t range) { return (uint32_t)range; }
+		constexpr uint32_t RangeEnd(uint64_t range) { return (uint32_t)(range >> 32); }
+	}
+
+	ThreadPool::ThreadPool(size_t threadCount) :
+		mThreadCount(std::max<size_t>(threadCount, 1)),
+		mRanges(new TaskRange[mThreadCount])
+	{
+		for (size_t i = 0; i < mThreadCount; ++i)
+		{
+			mRanges[i].mRange.store(0, std::memory_order_relaxed);
+		}
+
+		// The thread calling ParallelFor() is thread 0.
+		for (size_t i = 1; i < mThreadCount; ++i)
+		{
+			mWorkers.emplace_back(&ThreadPool::WorkerMain, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+		}
+
+		mWakeWorkers.notify_all();
+		for (std::thread& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& task)
+	{
+		// Nested loops would wait on themselves, so they (and loops started while another is running) run on the calling thread.
+		std::unique_lock<std::mutex> loopLock;
+		if (!IsInParallelFor() && mWorkers.size() > 0 && count > 1 && count <= UINT32_MAX)
+		{
+			loopLock = std::unique_lock<std::mutex>(mLoopMutex, std::try_to_lock);
+		}
+
+		if (!loopLock.owns_lock())
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				task(i);
+			}
+			return;
+		}
+
+		for (size_t i = 0; i < mThreadCount; ++i)
+		{
+			mRanges[i].mRange.store(MakeRange((uint32_t)(count * i / mThreadCount), (uint32_t)(count * (i + 1) / mThreadCount)), std::memory_order_relaxed);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mTask = &task;
+			mBusyWorkers = mWorkers.size();
+			++mLoop;
+		}
+
+		mWakeWorkers.notify_all();
+		RunTasks(0);
+
+		// Workers may still be running the last tasks they took.
+		std::unique_lock<std::mutex> lock(mMutex);
+		mLoopDone.wait(lock, [this]() { return mBusyWorkers == 0; });
+		mTask = nullptr;
+	}
+
+	bool ThreadPool::IsInParallelFor()const
+	{
+		return CurrentPool == this;
+	}
+
+	void ThreadPool::WorkerMain(size_t threadIndex)
+	{
+		uint64_t loop = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mWakeWorkers.wait(lock, [this, loop]() { return mStop || mLoop != loop; });
+				if (mStop)
+				{
+					return;
+				}
+
+				loop = mLoop;
+			}
+
+			RunTasks(threadIndex);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (--mBusyWorkers == 0)
+			{
+				mLoopDone.notify_one();
+			}
+		}
+	}
+
+	void ThreadPool::RunTasks(size_t threadIndex)
+	{
+		CurrentPool = this;
+
+		const std::function<void(size_t)>& task = *mTask;
+		while (true)
+		{
+			uint32_t index;
+			if (PopTask(threadIndex, index))
+			{
+				task(index);
+			}
+			else if (!StealTasks(threadIndex))
+			{
+				break;
+			}
+		}
+
+		CurrentPool = nullptr;
+	}
+
+	bool ThreadPool::PopTask(size_t threadIndex, uint32_t& index)
+	{
+		std::atomic<uint64_t>& range = mRanges[threadIndex].mRange;
+
+		uint64_t current = range.load(std::memory_order_acquire);
+		while (RangeBegin(current) < RangeEnd(current))
+		{
+			if (range.compare_exchange_weak(current, MakeRange(RangeBegin(current) + 1, RangeEnd(current)), std::memory_order_acq_rel))
+			{
+				index = RangeBegin(current);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool ThreadPool::StealTasks(size_t threadIndex)
+	{
+		for (size_t i = 1; i < mThreadCount; ++i)
+		{
+			std::atomic<uint64_t>& victim = mRanges[(threadIndex + i) % mThreadCount].mRange;
+
+			// Take the back half, the victim keeps working through the front.
+			uint64_t current = victim.load(std::memory_order_acquire);
+			while (RangeBegin(current) < RangeEnd(current))
+			{
+				const uint32_t begin = RangeBegin(current);
+				const uint32_t end = RangeEnd(current);
+				const uint32_t split = end - (end - begin + 1) / 2;
+
+				if (victim.compare_exchange_weak(current, MakeRange(begin, split), std::memory_order_acq_rel))
+				{
+					// Our own range is empty, so nobody else writes to it.
+					mRanges[threadIndex].mRange.store(MakeRange(split, end), std::memory_order_release);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cpprefl::serialization
+{
+	// A fixed set of threads for running loops in parallel, e.g. to decode large arrays.
+	//
+	// Each thread works through its own contiguous range of indices, and steals half of the remaining range of another thread
+	// when it runs out, so uneven work (e.g. elements of different sizes) is balanced without handing out indices one at a time.
+	class ThreadPool
+	{
+	public:
+		// Creates a pool that runs loops on the given number of threads, including the thread calling ParallelFor().
+		explicit ThreadPool(size_t threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		size_t GetThreadCount()const { return mThreadCount; }
+
+		// Calls the task for every index in [0, count) and returns once all calls are done. Calls made from inside a task
+		// (or while another thread is running a loop) run on the calling thread only.
+		void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+		// Returns true if the calling thread is running a task of this pool.
+		bool IsInParallelFor()const;
+
+	private:
+		// Remaining indices of a thread: the first index in the low 32 bits, the end in the high 32 bits.
+		struct alignas(64) TaskRange
+		{
+			std::atomic<uint64_t> mRange;
+		};
+
+		void WorkerMain(size_t threadIndex);
+		void RunTasks(size_t threadIndex);
+
+		bool PopTask(size_t threadIndex, uint32_t& index);
+		bool StealTasks(size_t threadIndex);
+
+		size_t mThreadCount;
+		std::vector<std::thread> mWorkers;
+		std::unique_ptr<TaskRange[]> mRanges;
+
+		// Only one loop runs at a time.
+		std::mutex mLoopMutex;
+
+		std::mutex mMutex;
+		std::condition_variable mWakeWorkers;
+		std::condition_variable mLoopDone;
+
+		const std::function<void(size_t)>* mTask = nullptr;
+		uint64_t mLoop = 0;
+		size_t mBusyWorkers = 0;
+		bool mStop = false;
+	};
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace cpprefl::serialization
+{
+	// Push interface for writing a serialized document. The Serializer drives the writer straight off the reflection data,
+	// so no intermediate document is ever built.
+	//
+	// Objects are written with BeginObject(), then Key() followed by exactly one value for each field, then EndObject().
+	// Arrays are written with BeginArray(), one value per element, then EndArray().
+	class IWriter
+	{
+	public:
+		virtual ~IWriter() = default;
+
+		virtual void BeginObject() = 0;
+
+		// Writes the key of the next value in the current object.
+		virtual void Key(std::string_view key) = 0;
+
+		virtual void EndObject() = 0;
+
+		virtual void BeginArray() = 0;
+		virtual void EndArray() = 0;
+
+		virtual void WriteNull() = 0;
+		virtual void WriteBool(bool value) = 0;
+		virtual void WriteInt(int64_t value) = 0;
+		virtual void WriteUInt(uint64_t value) = 0;
+
+		// Floats are written separately from doubles so they can use their own shortest representation.
+		virtual void WriteFloat(float value) = 0;
+		virtual void WriteDouble(double value) = 0;
+
+		virtual void WriteString(std::string_view value) = 0;
+	};
+}